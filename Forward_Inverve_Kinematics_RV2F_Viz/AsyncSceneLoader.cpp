@@ -0,0 +1,304 @@
+#include "AsyncSceneLoader.h"
+
+#include <Inventor/SbViewportRegion.h>
+#include <Inventor/SoFullPath.h>
+#include <Inventor/actions/SoGetMatrixAction.h>
+#include <Inventor/actions/SoSearchAction.h>
+#include <Inventor/VRMLnodes/SoVRMLLOD.h>
+#include <Inventor/VRMLnodes/SoVRMLShape.h>
+#include <Inventor/VRMLnodes/SoVRMLTransform.h>
+#include <rl/sg/Model.h>
+#include <rl/sg/Shape.h>
+#include <rl/sg/so/Shape.h>
+
+#include <algorithm>
+
+#include "MeshCache.h"
+
+namespace vm {
+
+static SbMatrix getPathMatrix(SoPath* _path) {
+	SbViewportRegion viewport_region;
+	SoGetMatrixAction action(viewport_region);
+	action.apply(_path);
+	return action.getMatrix();
+}
+
+AsyncSceneLoader::AsyncSceneLoader() {
+	this->structure_depth = 0;
+	this->number_of_requests = 0;
+	this->number_of_attached = 0;
+	this->stopping = false;
+}
+
+AsyncSceneLoader::~AsyncSceneLoader() {
+	this->uninstall();
+
+	// files that were read but never attached
+	for (std::size_t i = 0; i < this->finished.size(); ++i) {
+		this->finished[i].node->unref();
+		if (this->finished[i].child != NULL) {
+			this->finished[i].child->unref();
+		}
+	}
+}
+
+void AsyncSceneLoader::install(std::size_t _number_of_threads) {
+	this->uninstall();
+
+	if (_number_of_threads == 0) {
+		_number_of_threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+	}
+
+	this->stopping = false;
+
+	for (std::size_t i = 0; i < _number_of_threads; ++i) {
+		this->threads.push_back(std::thread(&AsyncSceneLoader::run, this));
+	}
+
+	SoVRMLInline::setFetchURLCallBack(AsyncSceneLoader::fetchUrl, this);
+}
+
+void AsyncSceneLoader::uninstall() {
+	if (this->threads.empty() == true) {
+		return;
+	}
+
+	SoVRMLInline::setFetchURLCallBack(NULL, NULL);
+
+	// pending files are still read, poll() attaches them afterwards
+	{
+		std::lock_guard<std::mutex> locker(this->mutex);
+		this->stopping = true;
+	}
+
+	this->condition.notify_all();
+
+	for (std::size_t i = 0; i < this->threads.size(); ++i) {
+		this->threads[i].join();
+	}
+
+	this->threads.clear();
+}
+
+void AsyncSceneLoader::addScene(rl::sg::Scene* _scene) {
+	this->scenes.push_back(_scene);
+}
+
+std::size_t AsyncSceneLoader::poll() {
+	std::deque<AsyncSceneLoader::Request> requests;
+
+	{
+		std::lock_guard<std::mutex> locker(this->mutex);
+		requests.swap(this->finished);
+	}
+
+	for (std::size_t i = 0; i < requests.size(); ++i) {
+		if (requests[i].child != NULL) {
+			requests[i].node->setChildData(requests[i].child);
+			this->createShapes(requests[i].node, requests[i].child);
+			requests[i].child->unref();
+		}
+
+		this->placements.erase(requests[i].node);
+		requests[i].node->unref();
+	}
+
+	this->number_of_attached += requests.size();
+
+	return requests.size();
+}
+
+bool AsyncSceneLoader::isFinished() {
+	std::lock_guard<std::mutex> locker(this->mutex);
+	return this->pending.empty() == true && this->finished.empty() == true && this->number_of_attached == this->number_of_requests;
+}
+
+std::size_t AsyncSceneLoader::getNumberOfRequests() {
+	std::lock_guard<std::mutex> locker(this->mutex);
+	return this->number_of_requests;
+}
+
+std::size_t AsyncSceneLoader::getNumberOfAttached() const {
+	return this->number_of_attached;
+}
+
+void AsyncSceneLoader::fetchUrl(const SbString& _url, void* _closure, SoVRMLInline* _node) {
+	AsyncSceneLoader* loader = static_cast<AsyncSceneLoader*>(_closure);
+
+	AsyncSceneLoader::Request request;
+	request.node = _node;
+	request.file_name = MeshCache::resolveUrl(_url);
+	request.child = NULL;
+
+	// the top level file is read by Scene::load() itself, the bodies of its inlines are never known to place()
+	if (loader->structure_depth == 0 || (MeshCache::isUpToDate(request.file_name) == false && MeshCache::isGeometryFile(request.file_name) == false)) {
+		loader->loadStructure(request.file_name, _node);
+		return;
+	}
+
+	// keeps the inline alive until poll() attached its geometry
+	_node->ref();
+	loader->placements[_node] = AsyncSceneLoader::Placement();
+
+	{
+		std::lock_guard<std::mutex> locker(loader->mutex);
+		loader->pending.push_back(request);
+		++loader->number_of_requests;
+	}
+
+	loader->condition.notify_one();
+}
+
+void AsyncSceneLoader::loadStructure(const std::string& _file_name, SoVRMLInline* _node) {
+	// nested inlines come back through fetchUrl() while the file is read
+	++this->structure_depth;
+	SoNode* child = MeshCache::read(_file_name);
+	--this->structure_depth;
+
+	if (child == NULL) {
+		return;
+	}
+
+	child->ref();
+	_node->setChildData(child);
+	this->place(child);
+	child->unref();
+}
+
+void AsyncSceneLoader::place(SoNode* _root) {
+	SoSearchAction search;
+	search.setType(SoVRMLInline::getClassTypeId());
+	search.setInterest(SoSearchAction::ALL);
+	search.setSearchingAll(TRUE);
+	search.apply(_root);
+
+	// files enclosing this one are placed later and find the body if this file has none
+	for (int i = 0; i < search.getPaths().getLength(); ++i) {
+		SoFullPath* path = static_cast<SoFullPath*>(search.getPaths()[i]);
+
+		std::map<SoVRMLInline*, AsyncSceneLoader::Placement>::iterator placement = this->placements.find(static_cast<SoVRMLInline*>(path->getTail()));
+		if (placement == this->placements.end()) {
+			continue;
+		}
+
+		for (int j = path->getLength() - 2; j >= 0; --j) {
+			if (path->getNode(j)->isOfType(SoVRMLTransform::getClassTypeId()) == TRUE && path->getNode(j)->getName().getLength() > 0) {
+				SoPath* body_path = path->copy(j + 1);
+				body_path->ref();
+				placement->second.body_name = path->getNode(j)->getName().getString();
+				placement->second.matrix = getPathMatrix(body_path);
+				body_path->unref();
+				break;
+			}
+		}
+	}
+}
+
+void AsyncSceneLoader::createShapes(SoVRMLInline* _node, SoNode* _child) {
+	std::map<SoVRMLInline*, AsyncSceneLoader::Placement>::iterator placement = this->placements.find(_node);
+
+	// an inline outside of every body has no shapes in the scenes either
+	if (placement == this->placements.end() || placement->second.body_name.empty() == true) {
+		return;
+	}
+
+	for (std::size_t i = 0; i < this->scenes.size(); ++i) {
+		for (std::size_t j = 0; j < this->scenes[i]->getNumModels(); ++j) {
+			rl::sg::Model* model = this->scenes[i]->getModel(j);
+
+			for (std::size_t k = 0; k < model->getNumBodies(); ++k) {
+				if (model->getBody(k)->getName() == placement->second.body_name) {
+					this->createShapes(model->getBody(k), placement->second.matrix, _child);
+				}
+			}
+		}
+	}
+}
+
+void AsyncSceneLoader::createShapes(rl::sg::Body* _body, const SbMatrix& _matrix, SoNode* _child) {
+	SoSearchAction search;
+	search.setType(SoVRMLShape::getClassTypeId());
+	search.setInterest(SoSearchAction::ALL);
+	search.setSearchingAll(TRUE);
+	search.apply(_child);
+
+	for (int i = 0; i < search.getPaths().getLength(); ++i) {
+		SoFullPath* path = static_cast<SoFullPath*>(search.getPaths()[i]);
+		SoVRMLShape* vrml_shape = static_cast<SoVRMLShape*>(path->getTail());
+
+		// reduced levels of detail are skipped, the full resolution level stands for its SoVRMLLOD
+		SoVRMLLOD* lod = NULL;
+		bool reduced_flag = false;
+		for (int j = 0; j + 1 < path->getLength(); ++j) {
+			if (path->getNode(j)->isOfType(SoVRMLLOD::getClassTypeId()) == TRUE) {
+				if (path->getIndex(j + 1) != 0) {
+					reduced_flag = true;
+				} else if (j + 2 == path->getLength()) {
+					lod = static_cast<SoVRMLLOD*>(path->getNode(j));
+				}
+			}
+		}
+
+		if (reduced_flag == true) {
+			continue;
+		}
+
+		// row vectors, the shape transform within the file comes first
+		SbMatrix matrix = getPathMatrix(path);
+		matrix.multRight(_matrix);
+
+		rl::math::Transform transform;
+		transform.setIdentity();
+		for (int j = 0; j < 4; ++j) {
+			for (int k = 0; k < 4; ++k) {
+				transform.matrix()(j, k) = matrix[k][j];
+			}
+		}
+
+		rl::sg::Shape* shape = _body->create(vrml_shape);
+		shape->setTransform(transform);
+
+		// the viewer keeps switching between the levels
+		rl::sg::so::Shape* so_shape = dynamic_cast<rl::sg::so::Shape*>(shape);
+		if (so_shape != NULL && lod != NULL) {
+			int index = so_shape->root->findChild(vrml_shape);
+			if (index >= 0) {
+				so_shape->root->replaceChild(index, lod);
+			}
+		}
+	}
+}
+
+void AsyncSceneLoader::run() {
+	while (true) {
+		AsyncSceneLoader::Request request;
+
+		{
+			std::unique_lock<std::mutex> locker(this->mutex);
+			this->condition.wait(locker, [this]() { return this->stopping == true || this->pending.empty() == false; });
+
+			if (this->pending.empty() == true) {
+				return;
+			}
+
+			request = this->pending.front();
+			this->pending.pop_front();
+		}
+
+		request.child = MeshCache::read(request.file_name);
+
+		if (request.child != NULL) {
+			request.child->ref();
+
+			if (this->prepare) {
+				this->prepare(request.child);
+			}
+		}
+
+		std::lock_guard<std::mutex> locker(this->mutex);
+		this->finished.push_back(request);
+	}
+}
+
+}
@@ -0,0 +1,97 @@
+#ifndef VM_ASYNC_SCENE_LOADER_H
+#define VM_ASYNC_SCENE_LOADER_H
+
+#include <Inventor/SbMatrix.h>
+#include <Inventor/SbString.h>
+#include <Inventor/nodes/SoNode.h>
+#include <Inventor/VRMLnodes/SoVRMLInline.h>
+#include <rl/sg/Body.h>
+#include <rl/sg/Scene.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace vm {
+
+// Defers the inline geometry files of a scene (the link meshes of the rlsg examples) to worker threads.
+// While install()ed, Scene::load() reads the scene structure synchronously, i.e. every file with DEF'd nodes or
+// nested inlines (robot.wrl, environment.wrl) and every file inlined by the top level file, so the scene gets all
+// its models and bodies. Only leaf geometry files below a structural file are left empty, the workers read them
+// (through the mesh cache) in parallel and poll(), called on the GUI thread, attaches every finished file to its
+// inline node and creates its shapes in the body of every added scene that owns the inline, the way Scene::load()
+// would have. Requires a thread safe Coin build.
+class AsyncSceneLoader {
+public:
+	typedef std::function<void(SoNode*)> PrepareFunction;
+
+	AsyncSceneLoader();
+	virtual ~AsyncSceneLoader();
+
+	// 0 threads selects the hardware concurrency
+	void install(std::size_t _number_of_threads);
+	void uninstall();
+
+	// scenes that get the shapes of the deferred files, add them before they are loaded
+	void addScene(rl::sg::Scene* _scene);
+
+	// attaches finished files to the scene graph, returns the number of attached files
+	std::size_t poll();
+
+	bool isFinished();
+
+	std::size_t getNumberOfRequests();
+	std::size_t getNumberOfAttached() const;
+
+	// runs on the worker thread for every deferred file before it is attached, e.g. to generate levels of detail,
+	// only the full resolution level of an SoVRMLLOD becomes a shape of the scenes
+	AsyncSceneLoader::PrepareFunction prepare;
+
+private:
+	struct Request {
+		SoVRMLInline* node;
+		std::string file_name;
+		SoNode* child;
+	};
+
+	// body of a deferred inline, named after its nearest DEF'd SoVRMLTransform, and the transform from body to inline
+	struct Placement {
+		std::string body_name;
+		SbMatrix matrix;
+	};
+
+	static void fetchUrl(const SbString& _url, void* _closure, SoVRMLInline* _node);
+
+	void loadStructure(const std::string& _file_name, SoVRMLInline* _node);
+	void place(SoNode* _root);
+	void createShapes(SoVRMLInline* _node, SoNode* _child);
+	void createShapes(rl::sg::Body* _body, const SbMatrix& _matrix, SoNode* _child);
+
+	void run();
+
+	std::vector<rl::sg::Scene*> scenes;
+
+	// only used on the thread of Scene::load() and poll()
+	std::map<SoVRMLInline*, AsyncSceneLoader::Placement> placements;
+	std::size_t structure_depth;
+
+	std::vector<std::thread> threads;
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::deque<AsyncSceneLoader::Request> pending;
+	std::deque<AsyncSceneLoader::Request> finished;
+	std::size_t number_of_requests;
+	bool stopping;
+
+	std::size_t number_of_attached;
+};
+
+}
+
+#endif /* VM_ASYNC_SCENE_LOADER_H */
@@ -0,0 +1,26 @@
+#ifndef VM_BODY_FRAMES_H
+#define VM_BODY_FRAMES_H
+
+#include <rl/math/Vector.h>
+#include <rl/mdl/Kinematic.h>
+#include <rl/sg/Body.h>
+#include <rl/sg/Model.h>
+
+#include <algorithm>
+
+namespace vm {
+
+// moves the bodies of _model to the configuration _q (radians) of _kinematic, bodies without a counterpart stay
+inline void setBodyFrames(rl::mdl::Kinematic* _kinematic, rl::sg::Model* _model, const rl::math::Vector& _q) {
+	_kinematic->setPosition(_q);
+	_kinematic->forwardPosition();
+
+	std::size_t number_of_bodies = std::min(_kinematic->getBodies(), _model->getNumBodies());
+	for (std::size_t i = 0; i < number_of_bodies; ++i) {
+		_model->getBody(i)->setFrame(_kinematic->getBodyFrame(i));
+	}
+}
+
+}
+
+#endif /* VM_BODY_FRAMES_H */
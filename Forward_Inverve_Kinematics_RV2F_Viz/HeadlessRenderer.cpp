@@ -0,0 +1,120 @@
+#include "HeadlessRenderer.h"
+
+#include <Inventor/nodes/SoDirectionalLight.h>
+
+#include <algorithm>
+#include <numeric>
+
+#include "BodyFrames.h"
+
+namespace vm {
+
+HeadlessRenderer::HeadlessRenderer(SoNode* _scene_root, rl::mdl::Kinematic* _kinematic, rl::sg::Model* _model, short _width, short _height) :
+	viewport(_width, _height),
+	renderer(viewport)
+{
+	this->kinematic = _kinematic;
+	this->model = _model;
+	this->max_pending_writes = 8;
+	this->write_error_flag = false;
+
+	// same headlight setup as the examiner viewer
+	this->root = new SoSeparator();
+	this->root->ref();
+
+	this->camera = new SoPerspectiveCamera();
+	this->root->addChild(this->camera);
+	this->root->addChild(new SoDirectionalLight());
+	this->root->addChild(_scene_root);
+
+	this->camera->viewAll(this->root, this->viewport);
+
+	this->renderer.setBackgroundColor(SbColor(0, 0, 0));
+	this->renderer.setComponents(SoOffscreenRenderer::RGB);
+}
+
+HeadlessRenderer::~HeadlessRenderer() {
+	this->waitForWrites();
+	this->root->unref();
+}
+
+bool HeadlessRenderer::render(const rl::math::Vector& _q) {
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	setBodyFrames(this->kinematic, this->model, _q);
+
+	bool result = this->renderer.render(this->root) == TRUE;
+
+	this->frame_times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+	return result;
+}
+
+QImage HeadlessRenderer::getImage() const {
+	SbVec2s size = this->viewport.getViewportSizePixels();
+
+	// GL rows start at the bottom, the copy made by mirrored() also detaches from the renderer buffer
+	QImage image(this->renderer.getBuffer(), size[0], size[1], size[0] * 3, QImage::Format_RGB888);
+	return image.mirrored();
+}
+
+bool HeadlessRenderer::renderToFile(const rl::math::Vector& _q, const QString& _file_name) {
+	if (this->render(_q) == false) {
+		return false;
+	}
+
+	while (this->pending_writes.size() >= std::max<std::size_t>(this->max_pending_writes, 1)) {
+		this->write_error_flag = (this->pending_writes.front().get() == false) || this->write_error_flag;
+		this->pending_writes.pop_front();
+	}
+
+	QImage image = this->getImage();
+	this->pending_writes.push_back(std::async(std::launch::async, [image, _file_name]() {
+		return image.save(_file_name);
+	}));
+
+	return true;
+}
+
+bool HeadlessRenderer::waitForWrites() {
+	while (this->pending_writes.empty() == false) {
+		this->write_error_flag = (this->pending_writes.front().get() == false) || this->write_error_flag;
+		this->pending_writes.pop_front();
+	}
+
+	bool result = (this->write_error_flag == false);
+	this->write_error_flag = false;
+
+	return result;
+}
+
+HeadlessRenderer::Statistics HeadlessRenderer::getStatistics() const {
+	HeadlessRenderer::Statistics statistics;
+	statistics.number_of_frames = this->frame_times.size();
+	statistics.min = 0;
+	statistics.mean = 0;
+	statistics.median = 0;
+	statistics.percentile95 = 0;
+	statistics.max = 0;
+
+	if (this->frame_times.empty() == true) {
+		return statistics;
+	}
+
+	std::vector<double> sorted(this->frame_times);
+	std::sort(sorted.begin(), sorted.end());
+
+	statistics.min = sorted.front();
+	statistics.mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
+	statistics.median = sorted[sorted.size() / 2];
+	statistics.percentile95 = sorted[std::min(sorted.size() - 1, sorted.size() * 95 / 100)];
+	statistics.max = sorted.back();
+
+	return statistics;
+}
+
+void HeadlessRenderer::resetStatistics() {
+	this->frame_times.clear();
+}
+
+}
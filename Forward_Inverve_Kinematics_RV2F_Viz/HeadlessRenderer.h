@@ -0,0 +1,70 @@
+#ifndef VM_HEADLESS_RENDERER_H
+#define VM_HEADLESS_RENDERER_H
+
+#include <Inventor/SbViewportRegion.h>
+#include <Inventor/SoOffscreenRenderer.h>
+#include <Inventor/nodes/SoPerspectiveCamera.h>
+#include <Inventor/nodes/SoSeparator.h>
+#include <QImage>
+#include <QString>
+#include <rl/math/Vector.h>
+#include <rl/mdl/Kinematic.h>
+#include <rl/sg/Model.h>
+
+#include <chrono>
+#include <deque>
+#include <future>
+#include <vector>
+
+namespace vm {
+
+// Renders the scene without a window through an offscreen GL context (also with a software rasterizer such as Mesa
+// llvmpipe). The camera is fitted once to the initial scene, images are encoded and written by background tasks
+// so that the GL thread only renders. Frame times of render() are kept for benchmarking.
+class HeadlessRenderer {
+public:
+	struct Statistics {
+		std::size_t number_of_frames;
+		double min;
+		double mean;
+		double median;
+		double percentile95;
+		double max;
+	};
+
+	HeadlessRenderer(SoNode* _scene_root, rl::mdl::Kinematic* _kinematic, rl::sg::Model* _model, short _width, short _height);
+	virtual ~HeadlessRenderer();
+
+	// moves the bodies to _q (radians) and renders one frame
+	bool render(const rl::math::Vector& _q);
+
+	QImage getImage() const;
+
+	// renders and queues the image for writing, waits only if max_pending_writes images are still being written
+	bool renderToFile(const rl::math::Vector& _q, const QString& _file_name);
+	// returns false if any image could not be written
+	bool waitForWrites();
+
+	HeadlessRenderer::Statistics getStatistics() const;
+	void resetStatistics();
+
+	std::size_t max_pending_writes;
+
+private:
+	SoSeparator* root;
+	SoPerspectiveCamera* camera;
+	SbViewportRegion viewport;
+	SoOffscreenRenderer renderer;
+
+	rl::mdl::Kinematic* kinematic;
+	rl::sg::Model* model;
+
+	std::deque<std::future<bool> > pending_writes;
+	bool write_error_flag;
+
+	std::vector<double> frame_times;
+};
+
+}
+
+#endif /* VM_HEADLESS_RENDERER_H */
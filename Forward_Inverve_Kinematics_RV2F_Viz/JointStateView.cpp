@@ -0,0 +1,52 @@
+#include "JointStateView.h"
+
+#include <rl/math/Unit.h>
+
+#include "BodyFrames.h"
+
+namespace vm {
+
+JointStateView::JointStateView(TripleBuffer<JointState>* _buffer, rl::mdl::Kinematic* _kinematic, rl::sg::Model* _model) {
+	this->buffer = _buffer;
+	this->kinematic = _kinematic;
+	this->model = _model;
+	this->angle_scale = rl::math::DEG2RAD;
+	this->number_of_dropped_states = 0;
+}
+
+JointStateView::~JointStateView() {
+}
+
+bool JointStateView::update() {
+	if (this->buffer->update() == false) {
+		return false;
+	}
+
+	const JointState& joint_state = this->buffer->getFrontBuffer();
+
+	if (this->joint_state.sequence != 0 && joint_state.sequence > this->joint_state.sequence + 1) {
+		this->number_of_dropped_states += joint_state.sequence - this->joint_state.sequence - 1;
+	}
+
+	this->joint_state = joint_state;
+
+	// joints beyond the eight of JointState stay at zero
+	rl::math::Vector q = rl::math::Vector::Zero(this->kinematic->getDof());
+	for (std::size_t i = 0; i < this->kinematic->getDof() && i < 8; ++i) {
+		q(i) = this->joint_state.angles[i] * this->angle_scale;
+	}
+
+	setBodyFrames(this->kinematic, this->model, q);
+
+	return true;
+}
+
+const JointState& JointStateView::getJointState() const {
+	return this->joint_state;
+}
+
+unsigned long long JointStateView::getNumberOfDroppedStates() const {
+	return this->number_of_dropped_states;
+}
+
+}
@@ -0,0 +1,41 @@
+#ifndef VM_JOINT_STATE_VIEW_H
+#define VM_JOINT_STATE_VIEW_H
+
+#include <rl/mdl/Kinematic.h>
+#include <rl/sg/Model.h>
+
+#include "JointState.h"
+#include "TripleBuffer.h"
+
+namespace vm {
+
+// Consumer side of the live joint state feed: takes the latest state from the triple buffer at the frame rate of
+// the viewer, runs forward kinematics and moves the bodies of the scene graph model. Never blocks the producer.
+class JointStateView {
+public:
+	JointStateView(TripleBuffer<JointState>* _buffer, rl::mdl::Kinematic* _kinematic, rl::sg::Model* _model);
+	virtual ~JointStateView();
+
+	// returns true if a new state was applied
+	bool update();
+
+	const JointState& getJointState() const;
+
+	// states skipped because the producer was faster than the view
+	unsigned long long getNumberOfDroppedStates() const;
+
+	// conversion from JointState angles to radians, the default assumes degrees
+	double angle_scale;
+
+private:
+	TripleBuffer<JointState>* buffer;
+	rl::mdl::Kinematic* kinematic;
+	rl::sg::Model* model;
+
+	JointState joint_state;
+	unsigned long long number_of_dropped_states;
+};
+
+}
+
+#endif /* VM_JOINT_STATE_VIEW_H */
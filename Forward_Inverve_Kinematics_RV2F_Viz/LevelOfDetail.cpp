@@ -0,0 +1,249 @@
+#include "LevelOfDetail.h"
+
+#include <Inventor/SbBox3f.h>
+#include <Inventor/SoPath.h>
+#include <Inventor/SoPrimitiveVertex.h>
+#include <Inventor/actions/SoCallbackAction.h>
+#include <Inventor/actions/SoSearchAction.h>
+#include <Inventor/lists/SoPathList.h>
+#include <Inventor/nodes/SoGroup.h>
+#include <Inventor/nodes/SoShape.h>
+#include <Inventor/VRMLnodes/SoVRMLCoordinate.h>
+#include <Inventor/VRMLnodes/SoVRMLIndexedFaceSet.h>
+#include <Inventor/VRMLnodes/SoVRMLLOD.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <set>
+
+namespace vm {
+
+namespace {
+
+void collectTriangle(void* _data, SoCallbackAction* _action, const SoPrimitiveVertex* _v1, const SoPrimitiveVertex* _v2, const SoPrimitiveVertex* _v3) {
+	std::vector<SbVec3f>* points = static_cast<std::vector<SbVec3f>*>(_data);
+	points->push_back(_v1->getPoint());
+	points->push_back(_v2->getPoint());
+	points->push_back(_v3->getPoint());
+}
+
+}
+
+LevelOfDetail::LevelOfDetail() {
+	this->cells.push_back(32);
+	this->cells.push_back(8);
+	this->ranges.push_back(8);
+	this->ranges.push_back(24);
+	this->min_triangles = 200;
+}
+
+LevelOfDetail::~LevelOfDetail() {
+}
+
+std::size_t LevelOfDetail::apply(SoNode* _root) {
+	this->number_of_triangles.assign(this->cells.size() + 1, 0);
+
+	SoSearchAction search;
+	search.setType(SoVRMLShape::getClassTypeId());
+	search.setInterest(SoSearchAction::ALL);
+	search.setSearchingAll(TRUE);
+	search.apply(_root);
+
+	// parents and indices are collected first, replacing children would truncate the remaining paths
+	std::vector<SoGroup*> parents;
+	std::vector<int> indices;
+	std::vector<SoVRMLShape*> shapes;
+
+	const SoPathList& paths = search.getPaths();
+
+	for (int i = 0; i < paths.getLength(); ++i) {
+		SoPath* path = paths[i];
+		if (path->getLength() < 2 || path->getNodeFromTail(1)->isOfType(SoGroup::getClassTypeId()) == false) {
+			continue;
+		}
+
+		parents.push_back(static_cast<SoGroup*>(path->getNodeFromTail(1)));
+		indices.push_back(path->getIndexFromTail(0));
+		shapes.push_back(static_cast<SoVRMLShape*>(path->getTail()));
+
+		parents.back()->ref();
+		shapes.back()->ref();
+	}
+
+	std::size_t number_of_shapes = 0;
+
+	// the same shape may be instanced more than once, every instance gets the same LOD node
+	std::map<SoVRMLShape*, SoVRMLLOD*> replacements;
+
+	for (std::size_t i = 0; i < shapes.size(); ++i) {
+		SoVRMLShape* shape = shapes[i];
+
+		std::map<SoVRMLShape*, SoVRMLLOD*>::iterator found = replacements.find(shape);
+		if (found == replacements.end()) {
+			found = replacements.insert(std::make_pair(shape, this->createLod(shape))).first;
+		}
+
+		if (found->second != NULL) {
+			parents[i]->replaceChild(indices[i], found->second);
+			++number_of_shapes;
+		}
+	}
+
+	for (std::size_t i = 0; i < shapes.size(); ++i) {
+		shapes[i]->unref();
+		parents[i]->unref();
+	}
+
+	return number_of_shapes;
+}
+
+SoVRMLLOD* LevelOfDetail::createLod(SoVRMLShape* _shape) {
+	std::vector<SbVec3f> points;
+	SoCallbackAction action;
+	action.addTriangleCallback(SoShape::getClassTypeId(), collectTriangle, &points);
+	action.apply(_shape);
+
+	std::size_t triangles = points.size() / 3;
+	this->number_of_triangles[0] += triangles;
+
+	if (triangles < this->min_triangles) {
+		return NULL;
+	}
+
+	SbBox3f box;
+	for (std::size_t i = 0; i < points.size(); ++i) {
+		box.extendBy(points[i]);
+	}
+
+	float radius = (box.getMax() - box.getMin()).length() / 2;
+
+	SoVRMLLOD* lod = new SoVRMLLOD();
+	lod->center = box.getCenter();
+	lod->addLevel(_shape);
+
+	for (std::size_t i = 0; i < this->cells.size() && i < this->ranges.size(); ++i) {
+		std::size_t reduced_triangles = 0;
+		SoVRMLShape* reduced = LevelOfDetail::simplify(_shape, this->cells[i], reduced_triangles);
+		if (reduced == NULL) {
+			break;
+		}
+
+		lod->range.set1Value(static_cast<int>(i), this->ranges[i] * radius);
+		lod->addLevel(reduced);
+		this->number_of_triangles[i + 1] += reduced_triangles;
+	}
+
+	return lod;
+}
+
+SoVRMLShape* LevelOfDetail::simplify(SoVRMLShape* _shape, std::size_t _cells, std::size_t& _triangles) {
+	std::vector<SbVec3f> points;
+	SoCallbackAction action;
+	action.addTriangleCallback(SoShape::getClassTypeId(), collectTriangle, &points);
+	action.apply(_shape);
+
+	_triangles = 0;
+
+	if (points.empty() == true) {
+		return NULL;
+	}
+
+	SbBox3f box;
+	for (std::size_t i = 0; i < points.size(); ++i) {
+		box.extendBy(points[i]);
+	}
+
+	float dx;
+	float dy;
+	float dz;
+	box.getSize(dx, dy, dz);
+	float cell_size = std::max(std::max(dx, dy), dz) / std::max<std::size_t>(_cells, 1);
+	if (cell_size <= 0) {
+		return NULL;
+	}
+
+	// every vertex is moved to the mean of its grid cell
+	std::map<std::array<int, 3>, int32_t> cell_indices;
+	std::vector<SbVec3f> sums;
+	std::vector<int> counts;
+	std::vector<int32_t> vertex_cells(points.size());
+
+	for (std::size_t i = 0; i < points.size(); ++i) {
+		SbVec3f offset = points[i] - box.getMin();
+		std::array<int, 3> cell = {{
+			static_cast<int>(std::floor(offset[0] / cell_size)),
+			static_cast<int>(std::floor(offset[1] / cell_size)),
+			static_cast<int>(std::floor(offset[2] / cell_size))
+		}};
+
+		std::map<std::array<int, 3>, int32_t>::iterator found = cell_indices.find(cell);
+		if (found == cell_indices.end()) {
+			found = cell_indices.insert(std::make_pair(cell, static_cast<int32_t>(sums.size()))).first;
+			sums.push_back(SbVec3f(0, 0, 0));
+			counts.push_back(0);
+		}
+
+		sums[found->second] += points[i];
+		++counts[found->second];
+		vertex_cells[i] = found->second;
+	}
+
+	// triangles collapsed into a cell edge or point are dropped, as are duplicates of the same cell triple
+	std::set<std::array<int32_t, 3> > faces;
+	SoVRMLIndexedFaceSet* face_set = new SoVRMLIndexedFaceSet();
+	int number_of_indices = 0;
+
+	for (std::size_t i = 0; i < points.size(); i += 3) {
+		int32_t a = vertex_cells[i];
+		int32_t b = vertex_cells[i + 1];
+		int32_t c = vertex_cells[i + 2];
+		if (a == b || b == c || c == a) {
+			continue;
+		}
+
+		std::array<int32_t, 3> face = {{ a, b, c }};
+		std::rotate(face.begin(), std::min_element(face.begin(), face.end()), face.end());
+		if (faces.insert(face).second == false) {
+			continue;
+		}
+
+		face_set->coordIndex.set1Value(number_of_indices++, a);
+		face_set->coordIndex.set1Value(number_of_indices++, b);
+		face_set->coordIndex.set1Value(number_of_indices++, c);
+		face_set->coordIndex.set1Value(number_of_indices++, -1);
+		++_triangles;
+	}
+
+	if (_triangles == 0) {
+		face_set->ref();
+		face_set->unref();
+		return NULL;
+	}
+
+	SoVRMLCoordinate* coordinate = new SoVRMLCoordinate();
+	coordinate->point.setNum(static_cast<int>(sums.size()));
+	SbVec3f* values = coordinate->point.startEditing();
+	for (std::size_t i = 0; i < sums.size(); ++i) {
+		values[i] = sums[i] / static_cast<float>(counts[i]);
+	}
+	coordinate->point.finishEditing();
+
+	// normals are generated by Coin, the crease angle keeps hard CAD edges
+	face_set->coord = coordinate;
+	face_set->creaseAngle = 0.5f;
+	face_set->solid = FALSE;
+
+	SoVRMLShape* shape = new SoVRMLShape();
+	shape->appearance = _shape->appearance.getValue();
+	shape->geometry = face_set;
+
+	return shape;
+}
+
+std::size_t LevelOfDetail::getNumberOfTriangles(std::size_t _level) const {
+	return _level < this->number_of_triangles.size() ? this->number_of_triangles[_level] : 0;
+}
+
+}
@@ -0,0 +1,46 @@
+#ifndef VM_LEVEL_OF_DETAIL_H
+#define VM_LEVEL_OF_DETAIL_H
+
+#include <Inventor/nodes/SoNode.h>
+#include <Inventor/VRMLnodes/SoVRMLLOD.h>
+#include <Inventor/VRMLnodes/SoVRMLShape.h>
+
+#include <vector>
+
+namespace vm {
+
+// Generates reduced versions of the scene meshes by vertex clustering and replaces every shape with a distance
+// switched SoVRMLLOD node (full resolution first, then one level per entry of cells). Appearance nodes are shared
+// between the levels, only the geometry is duplicated.
+class LevelOfDetail {
+public:
+	LevelOfDetail();
+	virtual ~LevelOfDetail();
+
+	// returns the number of shapes that were replaced
+	std::size_t apply(SoNode* _root);
+
+	// returns NULL if the shape has no triangles, the new shape is not referenced
+	static SoVRMLShape* simplify(SoVRMLShape* _shape, std::size_t _cells, std::size_t& _triangles);
+
+	// clustering grid resolution along the largest extent of a shape, one entry per reduced level
+	std::vector<std::size_t> cells;
+
+	// switching distances in multiples of the shape bounding radius, one entry per reduced level
+	std::vector<float> ranges;
+
+	// shapes with fewer triangles are kept at full resolution
+	std::size_t min_triangles;
+
+	std::size_t getNumberOfTriangles(std::size_t _level) const;
+
+private:
+	// returns NULL for shapes below min_triangles
+	SoVRMLLOD* createLod(SoVRMLShape* _shape);
+
+	std::vector<std::size_t> number_of_triangles;
+};
+
+}
+
+#endif /* VM_LEVEL_OF_DETAIL_H */
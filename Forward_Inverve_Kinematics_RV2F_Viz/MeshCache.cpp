@@ -0,0 +1,428 @@
+#include "MeshCache.h"
+
+#include <Inventor/SbColor.h>
+#include <Inventor/SbMatrix.h>
+#include <Inventor/SoDB.h>
+#include <Inventor/SoInput.h>
+#include <Inventor/SoPrimitiveVertex.h>
+#include <Inventor/actions/SoCallbackAction.h>
+#include <Inventor/lists/SbStringList.h>
+#include <Inventor/nodes/SoShape.h>
+#include <Inventor/VRMLnodes/SoVRMLAppearance.h>
+#include <Inventor/VRMLnodes/SoVRMLCoordinate.h>
+#include <Inventor/VRMLnodes/SoVRMLGroup.h>
+#include <Inventor/VRMLnodes/SoVRMLIndexedFaceSet.h>
+#include <Inventor/VRMLnodes/SoVRMLMaterial.h>
+#include <Inventor/VRMLnodes/SoVRMLNormal.h>
+#include <Inventor/VRMLnodes/SoVRMLShape.h>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <vector>
+
+namespace vm {
+
+namespace {
+
+// file layout: Header, then per part PartHeader, float positions[3 * vertices], float normals[3 * vertices], int32 indices[indices]
+// indices already contain the -1 face separators, so they are copied into the face set unchanged
+struct Header {
+	char magic[4];
+	std::uint32_t version;
+	std::int64_t source_size;
+	std::int64_t source_time;
+	std::uint32_t number_of_parts;
+	std::uint32_t reserved;
+};
+
+struct PartHeader {
+	float diffuse[3];
+	float emissive[3];
+	float specular[3];
+	float shininess;
+	float transparency;
+	std::uint32_t number_of_vertices;
+	std::uint32_t number_of_indices;
+	std::uint32_t reserved;
+};
+
+const char MAGIC[4] = { 'V', 'M', 'M', 'C' };
+// version 1 also flattened structural files with their inlines
+const std::uint32_t VERSION = 2;
+
+struct Part {
+	PartHeader header;
+	std::vector<float> positions;
+	std::vector<float> normals;
+	std::vector<std::int32_t> indices;
+	std::map<std::array<float, 6>, std::int32_t> vertices;
+};
+
+struct Mesh {
+	std::vector<Part> parts;
+	std::map<const SoNode*, std::size_t> part_indices;
+};
+
+std::atomic<unsigned long> cache_hits(0);
+std::atomic<unsigned long> cache_misses(0);
+std::atomic<bool> write_flag(false);
+
+std::int32_t addVertex(Part& _part, const SbMatrix& _matrix, const SoPrimitiveVertex* _vertex) {
+	SbVec3f point;
+	_matrix.multVecMatrix(_vertex->getPoint(), point);
+	SbVec3f normal;
+	_matrix.multDirMatrix(_vertex->getNormal(), normal);
+	normal.normalize();
+
+	// identical position and normal share one index
+	std::array<float, 6> key = {{ point[0], point[1], point[2], normal[0], normal[1], normal[2] }};
+	std::map<std::array<float, 6>, std::int32_t>::iterator found = _part.vertices.find(key);
+	if (found != _part.vertices.end()) {
+		return found->second;
+	}
+
+	std::int32_t index = static_cast<std::int32_t>(_part.positions.size() / 3);
+	_part.positions.insert(_part.positions.end(), key.begin(), key.begin() + 3);
+	_part.normals.insert(_part.normals.end(), key.begin() + 3, key.end());
+	_part.vertices[key] = index;
+
+	return index;
+}
+
+void collectTriangle(void* _data, SoCallbackAction* _action, const SoPrimitiveVertex* _v1, const SoPrimitiveVertex* _v2, const SoPrimitiveVertex* _v3) {
+	Mesh* mesh = static_cast<Mesh*>(_data);
+	const SoNode* shape = _action->getCurPathTail();
+
+	std::map<const SoNode*, std::size_t>::iterator found = mesh->part_indices.find(shape);
+	if (found == mesh->part_indices.end()) {
+		Part part;
+		std::memset(&part.header, 0, sizeof(PartHeader));
+
+		SbColor ambient;
+		SbColor diffuse;
+		SbColor specular;
+		SbColor emission;
+		_action->getMaterial(ambient, diffuse, specular, emission, part.header.shininess, part.header.transparency, _v1->getMaterialIndex());
+
+		for (int i = 0; i < 3; ++i) {
+			part.header.diffuse[i] = diffuse[i];
+			part.header.emissive[i] = emission[i];
+			part.header.specular[i] = specular[i];
+		}
+
+		found = mesh->part_indices.insert(std::make_pair(shape, mesh->parts.size())).first;
+		mesh->parts.push_back(part);
+	}
+
+	Part& part = mesh->parts[found->second];
+	const SbMatrix& matrix = _action->getModelMatrix();
+
+	part.indices.push_back(addVertex(part, matrix, _v1));
+	part.indices.push_back(addVertex(part, matrix, _v2));
+	part.indices.push_back(addVertex(part, matrix, _v3));
+	part.indices.push_back(-1);
+}
+
+bool readSourceInfo(const std::string& _source_file_name, std::int64_t& _size, std::int64_t& _time) {
+	QFileInfo info(QString::fromStdString(_source_file_name));
+	if (info.exists() == false) {
+		return false;
+	}
+
+	_size = info.size();
+	_time = info.lastModified().toMSecsSinceEpoch();
+
+	return true;
+}
+
+bool isIdentifierCharacter(char _character) {
+	return (_character >= 'a' && _character <= 'z') || (_character >= 'A' && _character <= 'Z') || (_character >= '0' && _character <= '9') || _character == '_';
+}
+
+// nodes whose content is not stored in the cache or that make other nodes or files part of the scene
+bool isStructuralKeyword(const QByteArray& _word) {
+	return _word == "DEF" || _word == "Inline" || _word == "EXTERNPROTO" || _word.endsWith("Texture") == true;
+}
+
+SoNode* readVrml(const std::string& _file_name) {
+	SoInput input;
+	if (input.openFile(_file_name.c_str()) == false) {
+		return NULL;
+	}
+
+	SoNode* root = SoDB::readAllVRML(&input);
+	input.closeFile();
+
+	return root;
+}
+
+}
+
+std::string MeshCache::getCacheFileName(const std::string& _source_file_name) {
+	return _source_file_name + ".vmesh";
+}
+
+bool MeshCache::convert(const std::string& _source_file_name) {
+	return MeshCache::convert(_source_file_name, MeshCache::getCacheFileName(_source_file_name));
+}
+
+bool MeshCache::isGeometryFile(const std::string& _source_file_name) {
+	QFile file(QString::fromStdString(_source_file_name));
+	if (file.open(QIODevice::ReadOnly) == false) {
+		return false;
+	}
+
+	// gzip compressed or VRML 1.0 files are not scanned and never cached
+	QByteArray text = file.readAll();
+	if (text.startsWith("#VRML V2.0") == false) {
+		return false;
+	}
+
+	// comments and strings are skipped, a keyword anywhere else makes the file structural
+	for (int i = 0; i < text.size();) {
+		if (text[i] == '#') {
+			while (i < text.size() && text[i] != '\n') {
+				++i;
+			}
+		} else if (text[i] == '"') {
+			for (++i; i < text.size() && text[i] != '"'; ++i) {
+				if (text[i] == '\\') {
+					++i;
+				}
+			}
+			++i;
+		} else if (isIdentifierCharacter(text[i]) == true) {
+			int begin = i;
+			while (i < text.size() && isIdentifierCharacter(text[i]) == true) {
+				++i;
+			}
+
+			if (isStructuralKeyword(text.mid(begin, i - begin)) == true) {
+				return false;
+			}
+		} else {
+			++i;
+		}
+	}
+
+	return true;
+}
+
+bool MeshCache::convert(const std::string& _source_file_name, const std::string& _cache_file_name) {
+	if (MeshCache::isGeometryFile(_source_file_name) == false) {
+		return false;
+	}
+
+	Header header;
+	std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+	header.version = VERSION;
+	header.reserved = 0;
+
+	if (readSourceInfo(_source_file_name, header.source_size, header.source_time) == false) {
+		return false;
+	}
+
+	SoNode* root = readVrml(_source_file_name);
+	if (root == NULL) {
+		return false;
+	}
+
+	root->ref();
+
+	Mesh mesh;
+	SoCallbackAction action;
+	action.addTriangleCallback(SoShape::getClassTypeId(), collectTriangle, &mesh);
+	action.apply(root);
+
+	root->unref();
+
+	header.number_of_parts = static_cast<std::uint32_t>(mesh.parts.size());
+
+	QSaveFile file(QString::fromStdString(_cache_file_name));
+	if (file.open(QIODevice::WriteOnly) == false) {
+		return false;
+	}
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+
+	for (std::size_t i = 0; i < mesh.parts.size(); ++i) {
+		Part& part = mesh.parts[i];
+		part.header.number_of_vertices = static_cast<std::uint32_t>(part.positions.size() / 3);
+		part.header.number_of_indices = static_cast<std::uint32_t>(part.indices.size());
+
+		file.write(reinterpret_cast<const char*>(&part.header), sizeof(PartHeader));
+		file.write(reinterpret_cast<const char*>(part.positions.data()), part.positions.size() * sizeof(float));
+		file.write(reinterpret_cast<const char*>(part.normals.data()), part.normals.size() * sizeof(float));
+		file.write(reinterpret_cast<const char*>(part.indices.data()), part.indices.size() * sizeof(std::int32_t));
+	}
+
+	return file.commit();
+}
+
+bool MeshCache::isUpToDate(const std::string& _source_file_name) {
+	std::int64_t size;
+	std::int64_t time;
+	if (readSourceInfo(_source_file_name, size, time) == false) {
+		return false;
+	}
+
+	QFile file(QString::fromStdString(MeshCache::getCacheFileName(_source_file_name)));
+	if (file.open(QIODevice::ReadOnly) == false) {
+		return false;
+	}
+
+	Header header;
+	if (file.read(reinterpret_cast<char*>(&header), sizeof(Header)) != sizeof(Header)) {
+		return false;
+	}
+
+	return std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 && header.version == VERSION && header.source_size == size && header.source_time == time;
+}
+
+SoNode* MeshCache::load(const std::string& _cache_file_name) {
+	QFile file(QString::fromStdString(_cache_file_name));
+	if (file.open(QIODevice::ReadOnly) == false || file.size() < static_cast<qint64>(sizeof(Header))) {
+		return NULL;
+	}
+
+	const uchar* data = file.map(0, file.size());
+	if (data == NULL) {
+		return NULL;
+	}
+
+	const uchar* end = data + file.size();
+	const Header* header = reinterpret_cast<const Header*>(data);
+	if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0 || header->version != VERSION) {
+		return NULL;
+	}
+
+	SoVRMLGroup* root = new SoVRMLGroup();
+	root->ref();
+
+	const uchar* position = data + sizeof(Header);
+
+	for (std::uint32_t i = 0; i < header->number_of_parts; ++i) {
+		if (end - position < static_cast<std::ptrdiff_t>(sizeof(PartHeader))) {
+			root->unref();
+			return NULL;
+		}
+
+		const PartHeader* part = reinterpret_cast<const PartHeader*>(position);
+		position += sizeof(PartHeader);
+
+		std::size_t vertex_bytes = part->number_of_vertices * 3 * sizeof(float);
+		std::size_t index_bytes = part->number_of_indices * sizeof(std::int32_t);
+		if (static_cast<std::size_t>(end - position) < 2 * vertex_bytes + index_bytes) {
+			root->unref();
+			return NULL;
+		}
+
+		// the mapped arrays are copied into the fields as a whole, nothing is parsed
+		SoVRMLCoordinate* coordinate = new SoVRMLCoordinate();
+		coordinate->point.setValues(0, part->number_of_vertices, reinterpret_cast<const SbVec3f*>(position));
+		position += vertex_bytes;
+
+		SoVRMLNormal* normal = new SoVRMLNormal();
+		normal->vector.setValues(0, part->number_of_vertices, reinterpret_cast<const SbVec3f*>(position));
+		position += vertex_bytes;
+
+		SoVRMLIndexedFaceSet* face_set = new SoVRMLIndexedFaceSet();
+		face_set->coord = coordinate;
+		face_set->normal = normal;
+		face_set->normalPerVertex = TRUE;
+		face_set->solid = FALSE;
+		face_set->coordIndex.setValues(0, part->number_of_indices, reinterpret_cast<const int32_t*>(position));
+		position += index_bytes;
+
+		SoVRMLMaterial* material = new SoVRMLMaterial();
+		material->diffuseColor.setValue(part->diffuse);
+		material->emissiveColor.setValue(part->emissive);
+		material->specularColor.setValue(part->specular);
+		material->shininess = part->shininess;
+		material->transparency = part->transparency;
+
+		SoVRMLAppearance* appearance = new SoVRMLAppearance();
+		appearance->material = material;
+
+		SoVRMLShape* shape = new SoVRMLShape();
+		shape->appearance = appearance;
+		shape->geometry = face_set;
+
+		root->addChild(shape);
+	}
+
+	root->unrefNoDelete();
+
+	return root;
+}
+
+void MeshCache::setWriteFlag(bool _write_flag) {
+	write_flag = _write_flag;
+}
+
+void MeshCache::install(bool _write_flag) {
+	MeshCache::setWriteFlag(_write_flag);
+	SoVRMLInline::setFetchURLCallBack(MeshCache::fetchUrl, NULL);
+}
+
+void MeshCache::uninstall() {
+	SoVRMLInline::setFetchURLCallBack(NULL, NULL);
+}
+
+unsigned long MeshCache::getNumberOfCacheHits() {
+	return cache_hits;
+}
+
+unsigned long MeshCache::getNumberOfCacheMisses() {
+	return cache_misses;
+}
+
+std::string MeshCache::resolveUrl(const SbString& _url) {
+	// relative urls are resolved against the directories of the files currently being read
+	SbStringList sub_directories;
+	SbString full_name = SoInput::searchForFile(_url, SoInput::getDirectories(), sub_directories);
+	if (full_name.getLength() == 0) {
+		full_name = _url;
+	}
+
+	return full_name.getString();
+}
+
+SoNode* MeshCache::read(const std::string& _source_file_name) {
+	// convert() leaves structural files alone, they are read as VRML and their inlines come back through fetchUrl()
+	if (MeshCache::isUpToDate(_source_file_name) == false && write_flag == true) {
+		MeshCache::convert(_source_file_name);
+	}
+
+	SoNode* child = NULL;
+
+	if (MeshCache::isUpToDate(_source_file_name) == true) {
+		child = MeshCache::load(MeshCache::getCacheFileName(_source_file_name));
+	}
+
+	if (child != NULL) {
+		++cache_hits;
+	} else {
+		++cache_misses;
+		child = readVrml(_source_file_name);
+	}
+
+	return child;
+}
+
+void MeshCache::fetchUrl(const SbString& _url, void* _closure, SoVRMLInline* _node) {
+	SoNode* child = MeshCache::read(MeshCache::resolveUrl(_url));
+
+	if (child != NULL) {
+		_node->setChildData(child);
+	}
+}
+
+}
@@ -0,0 +1,59 @@
+#ifndef VM_MESH_CACHE_H
+#define VM_MESH_CACHE_H
+
+#include <Inventor/SbString.h>
+#include <Inventor/nodes/SoNode.h>
+#include <Inventor/VRMLnodes/SoVRMLInline.h>
+
+#include <string>
+
+namespace vm {
+
+// Binary cache for the VRML link geometry referenced by rlsg scenes.
+// convert() flattens a .wrl file into indexed triangle meshes (positions and normals in file coordinates, one part
+// per shape and material) and writes them next to the source as <file>.vmesh. install() hooks the inline loader of
+// Coin, so rl::sg::so::Scene::load() gets the meshes from the mapped cache file instead of parsing VRML whenever the
+// cache is up to date. The .wrl files stay the source of truth, stale or missing caches fall back to the VRML file.
+// Only leaf geometry files are cached. Files with named nodes (the DEF'd body transforms of robot.wrl or
+// environment.wrl), nested inlines or other referenced files are always read as VRML, so the scene keeps its bodies
+// and a cache never depends on a file other than its source.
+class MeshCache {
+public:
+	static std::string getCacheFileName(const std::string& _source_file_name);
+
+	// true for a VRML 2.0 file without DEF, Inline, EXTERNPROTO or texture nodes, decided by scanning the file text
+	static bool isGeometryFile(const std::string& _source_file_name);
+
+	// returns false if the source is no geometry file, could not be read or the cache could not be written
+	static bool convert(const std::string& _source_file_name);
+	static bool convert(const std::string& _source_file_name, const std::string& _cache_file_name);
+
+	// true if the cache exists and matches size and modification time of the source
+	static bool isUpToDate(const std::string& _source_file_name);
+
+	// returns NULL if the cache file is missing or invalid, the node is not referenced
+	static SoNode* load(const std::string& _cache_file_name);
+
+	// resolves an inline url while its parent file is being read
+	static std::string resolveUrl(const SbString& _url);
+
+	// reads the cache if it is up to date and falls back to the VRML file, NULL if neither can be read
+	static SoNode* read(const std::string& _source_file_name);
+
+	// converts missing or stale caches in read()
+	static void setWriteFlag(bool _write_flag);
+
+	// _write_flag converts missing or stale caches while loading
+	static void install(bool _write_flag);
+	static void uninstall();
+
+	static unsigned long getNumberOfCacheHits();
+	static unsigned long getNumberOfCacheMisses();
+
+private:
+	static void fetchUrl(const SbString& _url, void* _closure, SoVRMLInline* _node);
+};
+
+}
+
+#endif /* VM_MESH_CACHE_H */
@@ -0,0 +1,82 @@
+#include "TrajectoryPlayer.h"
+
+#include <rl/math/Unit.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "BodyFrames.h"
+
+namespace vm {
+
+TrajectoryPlayer::TrajectoryPlayer(TrajectoryLogReader* _reader, rl::mdl::Kinematic* _kinematic, rl::sg::Model* _model) {
+	this->reader = _reader;
+	this->kinematic = _kinematic;
+	this->model = _model;
+	this->time_scale = 1;
+	this->angle_scale = rl::math::DEG2RAD;
+	this->playing_flag = false;
+	this->time = _reader->getStartTime();
+	this->last_update = std::chrono::steady_clock::now();
+}
+
+TrajectoryPlayer::~TrajectoryPlayer() {
+}
+
+void TrajectoryPlayer::play() {
+	this->playing_flag = true;
+	this->last_update = std::chrono::steady_clock::now();
+}
+
+void TrajectoryPlayer::pause() {
+	this->playing_flag = false;
+}
+
+bool TrajectoryPlayer::isPlaying() const {
+	return this->playing_flag;
+}
+
+void TrajectoryPlayer::seek(std::int64_t _time) {
+	this->time = std::max(this->reader->getStartTime(), std::min(this->reader->getEndTime(), _time));
+	this->show();
+}
+
+std::int64_t TrajectoryPlayer::getTime() const {
+	return this->time;
+}
+
+bool TrajectoryPlayer::update() {
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	std::chrono::steady_clock::duration elapsed = now - this->last_update;
+	this->last_update = now;
+
+	if (this->playing_flag == false) {
+		return true;
+	}
+
+	std::int64_t step = static_cast<std::int64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count() * this->time_scale);
+	this->seek(this->time + step);
+
+	if ((this->time_scale >= 0 && this->time >= this->reader->getEndTime()) || (this->time_scale < 0 && this->time <= this->reader->getStartTime())) {
+		this->playing_flag = false;
+		return false;
+	}
+
+	return true;
+}
+
+void TrajectoryPlayer::show() {
+	std::vector<double> values(this->reader->getDof());
+	if (values.empty() == true || this->reader->interpolate(this->time, values.data()) == false) {
+		return;
+	}
+
+	rl::math::Vector q(this->kinematic->getDof());
+	for (std::size_t i = 0; i < this->kinematic->getDof(); ++i) {
+		q(i) = (i < values.size()) ? values[i] * this->angle_scale : 0;
+	}
+
+	setBodyFrames(this->kinematic, this->model, q);
+}
+
+}
@@ -0,0 +1,51 @@
+#ifndef VM_TRAJECTORY_PLAYER_H
+#define VM_TRAJECTORY_PLAYER_H
+
+#include <rl/mdl/Kinematic.h>
+#include <rl/sg/Model.h>
+
+#include <chrono>
+
+#include "TrajectoryLog.h"
+
+namespace vm {
+
+// Plays a trajectory log on the scene graph model. update() advances the playback time by the scaled wall clock time
+// since the last call, interpolates the joint values from the streamed log and moves the bodies by forward kinematics.
+class TrajectoryPlayer {
+public:
+	TrajectoryPlayer(TrajectoryLogReader* _reader, rl::mdl::Kinematic* _kinematic, rl::sg::Model* _model);
+	virtual ~TrajectoryPlayer();
+
+	void play();
+	void pause();
+	bool isPlaying() const;
+
+	// jumps to _time (microseconds of the log) and shows it, also while paused
+	void seek(std::int64_t _time);
+	std::int64_t getTime() const;
+
+	// returns false at the end of the log, playback stops there
+	bool update();
+
+	// playback speed, 1 is real time, negative values play backwards
+	double time_scale;
+
+	// conversion from log values to radians, the default assumes degrees
+	double angle_scale;
+
+private:
+	void show();
+
+	TrajectoryLogReader* reader;
+	rl::mdl::Kinematic* kinematic;
+	rl::sg::Model* model;
+
+	bool playing_flag;
+	std::int64_t time;
+	std::chrono::steady_clock::time_point last_update;
+};
+
+}
+
+#endif /* VM_TRAJECTORY_PLAYER_H */
@@ -1,23 +1,366 @@
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
 #include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <QDir>
+#include <QSlider>
+#include <QTimer>
 #include <QWidget>
 #include <Inventor/SoDB.h>
 #include <Inventor/Qt/SoQt.h>
 #include <Inventor/Qt/viewers/SoQtExaminerViewer.h>
+#include <rl/math/Unit.h>
+#include <rl/mdl/Kinematic.h>
+#include <rl/mdl/XmlFactory.h>
 #include <rl/sg/so/Scene.h>
 
+#include "AsyncSceneLoader.h"
+#include "HeadlessRenderer.h"
+#include "JointStateView.h"
+#include "LevelOfDetail.h"
+#include "MeshCache.h"
+#include "TrajectoryLog.h"
+#include "TrajectoryPlayer.h"
+
+static const char* SCENE_FILE = "C:\\RoboWrapSVN4_build\\VC14_32\\dependencies\\rl-0.7.0\\share\\rl-0.7.0\\examples\\rlsg\\mitsubishi_rv_2f_boxes.xml";
+static const char* KINEMATICS_FILE = "C:\\RoboWrapSVN4_build\\VC14_32\\dependencies\\rl-0.7.0\\share\\rl-0.7.0\\examples\\rlmdl\\mitsubishi-rv2f.xml";
+
+// offline conversion: myViewDemo convert link0.wrl link1.wrl ...
+static int
+convertMeshes(int argc, char** argv)
+{
+	for (int i = 2; i < argc; ++i)
+	{
+		bool converted = vm::MeshCache::convert(argv[i]);
+		std::cout << argv[i] << (converted ? " -> " + vm::MeshCache::getCacheFileName(argv[i]) : std::string(" failed")) << std::endl;
+	}
+	return 0;
+}
+
+// uniformly within the joint limits, in degrees
+static void
+sampleConfigurations(rl::mdl::Kinematic* _kinematic, std::size_t _number_of_configurations, std::vector<rl::math::Vector>& _configurations)
+{
+	std::mt19937 generator(0);
+	for (std::size_t i = 0; i < _number_of_configurations; ++i)
+	{
+		rl::math::Vector q(_kinematic->getDof());
+		for (std::size_t j = 0; j < _kinematic->getDof(); ++j)
+		{
+			std::uniform_real_distribution<rl::math::Real> distribution(_kinematic->getMinimum()(j), _kinematic->getMaximum()(j));
+			q(j) = distribution(generator) * rl::math::RAD2DEG;
+		}
+		_configurations.push_back(q);
+	}
+}
+
+// joint configurations in degrees, either one per line or sampled from a trajectory log at 30 Hz
+static void
+readConfigurations(const std::string& _input, rl::mdl::Kinematic* _kinematic, std::vector<rl::math::Vector>& _configurations)
+{
+	vm::TrajectoryLogReader reader;
+	if (reader.open(QString::fromStdString(_input)))
+	{
+		std::vector<double> values(reader.getDof());
+		for (std::int64_t t = reader.getStartTime(); t <= reader.getEndTime(); t += 1000000 / 30)
+		{
+			reader.interpolate(t, values.data());
+			rl::math::Vector q = rl::math::Vector::Zero(_kinematic->getDof());
+			for (std::size_t j = 0; j < _kinematic->getDof() && j < values.size(); ++j)
+			{
+				q(j) = values[j];
+			}
+			_configurations.push_back(q);
+		}
+		return;
+	}
+
+	std::ifstream file(_input.c_str());
+	std::string line;
+	while (std::getline(file, line))
+	{
+		std::istringstream stream(line);
+		rl::math::Vector q = rl::math::Vector::Zero(_kinematic->getDof());
+		std::size_t j = 0;
+		while (j < _kinematic->getDof() && stream >> q(j))
+		{
+			++j;
+		}
+		if (j > 0)
+		{
+			_configurations.push_back(q);
+		}
+	}
+}
+
+// headless: myViewDemo render configurations.txt|trajectory.vmt output_dir [width height]
+//           myViewDemo benchmark [frames]
+static int
+renderHeadless(int argc, char** argv)
+{
+	bool benchmark = std::string(argv[1]) == "benchmark";
+	short width = (!benchmark && argc > 5) ? static_cast<short>(std::stoi(argv[4])) : 640;
+	short height = (!benchmark && argc > 5) ? static_cast<short>(std::stoi(argv[5])) : 480;
+
+	if (!benchmark && argc <= 3)
+	{
+		std::cerr << "Usage: " << argv[0] << " render configurations.txt|trajectory.vmt output_dir [width height]" << std::endl;
+		return 1;
+	}
+
+	vm::MeshCache::install(true);
+	rl::sg::so::Scene scene;
+	scene.load(SCENE_FILE);
+	rl::mdl::XmlFactory factory;
+	rl::mdl::Kinematic* kinematic = dynamic_cast<rl::mdl::Kinematic*>(factory.create(KINEMATICS_FILE));
+
+	std::vector<rl::math::Vector> configurations;
+	if (benchmark)
+	{
+		sampleConfigurations(kinematic, (argc > 2) ? std::stoul(argv[2]) : 1000, configurations);
+	}
+	else
+	{
+		readConfigurations(argv[2], kinematic, configurations);
+	}
+
+	vm::HeadlessRenderer renderer(scene.root, kinematic, scene.getModel(0), width, height);
+	QDir output_directory(benchmark ? QString() : QString::fromStdString(argv[3]));
+	if (!benchmark)
+	{
+		output_directory.mkpath(".");
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < configurations.size(); ++i)
+	{
+		rl::math::Vector q = configurations[i] * rl::math::DEG2RAD;
+		if (benchmark)
+		{
+			renderer.render(q);
+		}
+		else
+		{
+			renderer.renderToFile(q, output_directory.filePath(QString("frame_%1.png").arg(i, 6, 10, QChar('0'))));
+		}
+	}
+	bool written = renderer.waitForWrites();
+	double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	vm::HeadlessRenderer::Statistics statistics = renderer.getStatistics();
+	std::cout << "Frames: " << statistics.number_of_frames
+		<< " total [s]: " << total
+		<< " throughput [1/s]: " << statistics.number_of_frames / total << std::endl
+		<< "Frame time [ms] min: " << statistics.min * 1000
+		<< " mean: " << statistics.mean * 1000
+		<< " median: " << statistics.median * 1000
+		<< " 95%: " << statistics.percentile95 * 1000
+		<< " max: " << statistics.max * 1000 << std::endl;
+
+	delete kinematic;
+	return written ? 0 : 1;
+}
+
+// live twin: a 1 kHz producer stands in for the robot thread (vm::Robot::getJointStateBuffer()),
+// the view picks up the latest state once per frame, every produced state is recorded to _trajectory_file if given
+static int
+runLive(rl::mdl::Kinematic* _kinematic, rl::sg::Model* _model, const std::string& _trajectory_file)
+{
+	vm::TripleBuffer<vm::JointState> joint_state_buffer;
+	vm::JointStateView joint_state_view(&joint_state_buffer, _kinematic, _model);
+
+	// 1e-4 degree resolution, blocks of one second
+	vm::TrajectoryLogWriter trajectory_writer;
+	if (!_trajectory_file.empty())
+	{
+		trajectory_writer.open(QString::fromStdString(_trajectory_file), 6, 1e-4, 1000);
+	}
+
+	std::atomic<bool> running(true);
+	std::thread producer([&joint_state_buffer, &running, &trajectory_writer]()
+	{
+		std::uint64_t sequence = 0;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		std::chrono::steady_clock::time_point next = start;
+		while (running)
+		{
+			double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			vm::JointState& joint_state = joint_state_buffer.getBackBuffer();
+			joint_state.sequence = ++sequence;
+			joint_state.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+			for (int i = 0; i < 6; ++i)
+			{
+				joint_state.angles[i] = 30 * std::sin(t * (0.5 + 0.1 * i));
+			}
+			if (trajectory_writer.isOpen())
+			{
+				trajectory_writer.append(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count(), joint_state.angles);
+			}
+			joint_state_buffer.publish();
+			next += std::chrono::milliseconds(1);
+			std::this_thread::sleep_until(next);
+		}
+	});
+
+	QTimer frame_timer;
+	QObject::connect(&frame_timer, &QTimer::timeout, [&joint_state_view]()
+	{
+		joint_state_view.update();
+	});
+	frame_timer.start(16);
+
+	SoQt::mainLoop();
+
+	running = false;
+	producer.join();
+	std::cout << "Dropped joint states: " << joint_state_view.getNumberOfDroppedStates() << std::endl;
+
+	if (trajectory_writer.isOpen())
+	{
+		std::cout << "Recorded samples: " << trajectory_writer.getNumberOfSamples() << std::endl;
+		trajectory_writer.close();
+	}
+
+	return 0;
+}
+
+// plays _trajectory_file, scrubbing with the slider pauses playback while it is held
+static int
+runPlayback(rl::mdl::Kinematic* _kinematic, rl::sg::Model* _model, const std::string& _trajectory_file, double _time_scale)
+{
+	vm::TrajectoryLogReader trajectory_reader;
+	if (!trajectory_reader.open(QString::fromStdString(_trajectory_file)))
+	{
+		std::cerr << "Could not open " << _trajectory_file << std::endl;
+		return 1;
+	}
+
+	std::cout << "Samples: " << trajectory_reader.getNumberOfSamples()
+		<< " duration [s]: " << (trajectory_reader.getEndTime() - trajectory_reader.getStartTime()) * 1e-6 << std::endl;
+
+	vm::TrajectoryPlayer trajectory_player(&trajectory_reader, _kinematic, _model);
+	trajectory_player.time_scale = _time_scale;
+	trajectory_player.seek(trajectory_reader.getStartTime());
+	trajectory_player.play();
+
+	QSlider slider(Qt::Horizontal);
+	slider.setRange(0, 10000);
+	slider.setWindowTitle("Trajectory");
+	slider.resize(800, 40);
+	slider.show();
+
+	std::int64_t start_time = trajectory_reader.getStartTime();
+	double time_per_step = (trajectory_reader.getEndTime() - start_time) / 10000.0;
+
+	QObject::connect(&slider, &QSlider::sliderPressed, [&trajectory_player]()
+	{
+		trajectory_player.pause();
+	});
+	QObject::connect(&slider, &QSlider::sliderMoved, [&trajectory_player, start_time, time_per_step](int _value)
+	{
+		trajectory_player.seek(start_time + static_cast<std::int64_t>(_value * time_per_step));
+	});
+	QObject::connect(&slider, &QSlider::sliderReleased, [&trajectory_player]()
+	{
+		trajectory_player.play();
+	});
+
+	QTimer frame_timer;
+	QObject::connect(&frame_timer, &QTimer::timeout, [&trajectory_player, &slider, start_time, time_per_step]()
+	{
+		trajectory_player.update();
+		if (!slider.isSliderDown() && time_per_step > 0)
+		{
+			slider.blockSignals(true);
+			slider.setValue(static_cast<int>((trajectory_player.getTime() - start_time) / time_per_step));
+			slider.blockSignals(false);
+		}
+	});
+	frame_timer.start(16);
+
+	SoQt::mainLoop();
+
+	return 0;
+}
+
 int
 main(int argc, char** argv)
 {
 	SoDB::init();
+
+	if (argc > 2 && std::string(argv[1]) == "convert")
+	{
+		return convertMeshes(argc, argv);
+	}
+
+	if (argc > 1 && (std::string(argv[1]) == "render" || std::string(argv[1]) == "benchmark"))
+	{
+		return renderHeadless(argc, argv);
+	}
+
+	std::string mode = (argc > 1) ? argv[1] : "";
+	// live [record.vmt] or play record.vmt [time scale]
+	std::string trajectory_file = (argc > 2) ? argv[2] : "";
+	double time_scale = (argc > 3) ? std::stod(argv[3]) : 1;
+
 	QWidget* widget = SoQt::init(argc, argv, argv[0]);
 	widget->resize(800, 600);
+
+	// link geometry is read and reduced in worker threads while the window is already up
+	std::atomic<std::size_t> number_of_lod_shapes(0);
+	vm::MeshCache::setWriteFlag(true);
+	vm::AsyncSceneLoader loader;
+	loader.prepare = [&number_of_lod_shapes](SoNode* _node)
+	{
+		vm::LevelOfDetail level_of_detail;
+		number_of_lod_shapes += level_of_detail.apply(_node);
+	};
 	rl::sg::so::Scene scene;
-	scene.load("C:\\RoboWrapSVN4_build\\VC14_32\\dependencies\\rl-0.7.0\\share\\rl-0.7.0\\examples\\rlsg\\mitsubishi_rv_2f_boxes.xml");
+	loader.addScene(&scene);
+	loader.install(0);
+	scene.load(SCENE_FILE);
 	SoQtExaminerViewer viewer(widget, NULL, true, SoQtFullViewer::BUILD_POPUP);
 	viewer.setSceneGraph(scene.root);
 	viewer.setTransparencyType(SoGLRenderAction::SORTED_OBJECT_BLEND);
 	viewer.show();
 	SoQt::show(widget);
-	SoQt::mainLoop();
-	return 0;
-}
\ No newline at end of file
+
+	QTimer timer;
+	QObject::connect(&timer, &QTimer::timeout, [&]()
+	{
+		if (loader.poll() > 0)
+		{
+			viewer.viewAll();
+		}
+
+		if (loader.isFinished())
+		{
+			timer.stop();
+			loader.uninstall();
+			std::cout << "Loaded files: " << loader.getNumberOfAttached()
+				<< " mesh cache hits: " << vm::MeshCache::getNumberOfCacheHits()
+				<< " misses: " << vm::MeshCache::getNumberOfCacheMisses()
+				<< " LOD shapes: " << number_of_lod_shapes << std::endl;
+		}
+	});
+	timer.start(20);
+
+	if (mode != "live" && mode != "play")
+	{
+		SoQt::mainLoop();
+		return 0;
+	}
+
+	rl::mdl::XmlFactory factory;
+	rl::mdl::Kinematic* kinematic = dynamic_cast<rl::mdl::Kinematic*>(factory.create(KINEMATICS_FILE));
+
+	int result = (mode == "live") ? runLive(kinematic, scene.getModel(0), trajectory_file) : runPlayback(kinematic, scene.getModel(0), trajectory_file, time_scale);
+
+	delete kinematic;
+	return result;
+}
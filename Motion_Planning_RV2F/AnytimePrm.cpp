@@ -0,0 +1,216 @@
+#include "AnytimePrm.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace vm {
+
+AnytimePrm::Progress::Progress() {
+	this->elapsed = std::chrono::steady_clock::duration::zero();
+	this->number_of_vertices = 0;
+	this->number_of_edges = 0;
+	this->total_queries = 0;
+	this->free_queries = 0;
+	this->solved = false;
+	this->path_length = std::numeric_limits<rl::math::Real>::infinity();
+}
+
+AnytimePrm::AnytimePrm() {
+	this->duration = std::chrono::seconds(60);
+	this->report_interval = std::chrono::seconds(1);
+	this->start = NULL;
+	this->goal = NULL;
+	this->model = NULL;
+	this->sampler = NULL;
+	this->verifier = NULL;
+	this->k = 0;
+	this->radius = std::numeric_limits<rl::math::Real>::max();
+	this->stop_on_first_solution = false;
+
+	this->reset();
+}
+
+AnytimePrm::~AnytimePrm() {
+}
+
+void AnytimePrm::reset() {
+	this->roadmap.reset();
+	this->begin = 0;
+	this->end = 0;
+	this->total_queries_offset = 0;
+	this->free_queries_offset = 0;
+	this->cancelled = false;
+
+	std::lock_guard<std::mutex> locker(this->progress_mutex);
+	this->progress = AnytimePrm::Progress();
+}
+
+bool AnytimePrm::solve() {
+	std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+	this->roadmap.reset();
+	this->total_queries_offset = this->model->getTotalQueries();
+	this->free_queries_offset = this->model->getFreeQueries();
+
+	{
+		std::lock_guard<std::mutex> locker(this->progress_mutex);
+		this->progress = AnytimePrm::Progress();
+	}
+
+	if (this->isColliding(*this->start) == true || this->isColliding(*this->goal) == true) {
+		this->publishProgress(std::chrono::steady_clock::now() - start_time);
+		return false;
+	}
+
+	this->begin = this->roadmap.addVertex(*this->start);
+	this->connect(this->begin);
+	this->end = this->roadmap.addVertex(*this->goal);
+	this->connect(this->end);
+
+	return this->expand(start_time, this->duration);
+}
+
+bool AnytimePrm::expand(std::chrono::steady_clock::time_point _start_time, std::chrono::steady_clock::duration _duration) {
+	std::chrono::steady_clock::time_point report_time = _start_time + this->report_interval;
+
+	bool solved = this->updatePath();
+
+	while (this->isCancelled() == false && (solved == false || this->stop_on_first_solution == false)) {
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (now - _start_time >= _duration) {
+			break;
+		}
+
+		if (now >= report_time) {
+			solved = this->updatePath();
+			this->publishProgress(now - _start_time);
+			report_time += this->report_interval;
+		}
+
+		rl::math::Vector q = this->sampler->generate();
+		if (this->isColliding(q) == true) {
+			continue;
+		}
+
+		std::size_t vertex = this->roadmap.addVertex(q);
+		this->connect(vertex);
+
+		// first solution is reported right away, later improvements with the next report
+		if (solved == false && this->roadmap.isConnected(this->begin, this->end) == true) {
+			solved = this->updatePath();
+			this->publishProgress(std::chrono::steady_clock::now() - _start_time);
+		}
+	}
+
+	solved = this->updatePath();
+	this->publishProgress(std::chrono::steady_clock::now() - _start_time);
+
+	return solved;
+}
+
+void AnytimePrm::cancel() {
+	this->cancelled = true;
+}
+
+bool AnytimePrm::isCancelled() const {
+	return this->cancelled;
+}
+
+rl::plan::VectorList AnytimePrm::getPath() const {
+	std::lock_guard<std::mutex> locker(this->progress_mutex);
+	return this->progress.path;
+}
+
+AnytimePrm::Progress AnytimePrm::getProgress() const {
+	std::lock_guard<std::mutex> locker(this->progress_mutex);
+	return this->progress;
+}
+
+const Roadmap& AnytimePrm::getRoadmap() const {
+	return this->roadmap;
+}
+
+bool AnytimePrm::isColliding(const rl::math::Vector& _q) {
+	this->model->setPosition(_q);
+	this->model->updateFrames();
+	return this->model->isColliding();
+}
+
+void AnytimePrm::connect(std::size_t _vertex) {
+	std::size_t k = this->k;
+	if (k == 0) {
+		rl::math::Real dof = static_cast<rl::math::Real>(this->model->getDof());
+		rl::math::Real n = static_cast<rl::math::Real>(this->roadmap.getNumberOfVertices());
+		k = static_cast<std::size_t>(std::ceil(std::exp(1.0) * (1 + 1 / dof) * std::log(std::max<rl::math::Real>(n, 2))));
+	}
+
+	const rl::math::Vector& q = this->roadmap.getConfiguration(_vertex);
+
+	std::vector<Roadmap::Neighbor> neighbors;
+	this->roadmap.findNearest(q, k + 1, this->radius, this->model, neighbors);
+
+	// neighbors of the same component are connected as well, the resulting cycles shorten the path over time
+	for (std::size_t i = 0; i < neighbors.size(); ++i) {
+		if (neighbors[i].second == _vertex) {
+			continue;
+		}
+
+		if (this->verifier->isColliding(q, this->roadmap.getConfiguration(neighbors[i].second), neighbors[i].first) == false) {
+			this->roadmap.addEdge(_vertex, neighbors[i].second, neighbors[i].first);
+		}
+	}
+}
+
+bool AnytimePrm::updatePath() {
+	if (this->roadmap.getNumberOfVertices() < 2) {
+		return false;
+	}
+
+	std::vector<std::size_t> vertices;
+	rl::math::Real length;
+	if (this->roadmap.findShortestPath(this->begin, this->end, vertices, length) == false) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> locker(this->progress_mutex);
+
+	if (this->progress.solved == false || length < this->progress.path_length) {
+		this->progress.solved = true;
+		this->progress.path_length = length;
+		this->progress.path.clear();
+
+		for (std::size_t i = 0; i < vertices.size(); ++i) {
+			this->progress.path.push_back(this->roadmap.getConfiguration(vertices[i]));
+		}
+	}
+
+	return true;
+}
+
+void AnytimePrm::clearPath() {
+	std::lock_guard<std::mutex> locker(this->progress_mutex);
+	this->progress.solved = false;
+	this->progress.path_length = std::numeric_limits<rl::math::Real>::infinity();
+	this->progress.path.clear();
+}
+
+void AnytimePrm::publishProgress(std::chrono::steady_clock::duration _elapsed) {
+	AnytimePrm::Progress progress;
+
+	{
+		std::lock_guard<std::mutex> locker(this->progress_mutex);
+		this->progress.elapsed = _elapsed;
+		this->progress.number_of_vertices = this->roadmap.getNumberOfVertices();
+		this->progress.number_of_edges = this->roadmap.getNumberOfEdges();
+		this->progress.total_queries = this->model->getTotalQueries() - this->total_queries_offset;
+		this->progress.free_queries = this->model->getFreeQueries() - this->free_queries_offset;
+		progress = this->progress;
+	}
+
+	if (this->progress_callback) {
+		this->progress_callback(progress);
+	}
+}
+
+}
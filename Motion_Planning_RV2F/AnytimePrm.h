@@ -0,0 +1,103 @@
+#ifndef VM_ANYTIME_PRM_H
+#define VM_ANYTIME_PRM_H
+
+#include <rl/math/Vector.h>
+#include <rl/plan/Sampler.h>
+#include <rl/plan/SimpleModel.h>
+#include <rl/plan/VectorList.h>
+#include <rl/plan/Verifier.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+
+#include "Roadmap.h"
+
+namespace vm {
+
+// Probabilistic roadmap planner that keeps growing the roadmap after the first solution and
+// reports the best path found so far, the roadmap size and the collision check counters at a fixed interval.
+// solve() returns when the duration has elapsed, the planner was cancelled or, optionally, the first path was found.
+class AnytimePrm {
+public:
+	struct Progress {
+		Progress();
+
+		std::chrono::steady_clock::duration elapsed;
+
+		std::size_t number_of_vertices;
+		std::size_t number_of_edges;
+
+		std::size_t total_queries;
+		std::size_t free_queries;
+
+		bool solved;
+		rl::math::Real path_length;
+		rl::plan::VectorList path;
+	};
+
+	typedef std::function<void(const AnytimePrm::Progress&)> ProgressCallback;
+
+	AnytimePrm();
+	virtual ~AnytimePrm();
+
+	void reset();
+	virtual bool solve();
+
+	// may be called from any thread, solve() returns with the best path found so far
+	void cancel();
+	bool isCancelled() const;
+
+	rl::plan::VectorList getPath() const;
+	AnytimePrm::Progress getProgress() const;
+
+	const Roadmap& getRoadmap() const;
+
+	std::chrono::steady_clock::duration duration;
+	std::chrono::steady_clock::duration report_interval;
+
+	// called from the planning thread every report_interval and once when solve() returns
+	AnytimePrm::ProgressCallback progress_callback;
+
+	rl::math::Vector* start;
+	rl::math::Vector* goal;
+
+	rl::plan::SimpleModel* model;
+	rl::plan::Sampler* sampler;
+	rl::plan::Verifier* verifier;
+
+	// number of nearest neighbors, 0 selects the PRM* bound k = e * (1 + 1 / dof) * log(n)
+	std::size_t k;
+	rl::math::Real radius;
+
+	bool stop_on_first_solution;
+
+protected:
+	// grows the existing roadmap until _duration has passed since _start_time
+	bool expand(std::chrono::steady_clock::time_point _start_time, std::chrono::steady_clock::duration _duration);
+
+	bool isColliding(const rl::math::Vector& _q);
+	void connect(std::size_t _vertex);
+	bool updatePath();
+	void clearPath();
+	void publishProgress(std::chrono::steady_clock::duration _elapsed);
+
+	Roadmap roadmap;
+
+	std::size_t begin;
+	std::size_t end;
+
+	std::size_t total_queries_offset;
+	std::size_t free_queries_offset;
+
+private:
+	std::atomic<bool> cancelled;
+
+	mutable std::mutex progress_mutex;
+	AnytimePrm::Progress progress;
+};
+
+}
+
+#endif /* VM_ANYTIME_PRM_H */
@@ -0,0 +1,297 @@
+#include "BatchCollisionChecker.h"
+
+#include <rl/math/Transform.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace vm {
+
+BatchCollisionChecker::BatchCollisionChecker(rl::mdl::Kinematic* _kinematic) {
+	this->kinematic = _kinematic;
+	this->batch_size = 256;
+	this->margin = 0;
+	this->exact_model = NULL;
+	this->octree_environment = NULL;
+
+	this->resetCounters();
+}
+
+BatchCollisionChecker::~BatchCollisionChecker() {
+}
+
+void BatchCollisionChecker::setRobotModel(rl::sg::Model* _model, std::size_t _depth, std::size_t _min_triangles_per_sphere) {
+	this->body_sphere_trees.clear();
+	this->body_sphere_trees.resize(_model->getNumBodies());
+
+	for (std::size_t i = 0; i < _model->getNumBodies(); ++i) {
+		this->body_sphere_trees[i].build(_model->getBody(i), _depth, _min_triangles_per_sphere);
+	}
+}
+
+void BatchCollisionChecker::setBodySphereTree(std::size_t _body_index, const SphereTree& _sphere_tree) {
+	if (_body_index >= this->body_sphere_trees.size()) {
+		this->body_sphere_trees.resize(_body_index + 1);
+	}
+
+	this->body_sphere_trees[_body_index] = _sphere_tree;
+}
+
+void BatchCollisionChecker::addEnvironmentModel(rl::sg::Model* _model, std::size_t _depth, std::size_t _min_triangles_per_sphere) {
+	for (std::size_t i = 0; i < _model->getNumBodies(); ++i) {
+		SphereTree sphere_tree;
+		sphere_tree.build(_model->getBody(i), _depth, _min_triangles_per_sphere);
+		if (sphere_tree.isEmpty() == true) {
+			continue;
+		}
+
+		rl::math::Transform frame;
+		_model->getBody(i)->getFrame(frame);
+
+		const std::vector<SphereTree::Sphere>& leaves = sphere_tree.getLeaves();
+		for (std::size_t j = 0; j < leaves.size(); ++j) {
+			SphereTree::Sphere sphere = leaves[j];
+			sphere.center = frame * sphere.center;
+			this->addEnvironmentSphere(sphere);
+		}
+	}
+}
+
+void BatchCollisionChecker::addEnvironmentSphere(const SphereTree::Sphere& _sphere) {
+	std::size_t size = this->environment_x.size();
+
+	this->environment_x.conservativeResize(size + 1);
+	this->environment_y.conservativeResize(size + 1);
+	this->environment_z.conservativeResize(size + 1);
+	this->environment_radius.conservativeResize(size + 1);
+
+	this->environment_x(size) = _sphere.center.x();
+	this->environment_y(size) = _sphere.center.y();
+	this->environment_z(size) = _sphere.center.z();
+	this->environment_radius(size) = _sphere.radius;
+}
+
+void BatchCollisionChecker::clearEnvironment() {
+	this->environment_x.resize(0);
+	this->environment_y.resize(0);
+	this->environment_z.resize(0);
+	this->environment_radius.resize(0);
+}
+
+std::size_t BatchCollisionChecker::getNumberOfEnvironmentSpheres() const {
+	return this->environment_x.size();
+}
+
+std::size_t BatchCollisionChecker::check(const std::vector<rl::math::Vector>& _configurations, std::vector<char>& _colliding) {
+	_colliding.assign(_configurations.size(), 0);
+	std::vector<char> octree_colliding(_configurations.size(), 0);
+
+	OctreeEnvironment::Snapshot snapshot;
+	if (this->octree_environment != NULL) {
+		snapshot = this->octree_environment->getSnapshot();
+	}
+
+	std::size_t batch_size = std::max<std::size_t>(this->batch_size, 1);
+	for (std::size_t begin = 0; begin < _configurations.size(); begin += batch_size) {
+		this->checkBatch(_configurations, begin, std::min(begin + batch_size, _configurations.size()), snapshot, _colliding, octree_colliding);
+	}
+
+	std::size_t number_of_collisions = 0;
+	for (std::size_t i = 0; i < _colliding.size(); ++i) {
+		if (_colliding[i] != 0 && this->exact_model != NULL) {
+			this->exact_model->setPosition(_configurations[i]);
+			this->exact_model->updateFrames();
+			_colliding[i] = this->exact_model->isColliding() ? 1 : 0;
+			++this->exact_test_counter;
+		}
+
+		if (octree_colliding[i] != 0) {
+			_colliding[i] = 1;
+		}
+
+		if (_colliding[i] != 0) {
+			++number_of_collisions;
+		}
+	}
+
+	return number_of_collisions;
+}
+
+bool BatchCollisionChecker::isColliding(const rl::math::Vector& _configuration) {
+	std::vector<rl::math::Vector> configurations(1, _configuration);
+	std::vector<char> colliding;
+
+	return this->check(configurations, colliding) > 0;
+}
+
+unsigned long long BatchCollisionChecker::getNumberOfSphereTests() const {
+	return this->sphere_test_counter;
+}
+
+unsigned long long BatchCollisionChecker::getNumberOfExactTests() const {
+	return this->exact_test_counter;
+}
+
+void BatchCollisionChecker::resetCounters() {
+	this->sphere_test_counter = 0;
+	this->exact_test_counter = 0;
+}
+
+void BatchCollisionChecker::checkBatch(const std::vector<rl::math::Vector>& _configurations, std::size_t _begin, std::size_t _end, const OctreeEnvironment::Snapshot& _snapshot, std::vector<char>& _colliding, std::vector<char>& _octree_colliding) {
+	std::size_t rows = _end - _begin;
+	std::size_t number_of_bodies = std::min(this->body_sphere_trees.size(), this->kinematic->getBodies());
+
+	if (this->environment_x.size() == 0 && !_snapshot) {
+		return;
+	}
+
+	this->center_x.resize(number_of_bodies);
+	this->center_y.resize(number_of_bodies);
+	this->center_z.resize(number_of_bodies);
+
+	for (std::size_t b = 0; b < number_of_bodies; ++b) {
+		const SphereTree& sphere_tree = this->body_sphere_trees[b];
+
+		this->center_x[b].resize(sphere_tree.getNumberOfLevels());
+		this->center_y[b].resize(sphere_tree.getNumberOfLevels());
+		this->center_z[b].resize(sphere_tree.getNumberOfLevels());
+
+		for (std::size_t l = 0; l < sphere_tree.getNumberOfLevels(); ++l) {
+			std::size_t columns = sphere_tree.getLevel(l).spheres.size();
+			this->center_x[b][l].resize(rows, columns);
+			this->center_y[b][l].resize(rows, columns);
+			this->center_z[b][l].resize(rows, columns);
+		}
+	}
+
+	// forward kinematics stays scalar, its result is scattered into the sphere columns
+	for (std::size_t r = 0; r < rows; ++r) {
+		this->kinematic->setPosition(_configurations[_begin + r]);
+		this->kinematic->forwardPosition();
+
+		for (std::size_t b = 0; b < number_of_bodies; ++b) {
+			const SphereTree& sphere_tree = this->body_sphere_trees[b];
+			const rl::math::Transform& frame = this->kinematic->getBodyFrame(b);
+
+			for (std::size_t l = 0; l < sphere_tree.getNumberOfLevels(); ++l) {
+				const std::vector<SphereTree::Sphere>& spheres = sphere_tree.getLevel(l).spheres;
+
+				for (std::size_t s = 0; s < spheres.size(); ++s) {
+					rl::math::Vector3 center = frame * spheres[s].center;
+					this->center_x[b][l](r, s) = center.x();
+					this->center_y[b][l](r, s) = center.y();
+					this->center_z[b][l](r, s) = center.z();
+				}
+			}
+		}
+	}
+
+	Eigen::Array<char, Eigen::Dynamic, 1> colliding = Eigen::Array<char, Eigen::Dynamic, 1>::Zero(rows);
+	RealArray clearance(rows);
+
+	for (std::size_t b = 0; b < number_of_bodies; ++b) {
+		const SphereTree& sphere_tree = this->body_sphere_trees[b];
+		if (sphere_tree.isEmpty() == true) {
+			continue;
+		}
+
+		// hit masks of the previous level, a sphere is only refined where its parent was hit
+		Eigen::Array<char, Eigen::Dynamic, Eigen::Dynamic> parent_hits = Eigen::Array<char, Eigen::Dynamic, Eigen::Dynamic>::Ones(rows, 1);
+
+		for (std::size_t l = 0; l < sphere_tree.getNumberOfLevels(); ++l) {
+			const SphereTree::Level& level = sphere_tree.getLevel(l);
+			Eigen::Array<char, Eigen::Dynamic, Eigen::Dynamic> hits = Eigen::Array<char, Eigen::Dynamic, Eigen::Dynamic>::Zero(rows, level.spheres.size());
+
+			for (std::size_t s = 0; s < level.spheres.size(); ++s) {
+				std::size_t parent = (l == 0) ? 0 : level.parents[s];
+				if ((parent_hits.col(parent) != 0).any() == false) {
+					continue;
+				}
+
+				this->testEnvironment(this->center_x[b][l], this->center_y[b][l], this->center_z[b][l], s, level.spheres[s].radius, clearance);
+				hits.col(s) = ((clearance < 0).cast<char>() * parent_hits.col(parent));
+			}
+
+			parent_hits.swap(hits);
+		}
+
+		colliding = colliding.max((parent_hits != 0).rowwise().any().cast<char>());
+	}
+
+	for (std::size_t r = 0; r < rows; ++r) {
+		_colliding[_begin + r] = colliding(r);
+	}
+
+	if (!_snapshot) {
+		return;
+	}
+
+	// octree queries are scalar, configurations already hit by the sphere environment are skipped
+	for (std::size_t r = 0; r < rows; ++r) {
+		if (colliding(r) != 0 && this->exact_model == NULL) {
+			continue;
+		}
+
+		for (std::size_t b = 0; b < number_of_bodies; ++b) {
+			if (this->testOctree(*_snapshot, b, r) == true) {
+				_octree_colliding[_begin + r] = 1;
+				break;
+			}
+		}
+	}
+}
+
+bool BatchCollisionChecker::testOctree(const OccupancyOctree& _octree, std::size_t _body, std::size_t _row) {
+	const SphereTree& sphere_tree = this->body_sphere_trees[_body];
+	if (sphere_tree.isEmpty() == true) {
+		return false;
+	}
+
+	std::vector<char> parent_hits(1, 1);
+
+	for (std::size_t l = 0; l < sphere_tree.getNumberOfLevels(); ++l) {
+		const SphereTree::Level& level = sphere_tree.getLevel(l);
+		std::vector<char> hits(level.spheres.size(), 0);
+		bool hit_flag = false;
+
+		for (std::size_t s = 0; s < level.spheres.size(); ++s) {
+			std::size_t parent = (l == 0) ? 0 : level.parents[s];
+			if (parent_hits[parent] == 0) {
+				continue;
+			}
+
+			rl::math::Vector3 center(this->center_x[_body][l](_row, s), this->center_y[_body][l](_row, s), this->center_z[_body][l](_row, s));
+			if (_octree.intersectsSphere(center, level.spheres[s].radius + this->margin) == true) {
+				hits[s] = 1;
+				hit_flag = true;
+			}
+		}
+
+		if (hit_flag == false) {
+			return false;
+		}
+
+		parent_hits.swap(hits);
+	}
+
+	return true;
+}
+
+void BatchCollisionChecker::testEnvironment(const RealArray2& _x, const RealArray2& _y, const RealArray2& _z, std::size_t _column, rl::math::Real _radius, RealArray& _clearance) {
+	_clearance.setConstant(std::numeric_limits<rl::math::Real>::max());
+
+	for (RealArray::Index e = 0; e < this->environment_x.size(); ++e) {
+		rl::math::Real distance = _radius + this->environment_radius(e) + this->margin;
+
+		_clearance = _clearance.min(
+			(_x.col(_column) - this->environment_x(e)).square() +
+			(_y.col(_column) - this->environment_y(e)).square() +
+			(_z.col(_column) - this->environment_z(e)).square() -
+			distance * distance
+		);
+	}
+
+	this->sphere_test_counter += _x.rows() * this->environment_x.size();
+}
+
+}
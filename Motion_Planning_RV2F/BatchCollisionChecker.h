@@ -0,0 +1,85 @@
+#ifndef VM_BATCH_COLLISION_CHECKER_H
+#define VM_BATCH_COLLISION_CHECKER_H
+
+#include <rl/math/Vector.h>
+#include <rl/mdl/Kinematic.h>
+#include <rl/plan/SimpleModel.h>
+#include <rl/sg/Model.h>
+
+#include <vector>
+
+#include "OctreeEnvironment.h"
+#include "SphereTree.h"
+
+namespace vm {
+
+// Tests many configurations at once against the environment using sphere tree proxies of the robot links.
+// Sphere centers of a batch are kept as structure of arrays (one column of configurations per sphere) so that
+// the distance tests against the environment spheres run as vectorized Eigen array expressions.
+// The sphere test is conservative, positives can optionally be confirmed with an exact collision model.
+// An optional occupancy octree is tested as well, every check() call works on one snapshot of it.
+class BatchCollisionChecker {
+public:
+	typedef Eigen::Array<rl::math::Real, Eigen::Dynamic, 1> RealArray;
+	typedef Eigen::Array<rl::math::Real, Eigen::Dynamic, Eigen::Dynamic> RealArray2;
+
+	BatchCollisionChecker(rl::mdl::Kinematic* _kinematic);
+	virtual ~BatchCollisionChecker();
+
+	// fits one sphere tree per body, body i of the scene graph model belongs to body i of the kinematic
+	void setRobotModel(rl::sg::Model* _model, std::size_t _depth, std::size_t _min_triangles_per_sphere);
+	void setBodySphereTree(std::size_t _body_index, const SphereTree& _sphere_tree);
+
+	// adds the leaves of the fitted environment body trees in world coordinates
+	void addEnvironmentModel(rl::sg::Model* _model, std::size_t _depth, std::size_t _min_triangles_per_sphere);
+	void addEnvironmentSphere(const SphereTree::Sphere& _sphere);
+	void clearEnvironment();
+
+	std::size_t getNumberOfEnvironmentSpheres() const;
+
+	// returns the number of colliding configurations, _colliding[i] != 0 marks configuration i as colliding
+	std::size_t check(const std::vector<rl::math::Vector>& _configurations, std::vector<char>& _colliding);
+	bool isColliding(const rl::math::Vector& _configuration);
+
+	unsigned long long getNumberOfSphereTests() const;
+	unsigned long long getNumberOfExactTests() const;
+	void resetCounters();
+
+	// number of configurations transformed and tested together
+	std::size_t batch_size;
+
+	// additional clearance added to every sphere pair
+	rl::math::Real margin;
+
+	// optional exact model used to confirm sphere collisions, NULL keeps the conservative result
+	rl::plan::SimpleModel* exact_model;
+
+	// optional occupancy environment, octree hits are not confirmed by the exact model
+	OctreeEnvironment* octree_environment;
+
+private:
+	void checkBatch(const std::vector<rl::math::Vector>& _configurations, std::size_t _begin, std::size_t _end, const OctreeEnvironment::Snapshot& _snapshot, std::vector<char>& _colliding, std::vector<char>& _octree_colliding);
+	bool testOctree(const OccupancyOctree& _octree, std::size_t _body, std::size_t _row);
+	void testEnvironment(const RealArray2& _x, const RealArray2& _y, const RealArray2& _z, std::size_t _column, rl::math::Real _radius, RealArray& _clearance);
+
+	rl::mdl::Kinematic* kinematic;
+
+	std::vector<SphereTree> body_sphere_trees;
+
+	RealArray environment_x;
+	RealArray environment_y;
+	RealArray environment_z;
+	RealArray environment_radius;
+
+	// per body and level: sphere centers, rows are configurations of the batch, columns are spheres
+	std::vector<std::vector<RealArray2> > center_x;
+	std::vector<std::vector<RealArray2> > center_y;
+	std::vector<std::vector<RealArray2> > center_z;
+
+	unsigned long long sphere_test_counter;
+	unsigned long long exact_test_counter;
+};
+
+}
+
+#endif /* VM_BATCH_COLLISION_CHECKER_H */
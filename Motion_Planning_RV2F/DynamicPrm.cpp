@@ -0,0 +1,183 @@
+#include "DynamicPrm.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vm {
+
+DynamicPrm::RepairStatistics::RepairStatistics() {
+	this->checked_vertices = 0;
+	this->invalidated_vertices = 0;
+	this->restored_vertices = 0;
+	this->checked_edges = 0;
+	this->invalidated_edges = 0;
+	this->restored_edges = 0;
+	this->duration = std::chrono::steady_clock::duration::zero();
+}
+
+DynamicPrm::DynamicPrm() : AnytimePrm() {
+	this->kinematic = NULL;
+	this->repair_duration = std::chrono::seconds(5);
+	this->sweep_delta = 0.05;
+	this->sweep_padding = 0.02;
+	this->sweep_reach = 1;
+	this->cell_size = 0.1;
+	this->indexed_vertices = 0;
+	this->indexed_edges = 0;
+}
+
+DynamicPrm::~DynamicPrm() {
+}
+
+bool DynamicPrm::solve() {
+	this->vertex_index = SpatialHashIndex(this->cell_size);
+	this->edge_index = SpatialHashIndex(this->cell_size);
+	this->indexed_vertices = 0;
+	this->indexed_edges = 0;
+
+	bool solved = AnytimePrm::solve();
+
+	this->updateSpatialIndex();
+
+	return solved;
+}
+
+void DynamicPrm::setBodyBounds(const std::vector<SphereTree::Sphere>& _body_bounds) {
+	this->body_bounds = _body_bounds;
+}
+
+bool DynamicPrm::moveObstacle(rl::sg::Body* _body, const rl::math::Transform& _frame, const SpatialHashIndex::Box& _body_box) {
+	rl::math::Transform old_frame;
+	_body->getFrame(old_frame);
+
+	SpatialHashIndex::Box region;
+	for (int i = 0; i < 8; ++i) {
+		rl::math::Vector3 corner = _body_box.corner(static_cast<SpatialHashIndex::Box::CornerType>(i));
+		region.extend(old_frame * corner);
+		region.extend(_frame * corner);
+	}
+
+	_body->setFrame(_frame);
+
+	return this->repair(region);
+}
+
+bool DynamicPrm::repair(const SpatialHashIndex::Box& _region) {
+	std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+	this->repair_statistics = DynamicPrm::RepairStatistics();
+	this->updateSpatialIndex();
+
+	std::vector<std::size_t> vertices;
+	this->vertex_index.query(_region, vertices);
+
+	for (std::size_t i = 0; i < vertices.size(); ++i) {
+		bool valid_flag = !this->isColliding(this->roadmap.getConfiguration(vertices[i]));
+
+		if (valid_flag != this->roadmap.isVertexValid(vertices[i])) {
+			if (valid_flag == true) {
+				++this->repair_statistics.restored_vertices;
+			} else {
+				++this->repair_statistics.invalidated_vertices;
+			}
+		}
+
+		this->roadmap.setVertexValid(vertices[i], valid_flag);
+	}
+
+	this->repair_statistics.checked_vertices = vertices.size();
+
+	std::vector<std::size_t> edges;
+	this->edge_index.query(_region, edges);
+
+	for (std::size_t i = 0; i < edges.size(); ++i) {
+		const Roadmap::Edge& edge = this->roadmap.getEdge(edges[i]);
+		if (this->roadmap.isVertexValid(edge.source) == false || this->roadmap.isVertexValid(edge.target) == false) {
+			continue;
+		}
+
+		bool old_valid_flag = this->roadmap.isEdgeValid(edges[i]);
+		bool valid_flag = !this->verifier->isColliding(this->roadmap.getConfiguration(edge.source), this->roadmap.getConfiguration(edge.target), edge.weight);
+		++this->repair_statistics.checked_edges;
+
+		if (valid_flag != old_valid_flag) {
+			if (valid_flag == true) {
+				++this->repair_statistics.restored_edges;
+			} else {
+				++this->repair_statistics.invalidated_edges;
+			}
+		}
+
+		this->roadmap.setEdgeValid(edges[i], valid_flag);
+	}
+
+	this->roadmap.rebuildComponents();
+	this->clearPath();
+
+	bool solved = false;
+	if (this->roadmap.isVertexValid(this->begin) == true && this->roadmap.isVertexValid(this->end) == true) {
+		solved = this->updatePath();
+
+		if (solved == false) {
+			solved = this->expand(std::chrono::steady_clock::now(), this->repair_duration);
+			this->updateSpatialIndex();
+		} else {
+			this->publishProgress(std::chrono::steady_clock::now() - start_time);
+		}
+	}
+
+	this->repair_statistics.duration = std::chrono::steady_clock::now() - start_time;
+
+	return solved;
+}
+
+const DynamicPrm::RepairStatistics& DynamicPrm::getRepairStatistics() const {
+	return this->repair_statistics;
+}
+
+void DynamicPrm::updateSpatialIndex() {
+	for (std::size_t i = this->indexed_vertices; i < this->roadmap.getNumberOfVertices(); ++i) {
+		const rl::math::Vector& q = this->roadmap.getConfiguration(i);
+		this->vertex_index.insert(i, this->computeSweptBox(q, q, 0));
+	}
+	this->indexed_vertices = this->roadmap.getNumberOfVertices();
+
+	for (std::size_t i = this->indexed_edges; i < this->roadmap.getNumberOfEdges(); ++i) {
+		const Roadmap::Edge& edge = this->roadmap.getEdge(i);
+		this->edge_index.insert(i, this->computeSweptBox(this->roadmap.getConfiguration(edge.source), this->roadmap.getConfiguration(edge.target), edge.weight));
+	}
+	this->indexed_edges = this->roadmap.getNumberOfEdges();
+}
+
+SpatialHashIndex::Box DynamicPrm::computeSweptBox(const rl::math::Vector& _q0, const rl::math::Vector& _q1, rl::math::Real _distance) {
+	SpatialHashIndex::Box box;
+
+	std::size_t steps = static_cast<std::size_t>(std::ceil(_distance / this->sweep_delta));
+	for (std::size_t i = 0; i <= steps; ++i) {
+		rl::math::Real alpha = (steps > 0) ? static_cast<rl::math::Real>(i) / steps : 0;
+		this->extendBox(_q0 + alpha * (_q1 - _q0), box);
+	}
+
+	// every configuration on the edge is at most half a sample step away from the nearest sample
+	rl::math::Real step = (steps > 0) ? (_q1 - _q0).lpNorm<1>() / steps : 0;
+	rl::math::Real padding = this->sweep_padding + this->sweep_reach * step / 2;
+
+	box.min().array() -= padding;
+	box.max().array() += padding;
+
+	return box;
+}
+
+void DynamicPrm::extendBox(const rl::math::Vector& _q, SpatialHashIndex::Box& _box) {
+	this->kinematic->setPosition(_q);
+	this->kinematic->forwardPosition();
+
+	std::size_t number_of_bodies = std::min(this->body_bounds.size(), this->kinematic->getBodies());
+	for (std::size_t i = 0; i < number_of_bodies; ++i) {
+		rl::math::Vector3 center = this->kinematic->getBodyFrame(i) * this->body_bounds[i].center;
+		_box.extend(center - rl::math::Vector3::Constant(this->body_bounds[i].radius));
+		_box.extend(center + rl::math::Vector3::Constant(this->body_bounds[i].radius));
+	}
+}
+
+}
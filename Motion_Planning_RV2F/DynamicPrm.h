@@ -0,0 +1,85 @@
+#ifndef VM_DYNAMIC_PRM_H
+#define VM_DYNAMIC_PRM_H
+
+#include <rl/math/Transform.h>
+#include <rl/mdl/Kinematic.h>
+#include <rl/sg/Body.h>
+
+#include "AnytimePrm.h"
+#include "SpatialHashIndex.h"
+#include "SphereTree.h"
+
+namespace vm {
+
+// Anytime PRM that survives obstacle motion. The workspace volume swept by every roadmap vertex and edge is kept in a
+// spatial hash, so an obstacle update only rechecks the vertices and edges touching the changed region. Afterwards the
+// query is answered from the repaired roadmap and the roadmap is grown again only if start and goal got disconnected.
+class DynamicPrm : public AnytimePrm {
+public:
+	struct RepairStatistics {
+		RepairStatistics();
+
+		std::size_t checked_vertices;
+		std::size_t invalidated_vertices;
+		std::size_t restored_vertices;
+
+		std::size_t checked_edges;
+		std::size_t invalidated_edges;
+		std::size_t restored_edges;
+
+		std::chrono::steady_clock::duration duration;
+	};
+
+	DynamicPrm();
+	virtual ~DynamicPrm();
+
+	virtual bool solve();
+
+	// conservative bounding sphere of every kinematic body in body coordinates, e.g. the sphere tree roots
+	void setBodyBounds(const std::vector<SphereTree::Sphere>& _body_bounds);
+
+	// moves the obstacle body and repairs the roadmap inside the union of its old and new bounding box,
+	// _body_box is given in body coordinates
+	bool moveObstacle(rl::sg::Body* _body, const rl::math::Transform& _frame, const SpatialHashIndex::Box& _body_box);
+
+	// repairs the roadmap after the scene changed inside _region (world coordinates)
+	bool repair(const SpatialHashIndex::Box& _region);
+
+	const DynamicPrm::RepairStatistics& getRepairStatistics() const;
+
+	rl::mdl::Kinematic* kinematic;
+
+	// maximum time spent growing the roadmap when the repaired roadmap does not connect the query
+	std::chrono::steady_clock::duration repair_duration;
+
+	// configuration space step between the samples of an edge sweep and additional workspace padding of the swept boxes
+	rl::math::Real sweep_delta;
+	rl::math::Real sweep_padding;
+
+	// largest distance of a body bound from any revolute joint axis, e.g. the reach of the arm including the tool.
+	// Between two samples a body moves at most sweep_reach times the summed joint change, half of it is added to the
+	// padding, so a swept box contains every body bound along the whole edge and not only at the samples.
+	rl::math::Real sweep_reach;
+
+	rl::math::Real cell_size;
+
+protected:
+	void updateSpatialIndex();
+
+	SpatialHashIndex::Box computeSweptBox(const rl::math::Vector& _q0, const rl::math::Vector& _q1, rl::math::Real _distance);
+	void extendBox(const rl::math::Vector& _q, SpatialHashIndex::Box& _box);
+
+	std::vector<SphereTree::Sphere> body_bounds;
+
+	SpatialHashIndex vertex_index;
+	SpatialHashIndex edge_index;
+
+	std::size_t indexed_vertices;
+	std::size_t indexed_edges;
+
+	DynamicPrm::RepairStatistics repair_statistics;
+};
+
+}
+
+#endif /* VM_DYNAMIC_PRM_H */
@@ -0,0 +1,264 @@
+#include "OccupancyOctree.h"
+
+#include <cmath>
+
+namespace vm {
+
+OccupancyOctree::Node::Node() {
+	this->occupied = false;
+}
+
+OccupancyOctree::OccupancyOctree(const rl::math::Vector3& _center, rl::math::Real _size, std::size_t _depth) {
+	this->bounds = OccupancyOctree::Box(_center - rl::math::Vector3::Constant(_size / 2), _center + rl::math::Vector3::Constant(_size / 2));
+	this->depth = _depth;
+}
+
+OccupancyOctree OccupancyOctree::insertPoints(const std::vector<rl::math::Vector3>& _points) const {
+	std::vector<std::size_t> indices;
+	indices.reserve(_points.size());
+
+	for (std::size_t i = 0; i < _points.size(); ++i) {
+		if (this->bounds.contains(_points[i]) == true) {
+			indices.push_back(i);
+		}
+	}
+
+	OccupancyOctree octree = *this;
+	if (indices.empty() == false) {
+		octree.root = OccupancyOctree::insertPoints(this->root, this->bounds, this->depth, _points, indices);
+	}
+
+	return octree;
+}
+
+OccupancyOctree OccupancyOctree::fillRegion(const OccupancyOctree::Box& _region) const {
+	OccupancyOctree octree = *this;
+	octree.root = OccupancyOctree::setRegion(this->root, this->bounds, this->depth, _region, true);
+	return octree;
+}
+
+OccupancyOctree OccupancyOctree::clearRegion(const OccupancyOctree::Box& _region) const {
+	OccupancyOctree octree = *this;
+	octree.root = OccupancyOctree::setRegion(this->root, this->bounds, this->depth, _region, false);
+	return octree;
+}
+
+bool OccupancyOctree::isOccupied(const rl::math::Vector3& _point) const {
+	if (this->bounds.contains(_point) == false) {
+		return false;
+	}
+
+	OccupancyOctree::NodePtr node = this->root;
+	OccupancyOctree::Box box = this->bounds;
+
+	while (node) {
+		if (node->occupied == true) {
+			return true;
+		}
+
+		rl::math::Vector3 center = box.center();
+		std::size_t child = (_point.x() >= center.x() ? 1 : 0) | (_point.y() >= center.y() ? 2 : 0) | (_point.z() >= center.z() ? 4 : 0);
+
+		box = OccupancyOctree::getChildBox(box, child);
+		node = node->children[child];
+	}
+
+	return false;
+}
+
+bool OccupancyOctree::intersectsSphere(const rl::math::Vector3& _center, rl::math::Real _radius) const {
+	return OccupancyOctree::intersectsSphere(this->root, this->bounds, _center, _radius);
+}
+
+const OccupancyOctree::Box& OccupancyOctree::getBounds() const {
+	return this->bounds;
+}
+
+std::size_t OccupancyOctree::getDepth() const {
+	return this->depth;
+}
+
+rl::math::Real OccupancyOctree::getResolution() const {
+	return this->bounds.sizes().x() / std::pow(2.0, static_cast<double>(this->depth));
+}
+
+std::size_t OccupancyOctree::getNumberOfNodes() const {
+	std::size_t nodes = 0;
+	std::size_t occupied_leaves = 0;
+	OccupancyOctree::count(this->root, this->depth, nodes, occupied_leaves);
+	return nodes;
+}
+
+std::size_t OccupancyOctree::getNumberOfOccupiedLeaves() const {
+	std::size_t nodes = 0;
+	std::size_t occupied_leaves = 0;
+	OccupancyOctree::count(this->root, this->depth, nodes, occupied_leaves);
+	return occupied_leaves;
+}
+
+OccupancyOctree::Box OccupancyOctree::getChildBox(const OccupancyOctree::Box& _box, std::size_t _child) {
+	rl::math::Vector3 center = _box.center();
+	OccupancyOctree::Box box;
+
+	for (int i = 0; i < 3; ++i) {
+		if ((_child & (1 << i)) != 0) {
+			box.min()(i) = center(i);
+			box.max()(i) = _box.max()(i);
+		} else {
+			box.min()(i) = _box.min()(i);
+			box.max()(i) = center(i);
+		}
+	}
+
+	return box;
+}
+
+const OccupancyOctree::NodePtr& OccupancyOctree::getOccupiedNode() {
+	// shared by all trees, initialized once in a thread-safe way
+	static const OccupancyOctree::NodePtr occupied_node = []() {
+		std::shared_ptr<OccupancyOctree::Node> node = std::make_shared<OccupancyOctree::Node>();
+		node->occupied = true;
+		return OccupancyOctree::NodePtr(node);
+	}();
+
+	return occupied_node;
+}
+
+OccupancyOctree::NodePtr OccupancyOctree::normalize(const std::shared_ptr<OccupancyOctree::Node>& _node) {
+	std::size_t free_children = 0;
+	std::size_t occupied_children = 0;
+
+	for (std::size_t i = 0; i < 8; ++i) {
+		if (!_node->children[i]) {
+			++free_children;
+		} else if (_node->children[i]->occupied == true) {
+			++occupied_children;
+		}
+	}
+
+	if (free_children == 8) {
+		return OccupancyOctree::NodePtr();
+	}
+
+	if (occupied_children == 8) {
+		return OccupancyOctree::getOccupiedNode();
+	}
+
+	return _node;
+}
+
+OccupancyOctree::NodePtr OccupancyOctree::insertPoints(const OccupancyOctree::NodePtr& _node, const OccupancyOctree::Box& _box, std::size_t _depth, const std::vector<rl::math::Vector3>& _points, const std::vector<std::size_t>& _indices) {
+	if (_node && _node->occupied == true) {
+		return _node;
+	}
+
+	if (_depth == 0) {
+		return OccupancyOctree::getOccupiedNode();
+	}
+
+	std::vector<std::size_t> child_indices[8];
+	rl::math::Vector3 center = _box.center();
+
+	for (std::size_t i = 0; i < _indices.size(); ++i) {
+		const rl::math::Vector3& point = _points[_indices[i]];
+		std::size_t child = (point.x() >= center.x() ? 1 : 0) | (point.y() >= center.y() ? 2 : 0) | (point.z() >= center.z() ? 4 : 0);
+		child_indices[child].push_back(_indices[i]);
+	}
+
+	std::shared_ptr<OccupancyOctree::Node> node = _node ? std::make_shared<OccupancyOctree::Node>(*_node) : std::make_shared<OccupancyOctree::Node>();
+
+	for (std::size_t i = 0; i < 8; ++i) {
+		if (child_indices[i].empty() == false) {
+			node->children[i] = OccupancyOctree::insertPoints(node->children[i], OccupancyOctree::getChildBox(_box, i), _depth - 1, _points, child_indices[i]);
+		}
+	}
+
+	return OccupancyOctree::normalize(node);
+}
+
+OccupancyOctree::NodePtr OccupancyOctree::setRegion(const OccupancyOctree::NodePtr& _node, const OccupancyOctree::Box& _box, std::size_t _depth, const OccupancyOctree::Box& _region, bool _occupied) {
+	// boxes that only touch the region are left alone
+	if ((_region.min().array() < _box.max().array()).all() == false || (_region.max().array() > _box.min().array()).all() == false) {
+		return _node;
+	}
+
+	if (_region.contains(_box) == true) {
+		return _occupied ? OccupancyOctree::getOccupiedNode() : OccupancyOctree::NodePtr();
+	}
+
+	if (_depth == 0) {
+		// partially covered leaf: filling is conservative, clearing requires the leaf center to be inside
+		if (_occupied == true || _region.contains(_box.center()) == false) {
+			return _occupied ? OccupancyOctree::getOccupiedNode() : _node;
+		}
+
+		return OccupancyOctree::NodePtr();
+	}
+
+	if (!_node && _occupied == false) {
+		return _node;
+	}
+
+	std::shared_ptr<OccupancyOctree::Node> node;
+	if (_node && _node->occupied == true) {
+		if (_occupied == true) {
+			return _node;
+		}
+
+		// split the occupied node so that only the covered part is cleared
+		node = std::make_shared<OccupancyOctree::Node>();
+		for (std::size_t i = 0; i < 8; ++i) {
+			node->children[i] = OccupancyOctree::getOccupiedNode();
+		}
+	} else {
+		node = _node ? std::make_shared<OccupancyOctree::Node>(*_node) : std::make_shared<OccupancyOctree::Node>();
+	}
+
+	for (std::size_t i = 0; i < 8; ++i) {
+		node->children[i] = OccupancyOctree::setRegion(node->children[i], OccupancyOctree::getChildBox(_box, i), _depth - 1, _region, _occupied);
+	}
+
+	return OccupancyOctree::normalize(node);
+}
+
+bool OccupancyOctree::intersectsSphere(const OccupancyOctree::NodePtr& _node, const OccupancyOctree::Box& _box, const rl::math::Vector3& _center, rl::math::Real _radius) {
+	if (!_node) {
+		return false;
+	}
+
+	if (_box.squaredExteriorDistance(_center) > _radius * _radius) {
+		return false;
+	}
+
+	if (_node->occupied == true) {
+		return true;
+	}
+
+	for (std::size_t i = 0; i < 8; ++i) {
+		if (OccupancyOctree::intersectsSphere(_node->children[i], OccupancyOctree::getChildBox(_box, i), _center, _radius) == true) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void OccupancyOctree::count(const OccupancyOctree::NodePtr& _node, std::size_t _remaining_depth, std::size_t& _nodes, std::size_t& _occupied_leaves) {
+	if (!_node) {
+		return;
+	}
+
+	++_nodes;
+
+	if (_node->occupied == true) {
+		// collapsed nodes stand for all leaf cells below them
+		_occupied_leaves += static_cast<std::size_t>(1) << (3 * _remaining_depth);
+		return;
+	}
+
+	for (std::size_t i = 0; i < 8; ++i) {
+		OccupancyOctree::count(_node->children[i], _remaining_depth - 1, _nodes, _occupied_leaves);
+	}
+}
+
+}
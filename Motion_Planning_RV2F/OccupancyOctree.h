@@ -0,0 +1,67 @@
+#ifndef VM_OCCUPANCY_OCTREE_H
+#define VM_OCCUPANCY_OCTREE_H
+
+#include <rl/math/Vector.h>
+#include <Eigen/Geometry>
+
+#include <memory>
+#include <vector>
+
+namespace vm {
+
+// Persistent occupancy octree. Nodes are immutable and shared between versions, every update copies only the nodes
+// on the paths to the modified cells and returns a new tree, so older versions stay valid for concurrent readers.
+class OccupancyOctree {
+public:
+	typedef Eigen::AlignedBox<rl::math::Real, 3> Box;
+
+	struct Node {
+		Node();
+
+		// NULL children are free space
+		std::shared_ptr<const OccupancyOctree::Node> children[8];
+
+		// fully occupied node without children
+		bool occupied;
+	};
+
+	typedef std::shared_ptr<const OccupancyOctree::Node> NodePtr;
+
+	// cubic workspace with center _center and edge length _size, leaves are _size / 2^_depth wide
+	OccupancyOctree(const rl::math::Vector3& _center = rl::math::Vector3::Zero(), rl::math::Real _size = 4, std::size_t _depth = 7);
+
+	OccupancyOctree insertPoints(const std::vector<rl::math::Vector3>& _points) const;
+	OccupancyOctree fillRegion(const OccupancyOctree::Box& _region) const;
+	OccupancyOctree clearRegion(const OccupancyOctree::Box& _region) const;
+
+	bool isOccupied(const rl::math::Vector3& _point) const;
+	bool intersectsSphere(const rl::math::Vector3& _center, rl::math::Real _radius) const;
+
+	const OccupancyOctree::Box& getBounds() const;
+	std::size_t getDepth() const;
+	rl::math::Real getResolution() const;
+
+	std::size_t getNumberOfNodes() const;
+	std::size_t getNumberOfOccupiedLeaves() const;
+
+private:
+	static OccupancyOctree::Box getChildBox(const OccupancyOctree::Box& _box, std::size_t _child);
+	static const OccupancyOctree::NodePtr& getOccupiedNode();
+
+	// collapses nodes whose children are all free or all occupied
+	static OccupancyOctree::NodePtr normalize(const std::shared_ptr<OccupancyOctree::Node>& _node);
+
+	static OccupancyOctree::NodePtr insertPoints(const OccupancyOctree::NodePtr& _node, const OccupancyOctree::Box& _box, std::size_t _depth, const std::vector<rl::math::Vector3>& _points, const std::vector<std::size_t>& _indices);
+	static OccupancyOctree::NodePtr setRegion(const OccupancyOctree::NodePtr& _node, const OccupancyOctree::Box& _box, std::size_t _depth, const OccupancyOctree::Box& _region, bool _occupied);
+	static bool intersectsSphere(const OccupancyOctree::NodePtr& _node, const OccupancyOctree::Box& _box, const rl::math::Vector3& _center, rl::math::Real _radius);
+
+	static void count(const OccupancyOctree::NodePtr& _node, std::size_t _remaining_depth, std::size_t& _nodes, std::size_t& _occupied_leaves);
+
+	OccupancyOctree::Box bounds;
+	std::size_t depth;
+	OccupancyOctree::NodePtr root;
+};
+
+}
+
+#endif /* VM_OCCUPANCY_OCTREE_H */
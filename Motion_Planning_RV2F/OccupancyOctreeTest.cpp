@@ -0,0 +1,61 @@
+#include <vector>
+
+#include "OccupancyOctree.h"
+#include "TestCheck.h"
+
+namespace {
+
+vm::OccupancyOctree::Box makeBox(rl::math::Real _min, rl::math::Real _max) {
+	return vm::OccupancyOctree::Box(rl::math::Vector3::Constant(_min), rl::math::Vector3::Constant(_max));
+}
+
+}
+
+int
+main()
+{
+	bool passed = true;
+
+	// 4 m workspace with 8 x 8 x 8 leaves of 0.5 m
+	vm::OccupancyOctree empty(rl::math::Vector3::Zero(), 4, 3);
+	passed &= vm::check(empty.getResolution() == 0.5 && empty.getNumberOfNodes() == 0 && empty.isOccupied(rl::math::Vector3::Zero()) == false, "a new octree is not empty");
+
+	std::vector<rl::math::Vector3> points;
+	points.push_back(rl::math::Vector3(0.1, 0.1, 0.1));
+	points.push_back(rl::math::Vector3(0.2, 0.3, 0.4));
+	// outside of the workspace
+	points.push_back(rl::math::Vector3(5, 0, 0));
+
+	vm::OccupancyOctree first = empty.insertPoints(points);
+	passed &= vm::check(first.getNumberOfOccupiedLeaves() == 1 && first.isOccupied(rl::math::Vector3(0.45, 0.05, 0.25)) == true, "the points were not inserted into one leaf");
+	passed &= vm::check(first.isOccupied(rl::math::Vector3(0.55, 0.1, 0.1)) == false && first.isOccupied(rl::math::Vector3(5, 0, 0)) == false, "a free cell is occupied");
+	passed &= vm::check(empty.getNumberOfNodes() == 0, "the insertion changed the previous version");
+
+	// a filled octant collapses into a single node
+	vm::OccupancyOctree second = first.fillRegion(makeBox(-2, 0));
+	passed &= vm::check(second.getNumberOfOccupiedLeaves() == 65 && second.isOccupied(rl::math::Vector3::Constant(-1.5)) == true, "the region was not filled");
+	passed &= vm::check(second.getNumberOfNodes() == first.getNumberOfNodes() + 1, "the filled octant was not collapsed");
+	passed &= vm::check(first.getNumberOfOccupiedLeaves() == 1 && first.isOccupied(rl::math::Vector3::Constant(-1.5)) == false, "filling changed the previous version");
+
+	// clearing a part of a collapsed node splits it
+	vm::OccupancyOctree third = second.clearRegion(makeBox(-1, 0));
+	passed &= vm::check(third.getNumberOfOccupiedLeaves() == 57 && third.isOccupied(rl::math::Vector3::Constant(-0.5)) == false && third.isOccupied(rl::math::Vector3::Constant(-1.5)) == true, "the region was not cleared");
+	passed &= vm::check(second.getNumberOfOccupiedLeaves() == 65 && second.isOccupied(rl::math::Vector3::Constant(-0.5)) == true, "clearing changed the previous version");
+
+	// partially covered leaves are filled, but only cleared if their center is covered
+	vm::OccupancyOctree fourth = empty.fillRegion(makeBox(0.1, 0.2));
+	passed &= vm::check(fourth.getNumberOfOccupiedLeaves() == 1, "a partially covered leaf was not filled");
+	passed &= vm::check(fourth.clearRegion(makeBox(0.1, 0.2)).getNumberOfOccupiedLeaves() == 1, "a leaf was cleared without covering its center");
+	passed &= vm::check(fourth.clearRegion(makeBox(0.1, 0.3)).getNumberOfOccupiedLeaves() == 0, "a leaf with a covered center was not cleared");
+
+	// a full workspace is a single node, clearing everything leaves no node
+	vm::OccupancyOctree full = empty.fillRegion(makeBox(-2, 2));
+	passed &= vm::check(full.getNumberOfNodes() == 1 && full.getNumberOfOccupiedLeaves() == 512, "the full workspace was not collapsed");
+	passed &= vm::check(full.clearRegion(makeBox(-3, 3)).getNumberOfNodes() == 0, "the cleared workspace has nodes");
+
+	passed &= vm::check(first.intersectsSphere(rl::math::Vector3(0.6, 0.25, 0.25), 0.05) == false, "a sphere next to the occupied leaf intersects");
+	passed &= vm::check(first.intersectsSphere(rl::math::Vector3(0.6, 0.25, 0.25), 0.15) == true, "a sphere reaching into the occupied leaf does not intersect");
+	passed &= vm::check(third.intersectsSphere(rl::math::Vector3::Constant(-0.5), 0.4) == false && second.intersectsSphere(rl::math::Vector3::Constant(-0.5), 0.4) == true, "a cleared region intersects");
+
+	return passed == true ? 0 : 1;
+}
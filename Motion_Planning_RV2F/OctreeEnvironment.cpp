@@ -0,0 +1,102 @@
+#include "OctreeEnvironment.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace vm {
+
+OctreeEnvironment::OctreeEnvironment(const rl::math::Vector3& _center, rl::math::Real _size, std::size_t _depth) {
+	this->version = 0;
+	this->publish(OccupancyOctree(_center, _size, _depth));
+}
+
+OctreeEnvironment::~OctreeEnvironment() {
+}
+
+OctreeEnvironment::Snapshot OctreeEnvironment::getSnapshot() const {
+	return std::atomic_load(&this->snapshot);
+}
+
+unsigned long long OctreeEnvironment::getVersion() const {
+	return this->version;
+}
+
+bool OctreeEnvironment::loadPointCloud(const std::string& _file_name, const rl::math::Transform& _frame, std::size_t _points_per_update) {
+	std::ifstream file(_file_name.c_str());
+	if (file.is_open() == false) {
+		return false;
+	}
+
+	bool pcd_header_flag = false;
+	std::vector<rl::math::Vector3> points;
+	points.reserve(_points_per_update);
+
+	std::string line;
+	while (std::getline(file, line)) {
+		if (line.empty() == true || line[0] == '#') {
+			continue;
+		}
+
+		// skip the PCD header up to and including the DATA line
+		if (line.compare(0, 7, "VERSION") == 0) {
+			pcd_header_flag = true;
+		}
+
+		if (pcd_header_flag == true) {
+			if (line.compare(0, 4, "DATA") == 0) {
+				if (line.find("ascii") == std::string::npos) {
+					return false;
+				}
+				pcd_header_flag = false;
+			}
+			continue;
+		}
+
+		std::istringstream stream(line);
+		rl::math::Vector3 point;
+		if (!(stream >> point.x() >> point.y() >> point.z())) {
+			continue;
+		}
+
+		points.push_back(_frame * point);
+
+		if (points.size() >= _points_per_update) {
+			this->insertPoints(points);
+			points.clear();
+		}
+	}
+
+	if (points.empty() == false) {
+		this->insertPoints(points);
+	}
+
+	return true;
+}
+
+void OctreeEnvironment::insertPoints(const std::vector<rl::math::Vector3>& _points) {
+	std::lock_guard<std::mutex> locker(this->write_mutex);
+	this->publish(this->getSnapshot()->insertPoints(_points));
+}
+
+void OctreeEnvironment::fillRegion(const OccupancyOctree::Box& _region) {
+	std::lock_guard<std::mutex> locker(this->write_mutex);
+	this->publish(this->getSnapshot()->fillRegion(_region));
+}
+
+void OctreeEnvironment::clearRegion(const OccupancyOctree::Box& _region) {
+	std::lock_guard<std::mutex> locker(this->write_mutex);
+	this->publish(this->getSnapshot()->clearRegion(_region));
+}
+
+void OctreeEnvironment::clear() {
+	std::lock_guard<std::mutex> locker(this->write_mutex);
+	OctreeEnvironment::Snapshot current = this->getSnapshot();
+	this->publish(OccupancyOctree(current->getBounds().center(), current->getBounds().sizes().x(), current->getDepth()));
+}
+
+void OctreeEnvironment::publish(const OccupancyOctree& _octree) {
+	std::atomic_store(&this->snapshot, OctreeEnvironment::Snapshot(std::make_shared<OccupancyOctree>(_octree)));
+	++this->version;
+}
+
+}
@@ -0,0 +1,50 @@
+#ifndef VM_OCTREE_ENVIRONMENT_H
+#define VM_OCTREE_ENVIRONMENT_H
+
+#include <rl/math/Transform.h>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "OccupancyOctree.h"
+
+namespace vm {
+
+// Occupancy environment built from point clouds. Updates are serialized and published as a new octree version,
+// readers take a snapshot and keep querying it unaffected by concurrent inserts and clears.
+class OctreeEnvironment {
+public:
+	typedef std::shared_ptr<const OccupancyOctree> Snapshot;
+
+	OctreeEnvironment(const rl::math::Vector3& _center = rl::math::Vector3::Zero(), rl::math::Real _size = 4, std::size_t _depth = 7);
+	virtual ~OctreeEnvironment();
+
+	OctreeEnvironment::Snapshot getSnapshot() const;
+	unsigned long long getVersion() const;
+
+	// streams ASCII point clouds, either plain "x y z" lines or PCD files with DATA ascii, points are transformed
+	// by _frame and published every _points_per_update points so that readers see the environment fill up
+	bool loadPointCloud(const std::string& _file_name, const rl::math::Transform& _frame = rl::math::Transform::Identity(), std::size_t _points_per_update = 100000);
+
+	void insertPoints(const std::vector<rl::math::Vector3>& _points);
+	void fillRegion(const OccupancyOctree::Box& _region);
+	void clearRegion(const OccupancyOctree::Box& _region);
+
+	void clear();
+
+private:
+	void publish(const OccupancyOctree& _octree);
+
+	mutable std::mutex write_mutex;
+
+	// accessed with std::atomic_load / std::atomic_store only
+	OctreeEnvironment::Snapshot snapshot;
+
+	std::atomic<unsigned long long> version;
+};
+
+}
+
+#endif /* VM_OCTREE_ENVIRONMENT_H */
@@ -0,0 +1,82 @@
+#include "OctreeModel.h"
+
+#include <algorithm>
+
+namespace vm {
+
+OctreeModel::OctreeModel() : rl::plan::SimpleModel() {
+	this->kinematic = NULL;
+	this->environment = NULL;
+	this->margin = 0;
+}
+
+OctreeModel::~OctreeModel() {
+}
+
+bool OctreeModel::isColliding() {
+	if (rl::plan::SimpleModel::isColliding() == true) {
+		return true;
+	}
+
+	if (!this->snapshot || this->kinematic == NULL) {
+		return false;
+	}
+
+	std::size_t number_of_bodies = std::min(this->body_sphere_trees.size(), this->kinematic->getBodies());
+	for (std::size_t i = 0; i < number_of_bodies; ++i) {
+		if (OctreeModel::isColliding(*this->snapshot, this->body_sphere_trees[i], this->kinematic->getBodyFrame(i), this->margin) == true) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void OctreeModel::setBodySphereTrees(const std::vector<SphereTree>& _body_sphere_trees) {
+	this->body_sphere_trees = _body_sphere_trees;
+}
+
+void OctreeModel::refreshSnapshot() {
+	if (this->environment != NULL) {
+		this->snapshot = this->environment->getSnapshot();
+	} else {
+		this->snapshot.reset();
+	}
+}
+
+const OctreeEnvironment::Snapshot& OctreeModel::getSnapshot() const {
+	return this->snapshot;
+}
+
+bool OctreeModel::isColliding(const OccupancyOctree& _octree, const SphereTree& _sphere_tree, const rl::math::Transform& _frame, rl::math::Real _margin) {
+	// descend only below spheres that touch occupied space, a leaf hit counts as collision
+	std::vector<char> parent_hits(1, 1);
+
+	for (std::size_t l = 0; l < _sphere_tree.getNumberOfLevels(); ++l) {
+		const SphereTree::Level& level = _sphere_tree.getLevel(l);
+		std::vector<char> hits(level.spheres.size(), 0);
+		bool hit_flag = false;
+
+		for (std::size_t s = 0; s < level.spheres.size(); ++s) {
+			std::size_t parent = (l == 0) ? 0 : level.parents[s];
+			if (parent_hits[parent] == 0) {
+				continue;
+			}
+
+			if (_octree.intersectsSphere(_frame * level.spheres[s].center, level.spheres[s].radius + _margin) == true) {
+				hits[s] = 1;
+				hit_flag = true;
+			}
+		}
+
+		if (hit_flag == false) {
+			return false;
+		}
+
+		parent_hits.swap(hits);
+	}
+
+	return _sphere_tree.isEmpty() == false;
+}
+
+}
@@ -0,0 +1,43 @@
+#ifndef VM_OCTREE_MODEL_H
+#define VM_OCTREE_MODEL_H
+
+#include <rl/mdl/Kinematic.h>
+#include <rl/plan/SimpleModel.h>
+
+#include "OctreeEnvironment.h"
+#include "SphereTree.h"
+
+namespace vm {
+
+// Planning model that checks the scene graph and additionally the sphere trees of the robot bodies against an
+// occupancy octree. The model works on a pinned snapshot, refreshSnapshot() switches to the latest environment version.
+class OctreeModel : public rl::plan::SimpleModel {
+public:
+	OctreeModel();
+	virtual ~OctreeModel();
+
+	virtual bool isColliding();
+
+	void setBodySphereTrees(const std::vector<SphereTree>& _body_sphere_trees);
+
+	void refreshSnapshot();
+	const OctreeEnvironment::Snapshot& getSnapshot() const;
+
+	// kinematic whose body frames are current after updateFrames(), usually the one assigned to mdl
+	rl::mdl::Kinematic* kinematic;
+
+	OctreeEnvironment* environment;
+
+	rl::math::Real margin;
+
+	static bool isColliding(const OccupancyOctree& _octree, const SphereTree& _sphere_tree, const rl::math::Transform& _frame, rl::math::Real _margin);
+
+private:
+	std::vector<SphereTree> body_sphere_trees;
+
+	OctreeEnvironment::Snapshot snapshot;
+};
+
+}
+
+#endif /* VM_OCTREE_MODEL_H */
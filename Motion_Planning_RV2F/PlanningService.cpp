@@ -0,0 +1,430 @@
+#include "PlanningService.h"
+
+#include <rl/math/Unit.h>
+#include <rl/mdl/XmlFactory.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+namespace vm {
+
+PlanningService::Query::Query() {
+	this->timeout = std::chrono::seconds(10);
+}
+
+PlanningService::Result::Result() {
+	this->solved = false;
+	this->path_length = std::numeric_limits<rl::math::Real>::infinity();
+	this->elapsed = std::chrono::steady_clock::duration::zero();
+	this->number_of_vertices = 0;
+}
+
+PlanningService::PlanningService() {
+	this->k = 0;
+	this->radius = std::numeric_limits<rl::math::Real>::max();
+	this->delta = 1 * rl::math::DEG2RAD;
+	this->cell_size = 0.2;
+	this->vertex_index = SpatialHashIndex(this->cell_size);
+	this->stopping = true;
+	this->cancelled = false;
+	this->number_of_queries = 0;
+}
+
+PlanningService::~PlanningService() {
+	this->stop();
+}
+
+void PlanningService::start(const std::string& _kinematics_file, const std::string& _scene_file, std::size_t _number_of_threads) {
+	this->stop();
+
+	if (_number_of_threads == 0) {
+		_number_of_threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+	}
+
+	rl::mdl::XmlFactory factory;
+
+	for (std::size_t i = 0; i < _number_of_threads; ++i) {
+		std::unique_ptr<PlanningService::Worker> worker(new PlanningService::Worker());
+
+		worker->kinematic.reset(dynamic_cast<rl::mdl::Kinematic*>(factory.create(_kinematics_file)));
+		worker->scene.reset(new rl::sg::solid::Scene());
+		worker->scene->load(_scene_file);
+
+		worker->model.mdl = worker->kinematic.get();
+		worker->model.model = worker->scene->getModel(0);
+		worker->model.scene = worker->scene.get();
+
+		// distinct seeds, otherwise all workers would insert the same samples
+		worker->sampler.model = &worker->model;
+		worker->sampler.seed(static_cast<std::mt19937::result_type>(i + 1));
+
+		worker->verifier.delta = this->delta;
+		worker->verifier.model = &worker->model;
+
+		this->workers.push_back(std::move(worker));
+	}
+
+	{
+		std::lock_guard<std::mutex> locker(this->task_mutex);
+		this->stopping = false;
+	}
+	this->cancelled = false;
+
+	for (std::size_t i = 0; i < this->workers.size(); ++i) {
+		this->threads.push_back(std::thread(&PlanningService::run, this, this->workers[i].get()));
+	}
+}
+
+void PlanningService::stop() {
+	if (this->threads.empty() == true) {
+		return;
+	}
+
+	// queued queries still get an (unsolved) answer, their futures never see a broken promise
+	this->cancelled = true;
+
+	{
+		std::lock_guard<std::mutex> locker(this->task_mutex);
+		this->stopping = true;
+	}
+
+	this->task_condition.notify_all();
+
+	for (std::size_t i = 0; i < this->threads.size(); ++i) {
+		this->threads[i].join();
+	}
+
+	this->threads.clear();
+	this->workers.clear();
+}
+
+bool PlanningService::isRunning() const {
+	return this->threads.empty() == false;
+}
+
+std::size_t PlanningService::getNumberOfThreads() const {
+	return this->threads.size();
+}
+
+std::future<PlanningService::Result> PlanningService::submit(const PlanningService::Query& _query) {
+	std::shared_ptr<std::promise<PlanningService::Result> > promise = std::make_shared<std::promise<PlanningService::Result> >();
+	std::future<PlanningService::Result> future = promise->get_future();
+
+	{
+		std::lock_guard<std::mutex> locker(this->task_mutex);
+
+		// no worker would ever take the query
+		if (this->stopping == true) {
+			promise->set_exception(std::make_exception_ptr(std::runtime_error("PlanningService::submit() - service is not running")));
+			return future;
+		}
+
+		this->tasks.push_back([this, promise, _query](PlanningService::Worker& _worker) {
+			promise->set_value(this->answer(_worker, _query));
+		});
+	}
+
+	this->task_condition.notify_one();
+
+	return future;
+}
+
+std::vector<std::future<std::size_t> > PlanningService::expand(std::chrono::steady_clock::duration _duration) {
+	std::vector<std::future<std::size_t> > futures;
+	std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + _duration;
+
+	{
+		std::lock_guard<std::mutex> locker(this->task_mutex);
+
+		for (std::size_t i = 0; i < this->threads.size(); ++i) {
+			std::shared_ptr<std::promise<std::size_t> > promise = std::make_shared<std::promise<std::size_t> >();
+			futures.push_back(promise->get_future());
+
+			this->tasks.push_back([this, promise, deadline](PlanningService::Worker& _worker) {
+				promise->set_value(this->grow(_worker, deadline));
+			});
+		}
+	}
+
+	this->task_condition.notify_all();
+
+	return futures;
+}
+
+std::size_t PlanningService::getNumberOfVertices() const {
+	std::lock_guard<std::mutex> locker(this->roadmap_mutex);
+	return this->roadmap.getNumberOfVertices();
+}
+
+std::size_t PlanningService::getNumberOfEdges() const {
+	std::lock_guard<std::mutex> locker(this->roadmap_mutex);
+	return this->roadmap.getNumberOfEdges();
+}
+
+unsigned long long PlanningService::getNumberOfQueries() const {
+	return this->number_of_queries;
+}
+
+void PlanningService::resetRoadmap() {
+	std::lock_guard<std::mutex> locker(this->roadmap_mutex);
+	this->roadmap.reset();
+	this->vertex_index = SpatialHashIndex(this->cell_size);
+}
+
+void PlanningService::run(PlanningService::Worker* _worker) {
+	while (true) {
+		PlanningService::Task task;
+
+		{
+			std::unique_lock<std::mutex> locker(this->task_mutex);
+			this->task_condition.wait(locker, [this]() { return this->stopping == true || this->tasks.empty() == false; });
+
+			if (this->tasks.empty() == true) {
+				return;
+			}
+
+			task = std::move(this->tasks.front());
+			this->tasks.pop_front();
+		}
+
+		task(*_worker);
+	}
+}
+
+PlanningService::Result PlanningService::answer(PlanningService::Worker& _worker, const PlanningService::Query& _query) {
+	std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+	std::chrono::steady_clock::time_point deadline = start_time + _query.timeout;
+
+	++this->number_of_queries;
+
+	PlanningService::Result result;
+
+	if (this->cancelled == true || this->isColliding(_worker, _query.start) == true || this->isColliding(_worker, _query.goal) == true) {
+		result.elapsed = std::chrono::steady_clock::now() - start_time;
+		return result;
+	}
+
+	// start and goal stay out of the shared roadmap, their edges only live as long as the query
+	std::vector<Roadmap::Neighbor> start_connections;
+	std::vector<Roadmap::Neighbor> goal_connections;
+	rl::math::Real start_reach = this->connect(_worker, _query.start, start_connections);
+	rl::math::Real goal_reach = this->connect(_worker, _query.goal, goal_connections);
+
+	rl::math::Real distance = _worker.model.distance(_query.start, _query.goal);
+	if (distance <= this->radius && _worker.verifier.isColliding(_query.start, _query.goal, distance) == false) {
+		result.solved = true;
+		result.path_length = distance;
+		result.path.push_back(_query.start);
+		result.path.push_back(_query.goal);
+		result.number_of_vertices = this->getNumberOfVertices();
+		result.elapsed = std::chrono::steady_clock::now() - start_time;
+		return result;
+	}
+
+	while (this->findPath(_query, start_connections, goal_connections, result) == false) {
+		if (this->cancelled == true || std::chrono::steady_clock::now() >= deadline) {
+			break;
+		}
+
+		rl::math::Vector q = _worker.sampler.generate();
+		if (this->isColliding(_worker, q) == false) {
+			std::size_t vertex = this->insert(_worker, q);
+			this->connect(_worker, _query.start, start_reach, vertex, q, start_connections);
+			this->connect(_worker, _query.goal, goal_reach, vertex, q, goal_connections);
+		}
+	}
+
+	result.elapsed = std::chrono::steady_clock::now() - start_time;
+
+	return result;
+}
+
+std::size_t PlanningService::grow(PlanningService::Worker& _worker, std::chrono::steady_clock::time_point _deadline) {
+	std::size_t number_of_vertices = 0;
+
+	while (this->cancelled == false && std::chrono::steady_clock::now() < _deadline) {
+		rl::math::Vector q = _worker.sampler.generate();
+		if (this->isColliding(_worker, q) == false) {
+			this->insert(_worker, q);
+			++number_of_vertices;
+		}
+	}
+
+	return number_of_vertices;
+}
+
+bool PlanningService::isColliding(PlanningService::Worker& _worker, const rl::math::Vector& _q) {
+	_worker.model.setPosition(_q);
+	_worker.model.updateFrames();
+	return _worker.model.isColliding();
+}
+
+std::size_t PlanningService::insert(PlanningService::Worker& _worker, const rl::math::Vector& _q) {
+	std::vector<Roadmap::Neighbor> neighbors;
+	std::vector<rl::math::Vector> configurations;
+
+	{
+		std::lock_guard<std::mutex> locker(this->roadmap_mutex);
+
+		this->findNearest(_worker, _q, this->getNumberOfNeighbors(_worker), neighbors);
+
+		// copies, the configuration storage may grow while the edges are verified
+		for (std::size_t i = 0; i < neighbors.size(); ++i) {
+			configurations.push_back(this->roadmap.getConfiguration(neighbors[i].second));
+		}
+	}
+
+	std::vector<char> free_flags(neighbors.size(), 0);
+	for (std::size_t i = 0; i < neighbors.size(); ++i) {
+		free_flags[i] = _worker.verifier.isColliding(_q, configurations[i], neighbors[i].first) ? 0 : 1;
+	}
+
+	std::lock_guard<std::mutex> locker(this->roadmap_mutex);
+
+	std::size_t vertex = this->roadmap.addVertex(_q);
+	this->vertex_index.insert(vertex, SpatialHashIndex::Box(PlanningService::project(_q), PlanningService::project(_q)));
+
+	for (std::size_t i = 0; i < neighbors.size(); ++i) {
+		if (free_flags[i] != 0) {
+			this->roadmap.addEdge(vertex, neighbors[i].second, neighbors[i].first);
+		}
+	}
+
+	return vertex;
+}
+
+rl::math::Real PlanningService::connect(PlanningService::Worker& _worker, const rl::math::Vector& _q, std::vector<Roadmap::Neighbor>& _connections) {
+	std::vector<Roadmap::Neighbor> neighbors;
+	std::vector<rl::math::Vector> configurations;
+	std::size_t k = 0;
+
+	{
+		std::lock_guard<std::mutex> locker(this->roadmap_mutex);
+
+		k = this->getNumberOfNeighbors(_worker);
+		this->findNearest(_worker, _q, k, neighbors);
+
+		for (std::size_t i = 0; i < neighbors.size(); ++i) {
+			configurations.push_back(this->roadmap.getConfiguration(neighbors[i].second));
+		}
+	}
+
+	for (std::size_t i = 0; i < neighbors.size(); ++i) {
+		if (_worker.verifier.isColliding(_q, configurations[i], neighbors[i].first) == false) {
+			_connections.push_back(neighbors[i]);
+		}
+	}
+
+	// with fewer than k neighbors every vertex within the radius counts as a neighbor
+	return (neighbors.size() < k) ? this->radius : neighbors.back().first;
+}
+
+void PlanningService::connect(PlanningService::Worker& _worker, const rl::math::Vector& _q, rl::math::Real _reach, std::size_t _vertex, const rl::math::Vector& _vertex_q, std::vector<Roadmap::Neighbor>& _connections) {
+	rl::math::Real distance = _worker.model.distance(_q, _vertex_q);
+
+	if (distance <= _reach && _worker.verifier.isColliding(_q, _vertex_q, distance) == false) {
+		_connections.push_back(Roadmap::Neighbor(distance, _vertex));
+	}
+}
+
+bool PlanningService::findPath(const PlanningService::Query& _query, const std::vector<Roadmap::Neighbor>& _start_connections, const std::vector<Roadmap::Neighbor>& _goal_connections, PlanningService::Result& _result) {
+	std::lock_guard<std::mutex> locker(this->roadmap_mutex);
+
+	_result.number_of_vertices = this->roadmap.getNumberOfVertices();
+
+	// the components answer most unsolved checks without a search
+	bool connected = false;
+	for (std::size_t i = 0; i < _start_connections.size() && connected == false; ++i) {
+		for (std::size_t j = 0; j < _goal_connections.size() && connected == false; ++j) {
+			connected = this->roadmap.isConnected(_start_connections[i].second, _goal_connections[j].second);
+		}
+	}
+
+	if (connected == false) {
+		return false;
+	}
+
+	std::vector<std::size_t> vertices;
+	if (this->roadmap.findShortestPath(_start_connections, _goal_connections, vertices, _result.path_length) == false) {
+		return false;
+	}
+
+	_result.solved = true;
+	_result.path.clear();
+	_result.path.push_back(_query.start);
+
+	for (std::size_t i = 0; i < vertices.size(); ++i) {
+		_result.path.push_back(this->roadmap.getConfiguration(vertices[i]));
+	}
+
+	_result.path.push_back(_query.goal);
+
+	return true;
+}
+
+std::size_t PlanningService::getNumberOfNeighbors(const PlanningService::Worker& _worker) const {
+	if (this->k > 0) {
+		return this->k;
+	}
+
+	rl::math::Real dof = static_cast<rl::math::Real>(_worker.model.getDof());
+	rl::math::Real n = static_cast<rl::math::Real>(this->roadmap.getNumberOfVertices());
+	return static_cast<std::size_t>(std::ceil(std::exp(1.0) * (1 + 1 / dof) * std::log(std::max<rl::math::Real>(n, 2))));
+}
+
+void PlanningService::findNearest(PlanningService::Worker& _worker, const rl::math::Vector& _q, std::size_t _k, std::vector<Roadmap::Neighbor>& _neighbors) const {
+	_neighbors.clear();
+
+	if (this->roadmap.getNumberOfVertices() == 0) {
+		return;
+	}
+
+	rl::math::Vector3 center = PlanningService::project(_q);
+	std::vector<std::size_t> ids;
+
+	// a vertex outside of the box is farther away than its half width, so the box grows until it holds k neighbors
+	for (rl::math::Real extent = this->cell_size; ; extent *= 2) {
+		this->vertex_index.query(SpatialHashIndex::Box(center - rl::math::Vector3::Constant(extent), center + rl::math::Vector3::Constant(extent)), ids);
+
+		// once the box holds every vertex or the whole radius, the vertices outside of the half width count as well
+		bool complete = (ids.size() == this->roadmap.getNumberOfVertices() || extent >= this->radius);
+		rl::math::Real limit = (complete == true) ? this->radius : extent;
+
+		_neighbors.clear();
+		for (std::size_t i = 0; i < ids.size(); ++i) {
+			if (this->roadmap.isVertexValid(ids[i]) == false) {
+				continue;
+			}
+
+			rl::math::Real distance = _worker.model.distance(_q, this->roadmap.getConfiguration(ids[i]));
+			if (distance <= limit) {
+				_neighbors.push_back(Roadmap::Neighbor(distance, ids[i]));
+			}
+		}
+
+		if (complete == true || _neighbors.size() >= _k) {
+			break;
+		}
+	}
+
+	if (_neighbors.size() > _k) {
+		std::partial_sort(_neighbors.begin(), _neighbors.begin() + _k, _neighbors.end());
+		_neighbors.resize(_k);
+	} else {
+		std::sort(_neighbors.begin(), _neighbors.end());
+	}
+}
+
+rl::math::Vector3 PlanningService::project(const rl::math::Vector& _q) {
+	rl::math::Vector3 point = rl::math::Vector3::Zero();
+	for (std::size_t i = 0; i < 3 && i < static_cast<std::size_t>(_q.size()); ++i) {
+		point(i) = _q(i);
+	}
+
+	return point;
+}
+
+}
@@ -0,0 +1,141 @@
+#ifndef VM_PLANNING_SERVICE_H
+#define VM_PLANNING_SERVICE_H
+
+#include <rl/math/Vector.h>
+#include <rl/mdl/Kinematic.h>
+#include <rl/plan/RecursiveVerifier.h>
+#include <rl/plan/SimpleModel.h>
+#include <rl/plan/UniformSampler.h>
+#include <rl/plan/VectorList.h>
+#include <rl/sg/solid/Scene.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Roadmap.h"
+#include "SpatialHashIndex.h"
+
+namespace vm {
+
+// Long-lived multi-query planner. Robot and scene are loaded once per worker thread (rl models are not thread safe),
+// all workers grow and search one shared roadmap, so later queries reuse the vertices and edges found by earlier ones.
+// Collision checks and edge verification run outside the roadmap lock, only lookups and insertions are serialized.
+// Start and goal of a query are not inserted, they are connected to the roadmap through edges kept by the query.
+class PlanningService {
+public:
+	struct Query {
+		Query();
+
+		rl::math::Vector start;
+		rl::math::Vector goal;
+
+		std::chrono::steady_clock::duration timeout;
+	};
+
+	struct Result {
+		Result();
+
+		bool solved;
+		rl::math::Real path_length;
+		rl::plan::VectorList path;
+
+		std::chrono::steady_clock::duration elapsed;
+		std::size_t number_of_vertices;
+	};
+
+	PlanningService();
+	virtual ~PlanningService();
+
+	// loads kinematics and scene for every worker and starts the threads, 0 threads selects the hardware concurrency
+	void start(const std::string& _kinematics_file, const std::string& _scene_file, std::size_t _number_of_threads);
+	// cancels queued queries and joins the workers, the roadmap is kept
+	void stop();
+
+	bool isRunning() const;
+	std::size_t getNumberOfThreads() const;
+
+	// queries are answered concurrently in submission order, the future becomes ready when the query is solved or timed out,
+	// it holds a std::runtime_error right away if the service is not running
+	std::future<PlanningService::Result> submit(const PlanningService::Query& _query);
+
+	// grows the shared roadmap on every worker for _duration, e.g. between production cycles
+	std::vector<std::future<std::size_t> > expand(std::chrono::steady_clock::duration _duration);
+
+	std::size_t getNumberOfVertices() const;
+	std::size_t getNumberOfEdges() const;
+	unsigned long long getNumberOfQueries() const;
+
+	// only while no queries are running, vertex indices of running queries would become invalid
+	void resetRoadmap();
+
+	// number of nearest neighbors, 0 selects the PRM* bound k = e * (1 + 1 / dof) * log(n)
+	std::size_t k;
+	rl::math::Real radius;
+
+	// verifier resolution in joint space, applied when the workers are started
+	rl::math::Real delta;
+
+	// cell size of the neighbor index over the first three joints, applied by resetRoadmap()
+	rl::math::Real cell_size;
+
+private:
+	struct Worker {
+		std::unique_ptr<rl::mdl::Kinematic> kinematic;
+		std::unique_ptr<rl::sg::solid::Scene> scene;
+		rl::plan::SimpleModel model;
+		rl::plan::UniformSampler sampler;
+		rl::plan::RecursiveVerifier verifier;
+	};
+
+	typedef std::function<void(PlanningService::Worker&)> Task;
+
+	void run(PlanningService::Worker* _worker);
+
+	PlanningService::Result answer(PlanningService::Worker& _worker, const PlanningService::Query& _query);
+	std::size_t grow(PlanningService::Worker& _worker, std::chrono::steady_clock::time_point _deadline);
+
+	bool isColliding(PlanningService::Worker& _worker, const rl::math::Vector& _q);
+	// verifies the edges to the nearest neighbors without holding the roadmap lock and inserts the vertex
+	std::size_t insert(PlanningService::Worker& _worker, const rl::math::Vector& _q);
+	// verifies the edges to the nearest neighbors without inserting _q, appends the free ones to _connections and returns
+	// the distance up to which later vertices are connected as well
+	rl::math::Real connect(PlanningService::Worker& _worker, const rl::math::Vector& _q, std::vector<Roadmap::Neighbor>& _connections);
+	// connects _q to a vertex inserted later if it is within _reach and the edge is free
+	void connect(PlanningService::Worker& _worker, const rl::math::Vector& _q, rl::math::Real _reach, std::size_t _vertex, const rl::math::Vector& _vertex_q, std::vector<Roadmap::Neighbor>& _connections);
+	bool findPath(const PlanningService::Query& _query, const std::vector<Roadmap::Neighbor>& _start_connections, const std::vector<Roadmap::Neighbor>& _goal_connections, PlanningService::Result& _result);
+
+	// called with the roadmap lock held
+	std::size_t getNumberOfNeighbors(const PlanningService::Worker& _worker) const;
+	void findNearest(PlanningService::Worker& _worker, const rl::math::Vector& _q, std::size_t _k, std::vector<Roadmap::Neighbor>& _neighbors) const;
+	static rl::math::Vector3 project(const rl::math::Vector& _q);
+
+	std::vector<std::unique_ptr<PlanningService::Worker> > workers;
+	std::vector<std::thread> threads;
+
+	std::mutex task_mutex;
+	std::condition_variable task_condition;
+	std::deque<PlanningService::Task> tasks;
+	bool stopping;
+
+	std::atomic<bool> cancelled;
+
+	mutable std::mutex roadmap_mutex;
+	Roadmap roadmap;
+	// every vertex as a point at its first three joints, the joint distance is at least the distance of any joint
+	SpatialHashIndex vertex_index;
+
+	std::atomic<unsigned long long> number_of_queries;
+};
+
+}
+
+#endif /* VM_PLANNING_SERVICE_H */
@@ -0,0 +1,237 @@
+#include "Roadmap.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+
+namespace vm {
+
+Roadmap::Roadmap() {
+	this->reset();
+}
+
+void Roadmap::reset() {
+	this->configurations.clear();
+	this->incident_edges.clear();
+	this->edges.clear();
+	this->vertex_valid_flags.clear();
+	this->edge_valid_flags.clear();
+	this->component_parents.clear();
+}
+
+std::size_t Roadmap::addVertex(const rl::math::Vector& _q) {
+	std::size_t vertex = this->configurations.size();
+
+	this->configurations.push_back(_q);
+	this->incident_edges.push_back(std::vector<std::size_t>());
+	this->vertex_valid_flags.push_back(1);
+	this->component_parents.push_back(vertex);
+
+	return vertex;
+}
+
+std::size_t Roadmap::addEdge(std::size_t _source, std::size_t _target, rl::math::Real _weight) {
+	Roadmap::Edge edge;
+	edge.source = _source;
+	edge.target = _target;
+	edge.weight = _weight;
+
+	std::size_t index = this->edges.size();
+	this->edges.push_back(edge);
+	this->incident_edges[_source].push_back(index);
+	this->incident_edges[_target].push_back(index);
+	this->edge_valid_flags.push_back(1);
+
+	this->mergeComponents(_source, _target);
+
+	return index;
+}
+
+std::size_t Roadmap::getNumberOfVertices() const {
+	return this->configurations.size();
+}
+
+std::size_t Roadmap::getNumberOfEdges() const {
+	return this->edges.size();
+}
+
+const rl::math::Vector& Roadmap::getConfiguration(std::size_t _vertex) const {
+	return this->configurations[_vertex];
+}
+
+const Roadmap::Edge& Roadmap::getEdge(std::size_t _edge) const {
+	return this->edges[_edge];
+}
+
+const std::vector<std::size_t>& Roadmap::getIncidentEdges(std::size_t _vertex) const {
+	return this->incident_edges[_vertex];
+}
+
+bool Roadmap::isVertexValid(std::size_t _vertex) const {
+	return this->vertex_valid_flags[_vertex] != 0;
+}
+
+void Roadmap::setVertexValid(std::size_t _vertex, bool _valid_flag) {
+	this->vertex_valid_flags[_vertex] = _valid_flag ? 1 : 0;
+}
+
+bool Roadmap::isEdgeValid(std::size_t _edge) const {
+	const Roadmap::Edge& edge = this->edges[_edge];
+	return this->edge_valid_flags[_edge] != 0 && this->vertex_valid_flags[edge.source] != 0 && this->vertex_valid_flags[edge.target] != 0;
+}
+
+void Roadmap::setEdgeValid(std::size_t _edge, bool _valid_flag) {
+	this->edge_valid_flags[_edge] = _valid_flag ? 1 : 0;
+}
+
+void Roadmap::rebuildComponents() {
+	for (std::size_t i = 0; i < this->component_parents.size(); ++i) {
+		this->component_parents[i] = i;
+	}
+
+	for (std::size_t i = 0; i < this->edges.size(); ++i) {
+		if (this->isEdgeValid(i) == true) {
+			this->mergeComponents(this->edges[i].source, this->edges[i].target);
+		}
+	}
+}
+
+bool Roadmap::isConnected(std::size_t _vertex_a, std::size_t _vertex_b) const {
+	return this->findComponent(_vertex_a) == this->findComponent(_vertex_b);
+}
+
+void Roadmap::findNearest(const rl::math::Vector& _q, std::size_t _k, rl::math::Real _radius, rl::plan::Model* _model, std::vector<Roadmap::Neighbor>& _neighbors) const {
+	_neighbors.clear();
+
+	for (std::size_t i = 0; i < this->configurations.size(); ++i) {
+		if (this->vertex_valid_flags[i] == 0) {
+			continue;
+		}
+
+		rl::math::Real distance = _model->distance(_q, this->configurations[i]);
+		if (distance <= _radius) {
+			_neighbors.push_back(Roadmap::Neighbor(distance, i));
+		}
+	}
+
+	if (_k > 0 && _neighbors.size() > _k) {
+		std::partial_sort(_neighbors.begin(), _neighbors.begin() + _k, _neighbors.end());
+		_neighbors.resize(_k);
+	} else {
+		std::sort(_neighbors.begin(), _neighbors.end());
+	}
+}
+
+bool Roadmap::findShortestPath(std::size_t _start, std::size_t _goal, std::vector<std::size_t>& _vertices, rl::math::Real& _length) const {
+	_vertices.clear();
+	_length = std::numeric_limits<rl::math::Real>::infinity();
+
+	if (_start >= this->configurations.size() || _goal >= this->configurations.size()) {
+		return false;
+	}
+
+	if (this->isVertexValid(_start) == false || this->isVertexValid(_goal) == false || this->isConnected(_start, _goal) == false) {
+		return false;
+	}
+
+	return this->findShortestPath(std::vector<Roadmap::Neighbor>(1, Roadmap::Neighbor(0, _start)), std::vector<Roadmap::Neighbor>(1, Roadmap::Neighbor(0, _goal)), _vertices, _length);
+}
+
+bool Roadmap::findShortestPath(const std::vector<Roadmap::Neighbor>& _sources, const std::vector<Roadmap::Neighbor>& _targets, std::vector<std::size_t>& _vertices, rl::math::Real& _length) const {
+	_vertices.clear();
+	_length = std::numeric_limits<rl::math::Real>::infinity();
+
+	std::vector<rl::math::Real> distances(this->configurations.size(), std::numeric_limits<rl::math::Real>::infinity());
+	std::vector<rl::math::Real> target_weights(this->configurations.size(), std::numeric_limits<rl::math::Real>::infinity());
+	std::vector<std::size_t> predecessors(this->configurations.size(), this->configurations.size());
+	std::priority_queue<Roadmap::Neighbor, std::vector<Roadmap::Neighbor>, std::greater<Roadmap::Neighbor> > queue;
+
+	for (std::size_t i = 0; i < _targets.size(); ++i) {
+		if (_targets[i].second < this->configurations.size() && this->isVertexValid(_targets[i].second) == true) {
+			target_weights[_targets[i].second] = std::min(target_weights[_targets[i].second], _targets[i].first);
+		}
+	}
+
+	for (std::size_t i = 0; i < _sources.size(); ++i) {
+		if (_sources[i].second < this->configurations.size() && this->isVertexValid(_sources[i].second) == true && _sources[i].first < distances[_sources[i].second]) {
+			distances[_sources[i].second] = _sources[i].first;
+			queue.push(_sources[i]);
+		}
+	}
+
+	std::size_t last = this->configurations.size();
+
+	while (queue.empty() == false) {
+		Roadmap::Neighbor current = queue.top();
+		queue.pop();
+
+		// every remaining path is at least as long as the best one found
+		if (current.first >= _length) {
+			break;
+		}
+
+		if (current.first > distances[current.second]) {
+			continue;
+		}
+
+		if (current.first + target_weights[current.second] < _length) {
+			_length = current.first + target_weights[current.second];
+			last = current.second;
+		}
+
+		const std::vector<std::size_t>& incident = this->incident_edges[current.second];
+		for (std::size_t i = 0; i < incident.size(); ++i) {
+			if (this->isEdgeValid(incident[i]) == false) {
+				continue;
+			}
+
+			const Roadmap::Edge& edge = this->edges[incident[i]];
+			std::size_t next = (edge.source == current.second) ? edge.target : edge.source;
+			rl::math::Real distance = current.first + edge.weight;
+
+			if (distance < distances[next]) {
+				distances[next] = distance;
+				predecessors[next] = current.second;
+				queue.push(Roadmap::Neighbor(distance, next));
+			}
+		}
+	}
+
+	if (last == this->configurations.size()) {
+		return false;
+	}
+
+	// sources have no predecessor
+	for (std::size_t vertex = last; vertex != this->configurations.size(); vertex = predecessors[vertex]) {
+		_vertices.push_back(vertex);
+	}
+	std::reverse(_vertices.begin(), _vertices.end());
+
+	return true;
+}
+
+std::size_t Roadmap::findComponent(std::size_t _vertex) const {
+	std::size_t root = _vertex;
+	while (this->component_parents[root] != root) {
+		root = this->component_parents[root];
+	}
+
+	while (this->component_parents[_vertex] != root) {
+		std::size_t next = this->component_parents[_vertex];
+		this->component_parents[_vertex] = root;
+		_vertex = next;
+	}
+
+	return root;
+}
+
+void Roadmap::mergeComponents(std::size_t _vertex_a, std::size_t _vertex_b) {
+	std::size_t component_a = this->findComponent(_vertex_a);
+	std::size_t component_b = this->findComponent(_vertex_b);
+	if (component_a != component_b) {
+		this->component_parents[component_a] = component_b;
+	}
+}
+
+}
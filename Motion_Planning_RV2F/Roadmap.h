@@ -0,0 +1,73 @@
+#ifndef VM_ROADMAP_H
+#define VM_ROADMAP_H
+
+#include <rl/math/Vector.h>
+#include <rl/plan/Model.h>
+
+#include <utility>
+#include <vector>
+
+namespace vm {
+
+// Undirected roadmap with weighted edges and incremental connected components.
+// Vertices and edges can be invalidated and restored, components are then rebuilt from the valid edges.
+class Roadmap {
+public:
+	struct Edge {
+		std::size_t source;
+		std::size_t target;
+		rl::math::Real weight;
+	};
+
+	typedef std::pair<rl::math::Real, std::size_t> Neighbor;
+
+	Roadmap();
+	void reset();
+
+	std::size_t addVertex(const rl::math::Vector& _q);
+	std::size_t addEdge(std::size_t _source, std::size_t _target, rl::math::Real _weight);
+
+	std::size_t getNumberOfVertices() const;
+	std::size_t getNumberOfEdges() const;
+
+	const rl::math::Vector& getConfiguration(std::size_t _vertex) const;
+	const Roadmap::Edge& getEdge(std::size_t _edge) const;
+	const std::vector<std::size_t>& getIncidentEdges(std::size_t _vertex) const;
+
+	bool isVertexValid(std::size_t _vertex) const;
+	void setVertexValid(std::size_t _vertex, bool _valid_flag);
+
+	bool isEdgeValid(std::size_t _edge) const;
+	void setEdgeValid(std::size_t _edge, bool _valid_flag);
+
+	void rebuildComponents();
+
+	bool isConnected(std::size_t _vertex_a, std::size_t _vertex_b) const;
+
+	// linear nearest neighbor search over valid vertices, returns at most _k neighbors sorted by distance (_k == 0 means unlimited)
+	void findNearest(const rl::math::Vector& _q, std::size_t _k, rl::math::Real _radius, rl::plan::Model* _model, std::vector<Roadmap::Neighbor>& _neighbors) const;
+
+	// Dijkstra search over valid edges, _vertices holds the vertex sequence from start to goal
+	bool findShortestPath(std::size_t _start, std::size_t _goal, std::vector<std::size_t>& _vertices, rl::math::Real& _length) const;
+	// Dijkstra search between endpoints outside of the roadmap, each source and target is a valid vertex with the weight
+	// of its edge to the endpoint; _vertices holds the vertex sequence from a source to a target, _length includes both edges
+	bool findShortestPath(const std::vector<Roadmap::Neighbor>& _sources, const std::vector<Roadmap::Neighbor>& _targets, std::vector<std::size_t>& _vertices, rl::math::Real& _length) const;
+
+private:
+	std::size_t findComponent(std::size_t _vertex) const;
+	void mergeComponents(std::size_t _vertex_a, std::size_t _vertex_b);
+
+	std::vector<rl::math::Vector> configurations;
+	std::vector<std::vector<std::size_t> > incident_edges;
+	std::vector<Roadmap::Edge> edges;
+
+	std::vector<char> vertex_valid_flags;
+	std::vector<char> edge_valid_flags;
+
+	// union-find over vertices, compressed lazily during lookups
+	mutable std::vector<std::size_t> component_parents;
+};
+
+}
+
+#endif /* VM_ROADMAP_H */
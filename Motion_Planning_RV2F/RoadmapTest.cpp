@@ -0,0 +1,119 @@
+#include <cmath>
+#include <vector>
+
+#include "Roadmap.h"
+#include "TestCheck.h"
+
+namespace {
+
+std::size_t addVertex(vm::Roadmap& _roadmap, rl::math::Real _x) {
+	rl::math::Vector q(1);
+	q(0) = _x;
+	return _roadmap.addVertex(q);
+}
+
+bool isPath(const std::vector<std::size_t>& _vertices, std::size_t _first, std::size_t _second) {
+	return _vertices.size() == 2 && _vertices[0] == _first && _vertices[1] == _second;
+}
+
+bool isPath(const std::vector<std::size_t>& _vertices, std::size_t _first, std::size_t _second, std::size_t _third) {
+	return _vertices.size() == 3 && _vertices[0] == _first && _vertices[1] == _second && _vertices[2] == _third;
+}
+
+bool isLength(rl::math::Real _length, rl::math::Real _expected) {
+	return std::abs(_length - _expected) < 1e-9;
+}
+
+}
+
+int
+main()
+{
+	bool passed = true;
+
+	// components merge with every added edge and split again when edges or vertices are invalidated
+	{
+		vm::Roadmap roadmap;
+		for (std::size_t i = 0; i < 6; ++i) {
+			addVertex(roadmap, static_cast<rl::math::Real>(i));
+		}
+
+		roadmap.addEdge(0, 1, 1);
+		roadmap.addEdge(1, 2, 1);
+		roadmap.addEdge(3, 4, 1);
+
+		passed &= vm::check(roadmap.isConnected(0, 2) == true && roadmap.isConnected(2, 0) == true, "a chain is not one component");
+		passed &= vm::check(roadmap.isConnected(0, 3) == false && roadmap.isConnected(5, 0) == false, "separate components are connected");
+
+		std::size_t bridge = roadmap.addEdge(2, 3, 1);
+		passed &= vm::check(roadmap.isConnected(0, 4) == true, "the bridge did not merge the components");
+
+		roadmap.setEdgeValid(bridge, false);
+		roadmap.rebuildComponents();
+		passed &= vm::check(roadmap.isConnected(0, 4) == false && roadmap.isConnected(3, 4) == true, "the invalid bridge still connects");
+
+		roadmap.setEdgeValid(bridge, true);
+		roadmap.rebuildComponents();
+		passed &= vm::check(roadmap.isConnected(0, 4) == true, "the restored bridge does not connect");
+
+		// an invalid vertex invalidates its edges
+		roadmap.setVertexValid(1, false);
+		roadmap.rebuildComponents();
+		passed &= vm::check(roadmap.isEdgeValid(0) == false && roadmap.isConnected(0, 2) == false && roadmap.isConnected(2, 4) == true, "the invalid vertex still connects");
+	}
+
+	// shortest paths only use valid edges
+	{
+		vm::Roadmap roadmap;
+		for (std::size_t i = 0; i < 5; ++i) {
+			addVertex(roadmap, static_cast<rl::math::Real>(i));
+		}
+
+		roadmap.addEdge(0, 1, 1);
+		std::size_t short_edge = roadmap.addEdge(1, 3, 1);
+		roadmap.addEdge(0, 2, 0.5);
+		roadmap.addEdge(2, 3, 2);
+
+		std::vector<std::size_t> vertices;
+		rl::math::Real length = 0;
+
+		passed &= vm::check(roadmap.findShortestPath(0, 3, vertices, length) == true && isPath(vertices, 0, 1, 3) == true && isLength(length, 2) == true, "the shortest path was not found");
+
+		roadmap.setEdgeValid(short_edge, false);
+		roadmap.rebuildComponents();
+		passed &= vm::check(roadmap.findShortestPath(0, 3, vertices, length) == true && isPath(vertices, 0, 2, 3) == true && isLength(length, 2.5) == true, "the path uses an invalid edge");
+
+		passed &= vm::check(roadmap.findShortestPath(0, 4, vertices, length) == false && vertices.empty() == true, "a path to an unconnected vertex was found");
+		passed &= vm::check(roadmap.findShortestPath(0, 0, vertices, length) == true && vertices.size() == 1 && isLength(length, 0) == true, "the path to the start is not empty");
+
+		roadmap.setEdgeValid(short_edge, true);
+		roadmap.rebuildComponents();
+
+		// endpoints outside of the roadmap, the weights of their edges count towards the length
+		std::vector<vm::Roadmap::Neighbor> sources;
+		sources.push_back(vm::Roadmap::Neighbor(0.5, 0));
+		sources.push_back(vm::Roadmap::Neighbor(0.1, 2));
+
+		std::vector<vm::Roadmap::Neighbor> targets;
+		targets.push_back(vm::Roadmap::Neighbor(0.2, 3));
+
+		passed &= vm::check(roadmap.findShortestPath(sources, targets, vertices, length) == true && isPath(vertices, 2, 3) == true && isLength(length, 2.3) == true, "the nearer source was not chosen");
+
+		// a vertex near both endpoints needs no roadmap edge
+		sources.assign(1, vm::Roadmap::Neighbor(1, 0));
+		targets.clear();
+		targets.push_back(vm::Roadmap::Neighbor(0.3, 0));
+		targets.push_back(vm::Roadmap::Neighbor(0.1, 3));
+		passed &= vm::check(roadmap.findShortestPath(sources, targets, vertices, length) == true && vertices.size() == 1 && vertices[0] == 0 && isLength(length, 1.3) == true, "the shared vertex was not chosen");
+
+		// invalid vertices are no endpoints
+		roadmap.setVertexValid(3, false);
+		targets.assign(1, vm::Roadmap::Neighbor(0.1, 3));
+		passed &= vm::check(roadmap.findShortestPath(sources, targets, vertices, length) == false, "an invalid target was reached");
+
+		targets.assign(1, vm::Roadmap::Neighbor(0.1, 4));
+		passed &= vm::check(roadmap.findShortestPath(sources, targets, vertices, length) == false && vertices.empty() == true, "an unconnected target was reached");
+	}
+
+	return passed == true ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+#include "SpatialHashIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace vm {
+
+SpatialHashIndex::SpatialHashIndex(rl::math::Real _cell_size) {
+	this->cell_size = _cell_size;
+	this->reset();
+}
+
+void SpatialHashIndex::reset() {
+	this->cells.clear();
+	this->boxes.clear();
+	this->used_flags.clear();
+	this->query_stamps.clear();
+	this->query_stamp = 0;
+}
+
+void SpatialHashIndex::insert(std::size_t _id, const SpatialHashIndex::Box& _box) {
+	if (this->contains(_id) == true) {
+		this->remove(_id);
+	}
+
+	if (_id >= this->boxes.size()) {
+		this->boxes.resize(_id + 1);
+		this->used_flags.resize(_id + 1, 0);
+		this->query_stamps.resize(_id + 1, 0);
+	}
+
+	this->boxes[_id] = _box;
+	this->used_flags[_id] = 1;
+
+	long long minimum[3];
+	long long maximum[3];
+	this->getCellRange(_box, minimum, maximum);
+
+	for (long long x = minimum[0]; x <= maximum[0]; ++x) {
+		for (long long y = minimum[1]; y <= maximum[1]; ++y) {
+			for (long long z = minimum[2]; z <= maximum[2]; ++z) {
+				this->cells[this->getCellKey(x, y, z)].push_back(_id);
+			}
+		}
+	}
+}
+
+void SpatialHashIndex::remove(std::size_t _id) {
+	if (this->contains(_id) == false) {
+		return;
+	}
+
+	long long minimum[3];
+	long long maximum[3];
+	this->getCellRange(this->boxes[_id], minimum, maximum);
+
+	for (long long x = minimum[0]; x <= maximum[0]; ++x) {
+		for (long long y = minimum[1]; y <= maximum[1]; ++y) {
+			for (long long z = minimum[2]; z <= maximum[2]; ++z) {
+				std::unordered_map<SpatialHashIndex::CellKey, std::vector<std::size_t> >::iterator it = this->cells.find(this->getCellKey(x, y, z));
+				if (it == this->cells.end()) {
+					continue;
+				}
+
+				it->second.erase(std::remove(it->second.begin(), it->second.end(), _id), it->second.end());
+				if (it->second.empty() == true) {
+					this->cells.erase(it);
+				}
+			}
+		}
+	}
+
+	this->used_flags[_id] = 0;
+}
+
+bool SpatialHashIndex::contains(std::size_t _id) const {
+	return _id < this->used_flags.size() && this->used_flags[_id] != 0;
+}
+
+const SpatialHashIndex::Box& SpatialHashIndex::getBox(std::size_t _id) const {
+	return this->boxes[_id];
+}
+
+void SpatialHashIndex::query(const SpatialHashIndex::Box& _region, std::vector<std::size_t>& _ids) const {
+	_ids.clear();
+
+	if (++this->query_stamp == 0) {
+		std::fill(this->query_stamps.begin(), this->query_stamps.end(), 0);
+		this->query_stamp = 1;
+	}
+
+	long long minimum[3];
+	long long maximum[3];
+	this->getCellRange(_region, minimum, maximum);
+
+	for (long long x = minimum[0]; x <= maximum[0]; ++x) {
+		for (long long y = minimum[1]; y <= maximum[1]; ++y) {
+			for (long long z = minimum[2]; z <= maximum[2]; ++z) {
+				std::unordered_map<SpatialHashIndex::CellKey, std::vector<std::size_t> >::const_iterator it = this->cells.find(this->getCellKey(x, y, z));
+				if (it == this->cells.end()) {
+					continue;
+				}
+
+				for (std::size_t i = 0; i < it->second.size(); ++i) {
+					std::size_t id = it->second[i];
+					if (this->query_stamps[id] == this->query_stamp) {
+						continue;
+					}
+
+					this->query_stamps[id] = this->query_stamp;
+					if (this->boxes[id].intersects(_region) == true) {
+						_ids.push_back(id);
+					}
+				}
+			}
+		}
+	}
+}
+
+std::size_t SpatialHashIndex::getNumberOfCells() const {
+	return this->cells.size();
+}
+
+rl::math::Real SpatialHashIndex::getCellSize() const {
+	return this->cell_size;
+}
+
+SpatialHashIndex::CellKey SpatialHashIndex::getCellKey(long long _x, long long _y, long long _z) const {
+	// 21 bits per axis, cells wrap around far outside of any robot cell
+	const SpatialHashIndex::CellKey mask = (1ULL << 21) - 1;
+	return ((static_cast<SpatialHashIndex::CellKey>(_x) & mask) << 42) | ((static_cast<SpatialHashIndex::CellKey>(_y) & mask) << 21) | (static_cast<SpatialHashIndex::CellKey>(_z) & mask);
+}
+
+void SpatialHashIndex::getCellRange(const SpatialHashIndex::Box& _box, long long _minimum[3], long long _maximum[3]) const {
+	for (int i = 0; i < 3; ++i) {
+		_minimum[i] = static_cast<long long>(std::floor(_box.min()(i) / this->cell_size));
+		_maximum[i] = static_cast<long long>(std::floor(_box.max()(i) / this->cell_size));
+	}
+}
+
+}
@@ -0,0 +1,53 @@
+#ifndef VM_SPATIAL_HASH_INDEX_H
+#define VM_SPATIAL_HASH_INDEX_H
+
+#include <rl/math/Vector.h>
+#include <Eigen/Geometry>
+
+#include <unordered_map>
+#include <vector>
+
+namespace vm {
+
+// Uniform grid over workspace bounding boxes, maps every occupied cell to the ids of the boxes touching it.
+class SpatialHashIndex {
+public:
+	typedef Eigen::AlignedBox<rl::math::Real, 3> Box;
+
+	SpatialHashIndex(rl::math::Real _cell_size = 0.1);
+	void reset();
+
+	void insert(std::size_t _id, const SpatialHashIndex::Box& _box);
+	void remove(std::size_t _id);
+
+	bool contains(std::size_t _id) const;
+	const SpatialHashIndex::Box& getBox(std::size_t _id) const;
+
+	// ids of all boxes intersecting the region, every id is reported once
+	void query(const SpatialHashIndex::Box& _region, std::vector<std::size_t>& _ids) const;
+
+	std::size_t getNumberOfCells() const;
+
+	rl::math::Real getCellSize() const;
+
+private:
+	typedef unsigned long long CellKey;
+
+	SpatialHashIndex::CellKey getCellKey(long long _x, long long _y, long long _z) const;
+	void getCellRange(const SpatialHashIndex::Box& _box, long long _minimum[3], long long _maximum[3]) const;
+
+	rl::math::Real cell_size;
+
+	std::unordered_map<SpatialHashIndex::CellKey, std::vector<std::size_t> > cells;
+
+	std::vector<SpatialHashIndex::Box> boxes;
+	std::vector<char> used_flags;
+
+	// query stamps avoid reporting ids twice without clearing a visited set per query
+	mutable std::vector<unsigned int> query_stamps;
+	mutable unsigned int query_stamp;
+};
+
+}
+
+#endif /* VM_SPATIAL_HASH_INDEX_H */
@@ -0,0 +1,189 @@
+#include "SphereTree.h"
+
+#include <Inventor/SbMatrix.h>
+#include <Inventor/SoPrimitiveVertex.h>
+#include <Inventor/actions/SoCallbackAction.h>
+#include <Inventor/nodes/SoShape.h>
+#include <rl/sg/so/Shape.h>
+
+#include <algorithm>
+#include <limits>
+
+namespace vm {
+
+namespace {
+
+void collectTriangleCallback(void* _user_data, SoCallbackAction* _action, const SoPrimitiveVertex* _v1, const SoPrimitiveVertex* _v2, const SoPrimitiveVertex* _v3) {
+	std::vector<rl::math::Vector3>* points = static_cast<std::vector<rl::math::Vector3>*>(_user_data);
+	const SbMatrix& model_matrix = _action->getModelMatrix();
+
+	const SoPrimitiveVertex* vertices[3] = { _v1, _v2, _v3 };
+	for (std::size_t i = 0; i < 3; ++i) {
+		SbVec3f point;
+		model_matrix.multVecMatrix(vertices[i]->getPoint(), point);
+		points->push_back(rl::math::Vector3(point[0], point[1], point[2]));
+	}
+}
+
+}
+
+SphereTree::SphereTree() {
+	this->reset();
+}
+
+void SphereTree::reset() {
+	this->levels.clear();
+}
+
+void SphereTree::build(const std::vector<rl::math::Vector3>& _vertices, std::size_t _depth, std::size_t _min_triangles_per_sphere) {
+	this->reset();
+
+	if (_vertices.empty() == true) {
+		return;
+	}
+
+	// a trailing incomplete triangle is kept with the vertices it has
+	std::size_t number_of_triangles = (_vertices.size() + 2) / 3;
+
+	std::vector<rl::math::Vector3> centroids(number_of_triangles);
+	std::vector<std::vector<std::size_t> > current_triangles(1);
+	current_triangles[0].resize(number_of_triangles);
+
+	for (std::size_t i = 0; i < number_of_triangles; ++i) {
+		std::size_t end = std::min(3 * i + 3, _vertices.size());
+
+		centroids[i].setZero();
+		for (std::size_t j = 3 * i; j < end; ++j) {
+			centroids[i] += _vertices[j];
+		}
+		centroids[i] /= static_cast<rl::math::Real>(end - 3 * i);
+
+		current_triangles[0][i] = i;
+	}
+
+	SphereTree::Level root_level;
+	root_level.spheres.push_back(SphereTree::fitSphere(_vertices, current_triangles[0]));
+	root_level.parents.push_back(0);
+	this->levels.push_back(root_level);
+
+	for (std::size_t depth = 1; depth < std::max<std::size_t>(_depth, 1); ++depth) {
+		std::vector<std::vector<std::size_t> > next_triangles;
+		SphereTree::Level level;
+
+		for (std::size_t i = 0; i < current_triangles.size(); ++i) {
+			std::vector<std::size_t> lower;
+			std::vector<std::size_t> upper;
+
+			if (current_triangles[i].size() >= 2 * std::max<std::size_t>(_min_triangles_per_sphere, 1)) {
+				SphereTree::splitTriangles(centroids, current_triangles[i], lower, upper);
+			}
+
+			if (lower.empty() == true || upper.empty() == true) {
+				// sphere cannot be refined, carry it down unchanged to keep the level complete
+				level.spheres.push_back(this->levels.back().spheres[i]);
+				level.parents.push_back(i);
+				next_triangles.push_back(current_triangles[i]);
+				continue;
+			}
+
+			level.spheres.push_back(SphereTree::fitSphere(_vertices, lower));
+			level.parents.push_back(i);
+			next_triangles.push_back(lower);
+
+			level.spheres.push_back(SphereTree::fitSphere(_vertices, upper));
+			level.parents.push_back(i);
+			next_triangles.push_back(upper);
+		}
+
+		this->levels.push_back(level);
+		current_triangles.swap(next_triangles);
+	}
+}
+
+void SphereTree::build(rl::sg::Body* _body, std::size_t _depth, std::size_t _min_triangles_per_sphere) {
+	std::vector<rl::math::Vector3> vertices;
+	SphereTree::collectTriangles(_body, vertices);
+
+	this->build(vertices, _depth, _min_triangles_per_sphere);
+}
+
+void SphereTree::collectTriangles(rl::sg::Body* _body, std::vector<rl::math::Vector3>& _vertices) {
+	SoCallbackAction callback_action;
+	callback_action.addTriangleCallback(SoShape::getClassTypeId(), collectTriangleCallback, &_vertices);
+
+	for (std::size_t i = 0; i < _body->getNumShapes(); ++i) {
+		rl::sg::so::Shape* shape = dynamic_cast<rl::sg::so::Shape*>(_body->getShape(i));
+		if (shape == NULL) {
+			continue;
+		}
+
+		// shape root carries the shape transform, so vertices end up in body coordinates
+		callback_action.apply(shape->root);
+	}
+}
+
+bool SphereTree::isEmpty() const {
+	return this->levels.empty();
+}
+
+std::size_t SphereTree::getNumberOfLevels() const {
+	return this->levels.size();
+}
+
+const SphereTree::Level& SphereTree::getLevel(std::size_t _level) const {
+	return this->levels[_level];
+}
+
+const std::vector<SphereTree::Sphere>& SphereTree::getLeaves() const {
+	return this->levels.back().spheres;
+}
+
+SphereTree::Sphere SphereTree::fitSphere(const std::vector<rl::math::Vector3>& _vertices, const std::vector<std::size_t>& _triangles) {
+	rl::math::Vector3 minimum = rl::math::Vector3::Constant(std::numeric_limits<rl::math::Real>::max());
+	rl::math::Vector3 maximum = rl::math::Vector3::Constant(-std::numeric_limits<rl::math::Real>::max());
+
+	for (std::size_t i = 0; i < _triangles.size(); ++i) {
+		for (std::size_t j = 3 * _triangles[i]; j < std::min(3 * _triangles[i] + 3, _vertices.size()); ++j) {
+			minimum = minimum.cwiseMin(_vertices[j]);
+			maximum = maximum.cwiseMax(_vertices[j]);
+		}
+	}
+
+	SphereTree::Sphere sphere;
+	sphere.center = 0.5 * (minimum + maximum);
+	sphere.radius = 0;
+
+	// a sphere around all vertices of a triangle contains the whole triangle
+	for (std::size_t i = 0; i < _triangles.size(); ++i) {
+		for (std::size_t j = 3 * _triangles[i]; j < std::min(3 * _triangles[i] + 3, _vertices.size()); ++j) {
+			sphere.radius = std::max(sphere.radius, (_vertices[j] - sphere.center).norm());
+		}
+	}
+
+	return sphere;
+}
+
+void SphereTree::splitTriangles(const std::vector<rl::math::Vector3>& _centroids, const std::vector<std::size_t>& _triangles, std::vector<std::size_t>& _lower, std::vector<std::size_t>& _upper) {
+	rl::math::Vector3 minimum = rl::math::Vector3::Constant(std::numeric_limits<rl::math::Real>::max());
+	rl::math::Vector3 maximum = rl::math::Vector3::Constant(-std::numeric_limits<rl::math::Real>::max());
+
+	for (std::size_t i = 0; i < _triangles.size(); ++i) {
+		minimum = minimum.cwiseMin(_centroids[_triangles[i]]);
+		maximum = maximum.cwiseMax(_centroids[_triangles[i]]);
+	}
+
+	rl::math::Vector3::Index axis;
+	(maximum - minimum).maxCoeff(&axis);
+
+	// median split keeps both halves populated even for unevenly tessellated meshes
+	std::vector<std::size_t> sorted = _triangles;
+	std::vector<std::size_t>::iterator median = sorted.begin() + sorted.size() / 2;
+	std::nth_element(sorted.begin(), median, sorted.end(), [&_centroids, axis](std::size_t _a, std::size_t _b) {
+		return _centroids[_a](axis) < _centroids[_b](axis);
+	});
+
+	_lower.assign(sorted.begin(), median);
+	_upper.assign(median, sorted.end());
+}
+
+}
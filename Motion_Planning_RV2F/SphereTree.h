@@ -0,0 +1,52 @@
+#ifndef VM_SPHERE_TREE_H
+#define VM_SPHERE_TREE_H
+
+#include <rl/math/Vector.h>
+#include <rl/sg/Body.h>
+
+#include <vector>
+
+namespace vm {
+
+class SphereTree {
+public:
+	struct Sphere {
+		rl::math::Vector3 center;
+		rl::math::Real radius;
+	};
+
+	// spheres of one tree level, parent refers to the index of the enclosing sphere in the previous level
+	struct Level {
+		std::vector<SphereTree::Sphere> spheres;
+		std::vector<std::size_t> parents;
+	};
+
+	SphereTree();
+	void reset();
+
+	// fits a binary sphere tree to a triangle list (three consecutive vertices per triangle) by splitting the triangles
+	// at the median centroid along the largest extent, every sphere encloses all vertices of its triangles, so the leaves
+	// cover every triangle completely, every level is complete so that leaves are always found in the last level
+	void build(const std::vector<rl::math::Vector3>& _vertices, std::size_t _depth, std::size_t _min_triangles_per_sphere);
+	void build(rl::sg::Body* _body, std::size_t _depth, std::size_t _min_triangles_per_sphere);
+
+	// collects the triangles of the body shapes in body coordinates, three consecutive vertices per triangle
+	static void collectTriangles(rl::sg::Body* _body, std::vector<rl::math::Vector3>& _vertices);
+
+	bool isEmpty() const;
+
+	std::size_t getNumberOfLevels() const;
+	const SphereTree::Level& getLevel(std::size_t _level) const;
+
+	const std::vector<SphereTree::Sphere>& getLeaves() const;
+
+private:
+	static SphereTree::Sphere fitSphere(const std::vector<rl::math::Vector3>& _vertices, const std::vector<std::size_t>& _triangles);
+	static void splitTriangles(const std::vector<rl::math::Vector3>& _centroids, const std::vector<std::size_t>& _triangles, std::vector<std::size_t>& _lower, std::vector<std::size_t>& _upper);
+
+	std::vector<SphereTree::Level> levels;
+};
+
+}
+
+#endif /* VM_SPHERE_TREE_H */
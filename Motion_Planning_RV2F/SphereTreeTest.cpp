@@ -0,0 +1,79 @@
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "SphereTree.h"
+
+namespace {
+
+void addTriangle(std::vector<rl::math::Vector3>& _vertices, const rl::math::Vector3& _a, const rl::math::Vector3& _b, const rl::math::Vector3& _c) {
+	_vertices.push_back(_a);
+	_vertices.push_back(_b);
+	_vertices.push_back(_c);
+}
+
+bool isCovered(const std::vector<vm::SphereTree::Sphere>& _spheres, const rl::math::Vector3& _point) {
+	for (std::size_t i = 0; i < _spheres.size(); ++i) {
+		if ((_point - _spheres[i].center).norm() <= _spheres[i].radius + 1e-9) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+}
+
+int
+main()
+{
+	// a long floor face of two triangles next to a finely tessellated strip, so the splits along x cut through the floor
+	std::vector<rl::math::Vector3> vertices;
+	addTriangle(vertices, rl::math::Vector3(-10, -1, 0), rl::math::Vector3(10, -1, 0), rl::math::Vector3(10, 1, 0));
+	addTriangle(vertices, rl::math::Vector3(-10, -1, 0), rl::math::Vector3(10, 1, 0), rl::math::Vector3(-10, 1, 0));
+
+	for (std::size_t i = 0; i < 256; ++i) {
+		rl::math::Real x = -10 + 20 * static_cast<rl::math::Real>(i) / 256;
+		addTriangle(vertices, rl::math::Vector3(x, 1.1, 0), rl::math::Vector3(x + 0.05, 1.1, 0), rl::math::Vector3(x, 1.15, 0));
+	}
+
+	vm::SphereTree sphere_tree;
+	sphere_tree.build(vertices, 8, 1);
+
+	if (sphere_tree.getNumberOfLevels() != 8 || sphere_tree.getLeaves().size() < 2) {
+		std::cerr << "tree was not refined" << std::endl;
+		return 1;
+	}
+
+	// the corners of the floor are far apart, its interior is only covered by a sphere fitted over the whole triangle
+	if (isCovered(sphere_tree.getLeaves(), rl::math::Vector3(0.3, -0.4, 0)) == false) {
+		std::cerr << "floor interior is not covered by a leaf" << std::endl;
+		return 1;
+	}
+
+	// every point of every triangle lies in a leaf
+	std::mt19937 generator(0);
+	std::uniform_real_distribution<rl::math::Real> distribution(0, 1);
+
+	for (std::size_t i = 0; i < vertices.size(); i += 3) {
+		for (std::size_t j = 0; j < 100; ++j) {
+			rl::math::Real u = distribution(generator);
+			rl::math::Real v = distribution(generator);
+			if (u + v > 1) {
+				u = 1 - u;
+				v = 1 - v;
+			}
+
+			rl::math::Vector3 point = vertices[i] + u * (vertices[i + 1] - vertices[i]) + v * (vertices[i + 2] - vertices[i]);
+
+			if (isCovered(sphere_tree.getLeaves(), point) == false) {
+				std::cerr << "point of triangle " << i / 3 << " is not covered by a leaf" << std::endl;
+				return 1;
+			}
+		}
+	}
+
+	std::cout << "leaves: " << sphere_tree.getLeaves().size() << std::endl;
+
+	return 0;
+}
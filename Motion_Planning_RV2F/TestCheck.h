@@ -0,0 +1,19 @@
+#ifndef VM_TEST_CHECK_H
+#define VM_TEST_CHECK_H
+
+#include <iostream>
+
+namespace vm {
+
+// reports a failed condition of a test on stderr and returns it
+inline bool check(bool _condition, const char* _message) {
+	if (_condition == false) {
+		std::cerr << _message << std::endl;
+	}
+
+	return _condition;
+}
+
+}
+
+#endif /* VM_TEST_CHECK_H */
@@ -0,0 +1,400 @@
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <Inventor/SoDB.h>
+#include <rl/math/Unit.h>
+#include <rl/mdl/Kinematic.h>
+#include <rl/mdl/XmlFactory.h>
+#include <rl/plan/RecursiveVerifier.h>
+#include <rl/plan/SimpleModel.h>
+#include <rl/plan/UniformSampler.h>
+#include <rl/sg/so/Scene.h>
+#include <rl/sg/solid/Scene.h>
+
+#include "AnytimePrm.h"
+#include "BatchCollisionChecker.h"
+#include "DynamicPrm.h"
+#include "OctreeModel.h"
+#include "PlanningService.h"
+
+static vm::AnytimePrm* anytime_planner = NULL;
+
+static void
+cancelPlanner(int signal)
+{
+	if (anytime_planner != NULL)
+	{
+		anytime_planner->cancel();
+	}
+}
+
+int
+main(int argc, char** argv)
+{
+	std::string mode = "batch";
+	std::string kinematics_file = "C:\\RoboWrapSVN4_build\\VC14_32\\dependencies\\rl-0.7.0\\share\\rl-0.7.0\\examples\\rlmdl\\mitsubishi-rv2f.xml";
+	std::string scene_file = "C:\\RoboWrapSVN4_build\\VC14_32\\dependencies\\rl-0.7.0\\share\\rl-0.7.0\\examples\\rlsg\\mitsubishi_rv_2f_boxes.xml";
+	std::size_t number_of_configurations = 10000;
+	double duration = 60;
+	std::string point_cloud_file = "scan.pcd";
+
+	if (argc > 1)
+	{
+		mode = argv[1];
+	}
+
+	if (argc > 3)
+	{
+		kinematics_file = argv[2];
+		scene_file = argv[3];
+	}
+
+	if (argc > 4)
+	{
+		number_of_configurations = std::stoul(argv[4]);
+	}
+
+	if (argc > 5)
+	{
+		duration = std::stod(argv[5]);
+	}
+
+	if (argc > 6)
+	{
+		point_cloud_file = argv[6];
+	}
+
+	rl::mdl::XmlFactory factory;
+	rl::mdl::Kinematic* kinematics = dynamic_cast<rl::mdl::Kinematic*>(factory.create(kinematics_file));
+
+	if (mode == "batch")
+	{
+		SoDB::init();
+
+		rl::sg::so::Scene scene;
+		scene.load(scene_file);
+
+		vm::BatchCollisionChecker checker(kinematics);
+		checker.setRobotModel(scene.getModel(0), 4, 16);
+		for (std::size_t i = 1; i < scene.getNumModels(); ++i)
+		{
+			checker.addEnvironmentModel(scene.getModel(i), 3, 16);
+		}
+
+		rl::math::Vector minimum = kinematics->getMinimum();
+		rl::math::Vector maximum = kinematics->getMaximum();
+		std::mt19937 generator(0);
+		std::uniform_real_distribution<rl::math::Real> distribution(0, 1);
+
+		std::vector<rl::math::Vector> configurations(number_of_configurations, rl::math::Vector(kinematics->getDof()));
+		for (std::size_t i = 0; i < configurations.size(); ++i)
+		{
+			for (std::ptrdiff_t j = 0; j < configurations[i].size(); ++j)
+			{
+				configurations[i](j) = minimum(j) + distribution(generator) * (maximum(j) - minimum(j));
+			}
+		}
+
+		std::vector<char> colliding;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		std::size_t number_of_collisions = checker.check(configurations, colliding);
+		std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+		std::cout << "Environment spheres: " << checker.getNumberOfEnvironmentSpheres() << std::endl;
+		std::cout << "Configurations: " << configurations.size() << " colliding: " << number_of_collisions << std::endl;
+		std::cout << "Sphere tests: " << checker.getNumberOfSphereTests() << " duration [s] " << elapsed.count() << std::endl;
+	}
+	else if (mode == "anytime")
+	{
+		rl::sg::solid::Scene scene;
+		scene.load(scene_file);
+
+		rl::plan::SimpleModel model;
+		model.mdl = kinematics;
+		model.model = scene.getModel(0);
+		model.scene = &scene;
+
+		rl::plan::UniformSampler sampler;
+		sampler.model = &model;
+
+		rl::plan::RecursiveVerifier verifier;
+		verifier.delta = 1 * rl::math::DEG2RAD;
+		verifier.model = &model;
+
+		rl::math::Vector start(kinematics->getDof());
+		start << 90, -30, 90, 0, 0, 0;
+		start *= rl::math::DEG2RAD;
+		rl::math::Vector goal(kinematics->getDof());
+		goal << 0, 0, 90, 0, 0, 0;
+		goal *= rl::math::DEG2RAD;
+
+		vm::AnytimePrm planner;
+		planner.duration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(duration));
+		planner.report_interval = std::chrono::seconds(1);
+		planner.start = &start;
+		planner.goal = &goal;
+		planner.model = &model;
+		planner.sampler = &sampler;
+		planner.verifier = &verifier;
+		planner.progress_callback = [](const vm::AnytimePrm::Progress& progress)
+		{
+			std::cout << std::chrono::duration<double>(progress.elapsed).count() << " s"
+				<< " vertices " << progress.number_of_vertices
+				<< " edges " << progress.number_of_edges
+				<< " total CD " << progress.total_queries
+				<< " free CD " << progress.free_queries
+				<< " solved " << progress.solved;
+			if (progress.solved)
+			{
+				std::cout << " path length " << progress.path_length;
+			}
+			std::cout << std::endl;
+		};
+
+		anytime_planner = &planner;
+		std::signal(SIGINT, cancelPlanner);
+		bool solved = planner.solve();
+		anytime_planner = NULL;
+
+		std::cout << "Solved: " << solved << " waypoints: " << planner.getPath().size() << std::endl;
+	}
+	else if (mode == "dynamic")
+	{
+		SoDB::init();
+
+		rl::sg::so::Scene geometry;
+		geometry.load(scene_file);
+
+		rl::sg::solid::Scene scene;
+		scene.load(scene_file);
+
+		std::vector<vm::SphereTree::Sphere> body_bounds;
+		for (std::size_t i = 0; i < geometry.getModel(0)->getNumBodies(); ++i)
+		{
+			vm::SphereTree sphere_tree;
+			sphere_tree.build(geometry.getModel(0)->getBody(i), 1, 1);
+			if (!sphere_tree.isEmpty())
+			{
+				body_bounds.push_back(sphere_tree.getLevel(0).spheres[0]);
+			}
+			else
+			{
+				vm::SphereTree::Sphere sphere;
+				sphere.center.setZero();
+				sphere.radius = 0;
+				body_bounds.push_back(sphere);
+			}
+		}
+
+		rl::plan::SimpleModel model;
+		model.mdl = kinematics;
+		model.model = scene.getModel(0);
+		model.scene = &scene;
+
+		rl::plan::UniformSampler sampler;
+		sampler.model = &model;
+
+		rl::plan::RecursiveVerifier verifier;
+		verifier.delta = 1 * rl::math::DEG2RAD;
+		verifier.model = &model;
+
+		rl::math::Vector start(kinematics->getDof());
+		start << 90, -30, 90, 0, 0, 0;
+		start *= rl::math::DEG2RAD;
+		rl::math::Vector goal(kinematics->getDof());
+		goal << 0, 0, 90, 0, 0, 0;
+		goal *= rl::math::DEG2RAD;
+
+		vm::DynamicPrm planner;
+		planner.duration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(duration));
+		planner.start = &start;
+		planner.goal = &goal;
+		planner.model = &model;
+		planner.sampler = &sampler;
+		planner.verifier = &verifier;
+		planner.kinematic = kinematics;
+		planner.stop_on_first_solution = true;
+		// reach of the RV-2F including the gripper
+		planner.sweep_reach = 0.7;
+		planner.setBodyBounds(body_bounds);
+
+		bool solved = planner.solve();
+		std::cout << "Solved: " << solved << " vertices: " << planner.getRoadmap().getNumberOfVertices() << std::endl;
+
+		// shift the last environment body (object2) and repair the roadmap
+		rl::sg::Model* environment = scene.getModel(scene.getNumModels() - 1);
+		rl::sg::Body* obstacle = environment->getBody(environment->getNumBodies() - 1);
+
+		vm::SphereTree obstacle_tree;
+		obstacle_tree.build(geometry.getModel(geometry.getNumModels() - 1)->getBody(environment->getNumBodies() - 1), 1, 1);
+		if (obstacle_tree.isEmpty())
+		{
+			std::cerr << "The obstacle has no geometry to bound" << std::endl;
+			return 1;
+		}
+
+		vm::SphereTree::Sphere obstacle_sphere = obstacle_tree.getLevel(0).spheres[0];
+		vm::SpatialHashIndex::Box obstacle_box(
+			obstacle_sphere.center - rl::math::Vector3::Constant(obstacle_sphere.radius),
+			obstacle_sphere.center + rl::math::Vector3::Constant(obstacle_sphere.radius)
+		);
+
+		rl::math::Transform frame;
+		obstacle->getFrame(frame);
+		frame.translation().y() += 0.1;
+
+		solved = planner.moveObstacle(obstacle, frame, obstacle_box);
+
+		const vm::DynamicPrm::RepairStatistics& statistics = planner.getRepairStatistics();
+		std::cout << "Repaired: " << solved
+			<< " checked vertices " << statistics.checked_vertices
+			<< " invalidated " << statistics.invalidated_vertices
+			<< " checked edges " << statistics.checked_edges
+			<< " invalidated " << statistics.invalidated_edges
+			<< " duration [s] " << std::chrono::duration<double>(statistics.duration).count() << std::endl;
+	}
+	else if (mode == "octree")
+	{
+		SoDB::init();
+
+		rl::sg::so::Scene geometry;
+		geometry.load(scene_file);
+
+		rl::sg::solid::Scene scene;
+		scene.load(scene_file);
+
+		std::vector<vm::SphereTree> body_sphere_trees(geometry.getModel(0)->getNumBodies());
+		for (std::size_t i = 0; i < body_sphere_trees.size(); ++i)
+		{
+			body_sphere_trees[i].build(geometry.getModel(0)->getBody(i), 3, 8);
+		}
+
+		// 4 m cube around the robot base with 2^7 cells per side
+		vm::OctreeEnvironment environment(rl::math::Vector3(0, 0, 1), 4, 7);
+
+		// the scan is streamed in while the batch checker keeps querying consistent snapshots
+		std::thread loader([&environment, &point_cloud_file]() {
+			if (!environment.loadPointCloud(point_cloud_file, rl::math::Transform::Identity(), 10000))
+			{
+				std::cerr << "Could not load " << point_cloud_file << std::endl;
+			}
+		});
+
+		vm::BatchCollisionChecker checker(kinematics);
+		checker.octree_environment = &environment;
+		for (std::size_t i = 0; i < body_sphere_trees.size(); ++i)
+		{
+			checker.setBodySphereTree(i, body_sphere_trees[i]);
+		}
+
+		std::mt19937 generator(0);
+		std::vector<rl::math::Vector> configurations(number_of_configurations, rl::math::Vector(kinematics->getDof()));
+		for (std::size_t i = 0; i < configurations.size(); ++i)
+		{
+			for (std::size_t j = 0; j < kinematics->getDof(); ++j)
+			{
+				std::uniform_real_distribution<rl::math::Real> distribution(kinematics->getMinimum()(j), kinematics->getMaximum()(j));
+				configurations[i](j) = distribution(generator);
+			}
+		}
+
+		std::vector<char> colliding;
+		std::size_t number_of_collisions = checker.check(configurations, colliding);
+		std::cout << "Version " << environment.getVersion() << " colliding: " << number_of_collisions << std::endl;
+
+		loader.join();
+
+		number_of_collisions = checker.check(configurations, colliding);
+		std::cout << "Version " << environment.getVersion() << " colliding: " << number_of_collisions
+			<< " occupied leaves: " << environment.getSnapshot()->getNumberOfOccupiedLeaves() << std::endl;
+
+		// free the space in front of the robot and plan against the updated occupancy
+		environment.clearRegion(vm::OccupancyOctree::Box(rl::math::Vector3(0.2, -0.5, 0), rl::math::Vector3(0.8, 0.5, 1.5)));
+
+		vm::OctreeModel model;
+		model.mdl = kinematics;
+		model.model = scene.getModel(0);
+		model.scene = &scene;
+		model.kinematic = kinematics;
+		model.environment = &environment;
+		model.setBodySphereTrees(body_sphere_trees);
+		model.refreshSnapshot();
+
+		rl::plan::UniformSampler sampler;
+		sampler.model = &model;
+
+		rl::plan::RecursiveVerifier verifier;
+		verifier.delta = 1 * rl::math::DEG2RAD;
+		verifier.model = &model;
+
+		rl::math::Vector start(kinematics->getDof());
+		start << 90, -30, 90, 0, 0, 0;
+		start *= rl::math::DEG2RAD;
+		rl::math::Vector goal(kinematics->getDof());
+		goal << 0, 0, 90, 0, 0, 0;
+		goal *= rl::math::DEG2RAD;
+
+		vm::AnytimePrm planner;
+		planner.duration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(duration));
+		planner.start = &start;
+		planner.goal = &goal;
+		planner.model = &model;
+		planner.sampler = &sampler;
+		planner.verifier = &verifier;
+		planner.stop_on_first_solution = true;
+
+		bool solved = planner.solve();
+		std::cout << "Solved: " << solved << " vertices: " << planner.getRoadmap().getNumberOfVertices() << std::endl;
+	}
+	else if (mode == "service")
+	{
+		vm::PlanningService service;
+		service.start(kinematics_file, scene_file, 0);
+
+		// warm up the shared roadmap, then answer one cycle of pick and place queries concurrently
+		std::vector<std::future<std::size_t> > expansions = service.expand(std::chrono::seconds(5));
+		for (std::size_t i = 0; i < expansions.size(); ++i)
+		{
+			expansions[i].wait();
+		}
+
+		std::cout << "Threads: " << service.getNumberOfThreads() << " vertices: " << service.getNumberOfVertices() << std::endl;
+
+		rl::math::Vector pick(kinematics->getDof());
+		pick << 90, -30, 90, 0, 0, 0;
+		pick *= rl::math::DEG2RAD;
+		rl::math::Vector place(kinematics->getDof());
+		place << 0, 0, 90, 0, 0, 0;
+		place *= rl::math::DEG2RAD;
+
+		std::vector<std::future<vm::PlanningService::Result> > results;
+		for (std::size_t i = 0; i < 24; ++i)
+		{
+			vm::PlanningService::Query query;
+			query.start = (i % 2 == 0) ? pick : place;
+			query.goal = (i % 2 == 0) ? place : pick;
+			query.goal(0) += (static_cast<rl::math::Real>(i / 2) - 6) * rl::math::DEG2RAD;
+			query.timeout = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(duration));
+			results.push_back(service.submit(query));
+		}
+
+		for (std::size_t i = 0; i < results.size(); ++i)
+		{
+			vm::PlanningService::Result result = results[i].get();
+			std::cout << "Query " << i << " solved: " << result.solved
+				<< " length: " << result.path_length
+				<< " duration [s]: " << std::chrono::duration<double>(result.elapsed).count() << std::endl;
+		}
+
+		std::cout << "Queries: " << service.getNumberOfQueries() << " vertices: " << service.getNumberOfVertices() << " edges: " << service.getNumberOfEdges() << std::endl;
+
+		service.stop();
+	}
+
+	int l;
+	std::cin >> l;
+	return 0;
+}
@@ -0,0 +1,82 @@
+#include "ConcurrentTaskScheduler.h"
+
+namespace vm {
+
+ConcurrentTaskScheduler::ConcurrentTaskScheduler() {
+	this->next_id = 1;
+}
+
+ConcurrentTaskScheduler::Id ConcurrentTaskScheduler::add(const std::vector<ConcurrentTaskScheduler::Resource>& _resources, const std::vector<ConcurrentTaskScheduler::Id>& _dependencies, bool _barrier_flag) {
+	// an unknown id would otherwise count as finished
+	for (std::size_t i = 0; i < _dependencies.size(); ++i) {
+		if (this->isIssued(_dependencies[i]) == false) {
+			return 0;
+		}
+	}
+
+	ConcurrentTaskScheduler::Task task;
+	task.id = this->next_id++;
+	task.resources = _resources;
+	task.dependencies = _dependencies;
+	task.barrier_flag = _barrier_flag;
+	task.running_flag = false;
+
+	this->tasks.push_back(task);
+	this->unfinished_ids.insert(task.id);
+
+	return task.id;
+}
+
+void ConcurrentTaskScheduler::start(std::vector<ConcurrentTaskScheduler::Id>& _started_ids) {
+	// resources of the earlier unfinished tasks, started or not, so every resource is used in enqueue order
+	std::set<ConcurrentTaskScheduler::Resource> used_resources;
+	bool earlier_task_flag = false;
+
+	for (std::list<ConcurrentTaskScheduler::Task>::iterator it = this->tasks.begin(); it != this->tasks.end(); ++it) {
+		bool conflict_flag = (it->barrier_flag == true && earlier_task_flag == true);
+		for (std::size_t i = 0; i < it->resources.size() && conflict_flag == false; ++i) {
+			conflict_flag = (used_resources.find(it->resources[i]) != used_resources.end());
+		}
+
+		for (std::size_t i = 0; i < it->dependencies.size() && conflict_flag == false; ++i) {
+			conflict_flag = (this->unfinished_ids.find(it->dependencies[i]) != this->unfinished_ids.end());
+		}
+
+		if (it->running_flag == false && conflict_flag == false) {
+			it->running_flag = true;
+			_started_ids.push_back(it->id);
+		}
+
+		if (it->barrier_flag == true) {
+			break;
+		}
+
+		used_resources.insert(it->resources.begin(), it->resources.end());
+		earlier_task_flag = true;
+	}
+}
+
+void ConcurrentTaskScheduler::finish(ConcurrentTaskScheduler::Id _id) {
+	for (std::list<ConcurrentTaskScheduler::Task>::iterator it = this->tasks.begin(); it != this->tasks.end(); ++it) {
+		if (it->id == _id) {
+			this->tasks.erase(it);
+			break;
+		}
+	}
+
+	this->unfinished_ids.erase(_id);
+}
+
+bool ConcurrentTaskScheduler::isIssued(ConcurrentTaskScheduler::Id _id) const {
+	return _id != 0 && _id < this->next_id;
+}
+
+bool ConcurrentTaskScheduler::isFinished(ConcurrentTaskScheduler::Id _id) const {
+	return this->isIssued(_id) == true && this->unfinished_ids.find(_id) == this->unfinished_ids.end();
+}
+
+std::size_t ConcurrentTaskScheduler::getNumberOfUnfinishedTasks() const {
+	return this->unfinished_ids.size();
+}
+
+}
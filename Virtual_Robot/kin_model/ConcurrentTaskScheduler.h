@@ -0,0 +1,55 @@
+#ifndef VM_CONCURRENT_TASK_SCHEDULER_H
+#define VM_CONCURRENT_TASK_SCHEDULER_H
+
+#include <QtGlobal>
+
+#include <list>
+#include <set>
+#include <vector>
+
+namespace vm {
+
+// Decides which controller tasks may start. Tasks sharing a resource start in enqueue order, each one after the
+// earlier ones finished. A barrier starts when all earlier tasks finished and blocks all later ones. A task starts
+// after all its dependencies finished. Not thread safe, the controller serializes the calls.
+class ConcurrentTaskScheduler {
+public:
+	// ids increase with every added task, 0 is never issued
+	typedef quint64 Id;
+	// something a task uses exclusively, e.g. a robot or a queue
+	typedef quint64 Resource;
+
+	ConcurrentTaskScheduler();
+
+	// returns 0 if a dependency was never issued, an id that was issued may belong to a finished task
+	ConcurrentTaskScheduler::Id add(const std::vector<ConcurrentTaskScheduler::Resource>& _resources, const std::vector<ConcurrentTaskScheduler::Id>& _dependencies, bool _barrier_flag);
+
+	// marks every task that can start now as running and appends its id, in enqueue order
+	void start(std::vector<ConcurrentTaskScheduler::Id>& _started_ids);
+
+	// removes a running task, the tasks waiting for it may start with the next start()
+	void finish(ConcurrentTaskScheduler::Id _id);
+
+	bool isIssued(ConcurrentTaskScheduler::Id _id) const;
+	bool isFinished(ConcurrentTaskScheduler::Id _id) const;
+
+	std::size_t getNumberOfUnfinishedTasks() const;
+
+private:
+	struct Task {
+		ConcurrentTaskScheduler::Id id;
+		std::vector<ConcurrentTaskScheduler::Resource> resources;
+		std::vector<ConcurrentTaskScheduler::Id> dependencies;
+		bool barrier_flag;
+		bool running_flag;
+	};
+
+	// unfinished tasks in enqueue order, started ones stay until they finished
+	std::list<ConcurrentTaskScheduler::Task> tasks;
+	std::set<ConcurrentTaskScheduler::Id> unfinished_ids;
+	ConcurrentTaskScheduler::Id next_id;
+};
+
+}
+
+#endif /* VM_CONCURRENT_TASK_SCHEDULER_H */
@@ -0,0 +1,98 @@
+#include <vector>
+
+#include "ConcurrentTaskScheduler.h"
+#include "TestCheck.h"
+
+using namespace vm;
+
+static std::vector<ConcurrentTaskScheduler::Resource> makeResources(ConcurrentTaskScheduler::Resource _resource) {
+	return std::vector<ConcurrentTaskScheduler::Resource>(1, _resource);
+}
+
+static std::vector<ConcurrentTaskScheduler::Id> makeDependencies(ConcurrentTaskScheduler::Id _id) {
+	return std::vector<ConcurrentTaskScheduler::Id>(1, _id);
+}
+
+static std::vector<ConcurrentTaskScheduler::Id> start(ConcurrentTaskScheduler& _scheduler) {
+	std::vector<ConcurrentTaskScheduler::Id> started_ids;
+	_scheduler.start(started_ids);
+
+	return started_ids;
+}
+
+int main() {
+	bool passed = true;
+
+	// tasks of different robots run concurrently, tasks of one robot in enqueue order
+	{
+		ConcurrentTaskScheduler scheduler;
+		ConcurrentTaskScheduler::Id first = scheduler.add(makeResources(1), std::vector<ConcurrentTaskScheduler::Id>(), false);
+		ConcurrentTaskScheduler::Id other = scheduler.add(makeResources(2), std::vector<ConcurrentTaskScheduler::Id>(), false);
+		ConcurrentTaskScheduler::Id second = scheduler.add(makeResources(1), std::vector<ConcurrentTaskScheduler::Id>(), false);
+
+		std::vector<ConcurrentTaskScheduler::Id> started_ids = start(scheduler);
+		passed &= check(started_ids.size() == 2 && started_ids[0] == first && started_ids[1] == other, "different resources did not start together");
+
+		passed &= check(start(scheduler).empty() == true, "a started task was started again");
+
+		scheduler.finish(other);
+		passed &= check(start(scheduler).empty() == true, "a task started before the earlier task of its resource finished");
+
+		scheduler.finish(first);
+		started_ids = start(scheduler);
+		passed &= check(started_ids.size() == 1 && started_ids[0] == second, "the task did not start after the earlier task of its resource");
+	}
+
+	// a barrier waits for all earlier tasks and blocks all later ones
+	{
+		ConcurrentTaskScheduler scheduler;
+		ConcurrentTaskScheduler::Id earlier = scheduler.add(makeResources(1), std::vector<ConcurrentTaskScheduler::Id>(), false);
+		ConcurrentTaskScheduler::Id barrier = scheduler.add(std::vector<ConcurrentTaskScheduler::Resource>(), std::vector<ConcurrentTaskScheduler::Id>(), true);
+		ConcurrentTaskScheduler::Id later = scheduler.add(makeResources(2), std::vector<ConcurrentTaskScheduler::Id>(), false);
+
+		std::vector<ConcurrentTaskScheduler::Id> started_ids = start(scheduler);
+		passed &= check(started_ids.size() == 1 && started_ids[0] == earlier, "the barrier did not wait for the earlier task");
+
+		scheduler.finish(earlier);
+		started_ids = start(scheduler);
+		passed &= check(started_ids.size() == 1 && started_ids[0] == barrier, "the barrier did not start alone");
+
+		scheduler.finish(barrier);
+		started_ids = start(scheduler);
+		passed &= check(started_ids.size() == 1 && started_ids[0] == later, "the later task did not start after the barrier");
+	}
+
+	// a dependency delays its dependent even without a shared resource
+	{
+		ConcurrentTaskScheduler scheduler;
+		ConcurrentTaskScheduler::Id dependency = scheduler.add(makeResources(1), std::vector<ConcurrentTaskScheduler::Id>(), false);
+		ConcurrentTaskScheduler::Id dependent = scheduler.add(makeResources(2), makeDependencies(dependency), false);
+		ConcurrentTaskScheduler::Id independent = scheduler.add(makeResources(3), std::vector<ConcurrentTaskScheduler::Id>(), false);
+
+		std::vector<ConcurrentTaskScheduler::Id> started_ids = start(scheduler);
+		passed &= check(started_ids.size() == 2 && started_ids[0] == dependency && started_ids[1] == independent, "the dependent started before its dependency finished");
+
+		scheduler.finish(dependency);
+		started_ids = start(scheduler);
+		passed &= check(started_ids.size() == 1 && started_ids[0] == dependent, "the dependent did not start after its dependency");
+
+		// a finished dependency is fulfilled
+		passed &= check(scheduler.isFinished(dependency) == true, "the dependency is not finished");
+		ConcurrentTaskScheduler::Id late = scheduler.add(makeResources(4), makeDependencies(dependency), false);
+		started_ids = start(scheduler);
+		passed &= check(late != 0 && started_ids.size() == 1 && started_ids[0] == late, "a finished dependency blocked the task");
+	}
+
+	// ids that were never issued are rejected instead of counting as finished
+	{
+		ConcurrentTaskScheduler scheduler;
+		ConcurrentTaskScheduler::Id issued = scheduler.add(makeResources(1), std::vector<ConcurrentTaskScheduler::Id>(), false);
+
+		passed &= check(scheduler.add(makeResources(2), makeDependencies(0), false) == 0, "id 0 was accepted as dependency");
+		passed &= check(scheduler.add(makeResources(2), makeDependencies(issued + 100), false) == 0, "a future id was accepted as dependency");
+		passed &= check(scheduler.getNumberOfUnfinishedTasks() == 1, "a rejected task was added");
+		passed &= check(scheduler.isFinished(issued) == false, "an unfinished task counts as finished");
+	}
+
+	return passed == true ? 0 : 1;
+}
@@ -1,5 +1,9 @@
 #include "Controller.h"
 
+#include <QDebug>
+#include <QDir>
+#include <QThread>
+
 namespace vm {
 
 Controller::Controller(QObject* _parent) : QObject(_parent) {
@@ -7,14 +11,19 @@ Controller::Controller(QObject* _parent) : QObject(_parent) {
 	qRegisterMetaType<size_t>("size_t");
 	qRegisterMetaType<MachineRepresentation>("MachineRepresentation");
 	qRegisterMetaType<RobotRepresentation>("RobotRepresentation");
+	qRegisterMetaType<Controller::ConcurrentTask::Id>("Controller::ConcurrentTask::Id");
 
 
 	this->prefix = "";
+	this->concurrent_task_stopping_flag = false;
 
 	this->addConcurrentTaskQueue("A");
 	this->addConcurrentTaskQueue("B");
 	this->addConcurrentTaskQueue("C");
 
+	this->task_executor = new TaskExecutor(0, this);
+	this->concurrent_task_finished_callback = boost::bind(&Controller::processConcurrentTaskFinished, this, _1, _2);
+
 	this->machine_manager_thread = new QThread();
 	this->machine_manager_thread->start();
 
@@ -39,29 +48,20 @@ Controller::Controller(QObject* _parent) : QObject(_parent) {
 }
 
 Controller::~Controller() {
-	for (std::map<QString, QWaitCondition*>::iterator it = this->concurrent_task_wait_condition.begin(); it != this->concurrent_task_wait_condition.end(); ++it) {
-		if (it->second != NULL) {
-			delete it->second;
-			it->second = NULL;
-		}
-	}
-	this->concurrent_task_wait_condition.clear();
-
-	for (std::map<QString, QMutex*>::iterator it = this->concurrent_task_wait_condition_mutex.begin(); it != this->concurrent_task_wait_condition_mutex.end(); ++it) {
-		if (it->second != NULL) {
-			delete it->second;
-			it->second = NULL;
-		}
+	// a task blocked on a dialog would keep the executor waiting, it gets an empty answer,
+	// tasks that ask later do not wait at all
+	this->concurrent_task_wait_states_mutex.lock();
+	this->concurrent_task_stopping_flag = true;
+	for (std::map<Controller::ConcurrentTask::Id, ConcurrentTaskWaitState*>::iterator it = this->concurrent_task_wait_states.begin(); it != this->concurrent_task_wait_states.end(); ++it) {
+		it->second->mutex.lock();
+		it->second->answered_flag = true;
+		it->second->condition.wakeOne();
+		it->second->mutex.unlock();
 	}
-	this->concurrent_task_wait_condition_mutex.clear();
+	this->concurrent_task_wait_states_mutex.unlock();
 
-	for (std::map<QString, QReadWriteLock*>::iterator it = this->concurrent_task_wait_condition_data_lock.begin(); it != this->concurrent_task_wait_condition_data_lock.end(); ++it) {
-		if (it->second != NULL) {
-			delete it->second;
-			it->second = NULL;
-		}
-	}
-	this->concurrent_task_wait_condition_data_lock.clear();
+	// waits for the running callbacks, they use the machine manager
+	delete this->task_executor;
 
 	delete this->machine_manager;
 }
@@ -132,162 +132,159 @@ const MachineManager* Controller::getMachineManager() const {
 }
 
 
-void Controller::enqueueConcurrentTask(QString _queue_name, Controller::ConcurrentTask::GenericCallback _function_callback, QString _result_slot_name) {
+Controller::ConcurrentTask::Id Controller::getCurrentConcurrentTaskId() {
+	// the task id is the context of the executor group
+	return TaskExecutor::getCurrentContext();
+}
+
+Controller::ConcurrentTask::Id Controller::enqueueConcurrentTask(QString _queue_name, Controller::ConcurrentTask::GenericCallback _function_callback, Controller::ConcurrentTask::ResultCallback _result_callback) {
 	std::vector<Controller::ConcurrentTask::GenericCallback> function_callbacks;
 	function_callbacks.push_back(_function_callback);
 
-	this->enqueueConcurrentTask(_queue_name, function_callbacks, _result_slot_name);
+	std::vector<Controller::ConcurrentTask::Resource> resources;
+	return this->enqueueConcurrentTask(_queue_name, function_callbacks, _result_callback, resources, std::vector<Controller::ConcurrentTask::Id>(), false);
 }
 
-void Controller::enqueueConcurrentTask(QString _queue_name, std::vector<Controller::ConcurrentTask::GenericCallback> _function_callbacks, QString _result_slot_name) {
-	std::map<QString, std::queue<ConcurrentTask*> >::iterator queue_it = this->concurrent_task_queues.find(_queue_name);
-	if (queue_it == this->concurrent_task_queues.end()) {
-		return;
-	}
+Controller::ConcurrentTask::Id Controller::enqueueConcurrentTask(QString _queue_name, std::vector<Controller::ConcurrentTask::GenericCallback> _function_callbacks, Controller::ConcurrentTask::ResultCallback _result_callback) {
+	std::vector<Controller::ConcurrentTask::Resource> resources;
+	return this->enqueueConcurrentTask(_queue_name, _function_callbacks, _result_callback, resources, std::vector<Controller::ConcurrentTask::Id>(), false);
+}
 
-	std::map<QString, int>::iterator triggered_flag_it = this->concurrent_task_processing_triggerd_flag.find(_queue_name);
-	if (triggered_flag_it == this->concurrent_task_processing_triggerd_flag.end()) {
-		return;
-	}
+Controller::ConcurrentTask::Id Controller::enqueueConcurrentTask(QString _queue_name, std::vector<Controller::ConcurrentTask::GenericCallback> _function_callbacks, Controller::ConcurrentTask::ResultCallback _result_callback,
+	std::vector<Controller::ConcurrentTask::Resource> _resources, std::vector<Controller::ConcurrentTask::Id> _dependencies) {
+	return this->enqueueConcurrentTask(_queue_name, _function_callbacks, _result_callback, _resources, _dependencies, false);
+}
 
-	if (_function_callbacks.size() == 0) {
-		return;
-	}
+Controller::ConcurrentTask::Id Controller::enqueueConcurrentBarrier(QString _queue_name, Controller::ConcurrentTask::GenericCallback _function_callback, Controller::ConcurrentTask::ResultCallback _result_callback) {
+	std::vector<Controller::ConcurrentTask::GenericCallback> function_callbacks;
+	function_callbacks.push_back(_function_callback);
 
-	Controller::ConcurrentTask* concurrent_task = new Controller::ConcurrentTask();
-	concurrent_task->queue_name = _queue_name;
+	std::vector<Controller::ConcurrentTask::Resource> resources;
+	return this->enqueueConcurrentTask(_queue_name, function_callbacks, _result_callback, resources, std::vector<Controller::ConcurrentTask::Id>(), true);
+}
 
-	for (size_t i = 0; i < _function_callbacks.size(); ++i) {
-		concurrent_task->function_callbacks.push_back(_function_callbacks[i]);
+Controller::ConcurrentTask::Id Controller::enqueueConcurrentTask(QString _queue_name, std::vector<Controller::ConcurrentTask::GenericCallback>& _function_callbacks, Controller::ConcurrentTask::ResultCallback& _result_callback,
+	std::vector<Controller::ConcurrentTask::Resource>& _resources, const std::vector<Controller::ConcurrentTask::Id>& _dependencies, bool _barrier_flag) {
+	if (this->concurrent_task_queue_names.find(_queue_name) == this->concurrent_task_queue_names.end()) {
+		return 0;
 	}
 
-	for (size_t i = 0; i < concurrent_task->function_callbacks.size(); ++i) {
-		QFutureWatcher<int>* future_watcher = new QFutureWatcher<int>();
-		future_watcher->setProperty("QUEUE", QVariant(_queue_name));
-		future_watcher->setProperty("INDEX", QVariant(i));
-		QObject::connect(future_watcher, SIGNAL(finished()), this, SLOT(processConcurrentCommandFinished()));
-
-		concurrent_task->future_watchers.push_back(future_watcher);
+	if (_function_callbacks.size() == 0) {
+		return 0;
 	}
 
-	concurrent_task->result_slot_name = _result_slot_name;
-	concurrent_task->status.init(concurrent_task->function_callbacks.size());
+	// without resources the tasks of the queue run one after another
+	if (_resources.empty() == true && _barrier_flag == false) {
+		_resources.push_back(Controller::ConcurrentTask::makeQueueResource(_queue_name));
+	}
 
-	bool trigger_command_processing_flag = false;
 	this->concurrent_tasks_lock.lockForWrite();
-	queue_it->second.push(concurrent_task);
 
-	if (triggered_flag_it->second == 0) {
-		triggered_flag_it->second = 1;
-		trigger_command_processing_flag = true;
+	Controller::ConcurrentTask::Id task_id = this->concurrent_task_scheduler.add(_resources, _dependencies, _barrier_flag);
+	if (task_id == 0) {
+		this->concurrent_tasks_lock.unlock();
+		return 0;
 	}
-	this->concurrent_tasks_lock.unlock();
 
-	if (trigger_command_processing_flag == true) {
-		this->triggerConcurrentComandProcessing(_queue_name);
-	}
-}
+	// the callbacks are swapped in, bound arguments are not copied
+	Controller::ConcurrentTask& concurrent_task = this->concurrent_tasks[task_id];
+	concurrent_task.id = task_id;
+	concurrent_task.function_callbacks.swap(_function_callbacks);
+	concurrent_task.result_callback.swap(_result_callback);
 
+	this->concurrent_tasks_lock.unlock();
 
-void Controller::processConcurrentCommandFinished() {
-	QObject* sender = this->sender();
-	if (sender == NULL) {
-		return;
-	}
+	this->triggerConcurrentComandProcessing();
 
-	QFutureWatcher<int>* future_watcher = reinterpret_cast<QFutureWatcher<int>* >(sender);
-	if (future_watcher == NULL) {
-		return;
-	}
+	return task_id;
+}
 
-	QString queue_name = future_watcher->property("QUEUE").toString();
-	size_t index = future_watcher->property("INDEX").toUInt();
+void Controller::processConcurrentTaskFinished(Controller::ConcurrentTask::Id _task_id, const std::vector<int>& _status_codes) {
+	Controller::ConcurrentTask::ResultCallback result_callback;
 
-	std::map<QString, std::queue<ConcurrentTask*> >::iterator queue_it = this->concurrent_task_queues.find(queue_name);
-	if (queue_it == this->concurrent_task_queues.end()) {
-		return;
+	this->concurrent_tasks_lock.lockForWrite();
+
+	std::map<Controller::ConcurrentTask::Id, ConcurrentTask>::iterator it = this->concurrent_tasks.find(_task_id);
+	if (it != this->concurrent_tasks.end()) {
+		result_callback.swap(it->second.result_callback);
+		this->concurrent_tasks.erase(it);
 	}
+	this->concurrent_task_scheduler.finish(_task_id);
 
-	bool finished_flag = false;
-	bool trigger_command_processing_flag = false;
+	this->concurrent_tasks_lock.unlock();
 
-	this->concurrent_tasks_lock.lockForWrite();
+	this->triggerConcurrentComandProcessing();
 
-	queue_it->second.front()->finished_counter += 1;
+	Controller::ConcurrentTask::Status status;
+	status.status_codes = _status_codes;
 
-	if (queue_it->second.front()->finished_counter == queue_it->second.front()->future_watchers.size()) {
-		finished_flag = true;
+	if (result_callback.empty() == false) {
+		result_callback(_task_id, status);
 	}
+}
 
-	int result = future_watcher->result();
-	queue_it->second.front()->status.setStatusCode(index, result);
-
-	if (finished_flag == true) {
-		QString result_slot_name = queue_it->second.front()->result_slot_name;
-		Controller::ConcurrentTask::Status status = queue_it->second.front()->status;
-
-		delete queue_it->second.front();
-		queue_it->second.front() = NULL;
-		queue_it->second.pop();
+void Controller::triggerConcurrentComandProcessing() {
+	std::vector<Controller::ConcurrentTask::Id> started_task_ids;
+	std::vector<std::vector<Controller::ConcurrentTask::GenericCallback> > started_function_callbacks;
 
-		this->concurrent_tasks_lock.unlock();
+	this->concurrent_tasks_lock.lockForWrite();
 
-		this->triggerConcurrentComandProcessing(queue_name);
+	this->concurrent_task_scheduler.start(started_task_ids);
 
-		QMetaObject::invokeMethod(this, result_slot_name.toLocal8Bit().data(), Q_ARG(Controller::ConcurrentTask::Status, status));
-	} else {
-		this->concurrent_tasks_lock.unlock();
+	started_function_callbacks.resize(started_task_ids.size());
+	for (size_t i = 0; i < started_task_ids.size(); ++i) {
+		started_function_callbacks[i].swap(this->concurrent_tasks[started_task_ids[i]].function_callbacks);
 	}
-}
 
-void Controller::triggerConcurrentComandProcessing(QString _queue_name) {
-	std::map<QString, int>::iterator triggered_flag_it = this->concurrent_task_processing_triggerd_flag.find(_queue_name);
-	if (triggered_flag_it == this->concurrent_task_processing_triggerd_flag.end()) {
-		return;
-	}
+	this->concurrent_tasks_lock.unlock();
 
-	std::map<QString, std::queue<ConcurrentTask*> >::iterator queue_it = this->concurrent_task_queues.find(_queue_name);
-	if (queue_it == this->concurrent_task_queues.end()) {
-		return;
+	// the task id is the context of the group, so the continuation holds no bound arguments and is not allocated
+	for (size_t i = 0; i < started_task_ids.size(); ++i) {
+		this->task_executor->submit(started_function_callbacks[i], this->concurrent_task_finished_callback, started_task_ids[i]);
 	}
+}
 
-	this->concurrent_tasks_lock.lockForWrite();
 
-	if (queue_it->second.empty() == true) {
-		triggered_flag_it->second = 0;
+void Controller::addConcurrentTaskQueue(QString _queue_name) {
+	this->concurrent_task_queue_names.insert(_queue_name);
+}
 
-		this->concurrent_tasks_lock.unlock();
+Controller::ConcurrentTaskDataContainer Controller::requestSelectMachine(Controller::ConcurrentTask::Id _task_id, QStringList _machine_names) {
+	ConcurrentTaskWaitState wait_state;
 
-		return;
+	this->concurrent_task_wait_states_mutex.lock();
+	if (this->concurrent_task_stopping_flag == true) {
+		// nobody answers anymore, the empty answer cancels the task
+		this->concurrent_task_wait_states_mutex.unlock();
+		return wait_state.data;
 	}
+	this->concurrent_task_wait_states[_task_id] = &wait_state;
+	this->concurrent_task_wait_states_mutex.unlock();
 
-	for (size_t i = 0; i < queue_it->second.front()->future_watchers.size(); ++i) {
-		QFuture<int> future = QtConcurrent::run(queue_it->second.front()->function_callbacks[i]);
-		queue_it->second.front()->future_watchers[i]->setFuture(future);
-	}
+	emit requestSelectMachineDialog(_task_id, _machine_names);
 
-	this->concurrent_tasks_lock.unlock();
-}
+	// the answer may arrive before the task waits, the flag keeps it
+	wait_state.mutex.lock();
+	while (wait_state.answered_flag == false) {
+		wait_state.condition.wait(&wait_state.mutex);
+	}
+	wait_state.mutex.unlock();
 
+	this->concurrent_task_wait_states_mutex.lock();
+	this->concurrent_task_wait_states.erase(_task_id);
+	this->concurrent_task_wait_states_mutex.unlock();
 
-void Controller::addConcurrentTaskQueue(QString _queue_name) {
-	this->concurrent_task_processing_triggerd_flag[_queue_name] = 0;
-	this->concurrent_task_queues[_queue_name] = std::queue<ConcurrentTask*>();
-	this->concurrent_task_wait_condition_mutex[_queue_name] = new QMutex();
-	this->concurrent_task_wait_condition[_queue_name] = new QWaitCondition();
-	this->concurrent_task_wait_condition_data_lock[_queue_name] = new QReadWriteLock();
-	this->concurrent_task_wait_condition_data[_queue_name] = ConcurrentTaskDataContainer();
+	return wait_state.data;
 }
 
 
 
-void Controller::initializeApplication() {
-	QString queue_name = "A";
-
-	this->enqueueConcurrentTask(queue_name, boost::bind(&Controller::initializeApplicationConcurrent, this, queue_name), "processInitializeApplicationFinished");
+Controller::ConcurrentTask::Id Controller::initializeApplication() {
+	// a barrier, it touches every robot
+	return this->enqueueConcurrentBarrier("A", boost::bind(&Controller::initializeApplicationConcurrent, this), boost::bind(&Controller::processInitializeApplicationFinished, this, _1, _2));
 }
 
-int Controller::initializeApplicationConcurrent(QString _queue_name) {
+int Controller::initializeApplicationConcurrent() {
 	qDebug() << "Controller::initializeApplicationConcurrent()";
 	
 	QStringList machine_names = this->retrieveAvailableMachineNames();
@@ -307,36 +304,7 @@ int Controller::initializeApplicationConcurrent(QString _queue_name) {
 	else if (machine_names.size() == 1) {
 		this->setCurrentMachineName(machine_names[0]);
 	} else {
-		std::map<QString, QMutex*>::iterator wc_lock_it = this->concurrent_task_wait_condition_mutex.find(_queue_name);
-		if (wc_lock_it == this->concurrent_task_wait_condition_mutex.end() || wc_lock_it->second == NULL) {
-			return 1;
-		}
-
-		std::map<QString, QWaitCondition*>::iterator wc_it = this->concurrent_task_wait_condition.find(_queue_name);
-		if (wc_it == this->concurrent_task_wait_condition.end() || wc_it->second == NULL) {
-			return 1;
-		}
-
-		emit requestSelectMachineDialog(_queue_name, machine_names);
-
-		wc_lock_it->second->lock();
-		wc_it->second->wait(wc_lock_it->second);
-		wc_lock_it->second->unlock();
-
-
-		std::map<QString, QReadWriteLock*>::iterator wc_data_lock_it = this->concurrent_task_wait_condition_data_lock.find(_queue_name);
-		if (wc_data_lock_it == this->concurrent_task_wait_condition_data_lock.end() || wc_data_lock_it->second == NULL) {
-			return 1;
-		}
-
-		std::map<QString, ConcurrentTaskDataContainer>::iterator wc_data_it = this->concurrent_task_wait_condition_data.find(_queue_name);
-		if (wc_data_it == this->concurrent_task_wait_condition_data.end()) {
-			return 1;
-		}
-
-		wc_data_lock_it->second->lockForRead();
-		ConcurrentTaskDataContainer wait_condition_data = wc_data_it->second;
-		wc_data_lock_it->second->unlock();
+		ConcurrentTaskDataContainer wait_condition_data = this->requestSelectMachine(Controller::getCurrentConcurrentTaskId(), machine_names);
 
 		QString answer = wait_condition_data.getValue("ANSWER").toString();
 
@@ -377,22 +345,21 @@ int Controller::initializeApplicationConcurrent(QString _queue_name) {
 	return 0;
 }
 
-void Controller::processInitializeApplicationFinished(Controller::ConcurrentTask::Status _status) {
+void Controller::processInitializeApplicationFinished(Controller::ConcurrentTask::Id _task_id, Controller::ConcurrentTask::Status _status) {
 	if (_status.isSuccessful() == true) {
-		emit initializeApplicationFinished(true);
+		emit initializeApplicationFinished(_task_id, true);
 	} else {
-		emit initializeApplicationFinished(false);
+		emit initializeApplicationFinished(_task_id, false);
 	}
 }
 
 
-void Controller::uninitializeApplication() {
-	QString queue_name = "A";
-
-	this->enqueueConcurrentTask(queue_name, boost::bind(&Controller::uninitializeApplicationConcurrent, this, queue_name), "processUninitializeApplicationFinished");
+Controller::ConcurrentTask::Id Controller::uninitializeApplication() {
+	// a barrier, it touches every robot
+	return this->enqueueConcurrentBarrier("A", boost::bind(&Controller::uninitializeApplicationConcurrent, this), boost::bind(&Controller::processUninitializeApplicationFinished, this, _1, _2));
 }
 
-int Controller::uninitializeApplicationConcurrent(QString _queue_name) {
+int Controller::uninitializeApplicationConcurrent() {
 	// invoke: this->machine_manager->uninitialize();
 	bool status = false;
 	QMetaObject::invokeMethod(this->machine_manager, "uninitialize", Qt::BlockingQueuedConnection, Q_RETURN_ARG(bool, status));
@@ -403,22 +370,27 @@ int Controller::uninitializeApplicationConcurrent(QString _queue_name) {
 	return 0;
 }
 
-void Controller::processUninitializeApplicationFinished(Controller::ConcurrentTask::Status _status) {
+void Controller::processUninitializeApplicationFinished(Controller::ConcurrentTask::Id _task_id, Controller::ConcurrentTask::Status _status) {
 	if (_status.isSuccessful() == true) {
-		emit uninitializeApplicationFinished(true);
+		emit uninitializeApplicationFinished(_task_id, true);
 	} else {
-		emit uninitializeApplicationFinished(false);
+		emit uninitializeApplicationFinished(_task_id, false);
 	}
 }
 
 
-void Controller::enableAutomaticRead(size_t _line_id, size_t _robot_id) {
-	QString queue_name = "A";
+Controller::ConcurrentTask::Id Controller::enableAutomaticRead(size_t _line_id, size_t _robot_id) {
+	std::vector<Controller::ConcurrentTask::GenericCallback> function_callbacks;
+	function_callbacks.push_back(boost::bind(&Controller::enableAutomaticReadConcurrent, this, _line_id, _robot_id));
 
-	this->enqueueConcurrentTask(queue_name, boost::bind(&Controller::enableAutomaticReadConcurrent, this, queue_name, _line_id, _robot_id), "processEnableAutomaticReadFinished");
+	// only waits for earlier tasks of this robot and for barriers
+	std::vector<Controller::ConcurrentTask::Resource> resources;
+	resources.push_back(Controller::ConcurrentTask::makeRobotResource(_line_id, _robot_id));
+
+	return this->enqueueConcurrentTask("A", function_callbacks, boost::bind(&Controller::processEnableAutomaticReadFinished, this, _line_id, _robot_id, _1, _2), resources);
 }
 
-int Controller::enableAutomaticReadConcurrent(QString _queue_name, size_t _line_id, size_t _robot_id) {
+int Controller::enableAutomaticReadConcurrent(size_t _line_id, size_t _robot_id) {
 	// invoke: this->machine_manager->enableAutomaticRead(_line_id, _robot_id);
 	bool status = false;
 	QMetaObject::invokeMethod(this->machine_manager, "enableAutomaticRead", Qt::BlockingQueuedConnection, Q_RETURN_ARG(bool, status), Q_ARG(size_t, _line_id), Q_ARG(size_t, _robot_id));
@@ -429,22 +401,27 @@ int Controller::enableAutomaticReadConcurrent(QString _queue_name, size_t _line_
 	return 0;
 }
 
-void Controller:: processEnableAutomaticReadFinished(Controller::ConcurrentTask::Status _status) {
+void Controller::processEnableAutomaticReadFinished(size_t _line_id, size_t _robot_id, Controller::ConcurrentTask::Id _task_id, Controller::ConcurrentTask::Status _status) {
 	if (_status.isSuccessful() == true) {
-		emit enableAutomaticReadFinished(true);
+		emit enableAutomaticReadFinished(_line_id, _robot_id, _task_id, true);
 	} else {
-		emit enableAutomaticReadFinished(false);
+		emit enableAutomaticReadFinished(_line_id, _robot_id, _task_id, false);
 	}
 }
 
 
-void Controller::disableAutomaticRead(size_t _line_id, size_t _robot_id) {
-	QString queue_name = "A";
+Controller::ConcurrentTask::Id Controller::disableAutomaticRead(size_t _line_id, size_t _robot_id) {
+	std::vector<Controller::ConcurrentTask::GenericCallback> function_callbacks;
+	function_callbacks.push_back(boost::bind(&Controller::disableAutomaticReadConcurrent, this, _line_id, _robot_id));
+
+	// only waits for earlier tasks of this robot and for barriers
+	std::vector<Controller::ConcurrentTask::Resource> resources;
+	resources.push_back(Controller::ConcurrentTask::makeRobotResource(_line_id, _robot_id));
 
-	this->enqueueConcurrentTask(queue_name, boost::bind(&Controller::disableAutomaticReadConcurrent, this, queue_name, _line_id, _robot_id), "processDisableAutomaticReadFinished");
+	return this->enqueueConcurrentTask("A", function_callbacks, boost::bind(&Controller::processDisableAutomaticReadFinished, this, _line_id, _robot_id, _1, _2), resources);
 }
 
-int Controller::disableAutomaticReadConcurrent(QString _queue_name, size_t _line_id, size_t _robot_id) {
+int Controller::disableAutomaticReadConcurrent(size_t _line_id, size_t _robot_id) {
 	// invoke: this->machine_manager->disableAutomaticRead(_line_id, _robot_id);
 	bool status = false;
 	QMetaObject::invokeMethod(this->machine_manager, "disableAutomaticRead", Qt::BlockingQueuedConnection, Q_RETURN_ARG(bool, status), Q_ARG(size_t, _line_id), Q_ARG(size_t, _robot_id));
@@ -455,21 +432,26 @@ int Controller::disableAutomaticReadConcurrent(QString _queue_name, size_t _line
 	return 0;
 }
 
-void Controller::processDisableAutomaticReadFinished(Controller::ConcurrentTask::Status _status) {
+void Controller::processDisableAutomaticReadFinished(size_t _line_id, size_t _robot_id, Controller::ConcurrentTask::Id _task_id, Controller::ConcurrentTask::Status _status) {
 	if (_status.isSuccessful() == true) {
-		emit disableAutomaticReadFinished(true);
+		emit disableAutomaticReadFinished(_line_id, _robot_id, _task_id, true);
 	} else {
-		emit disableAutomaticReadFinished(false);
+		emit disableAutomaticReadFinished(_line_id, _robot_id, _task_id, false);
 	}
 }
 
-void Controller::restart(size_t _line_id, size_t _robot_id) {
-	QString queue_name = "A";
+Controller::ConcurrentTask::Id Controller::restart(size_t _line_id, size_t _robot_id) {
+	std::vector<Controller::ConcurrentTask::GenericCallback> function_callbacks;
+	function_callbacks.push_back(boost::bind(&Controller::restartConcurrent, this, _line_id, _robot_id));
+
+	// only waits for earlier tasks of this robot and for barriers
+	std::vector<Controller::ConcurrentTask::Resource> resources;
+	resources.push_back(Controller::ConcurrentTask::makeRobotResource(_line_id, _robot_id));
 
-	this->enqueueConcurrentTask(queue_name, boost::bind(&Controller::restartConcurrent, this, queue_name, _line_id, _robot_id), "processRestartFinished");
+	return this->enqueueConcurrentTask("A", function_callbacks, boost::bind(&Controller::processRestartFinished, this, _line_id, _robot_id, _1, _2), resources);
 }
 
-int Controller::restartConcurrent(QString _queue_name, size_t _line_id, size_t _robot_id) {
+int Controller::restartConcurrent(size_t _line_id, size_t _robot_id) {
 	// invoke: this->machine_manager->restart(_line_id, _robot_id)
 	bool status = false;
 	QMetaObject::invokeMethod(this->machine_manager, "restart", Qt::BlockingQueuedConnection, Q_RETURN_ARG(bool, status), Q_ARG(size_t, _line_id), Q_ARG(size_t, _robot_id));
@@ -480,37 +462,30 @@ int Controller::restartConcurrent(QString _queue_name, size_t _line_id, size_t _
 	return 0;
 }
 
-void Controller::processRestartFinished(Controller::ConcurrentTask::Status _status) {
+void Controller::processRestartFinished(size_t _line_id, size_t _robot_id, Controller::ConcurrentTask::Id _task_id, Controller::ConcurrentTask::Status _status) {
 	if (_status.isSuccessful() == true) {
-		emit restartFinished(true);
+		emit restartFinished(_line_id, _robot_id, _task_id, true);
 	} else {
-		emit restartFinished(false);
+		emit restartFinished(_line_id, _robot_id, _task_id, false);
 	}
 }
 
-void Controller::processSelectMachineDialogClosed(QString _queue_name, QString _answer, QString _machine_name) {
-	std::map<QString, QWaitCondition*>::iterator wc_it = this->concurrent_task_wait_condition.find(_queue_name);
-	if (wc_it == this->concurrent_task_wait_condition.end() || wc_it->second == NULL) {
-		return;
-	}
+void Controller::processSelectMachineDialogClosed(Controller::ConcurrentTask::Id _task_id, QString _answer, QString _machine_name) {
+	// the map lock keeps the waiting task from leaving before it was woken
+	QMutexLocker locker(&this->concurrent_task_wait_states_mutex);
 
-	std::map<QString, QReadWriteLock*>::iterator wc_data_lock_it = this->concurrent_task_wait_condition_data_lock.find(_queue_name);
-	if (wc_data_lock_it == this->concurrent_task_wait_condition_data_lock.end() || wc_data_lock_it->second == NULL) {
+	std::map<Controller::ConcurrentTask::Id, ConcurrentTaskWaitState*>::iterator it = this->concurrent_task_wait_states.find(_task_id);
+	if (it == this->concurrent_task_wait_states.end()) {
 		return;
 	}
 
-	std::map<QString, ConcurrentTaskDataContainer>::iterator wc_data_it = this->concurrent_task_wait_condition_data.find(_queue_name);
-	if (wc_data_it == this->concurrent_task_wait_condition_data.end()) {
-		return;
-	}
-
-	wc_data_lock_it->second->lockForWrite();
-	wc_data_it->second.reset();
-	wc_data_it->second.setValue("ANSWER", _answer);
-	wc_data_it->second.setValue("MACHINE_NAME", _machine_name);
-	wc_data_lock_it->second->unlock();
-
-	wc_it->second->wakeOne();
+	it->second->mutex.lock();
+	it->second->data.reset();
+	it->second->data.setValue("ANSWER", _answer);
+	it->second->data.setValue("MACHINE_NAME", _machine_name);
+	it->second->answered_flag = true;
+	it->second->condition.wakeOne();
+	it->second->mutex.unlock();
 }
 
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #ifndef VM_CONTROLLER_H
 #define VM_CONTROLLER_H
 
+#include <QHash>
 #include <QObject>
 #include <QMetaObject>
 #include <QString>
@@ -8,12 +9,6 @@
 
 #include <QReadWriteLock>
 
-
-#if (QT_VERSION >= QT_VERSION_CHECK(5, 0, 0))
-#include <QtConcurrent>
-#endif
-
-#include <QFutureWatcher>
 #include <QMutex>
 #include <QWaitCondition>
 
@@ -21,10 +16,12 @@
 #include <boost/bind.hpp>
 
 #include <map>
-#include <queue>
+#include <set>
 
 #include "ApplicationError.h"
+#include "ConcurrentTaskScheduler.h"
 #include "MachineManager.h"
+#include "TaskExecutor.h"
 #include "representations\MachineRepresentation.h"
 
 namespace vm {
@@ -69,34 +66,32 @@ public:
 			std::vector<int> status_codes;
 		};
 
-		typedef boost::function<int()> GenericCallback;
+		typedef ConcurrentTaskScheduler::Id Id;
+		typedef ConcurrentTaskScheduler::Resource Resource;
 
-		ConcurrentTask() {
-			this->finished_counter = 0;
+		typedef TaskExecutor::Function GenericCallback;
+		// called in the controller thread with the id and the status codes of all callbacks of the task
+		typedef boost::function<void(Controller::ConcurrentTask::Id, Controller::ConcurrentTask::Status)> ResultCallback;
+
+		// the highest bit is never set in a robot resource
+		static Resource makeRobotResource(size_t _line_id, size_t _robot_id) {
+			return (static_cast<quint64>(_line_id & 0x7fffffff) << 32) | static_cast<quint32>(_robot_id);
 		}
 
-		~ConcurrentTask() {
-			this->function_callbacks.clear();
+		static Resource makeQueueResource(QString _queue_name) {
+			return (Q_UINT64_C(1) << 63) | qHash(_queue_name);
+		}
 
-			for (size_t i = 0; i < this->future_watchers.size(); ++i) {
-				if (this->future_watchers[i] != NULL) {
-					delete this->future_watchers[i];
-					this->future_watchers[i] = NULL;
-				}
-			}
-			this->future_watchers.clear();
+		ConcurrentTask() {
+			this->id = 0;
 		}
 
-		QString queue_name;
+		Id id;
 
+		// moved out of the task when it starts
 		std::vector<GenericCallback> function_callbacks;
-		std::vector<QFutureWatcher<int>* > future_watchers;
-
-		int finished_counter;
-
-		Controller::ConcurrentTask::Status status;
 
-		QString result_slot_name;
+		ResultCallback result_callback;
 	};
 
 	struct ConcurrentTaskDataContainer {
@@ -138,51 +133,83 @@ public:
 	void setCurrentMachineName(QString _current_machine_name);
 	QStringList retrieveAvailableMachineNames() const;
 
-	void triggerConcurrentComandProcessing(QString _queue_name);
-
-public slots:
-	void enqueueConcurrentTask(QString _queue_name, Controller::ConcurrentTask::GenericCallback _function_callback, QString _result_slot_name);
-	void enqueueConcurrentTask(QString _queue_name, std::vector<Controller::ConcurrentTask::GenericCallback> _function_callbacka, QString _result_slot_name);
-	void processConcurrentCommandFinished();
-
-	void initializeApplication();
-	int initializeApplicationConcurrent(QString _queue_name);
-	void processInitializeApplicationFinished(Controller::ConcurrentTask::Status _status);
+	// starts every queued task that has no conflict with an earlier unfinished task and whose dependencies finished
+	void triggerConcurrentComandProcessing();
 
-	void uninitializeApplication();
-	int uninitializeApplicationConcurrent(QString _queue_name);
-	void processUninitializeApplicationFinished(Controller::ConcurrentTask::Status _status);
+	// id of the task whose callback runs on the calling thread, 0 outside of a task callback
+	static Controller::ConcurrentTask::Id getCurrentConcurrentTaskId();
 
-	void enableAutomaticRead(size_t _line_id, size_t _robot_id);
-	int enableAutomaticReadConcurrent(QString _queue_name, size_t _line_id, size_t _robot_id);
-	void processEnableAutomaticReadFinished(Controller::ConcurrentTask::Status _status);
-
-	void disableAutomaticRead(size_t _line_id, size_t _robot_id);
-	int disableAutomaticReadConcurrent(QString _queue_name, size_t _line_id, size_t _robot_id);
-	void processDisableAutomaticReadFinished(Controller::ConcurrentTask::Status _status);
-
-	void restart(size_t _line_id, size_t _robot_id);
-	int restartConcurrent(QString _queue_name, size_t _line_id, size_t _robot_id);
-	void processRestartFinished(Controller::ConcurrentTask::Status _status);
-
-	void processSelectMachineDialogClosed(QString _queue_name, QString _answer, QString _machine_name);
+public slots:
+	// Tasks without resources use their queue as resource, so the tasks of one queue run in enqueue order. Tasks with
+	// resources, e.g. one robot, only wait for earlier tasks sharing one of them, for barriers and for their
+	// dependencies. Returns 0 if the task was not enqueued, e.g. for a dependency that was never returned.
+	Controller::ConcurrentTask::Id enqueueConcurrentTask(QString _queue_name, Controller::ConcurrentTask::GenericCallback _function_callback, Controller::ConcurrentTask::ResultCallback _result_callback);
+	Controller::ConcurrentTask::Id enqueueConcurrentTask(QString _queue_name, std::vector<Controller::ConcurrentTask::GenericCallback> _function_callbacks, Controller::ConcurrentTask::ResultCallback _result_callback);
+	Controller::ConcurrentTask::Id enqueueConcurrentTask(QString _queue_name, std::vector<Controller::ConcurrentTask::GenericCallback> _function_callbacks, Controller::ConcurrentTask::ResultCallback _result_callback,
+		std::vector<Controller::ConcurrentTask::Resource> _resources, std::vector<Controller::ConcurrentTask::Id> _dependencies = std::vector<Controller::ConcurrentTask::Id>());
+	// waits for all earlier tasks and blocks all later ones, e.g. initializing the application
+	Controller::ConcurrentTask::Id enqueueConcurrentBarrier(QString _queue_name, Controller::ConcurrentTask::GenericCallback _function_callback, Controller::ConcurrentTask::ResultCallback _result_callback);
+
+	// the returned id is reported again by the *Finished signal of the task
+	Controller::ConcurrentTask::Id initializeApplication();
+	int initializeApplicationConcurrent();
+	void processInitializeApplicationFinished(Controller::ConcurrentTask::Id _task_id, Controller::ConcurrentTask::Status _status);
+
+	Controller::ConcurrentTask::Id uninitializeApplication();
+	int uninitializeApplicationConcurrent();
+	void processUninitializeApplicationFinished(Controller::ConcurrentTask::Id _task_id, Controller::ConcurrentTask::Status _status);
+
+	Controller::ConcurrentTask::Id enableAutomaticRead(size_t _line_id, size_t _robot_id);
+	int enableAutomaticReadConcurrent(size_t _line_id, size_t _robot_id);
+	void processEnableAutomaticReadFinished(size_t _line_id, size_t _robot_id, Controller::ConcurrentTask::Id _task_id, Controller::ConcurrentTask::Status _status);
+
+	Controller::ConcurrentTask::Id disableAutomaticRead(size_t _line_id, size_t _robot_id);
+	int disableAutomaticReadConcurrent(size_t _line_id, size_t _robot_id);
+	void processDisableAutomaticReadFinished(size_t _line_id, size_t _robot_id, Controller::ConcurrentTask::Id _task_id, Controller::ConcurrentTask::Status _status);
+
+	Controller::ConcurrentTask::Id restart(size_t _line_id, size_t _robot_id);
+	int restartConcurrent(size_t _line_id, size_t _robot_id);
+	void processRestartFinished(size_t _line_id, size_t _robot_id, Controller::ConcurrentTask::Id _task_id, Controller::ConcurrentTask::Status _status);
+
+	// _task_id is the one of requestSelectMachineDialog()
+	void processSelectMachineDialogClosed(Controller::ConcurrentTask::Id _task_id, QString _answer, QString _machine_name);
 
 signals:
-	void initializeApplicationFinished(bool _status);
-	void uninitializeApplicationFinished(bool _status);
-	void enableAutomaticReadFinished(bool _status);
-	void disableAutomaticReadFinished(bool _status);
-	void restartFinished(bool _status);
+	void initializeApplicationFinished(Controller::ConcurrentTask::Id _task_id, bool _status);
+	void uninitializeApplicationFinished(Controller::ConcurrentTask::Id _task_id, bool _status);
+	void enableAutomaticReadFinished(size_t _line_id, size_t _robot_id, Controller::ConcurrentTask::Id _task_id, bool _status);
+	void disableAutomaticReadFinished(size_t _line_id, size_t _robot_id, Controller::ConcurrentTask::Id _task_id, bool _status);
+	void restartFinished(size_t _line_id, size_t _robot_id, Controller::ConcurrentTask::Id _task_id, bool _status);
 
 	void applicationErrorOccured(ApplicationError _application_error);
 
-	void requestSelectMachineDialog(QString _queue_name, QStringList _machine_names);
+	// the task blocks until processSelectMachineDialogClosed() is called with its id
+	void requestSelectMachineDialog(Controller::ConcurrentTask::Id _task_id, QStringList _machine_names);
 
 	void machineRepresentationChangedd(MachineRepresentation _machine_representation);
 	void robotRepresentationChangedd(RobotRepresentation _robot_representation);
 
 private:
+	// answer a blocked task waits for, owned by the waiting task
+	struct ConcurrentTaskWaitState {
+		ConcurrentTaskWaitState() {
+			this->answered_flag = false;
+		}
+
+		QMutex mutex;
+		QWaitCondition condition;
+		bool answered_flag;
+		ConcurrentTaskDataContainer data;
+	};
+
 	void addConcurrentTaskQueue(QString _queue_name);
+	Controller::ConcurrentTask::Id enqueueConcurrentTask(QString _queue_name, std::vector<Controller::ConcurrentTask::GenericCallback>& _function_callbacks, Controller::ConcurrentTask::ResultCallback& _result_callback,
+		std::vector<Controller::ConcurrentTask::Resource>& _resources, const std::vector<Controller::ConcurrentTask::Id>& _dependencies, bool _barrier_flag);
+	// continuation of a started task, runs in the controller thread
+	void processConcurrentTaskFinished(Controller::ConcurrentTask::Id _task_id, const std::vector<int>& _status_codes);
+
+	// called from the task, emits requestSelectMachineDialog() and blocks until processSelectMachineDialogClosed() answered
+	ConcurrentTaskDataContainer requestSelectMachine(Controller::ConcurrentTask::Id _task_id, QStringList _machine_names);
 
 	mutable QReadWriteLock data_lock;
 		QString prefix;
@@ -194,15 +221,21 @@ private:
 
 	MachineManager* machine_manager;
 
-	mutable QReadWriteLock concurrent_tasks_lock;
-	std::map<QString, int> concurrent_task_processing_triggerd_flag;
-	std::map<QString, std::queue<ConcurrentTask*> > concurrent_task_queues;
-
-	mutable std::map<QString, QMutex*> concurrent_task_wait_condition_mutex;
-	std::map<QString, QWaitCondition*> concurrent_task_wait_condition;
+	// tasks without a conflict run concurrently, the callbacks of one task run concurrently
+	TaskExecutor* task_executor;
+	TaskExecutor::Continuation concurrent_task_finished_callback;
 
-	mutable std::map<QString, QReadWriteLock*> concurrent_task_wait_condition_data_lock;
-	std::map<QString, ConcurrentTaskDataContainer> concurrent_task_wait_condition_data;
+	mutable QReadWriteLock concurrent_tasks_lock;
+	ConcurrentTaskScheduler concurrent_task_scheduler;
+	// callbacks of the unfinished tasks, started ones stay until their continuation ran
+	std::map<Controller::ConcurrentTask::Id, ConcurrentTask> concurrent_tasks;
+	std::set<QString> concurrent_task_queue_names;
+
+	// tasks blocked in requestSelectMachine()
+	QMutex concurrent_task_wait_states_mutex;
+	std::map<Controller::ConcurrentTask::Id, ConcurrentTaskWaitState*> concurrent_task_wait_states;
+	// set by the destructor, no task starts waiting afterwards
+	bool concurrent_task_stopping_flag;
 };
 
 }
@@ -0,0 +1,260 @@
+#include "TaskExecutor.h"
+
+#include <algorithm>
+
+namespace vm {
+
+// the worker of the calling thread, submissions from a task go to its own deque
+static thread_local TaskExecutor* current_executor = NULL;
+static thread_local std::size_t current_worker_index = 0;
+static thread_local quint64 current_context = 0;
+
+TaskExecutor::TaskExecutor(std::size_t _number_of_threads, QObject* _parent) : QObject(_parent) {
+	if (_number_of_threads == 0) {
+		_number_of_threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 4);
+	}
+
+	this->next_worker.store(0);
+	this->number_of_queued_tasks.store(0);
+	this->stop_flag.store(false);
+	this->finished_signal_pending_flag = false;
+
+	QObject::connect(this, SIGNAL(groupsFinished()), this, SLOT(processFinishedGroups()), Qt::QueuedConnection);
+
+	for (std::size_t i = 0; i < _number_of_threads; ++i) {
+		this->workers.push_back(std::unique_ptr<TaskExecutor::Worker>(new TaskExecutor::Worker()));
+	}
+
+	// started after all deques exist, a worker may steal from any of them
+	for (std::size_t i = 0; i < this->workers.size(); ++i) {
+		this->workers[i]->thread = std::thread(&TaskExecutor::run, this, i);
+	}
+}
+
+TaskExecutor::~TaskExecutor() {
+	this->idle_mutex.lock();
+	this->stop_flag.store(true);
+	this->task_available.wakeAll();
+	this->idle_mutex.unlock();
+
+	for (std::size_t i = 0; i < this->workers.size(); ++i) {
+		this->workers[i]->thread.join();
+	}
+}
+
+std::size_t TaskExecutor::getNumberOfThreads() const {
+	return this->workers.size();
+}
+
+void TaskExecutor::submit(std::vector<TaskExecutor::Function>& _functions, const TaskExecutor::Continuation& _continuation, quint64 _context) {
+	if (_functions.empty() == true) {
+		return;
+	}
+
+	TaskExecutor::Group* group = this->acquireGroup(_functions.size(), _continuation, _context);
+
+	for (std::size_t i = 0; i < _functions.size(); ++i) {
+		TaskExecutor::Task* task = this->acquireTask();
+		task->function.swap(_functions[i]);
+		task->group = group;
+		task->index = i;
+
+		this->push(task);
+	}
+}
+
+void TaskExecutor::submit(TaskExecutor::Function& _function, const TaskExecutor::Continuation& _continuation, quint64 _context) {
+	TaskExecutor::Group* group = this->acquireGroup(1, _continuation, _context);
+
+	TaskExecutor::Task* task = this->acquireTask();
+	task->function.swap(_function);
+	task->group = group;
+	task->index = 0;
+
+	this->push(task);
+}
+
+quint64 TaskExecutor::getCurrentContext() {
+	return current_context;
+}
+
+void TaskExecutor::processFinishedGroups() {
+	// both lists keep their capacity
+	this->finished_mutex.lock();
+	this->processing_groups.swap(this->finished_groups);
+	this->finished_signal_pending_flag = false;
+	this->finished_mutex.unlock();
+
+	for (std::size_t i = 0; i < this->processing_groups.size(); ++i) {
+		TaskExecutor::Group* group = this->processing_groups[i];
+
+		// a continuation may submit the next group, it gets another group from the pool
+		if (group->continuation.empty() == false) {
+			group->continuation(group->context, group->results);
+		}
+
+		this->releaseGroup(group);
+	}
+
+	this->processing_groups.clear();
+}
+
+void TaskExecutor::run(std::size_t _worker_index) {
+	current_executor = this;
+	current_worker_index = _worker_index;
+
+	while (this->stop_flag.load() == false) {
+		TaskExecutor::Task* task = this->takeTask(_worker_index);
+
+		if (task == NULL) {
+			// the counter is raised before the wake up is sent under the idle mutex, so no wake up is lost
+			QMutexLocker locker(&this->idle_mutex);
+			while (this->stop_flag.load() == false && this->number_of_queued_tasks.load() == 0) {
+				this->task_available.wait(&this->idle_mutex);
+			}
+			continue;
+		}
+
+		current_context = task->group->context;
+		task->group->results[task->index] = task->function();
+		current_context = 0;
+		this->finishTask(task);
+	}
+
+	// tasks that did not start are dropped
+	TaskExecutor::Worker* worker = this->workers[_worker_index].get();
+	QMutexLocker locker(&worker->mutex);
+	while (worker->tasks.empty() == false) {
+		this->releaseTask(worker->tasks.front());
+		worker->tasks.pop_front();
+	}
+}
+
+TaskExecutor::Task* TaskExecutor::takeTask(std::size_t _worker_index) {
+	TaskExecutor::Task* task = NULL;
+
+	// own tasks oldest first
+	TaskExecutor::Worker* worker = this->workers[_worker_index].get();
+	worker->mutex.lock();
+	if (worker->tasks.empty() == false) {
+		task = worker->tasks.front();
+		worker->tasks.pop_front();
+	}
+	worker->mutex.unlock();
+
+	// steal the newest task of the next busy worker
+	for (std::size_t i = 1; task == NULL && i < this->workers.size(); ++i) {
+		TaskExecutor::Worker* victim = this->workers[(_worker_index + i) % this->workers.size()].get();
+
+		victim->mutex.lock();
+		if (victim->tasks.empty() == false) {
+			task = victim->tasks.back();
+			victim->tasks.pop_back();
+		}
+		victim->mutex.unlock();
+	}
+
+	if (task != NULL) {
+		--this->number_of_queued_tasks;
+	}
+
+	return task;
+}
+
+void TaskExecutor::push(TaskExecutor::Task* _task) {
+	std::size_t worker_index = 0;
+	if (current_executor == this) {
+		worker_index = current_worker_index;
+	} else {
+		worker_index = this->next_worker++ % this->workers.size();
+	}
+
+	// counted before it can be taken, a thief must not decrement the counter below zero
+	++this->number_of_queued_tasks;
+
+	TaskExecutor::Worker* worker = this->workers[worker_index].get();
+	worker->mutex.lock();
+	worker->tasks.push_back(_task);
+	worker->mutex.unlock();
+
+	this->idle_mutex.lock();
+	this->task_available.wakeOne();
+	this->idle_mutex.unlock();
+}
+
+void TaskExecutor::finishTask(TaskExecutor::Task* _task) {
+	TaskExecutor::Group* group = _task->group;
+	this->releaseTask(_task);
+
+	if (--group->number_of_pending_tasks > 0) {
+		return;
+	}
+
+	bool emit_flag = false;
+
+	this->finished_mutex.lock();
+	this->finished_groups.push_back(group);
+	if (this->finished_signal_pending_flag == false) {
+		this->finished_signal_pending_flag = true;
+		emit_flag = true;
+	}
+	this->finished_mutex.unlock();
+
+	if (emit_flag == true) {
+		emit groupsFinished();
+	}
+}
+
+TaskExecutor::Task* TaskExecutor::acquireTask() {
+	QMutexLocker locker(&this->pool_mutex);
+
+	if (this->free_tasks.empty() == true) {
+		this->tasks.push_back(std::unique_ptr<TaskExecutor::Task>(new TaskExecutor::Task()));
+		return this->tasks.back().get();
+	}
+
+	TaskExecutor::Task* task = this->free_tasks.back();
+	this->free_tasks.pop_back();
+
+	return task;
+}
+
+void TaskExecutor::releaseTask(TaskExecutor::Task* _task) {
+	// releases the bound arguments now, not when the task is reused
+	_task->function.clear();
+	_task->group = NULL;
+
+	QMutexLocker locker(&this->pool_mutex);
+	this->free_tasks.push_back(_task);
+}
+
+TaskExecutor::Group* TaskExecutor::acquireGroup(std::size_t _number_of_tasks, const TaskExecutor::Continuation& _continuation, quint64 _context) {
+	TaskExecutor::Group* group = NULL;
+
+	this->pool_mutex.lock();
+	if (this->free_groups.empty() == true) {
+		this->groups.push_back(std::unique_ptr<TaskExecutor::Group>(new TaskExecutor::Group()));
+		group = this->groups.back().get();
+	} else {
+		group = this->free_groups.back();
+		this->free_groups.pop_back();
+	}
+	this->pool_mutex.unlock();
+
+	// the results keep their capacity, a continuation in the small buffer of boost::function is copied in place
+	group->context = _context;
+	group->results.assign(_number_of_tasks, 0);
+	group->number_of_pending_tasks.store(_number_of_tasks);
+	group->continuation = _continuation;
+
+	return group;
+}
+
+void TaskExecutor::releaseGroup(TaskExecutor::Group* _group) {
+	_group->continuation.clear();
+
+	QMutexLocker locker(&this->pool_mutex);
+	this->free_groups.push_back(_group);
+}
+
+}
@@ -0,0 +1,112 @@
+#ifndef VM_TASK_EXECUTOR_H
+#define VM_TASK_EXECUTOR_H
+
+#include <QObject>
+#include <QMutex>
+#include <QWaitCondition>
+
+#include <boost/function.hpp>
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace vm {
+
+// Runs groups of functions on a fixed set of worker threads and calls a continuation with their results once the
+// whole group finished. The continuation runs in the thread of the executor (the thread of its QObject).
+// Every worker has its own deque, it takes its oldest task first and steals the newest task of another worker when
+// its deque is empty. Tasks submitted from a worker go to the deque of that worker.
+// Task and group objects are pooled and keep the capacity of their storage, the functions are swapped into them. A
+// submission still allocates when a pool or a worker deque grows, or when a pooled group gets more functions than it
+// had before. Building a boost::function from a functor larger than its small buffer, e.g. a member function with
+// bound arguments, allocates once in the caller. Continuations are copied, so they should fit the buffer, e.g. a member
+// function bound to its object and placeholders only; the context tells the continuation which group finished.
+class TaskExecutor : public QObject {
+	Q_OBJECT
+public:
+	typedef boost::function<int()> Function;
+	// context of the group and one result per function, in submission order
+	typedef boost::function<void(quint64, const std::vector<int>&)> Continuation;
+
+	// _number_of_threads 0 uses one thread per core, at least 4, the functions of the controller block on other threads
+	explicit TaskExecutor(std::size_t _number_of_threads = 0, QObject* _parent = NULL);
+	// tasks that did not start are dropped with their continuations, running tasks are waited for
+	virtual ~TaskExecutor();
+
+	std::size_t getNumberOfThreads() const;
+
+	// the functions are swapped out of _functions, so bound arguments are not copied again
+	void submit(std::vector<TaskExecutor::Function>& _functions, const TaskExecutor::Continuation& _continuation, quint64 _context = 0);
+	void submit(TaskExecutor::Function& _function, const TaskExecutor::Continuation& _continuation, quint64 _context = 0);
+
+	// context of the group whose function runs on the calling thread, 0 outside of a function
+	static quint64 getCurrentContext();
+
+signals:
+	void groupsFinished();
+
+private slots:
+	void processFinishedGroups();
+
+private:
+	struct Group {
+		quint64 context;
+		std::vector<int> results;
+		std::atomic<std::size_t> number_of_pending_tasks;
+		TaskExecutor::Continuation continuation;
+	};
+
+	struct Task {
+		TaskExecutor::Function function;
+		TaskExecutor::Group* group;
+		std::size_t index;
+	};
+
+	struct Worker {
+		QMutex mutex;
+		std::deque<TaskExecutor::Task*> tasks;
+		std::thread thread;
+	};
+
+	TaskExecutor(const TaskExecutor&);
+	TaskExecutor& operator=(const TaskExecutor&);
+
+	void run(std::size_t _worker_index);
+	TaskExecutor::Task* takeTask(std::size_t _worker_index);
+	void push(TaskExecutor::Task* _task);
+	void finishTask(TaskExecutor::Task* _task);
+	TaskExecutor::Group* acquireGroup(std::size_t _number_of_tasks, const TaskExecutor::Continuation& _continuation, quint64 _context);
+
+	TaskExecutor::Task* acquireTask();
+	void releaseTask(TaskExecutor::Task* _task);
+	void releaseGroup(TaskExecutor::Group* _group);
+
+	std::vector<std::unique_ptr<TaskExecutor::Worker> > workers;
+	std::atomic<std::size_t> next_worker;
+
+	// workers sleep here when no deque has a task
+	QMutex idle_mutex;
+	QWaitCondition task_available;
+	std::atomic<std::size_t> number_of_queued_tasks;
+	std::atomic<bool> stop_flag;
+
+	QMutex pool_mutex;
+	std::vector<TaskExecutor::Task*> free_tasks;
+	std::vector<TaskExecutor::Group*> free_groups;
+	std::vector<std::unique_ptr<TaskExecutor::Task> > tasks;
+	std::vector<std::unique_ptr<TaskExecutor::Group> > groups;
+
+	// groups whose continuation did not run yet, groupsFinished() is queued once until they are processed
+	QMutex finished_mutex;
+	std::vector<TaskExecutor::Group*> finished_groups;
+	bool finished_signal_pending_flag;
+	// only used by processFinishedGroups()
+	std::vector<TaskExecutor::Group*> processing_groups;
+};
+
+}
+
+#endif /* VM_TASK_EXECUTOR_H */
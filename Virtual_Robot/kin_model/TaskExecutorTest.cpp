@@ -0,0 +1,76 @@
+#include <QCoreApplication>
+
+#include <boost/bind.hpp>
+
+#include <iostream>
+#include <vector>
+
+#include "TaskExecutor.h"
+
+using namespace vm;
+
+struct Receiver {
+	Receiver() {
+		this->number_of_finished_groups = 0;
+		this->passed_flag = true;
+	}
+
+	// every result is the context of its group times 10 plus the index of its function
+	void processGroupFinished(quint64 _context, const std::vector<int>& _results) {
+		for (std::size_t i = 0; i < _results.size(); ++i) {
+			if (_results[i] != static_cast<int>(_context * 10 + i)) {
+				std::cerr << "group " << _context << " has a wrong result " << _results[i] << " at " << i << std::endl;
+				this->passed_flag = false;
+			}
+		}
+
+		++this->number_of_finished_groups;
+	}
+
+	std::size_t number_of_finished_groups;
+	bool passed_flag;
+};
+
+static int computeResult(int _index) {
+	return static_cast<int>(TaskExecutor::getCurrentContext() * 10) + _index;
+}
+
+int main(int argc, char** argv) {
+	QCoreApplication application(argc, argv);
+
+	TaskExecutor executor(4);
+	Receiver receiver;
+	TaskExecutor::Continuation continuation = boost::bind(&Receiver::processGroupFinished, &receiver, _1, _2);
+
+	const std::size_t number_of_groups = 1000;
+	std::vector<TaskExecutor::Function> functions;
+
+	for (std::size_t i = 1; i <= number_of_groups; ++i) {
+		for (std::size_t j = 0; j < 1 + i % 4; ++j) {
+			functions.push_back(boost::bind(&computeResult, static_cast<int>(j)));
+		}
+
+		executor.submit(functions, continuation, i);
+
+		if (functions.size() != 1 + i % 4 || functions[0].empty() == false) {
+			std::cerr << "the functions were not swapped out" << std::endl;
+			return 1;
+		}
+		functions.clear();
+	}
+
+	TaskExecutor::Function function = boost::bind(&computeResult, 0);
+	executor.submit(function, continuation, number_of_groups + 1);
+
+	// the continuations run in this thread
+	while (receiver.number_of_finished_groups < number_of_groups + 1) {
+		QCoreApplication::processEvents();
+	}
+
+	if (TaskExecutor::getCurrentContext() != 0) {
+		std::cerr << "a context is set outside of a function" << std::endl;
+		return 1;
+	}
+
+	return receiver.passed_flag == true ? 0 : 1;
+}
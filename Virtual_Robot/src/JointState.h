@@ -0,0 +1,28 @@
+#ifndef VM_JOINT_STATE_H
+#define VM_JOINT_STATE_H
+
+#include <cstdint>
+
+namespace vm {
+
+// Plain joint state sample as published to live consumers, angles in the units of RobotJointAngles (J1 .. J8)
+struct JointState {
+	JointState() {
+		this->sequence = 0;
+		this->timestamp = 0;
+		for (int i = 0; i < 8; ++i) {
+			this->angles[i] = 0;
+		}
+	}
+
+	std::uint64_t sequence;
+
+	// milliseconds since epoch
+	std::int64_t timestamp;
+
+	double angles[8];
+};
+
+}
+
+#endif /* VM_JOINT_STATE_H */
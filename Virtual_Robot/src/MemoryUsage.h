@@ -0,0 +1,37 @@
+#ifndef VM_MEMORY_USAGE_H
+#define VM_MEMORY_USAGE_H
+
+#include <QString>
+#include <QStringList>
+
+#include <cstddef>
+
+namespace vm {
+
+// Estimates for RobotMemoryStats, implicitly shared buffers are counted with every owner.
+
+// header and characters of the string buffer, empty strings share a static buffer
+inline std::size_t getHeapMemoryUsage(const QString& _string) {
+	if (_string.capacity() == 0) {
+		return 0;
+	}
+
+	return 3 * sizeof(void*) + (_string.capacity() + 1) * sizeof(QChar);
+}
+
+inline std::size_t getHeapMemoryUsage(const QStringList& _strings) {
+	std::size_t number_of_bytes = (_strings.isEmpty() == true) ? 0 : 2 * sizeof(void*) + _strings.size() * sizeof(void*);
+
+	for (int i = 0; i < _strings.size(); ++i) {
+		number_of_bytes += sizeof(QString) + getHeapMemoryUsage(_strings[i]);
+	}
+
+	return number_of_bytes;
+}
+
+// node of a std::map (color, parent, left, right) without the value
+static const std::size_t MAP_NODE_SIZE = 4 * sizeof(void*);
+
+}
+
+#endif /* VM_MEMORY_USAGE_H */
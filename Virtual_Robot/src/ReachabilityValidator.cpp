@@ -0,0 +1,283 @@
+#include "ReachabilityValidator.h"
+
+#include <QFuture>
+#include <QList>
+#include <QtConcurrent>
+#include <rl/math/Transform.h>
+#include <rl/math/Unit.h>
+#include <rl/mdl/NloptInverseKinematics.h>
+#include <rl/mdl/XmlFactory.h>
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+namespace vm {
+
+ReachabilityValidator::ReachabilityValidator() {
+	this->singularity_threshold = 1.0e-4;
+	this->ik_duration = std::chrono::milliseconds(100);
+}
+
+ReachabilityValidator::~ReachabilityValidator() {
+}
+
+bool ReachabilityValidator::load(const std::string& _kinematics_file, std::size_t _number_of_threads) {
+	this->kinematics.clear();
+	this->free_kinematics.clear();
+	this->clearCache();
+
+	if (_number_of_threads == 0) {
+		_number_of_threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+	}
+
+	rl::mdl::XmlFactory factory;
+
+	// the models keep the current configuration, every thread needs its own
+	for (std::size_t i = 0; i < _number_of_threads; ++i) {
+		std::unique_ptr<rl::mdl::Kinematic> kinematic(dynamic_cast<rl::mdl::Kinematic*>(factory.create(_kinematics_file)));
+		if (kinematic == NULL) {
+			this->kinematics.clear();
+			this->free_kinematics.clear();
+			return false;
+		}
+
+		this->free_kinematics.push_back(kinematic.get());
+		this->kinematics.push_back(std::move(kinematic));
+	}
+
+	return true;
+}
+
+bool ReachabilityValidator::isLoaded() const {
+	return this->kinematics.empty() == false;
+}
+
+std::size_t ReachabilityValidator::validate(const std::vector<ReachabilityValidator::Point>& _points, std::vector<ReachabilityValidator::Result>& _results) {
+	_results.resize(_points.size());
+
+	// points to check, equal values in the list are checked once
+	std::vector<std::size_t> work;
+	std::unordered_map<ReachabilityValidator::CacheKey, std::size_t, ReachabilityValidator::CacheKeyHash> first_points;
+	std::vector<std::pair<std::size_t, std::size_t> > duplicates;
+
+	QMutexLocker locker(&this->cache_mutex);
+
+	for (std::size_t i = 0; i < _points.size(); ++i) {
+		ReachabilityValidator::CacheKey key = this->makeCacheKey(_points[i]);
+
+		ReachabilityValidator::Cache::const_iterator it = this->cache.find(key);
+		if (it != this->cache.end()) {
+			_results[i] = it->second;
+			continue;
+		}
+
+		std::pair<std::unordered_map<ReachabilityValidator::CacheKey, std::size_t, ReachabilityValidator::CacheKeyHash>::iterator, bool> inserted = first_points.insert(std::make_pair(key, i));
+		if (inserted.second == true) {
+			work.push_back(i);
+		} else {
+			duplicates.push_back(std::make_pair(i, inserted.first->second));
+		}
+	}
+
+	locker.unlock();
+
+	if (work.empty() == false && this->isLoaded() == true) {
+		// workers take the next point, inverse kinematics times differ a lot between points
+		std::atomic<std::size_t> next_work(0);
+		QList<QFuture<void> > futures;
+
+		for (std::size_t i = 0; i < this->kinematics.size() && i < work.size(); ++i) {
+			futures.append(QtConcurrent::run([this, &_points, &_results, &work, &next_work]() {
+				// another validation may hold some of the models, the worker waits for one
+				rl::mdl::Kinematic* kinematic = this->acquireKinematic();
+
+				for (std::size_t j = next_work++; j < work.size(); j = next_work++) {
+					_results[work[j]] = this->check(kinematic, _points[work[j]]);
+				}
+
+				this->releaseKinematic(kinematic);
+			}));
+		}
+
+		for (int i = 0; i < futures.size(); ++i) {
+			futures[i].waitForFinished();
+		}
+
+		locker.relock();
+
+		for (std::size_t i = 0; i < work.size(); ++i) {
+			this->cache[this->makeCacheKey(_points[work[i]])] = _results[work[i]];
+		}
+
+		locker.unlock();
+	} else if (work.empty() == false) {
+		// no model, nothing can be reached
+		for (std::size_t i = 0; i < work.size(); ++i) {
+			_results[work[i]].status = ReachabilityValidator::STATUS_UNREACHABLE;
+			_results[work[i]].joint = -1;
+			_results[work[i]].manipulability = 0.0;
+		}
+	}
+
+	for (std::size_t i = 0; i < duplicates.size(); ++i) {
+		_results[duplicates[i].first] = _results[duplicates[i].second];
+	}
+
+	std::size_t number_of_problems = 0;
+	for (std::size_t i = 0; i < _results.size(); ++i) {
+		if (_results[i].status != ReachabilityValidator::STATUS_OK) {
+			++number_of_problems;
+		}
+	}
+
+	return number_of_problems;
+}
+
+void ReachabilityValidator::clearCache() {
+	QMutexLocker locker(&this->cache_mutex);
+	this->cache.clear();
+}
+
+std::size_t ReachabilityValidator::getCacheSize() const {
+	QMutexLocker locker(&this->cache_mutex);
+	return this->cache.size();
+}
+
+bool ReachabilityValidator::CacheKey::operator==(const ReachabilityValidator::CacheKey& _other) const {
+	return this->type == _other.type && std::memcmp(this->values, _other.values, sizeof(this->values)) == 0 && this->ik_duration == _other.ik_duration;
+}
+
+std::size_t ReachabilityValidator::CacheKeyHash::operator()(const ReachabilityValidator::CacheKey& _key) const {
+	// FNV-1a over the type and the value bits
+	std::uint64_t hash = 14695981039346656037ULL;
+
+	const unsigned char* bytes = reinterpret_cast<const unsigned char*>(_key.values);
+	for (std::size_t i = 0; i < sizeof(_key.values); ++i) {
+		hash = (hash ^ bytes[i]) * 1099511628211ULL;
+	}
+
+	hash = (hash ^ static_cast<std::uint64_t>(_key.ik_duration)) * 1099511628211ULL;
+
+	return static_cast<std::size_t>((hash ^ static_cast<std::uint64_t>(_key.type)) * 1099511628211ULL);
+}
+
+ReachabilityValidator::CacheKey ReachabilityValidator::makeCacheKey(const ReachabilityValidator::Point& _point) const {
+	ReachabilityValidator::CacheKey key;
+	key.type = _point.type;
+	key.ik_duration = 0;
+
+	for (int i = 0; i < 8; ++i) {
+		// -0.0 and 0.0 are the same point
+		key.values[i] = (_point.values[i] == 0.0) ? 0.0 : _point.values[i];
+	}
+
+	// the configuration flags are not checked
+	if (_point.type == RobotChangeSet::VARIABLE_POSE) {
+		key.values[6] = 0.0;
+		key.values[7] = 0.0;
+		// a longer time limit may solve a pose that was unreachable before
+		key.ik_duration = this->ik_duration.count();
+	}
+
+	return key;
+}
+
+rl::mdl::Kinematic* ReachabilityValidator::acquireKinematic() {
+	QMutexLocker locker(&this->kinematics_mutex);
+
+	while (this->free_kinematics.empty() == true) {
+		this->kinematic_released.wait(&this->kinematics_mutex);
+	}
+
+	rl::mdl::Kinematic* kinematic = this->free_kinematics.back();
+	this->free_kinematics.pop_back();
+
+	return kinematic;
+}
+
+void ReachabilityValidator::releaseKinematic(rl::mdl::Kinematic* _kinematic) {
+	QMutexLocker locker(&this->kinematics_mutex);
+
+	this->free_kinematics.push_back(_kinematic);
+	this->kinematic_released.wakeOne();
+}
+
+ReachabilityValidator::Result ReachabilityValidator::check(rl::mdl::Kinematic* _kinematic, const ReachabilityValidator::Point& _point) const {
+	ReachabilityValidator::Result result;
+	result.status = ReachabilityValidator::STATUS_OK;
+	result.joint = -1;
+	result.manipulability = 0.0;
+
+	std::size_t dof = std::min<std::size_t>(_kinematic->getDof(), 8);
+
+	if (_point.type == RobotChangeSet::VARIABLE_JOINT_ANGLES) {
+		rl::math::Vector q(_kinematic->getDof());
+		q.setZero();
+		for (std::size_t i = 0; i < dof; ++i) {
+			q(i) = _point.values[i] * rl::math::DEG2RAD;
+		}
+
+		rl::math::Vector minimum = _kinematic->getMinimum();
+		rl::math::Vector maximum = _kinematic->getMaximum();
+
+		for (std::size_t i = 0; i < dof; ++i) {
+			if (q(i) < minimum(i) || q(i) > maximum(i)) {
+				result.status = ReachabilityValidator::STATUS_JOINT_LIMIT;
+				result.joint = static_cast<int>(i);
+				return result;
+			}
+		}
+
+		_kinematic->setPosition(q);
+		_kinematic->forwardPosition();
+	} else if (_point.type == RobotChangeSet::VARIABLE_POSE) {
+		rl::math::Transform goal;
+		goal.setIdentity();
+		goal.linear() = (
+			rl::math::AngleAxis(_point.values[5] * rl::math::DEG2RAD, rl::math::Vector3::UnitZ()) *
+			rl::math::AngleAxis(_point.values[4] * rl::math::DEG2RAD, rl::math::Vector3::UnitY()) *
+			rl::math::AngleAxis(_point.values[3] * rl::math::DEG2RAD, rl::math::Vector3::UnitX())
+		).toRotationMatrix();
+		goal.translation() = rl::math::Vector3(_point.values[0], _point.values[1], _point.values[2]) / 1000.0;
+
+		// starts from the previous solution of this model, neighbouring points of a program are close
+		rl::mdl::NloptInverseKinematics ik(_kinematic);
+		ik.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(this->ik_duration);
+		ik.goals.push_back(std::make_pair(goal, 0));
+
+		if (ik.solve() == false) {
+			// the previous solution may be far away, the middle of the joint ranges does not depend on earlier points
+			rl::math::Vector minimum = _kinematic->getMinimum();
+			rl::math::Vector maximum = _kinematic->getMaximum();
+			rl::math::Vector q(_kinematic->getDof());
+			for (std::size_t i = 0; i < _kinematic->getDof(); ++i) {
+				q(i) = (std::isfinite(minimum(i)) == true && std::isfinite(maximum(i)) == true) ? 0.5 * (minimum(i) + maximum(i)) : 0.0;
+			}
+			_kinematic->setPosition(q);
+
+			if (ik.solve() == false) {
+				// a time limited search is no proof, the point is cached for this time limit only
+				result.status = ReachabilityValidator::STATUS_UNREACHABLE;
+				return result;
+			}
+		}
+
+		_kinematic->forwardPosition();
+	} else {
+		return result;
+	}
+
+	_kinematic->calculateJacobian();
+	result.manipulability = _kinematic->calculateManipulabilityMeasure();
+
+	if (result.manipulability < this->singularity_threshold) {
+		result.status = ReachabilityValidator::STATUS_NEAR_SINGULAR;
+	}
+
+	return result;
+}
+
+}
@@ -0,0 +1,108 @@
+#ifndef VM_REACHABILITY_VALIDATOR_H
+#define VM_REACHABILITY_VALIDATOR_H
+
+#include <QMutex>
+#include <QString>
+#include <QWaitCondition>
+#include <rl/mdl/Kinematic.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "RobotChangeSet.h"
+
+namespace vm {
+
+// Checks taught points against a kinematic model in parallel.
+// Joint angles variables are checked against the joint limits, poses are solved with inverse kinematics, both are
+// reported as near singular if the manipulability at the configuration is below singularity_threshold.
+// Every worker borrows a model of its own, concurrent validations share the models. Results are cached by value, so
+// unchanged points are not checked again. A pose the inverse kinematics did not solve in time is cached together with
+// ik_duration and only checked again with a longer limit.
+// The inverse kinematics starts from the previous solution of the model, so the manipulability of a pose is the one of
+// the solution found first; a cached STATUS_NEAR_SINGULAR pose may have other solutions that are not near a singularity.
+class ReachabilityValidator {
+public:
+	enum Status {
+		STATUS_OK,
+		STATUS_UNREACHABLE,
+		STATUS_NEAR_SINGULAR,
+		STATUS_JOINT_LIMIT
+	};
+
+	// joint angles J1 .. J8 in degrees, poses X, Y, Z in millimeters, A, B, C in degrees (rotations about x, y, z),
+	// the configuration flags F1 and F2 are not checked
+	struct Point {
+		RobotChangeSet::VariableType type;
+		QString program_name;
+		QString variable_name;
+		unsigned int variable_index;
+		double values[8];
+	};
+
+	struct Result {
+		ReachabilityValidator::Status status;
+		// joint outside of its limits, -1 otherwise
+		int joint;
+		// at the given or solved configuration, 0 if unreachable
+		double manipulability;
+	};
+
+	ReachabilityValidator();
+	virtual ~ReachabilityValidator();
+
+	// _number_of_threads 0 uses one model per hardware thread, not while validate() runs
+	bool load(const std::string& _kinematics_file, std::size_t _number_of_threads = 0);
+	bool isLoaded() const;
+
+	// one result per point, returns the number of points that are not STATUS_OK
+	std::size_t validate(const std::vector<ReachabilityValidator::Point>& _points, std::vector<ReachabilityValidator::Result>& _results);
+
+	// the cache does not depend on singularity_threshold, clear it after changing it
+	void clearCache();
+	std::size_t getCacheSize() const;
+
+	double singularity_threshold;
+	// time limit of the inverse kinematics of one pose, not while validate() runs
+	std::chrono::steady_clock::duration ik_duration;
+
+private:
+	struct CacheKey {
+		bool operator==(const ReachabilityValidator::CacheKey& _other) const;
+
+		RobotChangeSet::VariableType type;
+		double values[8];
+		// time limit the result was found with, 0 for joint angles
+		std::chrono::steady_clock::rep ik_duration;
+	};
+
+	struct CacheKeyHash {
+		std::size_t operator()(const ReachabilityValidator::CacheKey& _key) const;
+	};
+
+	typedef std::unordered_map<ReachabilityValidator::CacheKey, ReachabilityValidator::Result, ReachabilityValidator::CacheKeyHash> Cache;
+
+	ReachabilityValidator::CacheKey makeCacheKey(const ReachabilityValidator::Point& _point) const;
+
+	ReachabilityValidator::Result check(rl::mdl::Kinematic* _kinematic, const ReachabilityValidator::Point& _point) const;
+
+	// blocks until a model is free
+	rl::mdl::Kinematic* acquireKinematic();
+	void releaseKinematic(rl::mdl::Kinematic* _kinematic);
+
+	std::vector<std::unique_ptr<rl::mdl::Kinematic> > kinematics;
+
+	QMutex kinematics_mutex;
+	QWaitCondition kinematic_released;
+	std::vector<rl::mdl::Kinematic*> free_kinematics;
+
+	mutable QMutex cache_mutex;
+	ReachabilityValidator::Cache cache;
+};
+
+}
+
+#endif /* VM_REACHABILITY_VALIDATOR_H */
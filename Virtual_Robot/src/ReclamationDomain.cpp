@@ -0,0 +1,75 @@
+#include "ReclamationDomain.h"
+
+namespace vm {
+
+ReclamationDomain::ReadGuard::ReadGuard(const ReclamationDomain* _domain) {
+	this->domain = _domain;
+
+	// sequentially consistent, a reader that raced with an epoch change counts itself in the new epoch
+	for (;;) {
+		unsigned long long epoch = this->domain->epoch.load();
+		this->parity = static_cast<int>(epoch & 1);
+		this->domain->number_of_readers[this->parity].fetch_add(1);
+
+		if (this->domain->epoch.load() == epoch) {
+			break;
+		}
+
+		this->domain->number_of_readers[this->parity].fetch_sub(1);
+	}
+}
+
+ReclamationDomain::ReadGuard::~ReadGuard() {
+	this->domain->number_of_readers[this->parity].fetch_sub(1);
+}
+
+ReclamationDomain::ReclamationDomain() {
+	this->epoch.store(1);
+	this->number_of_readers[0].store(0);
+	this->number_of_readers[1].store(0);
+}
+
+ReclamationDomain::~ReclamationDomain() {
+	for (std::size_t i = 0; i < this->retired.size(); ++i) {
+		this->retired[i].deleter();
+	}
+}
+
+void ReclamationDomain::retire(const std::function<void()>& _deleter) {
+	ReclamationDomain::Retired retired_object;
+	retired_object.epoch = this->epoch.load();
+	retired_object.deleter = _deleter;
+
+	this->retired.push_back(retired_object);
+}
+
+void ReclamationDomain::collect() {
+	if (this->retired.empty() == true) {
+		return;
+	}
+
+	// the readers of the previous epoch have left, advance so that the current ones become the previous ones
+	unsigned long long current_epoch = this->epoch.load();
+	if (this->number_of_readers[(current_epoch - 1) & 1].load() != 0) {
+		return;
+	}
+
+	this->epoch.store(current_epoch + 1);
+
+	// objects retired before the current epoch were unlinked before any remaining reader entered
+	std::size_t kept = 0;
+	for (std::size_t i = 0; i < this->retired.size(); ++i) {
+		if (this->retired[i].epoch < current_epoch) {
+			this->retired[i].deleter();
+		} else {
+			this->retired[kept++] = this->retired[i];
+		}
+	}
+	this->retired.resize(kept);
+}
+
+std::size_t ReclamationDomain::getNumberOfRetired() const {
+	return this->retired.size();
+}
+
+}
@@ -0,0 +1,66 @@
+#ifndef VM_RECLAMATION_DOMAIN_H
+#define VM_RECLAMATION_DOMAIN_H
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+namespace vm {
+
+// Deferred deletion of tables replaced by a writer while readers may still use them.
+// Readers announce themselves with a ReadGuard (an atomic increment of the counter of the current epoch, never blocks).
+// An object retired in epoch e is deleted by the writer once the readers of epoch e have left,
+// a steady stream of new readers does not hold back the reclamation.
+class ReclamationDomain {
+public:
+	class ReadGuard {
+	public:
+		explicit ReadGuard(const ReclamationDomain* _domain);
+		~ReadGuard();
+
+	private:
+		ReadGuard(const ReadGuard&);
+		ReadGuard& operator=(const ReadGuard&);
+
+		const ReclamationDomain* domain;
+		int parity;
+	};
+
+	ReclamationDomain();
+	~ReclamationDomain();
+
+	// writer side, writers are serialized by the owner
+	template<typename T>
+	void retire(T* _object) {
+		this->retire(std::function<void()>([_object]() { delete _object; }));
+	}
+
+	template<typename T>
+	void retireArray(T* _objects) {
+		this->retire(std::function<void()>([_objects]() { delete[] _objects; }));
+	}
+
+	void retire(const std::function<void()>& _deleter);
+
+	// deletes the retired objects no reader can see anymore, called after the replacement was published
+	void collect();
+
+	std::size_t getNumberOfRetired() const;
+
+private:
+	ReclamationDomain(const ReclamationDomain&);
+	ReclamationDomain& operator=(const ReclamationDomain&);
+
+	struct Retired {
+		unsigned long long epoch;
+		std::function<void()> deleter;
+	};
+
+	std::atomic<unsigned long long> epoch;
+	mutable std::atomic<int> number_of_readers[2];
+	std::vector<ReclamationDomain::Retired> retired;
+};
+
+}
+
+#endif /* VM_RECLAMATION_DOMAIN_H */
@@ -1,63 +1,98 @@
 #include "Robot.h"
 
+#include <QDateTime>
+
+#include <algorithm>
+#include <cmath>
+
 namespace vm {
 
+// clamps to [_min_value, _max_value] and snaps to the nearest step counted from _min_value
+static int quantizeValue(int _value, int _min_value, int _max_value, int _step_size) {
+	int value = std::min(std::max(_min_value, _value), _max_value);
+
+	if (_step_size > 0) {
+		long long steps = std::llround(static_cast<double>(static_cast<long long>(value) - _min_value) / _step_size);
+		long long snapped_value = _min_value + steps * _step_size;
+		if (snapped_value > _max_value) {
+			snapped_value -= _step_size;
+		}
+		value = static_cast<int>(snapped_value);
+	}
+
+	return value;
+}
+
+static double quantizeValue(double _value, double _min_value, double _max_value, double _step_size) {
+	double value = std::min(std::max(_min_value, _value), _max_value);
+
+	if (_step_size > 0.0) {
+		value = _min_value + std::floor((value - _min_value) / _step_size + 0.5) * _step_size;
+		if (value > _max_value) {
+			value -= _step_size;
+		}
+	}
+
+	return value;
+}
+
 Robot::Attribute::Attribute() {
 	this->reset();
 }
 
 void Robot::Attribute::reset() {
 	this->value_type = Robot::Attribute::TYPE_UNKNOWN;
-	this->default_value = QVariant();
-	this->min_value = QVariant();
-	this->max_value = QVariant();
-	this->step_size = QVariant();
 	this->read_only_flag = false;
+
+	this->int_value = 0;
+	this->int_default_value = 0;
+	this->int_min_value = 0;
+	this->int_max_value = 0;
+	this->int_step_size = 0;
+
+	this->real_value = 0.0;
+	this->real_default_value = 0.0;
+	this->real_min_value = 0.0;
+	this->real_max_value = 0.0;
+	this->real_step_size = 0.0;
+
+	this->string_value.clear();
+	this->string_default_value.clear();
+	this->enum_values.clear();
 }
 
 void Robot::Attribute::initValueAsInt(int _default_value, int _min_value, int _max_value, int _step_size) {
 	this->value_type = Robot::Attribute::TYPE_INT;
-	this->default_value = _default_value;
-	this->min_value = _min_value;
-	this->max_value = _max_value;
-	this->step_size = _step_size;
+	this->int_default_value = _default_value;
+	this->int_min_value = _min_value;
+	this->int_max_value = std::max(_min_value, _max_value);
+	this->int_step_size = std::max(_step_size, 0);
 
-	this->setValue(this->default_value);
+	this->setIntValue(this->int_default_value);
 }
 
 void Robot::Attribute::initValueAsReal(double _default_value, double _min_value, double _max_value, double _step_size) {
 	this->value_type = Robot::Attribute::TYPE_REAL;
-	this->default_value = _default_value;
-	this->min_value = _min_value;
-	this->max_value = _max_value;
-	this->step_size = _step_size;
+	this->real_default_value = _default_value;
+	this->real_min_value = _min_value;
+	this->real_max_value = std::max(_min_value, _max_value);
+	this->real_step_size = std::max(_step_size, 0.0);
 
-	this->setValue(this->default_value);
+	this->setRealValue(this->real_default_value);
 }
 
 void Robot::Attribute::initValueAsString(const QString& _default_value) {
 	this->value_type = Robot::Attribute::TYPE_STRING;
-	this->default_value = _default_value;
-	this->min_value = QVariant();
-	this->max_value = QVariant();
-	this->step_size = QVariant();
+	this->string_default_value = _default_value;
 
-	this->setValue(this->default_value);
+	this->setStringValue(this->string_default_value);
 }
 
 void Robot::Attribute::initValueAsEnum(const QStringList& _value_list) {
 	this->value_type = Robot::Attribute::TYPE_ENUM;
-	this->default_value = _value_list;
-	this->min_value = QVariant();
-	this->max_value = QVariant();
-	this->step_size = QVariant();
+	this->enum_values = _value_list;
 
-	if (_value_list.size() > 0) {
-		this->setValue(_value_list[0]);
-	}
-	else {
-		this->setValue(QVariant());
-	}
+	this->int_value = (this->enum_values.size() > 0) ? 0 : -1;
 }
 
 QString Robot::Attribute::getName() const {
@@ -84,105 +119,281 @@ void Robot::Attribute::setValueType(Robot::Attribute::ValueType _value_type) {
 	this->value_type = _value_type;
 }
 
-QVariant Robot::Attribute::getValue() const {
-	QVariant temp;
+int Robot::Attribute::getIntValue() const {
+	return this->int_value;
+}
 
-	switch (this->value_type) {
-	case TYPE_ENUM: {
-		QString current_value = this->value.toString();
+bool Robot::Attribute::setIntValue(int _value) {
+	if (this->value_type != Robot::Attribute::TYPE_INT) {
+		return false;
+	}
 
-		QStringList value_list = this->default_value.toStringList();
-		if (value_list.contains(current_value) == true) {
-			temp = this->value;
-		}
-		else {
-			temp = QVariant("");
-		}
-		break;
+	this->int_value = quantizeValue(_value, this->int_min_value, this->int_max_value, this->int_step_size);
+	return true;
+}
+
+double Robot::Attribute::getRealValue() const {
+	return this->real_value;
+}
+
+bool Robot::Attribute::setRealValue(double _value) {
+	if (this->value_type != Robot::Attribute::TYPE_REAL) {
+		return false;
 	}
-	case TYPE_INT: {
-		int current_value = this->value.toInt();
-		int min_value = this->min_value.toInt();
-		int max_value = this->max_value.toInt();
-		int step_size = this->step_size.toInt();
 
-		current_value = std::min(std::max(min_value, current_value), max_value);
-		if (step_size != 0) {
-			//TODO correct value depending on current value of step_size
-		}
+	this->real_value = quantizeValue(_value, this->real_min_value, this->real_max_value, this->real_step_size);
+	return true;
+}
 
-		temp = QVariant(current_value);
+const QString& Robot::Attribute::getStringValue() const {
+	return this->string_value;
+}
 
-		break;
+bool Robot::Attribute::setStringValue(const QString& _value) {
+	if (this->value_type != Robot::Attribute::TYPE_STRING) {
+		return false;
 	}
-	case TYPE_REAL: {
-		double current_value = this->value.toDouble();
-		double min_value = this->min_value.toDouble();
-		double max_value = this->max_value.toDouble();
-		double step_size = this->step_size.toDouble();
 
-		current_value = std::min(std::max(min_value, current_value), max_value);
-		if (step_size != 0.0) {
-			//TODO correct value depending on current value of step_size
-		}
+	this->string_value = _value;
+	return true;
+}
 
-		temp = QVariant(current_value);
-		break;
+int Robot::Attribute::getEnumIndex() const {
+	return this->int_value;
+}
+
+bool Robot::Attribute::setEnumIndex(int _index) {
+	if (this->value_type != Robot::Attribute::TYPE_ENUM || _index < 0 || _index >= this->enum_values.size()) {
+		return false;
 	}
-	case TYPE_STRING: {
-		temp = value;
-		break;
+
+	this->int_value = _index;
+	return true;
+}
+
+const QString& Robot::Attribute::getEnumValue() const {
+	static const QString empty_value;
+
+	if (this->int_value < 0 || this->int_value >= this->enum_values.size()) {
+		return empty_value;
 	}
+
+	return this->enum_values[this->int_value];
+}
+
+bool Robot::Attribute::setEnumValue(const QString& _value) {
+	if (this->value_type != Robot::Attribute::TYPE_ENUM) {
+		return false;
 	}
 
-	return temp;
+	return this->setEnumIndex(this->enum_values.indexOf(_value));
+}
+
+const QStringList& Robot::Attribute::getEnumValues() const {
+	return this->enum_values;
+}
+
+QVariant Robot::Attribute::getValue() const {
+	switch (this->value_type) {
+	case TYPE_ENUM:
+		return QVariant(this->getEnumValue());
+	case TYPE_INT:
+		return QVariant(this->int_value);
+	case TYPE_REAL:
+		return QVariant(this->real_value);
+	case TYPE_STRING:
+		return QVariant(this->string_value);
+	default:
+		return QVariant();
+	}
 }
 
-void Robot::Attribute::setValue(const QVariant& _value) {
-	this->value = _value;
+bool Robot::Attribute::setValue(const QVariant& _value) {
+	switch (this->value_type) {
+	case TYPE_ENUM:
+		return _value.type() == QVariant::String && this->setEnumValue(_value.toString());
+	case TYPE_INT:
+		return _value.type() == QVariant::Int && this->setIntValue(_value.toInt());
+	case TYPE_REAL:
+		return _value.type() == QVariant::Double && this->setRealValue(_value.toDouble());
+	case TYPE_STRING:
+		return _value.type() == QVariant::String && this->setStringValue(_value.toString());
+	default:
+		return false;
+	}
 }
 
 QVariant Robot::Attribute::getDefaultValue() const {
-	return this->default_value;
+	switch (this->value_type) {
+	case TYPE_ENUM:
+		return QVariant(this->enum_values);
+	case TYPE_INT:
+		return QVariant(this->int_default_value);
+	case TYPE_REAL:
+		return QVariant(this->real_default_value);
+	case TYPE_STRING:
+		return QVariant(this->string_default_value);
+	default:
+		return QVariant();
+	}
 }
 
 void Robot::Attribute::setDefaultValue(const QVariant& _default_value) {
-	this->default_value = _default_value;
+	switch (this->value_type) {
+	case TYPE_ENUM: {
+		// keeps the current value if it is still in the list
+		QString current_value = this->getEnumValue();
+		this->enum_values = _default_value.toStringList();
+		if (this->setEnumValue(current_value) == false) {
+			this->int_value = (this->enum_values.size() > 0) ? 0 : -1;
+		}
+		break;
+	}
+	case TYPE_INT:
+		this->int_default_value = _default_value.toInt();
+		break;
+	case TYPE_REAL:
+		this->real_default_value = _default_value.toDouble();
+		break;
+	case TYPE_STRING:
+		this->string_default_value = _default_value.toString();
+		break;
+	default:
+		break;
+	}
 }
 
 QVariant Robot::Attribute::getMinValue() const {
-	return this->min_value;
+	switch (this->value_type) {
+	case TYPE_INT:
+		return QVariant(this->int_min_value);
+	case TYPE_REAL:
+		return QVariant(this->real_min_value);
+	default:
+		return QVariant();
+	}
 }
 
 void Robot::Attribute::setMinValue(const QVariant& _min_value) {
-	this->min_value = min_value;
+	// the current value is validated against the new range
+	if (this->value_type == TYPE_INT) {
+		this->int_min_value = _min_value.toInt();
+		this->int_max_value = std::max(this->int_min_value, this->int_max_value);
+		this->setIntValue(this->int_value);
+	} else if (this->value_type == TYPE_REAL) {
+		this->real_min_value = _min_value.toDouble();
+		this->real_max_value = std::max(this->real_min_value, this->real_max_value);
+		this->setRealValue(this->real_value);
+	}
 }
 
 QVariant Robot::Attribute::getMaxValue() const {
-	return this->max_value;
+	switch (this->value_type) {
+	case TYPE_INT:
+		return QVariant(this->int_max_value);
+	case TYPE_REAL:
+		return QVariant(this->real_max_value);
+	default:
+		return QVariant();
+	}
 }
 
 void Robot::Attribute::setMaxValue(const QVariant& _max_value) {
-	this->max_value = _max_value;
+	if (this->value_type == TYPE_INT) {
+		this->int_max_value = std::max(this->int_min_value, _max_value.toInt());
+		this->setIntValue(this->int_value);
+	} else if (this->value_type == TYPE_REAL) {
+		this->real_max_value = std::max(this->real_min_value, _max_value.toDouble());
+		this->setRealValue(this->real_value);
+	}
 }
 
 QVariant Robot::Attribute::getStepSize() const {
-	return this->step_size;
+	switch (this->value_type) {
+	case TYPE_INT:
+		return QVariant(this->int_step_size);
+	case TYPE_REAL:
+		return QVariant(this->real_step_size);
+	default:
+		return QVariant();
+	}
 }
 
 void Robot::Attribute::setStepSize(const QVariant& _step_size) {
-	this->step_size = _step_size;
+	if (this->value_type == TYPE_INT) {
+		this->int_step_size = std::max(_step_size.toInt(), 0);
+		this->setIntValue(this->int_value);
+	} else if (this->value_type == TYPE_REAL) {
+		this->real_step_size = std::max(_step_size.toDouble(), 0.0);
+		this->setRealValue(this->real_value);
+	}
+}
+
+std::size_t Robot::Attribute::getMemoryUsage() const {
+	return sizeof(Robot::Attribute) + getHeapMemoryUsage(this->name) + getHeapMemoryUsage(this->string_value) +
+		getHeapMemoryUsage(this->string_default_value) + getHeapMemoryUsage(this->enum_values);
 }
 
 
 //---------------------------------------------------------------------------------------------------------------------------------
 
 
-Robot::Robot(QObject* _parent) : QObject(_parent) {
+// the attribute is validated and changed in place, without copying it out of the map and back
+static bool setAttributeValueInPlace(Robot::AttributeMap& _attributes, const QString& _name, const QVariant& _value) {
+	Robot::AttributeIter it = _attributes.find(_name);
+	if (it == _attributes.end()) {
+		return false;
+	}
+
+	return it->second.setValue(_value);
+}
+
+Robot::Robot(QObject* _parent) :
+	QObject(_parent),
+	variable_names(&this->domain),
+	joint_angles_variables(&this->domain),
+	numeric_variables(&this->domain),
+	pose_variables(&this->domain),
+	string_variables(&this->domain)
+{
 	this->automatic_read_enabled_flag = true;
+	this->parameters = std::make_shared<const Robot::ParameterMap>();
+	this->battery_power_on_time.store(0);
+	this->battery_remaining_time.store(0);
+
+	this->pending_battery_changed_flag = false;
+	this->pending_number_of_writes = 0;
+	this->change_notification_scheduled_flag = false;
+	this->change_notification_interval.store(20);
+	this->data_version.store(0);
+	this->journal_compaction_flag = false;
+	this->history_flag = false;
+	this->number_of_parameter_map_copies = 0;
+	this->memory_stats_representation_flag.store(false);
+
+	qRegisterMetaType<RobotChangeSet>("RobotChangeSet");
+	qRegisterMetaType<RobotRepresentationSnapshot>("RobotRepresentationSnapshot");
+	qRegisterMetaType<RobotRepresentationDelta>("RobotRepresentationDelta");
+	qRegisterMetaType<RobotVariableBatch>("RobotVariableBatch");
+	qRegisterMetaType<RobotMemoryStats>("RobotMemoryStats");
+
+	// the timer moves with the robot, so the notifications are emitted from the robot thread
+	this->change_timer = new QTimer(this);
+	this->change_timer->setSingleShot(true);
+	QObject::connect(this->change_timer, SIGNAL(timeout()), this, SLOT(flushChanges()));
+	this->subscription_timer = new QTimer(this);
+	this->subscription_timer->setSingleShot(true);
+	QObject::connect(this->subscription_timer, SIGNAL(timeout()), this, SLOT(deliverPendingSubscriptions()));
+	this->live_joint_angles_flag = false;
+	this->joint_state_sequence = 0;
 }
 
 Robot::~Robot() {
+	QMutexLocker locker(&this->subscription_mutex);
+
+	for (std::size_t i = 0; i < this->subscriptions.size(); ++i) {
+		this->subscriptions[i]->robot = NULL;
+	}
 }
 
 
@@ -247,59 +458,31 @@ void Robot::removeAllAttributes() {
 }
 
 
-bool Robot::getAttributeValue(const QString& _name, Robot::Attribute::ValueType& _value_type, QVariant& _value) const {
-	if (this->hasAttribute(_name) == false) {
-		return false;
+const Robot::Attribute* Robot::findAttribute(const QString& _name) const {
+	Robot::AttributeConstIter it = this->attributes.find(_name);
+	if (it == this->attributes.end()) {
+		return NULL;
 	}
 
-	Robot::Attribute attribute = this->getAttribute(_name);
-	_value_type = attribute.getValueType();
-	_value = attribute.getValue();
-
-	return true;
+	return &it->second;
 }
 
-bool Robot::setAttributeValue(const QString& _name, const QVariant& _value) {
-	if (this->hasAttribute(_name) == false) {
+bool Robot::getAttributeValue(const QString& _name, Robot::Attribute::ValueType& _value_type, QVariant& _value) const {
+	const Robot::Attribute* attribute = this->findAttribute(_name);
+	if (attribute == NULL) {
 		return false;
 	}
 
-	Robot::Attribute attribute = this->getAttribute(_name);
-	switch (attribute.getValueType()) {
-	case Robot::Attribute::TYPE_ENUM:
-		if (_value.type() == QVariant::String) {
-			attribute.setValue(_value);
-		} else {
-			return false;
-		}
-		break;
-	case Robot::Attribute::TYPE_INT:
-		if (_value.type() == QVariant::Int) {
-			attribute.setValue(_value);
-		} else {
-			return false;
-		}
-		break;
-	case Robot::Attribute::TYPE_REAL:
-		if (_value.type() == QVariant::Double) {
-			attribute.setValue(_value);
-		} else {
-			return false;
-		}
-		break;
-	case Robot::Attribute::TYPE_STRING:
-		if (_value.type() == QVariant::String) {
-			attribute.setValue(_value);
-		} else {
-			return false;
-		}
-		break;
-	}
+	_value_type = attribute->getValueType();
+	_value = attribute->getValue();
 
-	this->setAttribute(attribute);
 	return true;
 }
 
+bool Robot::setAttributeValue(const QString& _name, const QVariant& _value) {
+	return setAttributeValueInPlace(this->attributes, _name, _value);
+}
+
 
 size_t Robot::getNumberOfConnectionAttributes(size_t _connection_index) const {
 	if (_connection_index >= this->getNumberOfConnections()) {
@@ -373,18 +556,27 @@ void Robot::removeAllConnectionAttributes(size_t _connection_index) {
 	this->connection_attributes[_connection_index].clear();
 }
 
-bool Robot::getConnectionAttributeValue(size_t _connection_index, const QString& _name, Robot::Attribute::ValueType& _value_type, QVariant& _value) const {
+const Robot::Attribute* Robot::findConnectionAttribute(size_t _connection_index, const QString& _name) const {
 	if (_connection_index >= this->getNumberOfConnections()) {
-		return false;
+		return NULL;
+	}
+
+	Robot::AttributeConstIter it = this->connection_attributes[_connection_index].find(_name);
+	if (it == this->connection_attributes[_connection_index].end()) {
+		return NULL;
 	}
 
-	if (this->hasConnectionAttribute(_connection_index, _name) == false) {
+	return &it->second;
+}
+
+bool Robot::getConnectionAttributeValue(size_t _connection_index, const QString& _name, Robot::Attribute::ValueType& _value_type, QVariant& _value) const {
+	const Robot::Attribute* attribute = this->findConnectionAttribute(_connection_index, _name);
+	if (attribute == NULL) {
 		return false;
 	}
 
-	Robot::Attribute attribute = this->getConnectionAttribute(_connection_index, _name);
-	_value_type = attribute.getValueType();
-	_value = attribute.getValue();
+	_value_type = attribute->getValueType();
+	_value = attribute->getValue();
 
 	return true;
 }
@@ -394,44 +586,7 @@ bool Robot::setConnectionAttributeValue(size_t _connection_index, const QString&
 		return false;
 	}
 
-	if (this->hasConnectionAttribute(_connection_index, _name) == false) {
-		return false;
-	}
-
-	Robot::Attribute attribute = this->getConnectionAttribute(_connection_index, _name);
-	switch (attribute.getValueType()) {
-	case Robot::Attribute::TYPE_ENUM:
-		if (_value.type() == QVariant::String) {
-			attribute.setValue(_value);
-		} else {
-			return false;
-		}
-		break;
-	case Robot::Attribute::TYPE_INT:
-		if (_value.type() == QVariant::Int) {
-			attribute.setValue(_value);
-		} else {
-			return false;
-		}
-		break;
-	case Robot::Attribute::TYPE_REAL:
-		if (_value.type() == QVariant::Double) {
-			attribute.setValue(_value);
-		} else {
-			return false;
-		}
-		break;
-	case Robot::Attribute::TYPE_STRING:
-		if (_value.type() == QVariant::String) {
-			attribute.setValue(_value);
-		} else {
-			return false;
-		}
-		break;
-	}
-
-	this->setConnectionAttribute(_connection_index, attribute);
-	return true;
+	return setAttributeValueInPlace(this->connection_attributes[_connection_index], _name, _value);
 }
 
 size_t Robot::getNumberOfConnections() const {
@@ -459,396 +614,1717 @@ void Robot::setConnectionUseFlag(size_t _connection_index, bool _use_flag) {
 	}
 }
 
-void Robot::initRobotRepresentation(RobotRepresentation& _robot_representation) {
-	_robot_representation.reset();
+template<typename R>
+static void setVariableRepresentation(R& _robot_representation, const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, const QString& _string_variable) {
+	StringVariableRepresentation variable_representation;
+	variable_representation.setProgramName(_program_name);
+	variable_representation.setName(_variable_name);
+	variable_representation.setIndex(_variable_index);
+	variable_representation.setValue(_string_variable);
 
-	for (std::map<QString, std::map<QString, std::map<unsigned int, QString> > >::const_iterator it0 = this->string_variables.begin(); it0 != this->string_variables.end(); ++it0) {
-		for (std::map<QString, std::map<unsigned int, QString> >::const_iterator it1 = it0->second.begin(); it1 != it0->second.end(); ++it1) {
-			for (std::map<unsigned int, QString>::const_iterator it2 = it1->second.begin(); it2 != it1->second.end(); ++it2) {
-				StringVariableRepresentation variable_representation;
-				variable_representation.setProgramName(it0->first);
-				variable_representation.setName(it1->first);
-				variable_representation.setIndex(it2->first);
-				variable_representation.setValue(it2->second);
+	_robot_representation.setStringVariableRepresentation(_program_name, _variable_name, _variable_index, variable_representation);
+}
 
-				_robot_representation.setStringVariableRepresentation(it0->first, it1->first, it2->first, variable_representation);
-			}
-		}
-	}
+template<typename R>
+static void setVariableRepresentation(R& _robot_representation, const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, const RobotJointAngles& _joint_angles_variable) {
+	JointAnglesVariableRepresentation variable_representation;
+	variable_representation.setProgramName(_program_name);
+	variable_representation.setName(_variable_name);
+	variable_representation.setIndex(_variable_index);
+	variable_representation.setValue(
+		_joint_angles_variable.getJ1(),
+		_joint_angles_variable.getJ2(),
+		_joint_angles_variable.getJ3(),
+		_joint_angles_variable.getJ4(),
+		_joint_angles_variable.getJ5(),
+		_joint_angles_variable.getJ6(),
+		_joint_angles_variable.getJ7(),
+		_joint_angles_variable.getJ8()
+	);
 
-	for (std::map<QString, std::map<QString, std::map<unsigned int, RobotJointAngles> > >::const_iterator it0 = this->joint_angles_variables.begin(); it0 != this->joint_angles_variables.end(); ++it0) {
-		for (std::map<QString, std::map<unsigned int, RobotJointAngles> >::const_iterator it1 = it0->second.begin(); it1 != it0->second.end(); ++it1) {
-			for (std::map<unsigned int, RobotJointAngles>::const_iterator it2 = it1->second.begin(); it2 != it1->second.end(); ++it2) {
-				JointAnglesVariableRepresentation variable_representation;
-				variable_representation.setProgramName(it0->first);
-				variable_representation.setName(it1->first);
-				variable_representation.setIndex(it2->first);
-				variable_representation.setValue(
-					it2->second.getJ1(),
-					it2->second.getJ2(),
-					it2->second.getJ3(),
-					it2->second.getJ4(),
-					it2->second.getJ5(),
-					it2->second.getJ6(),
-					it2->second.getJ7(),
-					it2->second.getJ8()
-				);
-
-				_robot_representation.setJointAnglesVariableRepresentation(it0->first, it1->first, it2->first, variable_representation);
-			}
-		}
-	}
+	_robot_representation.setJointAnglesVariableRepresentation(_program_name, _variable_name, _variable_index, variable_representation);
+}
 
-	for (std::map<QString, std::map<QString, std::map<unsigned int, double> > >::const_iterator it0 = this->numeric_variables.begin(); it0 != this->numeric_variables.end(); ++it0) {
-		for (std::map<QString, std::map<unsigned int, double> >::const_iterator it1 = it0->second.begin(); it1 != it0->second.end(); ++it1) {
-			for (std::map<unsigned int, double>::const_iterator it2 = it1->second.begin(); it2 != it1->second.end(); ++it2) {
-				NumericVariableRepresentation variable_representation;
-				variable_representation.setProgramName(it0->first);
-				variable_representation.setName(it1->first);
-				variable_representation.setIndex(it2->first);
-				variable_representation.setValue(it2->second);
+template<typename R>
+static void setVariableRepresentation(R& _robot_representation, const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, double _numeric_variable) {
+	NumericVariableRepresentation variable_representation;
+	variable_representation.setProgramName(_program_name);
+	variable_representation.setName(_variable_name);
+	variable_representation.setIndex(_variable_index);
+	variable_representation.setValue(_numeric_variable);
 
-				_robot_representation.setNumericVariableRepresentation(it0->first, it1->first, it2->first, variable_representation);
-			}
-		}
-	}
+	_robot_representation.setNumericVariableRepresentation(_program_name, _variable_name, _variable_index, variable_representation);
+}
 
-	for (std::map<QString, std::map<QString, std::map<unsigned int, RobotPose> > >::const_iterator it0 = this->pose_variables.begin(); it0 != this->pose_variables.end(); ++it0) {
-		for (std::map<QString, std::map<unsigned int, RobotPose> >::const_iterator it1 = it0->second.begin(); it1 != it0->second.end(); ++it1) {
-			for (std::map<unsigned int, RobotPose>::const_iterator it2 = it1->second.begin(); it2 != it1->second.end(); ++it2) {
-				PoseVariableRepresentation variable_representation;
-				variable_representation.setProgramName(it0->first);
-				variable_representation.setName(it1->first);
-				variable_representation.setIndex(it2->first);
-				variable_representation.setValue(
-					it2->second.getX(),
-					it2->second.getY(),
-					it2->second.getZ(),
-					it2->second.getA(),
-					it2->second.getB(),
-					it2->second.getZ(),
-					it2->second.getF1(),
-					it2->second.getF2()
-					);
-
-				_robot_representation.setPoseVariableRepresentation(it0->first, it1->first, it2->first, variable_representation);
-			}
-		}
-	}
+template<typename R>
+static void setVariableRepresentation(R& _robot_representation, const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, const RobotPose& _pose_variable) {
+	PoseVariableRepresentation variable_representation;
+	variable_representation.setProgramName(_program_name);
+	variable_representation.setName(_variable_name);
+	variable_representation.setIndex(_variable_index);
+	variable_representation.setValue(
+		_pose_variable.getX(),
+		_pose_variable.getY(),
+		_pose_variable.getZ(),
+		_pose_variable.getA(),
+		_pose_variable.getB(),
+		_pose_variable.getC(),
+		_pose_variable.getF1(),
+		_pose_variable.getF2()
+		);
+
+	_robot_representation.setPoseVariableRepresentation(_program_name, _variable_name, _variable_index, variable_representation);
+}
 
-	for (std::map<QString, std::vector<double> >::const_iterator it = this->parameters.begin(); it != this->parameters.end(); ++it) {
-		ParameterRepresentation parameter_representation;
-		parameter_representation.setName(it->first);
-		parameter_representation.setValues(it->second);
+template<typename R>
+static void setParameterRepresentation(R& _robot_representation, const QString& _parameter_name, const std::vector<double>& _values) {
+	ParameterRepresentation parameter_representation;
+	parameter_representation.setName(_parameter_name);
+	parameter_representation.setValues(_values);
 
-		_robot_representation.setParameterRepresentations(it->first, parameter_representation);
-	}
+	_robot_representation.setParameterRepresentations(_parameter_name, parameter_representation);
 }
 
+void Robot::initRobotRepresentation(RobotRepresentation& _robot_representation) {
+	_robot_representation.reset();
+	this->addRobotRepresentations(_robot_representation);
+}
 
-bool Robot::getJointAnglesVariable(QString _program_name, QString _variable_name, unsigned int _variable_index, RobotJointAngles& _joint_angles_variable) const {
-	QReadLocker locker(&this->data_lock);
+template<typename R>
+void Robot::addRobotRepresentations(R& _robot_representation) {
+	// every variable is copied consistently, slots and names are never freed, so no ReadGuard is needed
+	this->initVariableRepresentations(this->string_variables, _robot_representation);
+	this->initVariableRepresentations(this->joint_angles_variables, _robot_representation);
+	this->initVariableRepresentations(this->numeric_variables, _robot_representation);
+	this->initVariableRepresentations(this->pose_variables, _robot_representation);
 
-	std::map<QString, std::map<QString, std::map<unsigned int, RobotJointAngles> > >::const_iterator it0 = this->joint_angles_variables.find(_program_name);
-	if (it0 == this->joint_angles_variables.end()) {
-		return false;
+	std::shared_ptr<const Robot::ParameterMap> current_parameters = std::atomic_load(&this->parameters);
+	for (Robot::ParameterMap::const_iterator it = current_parameters->begin(); it != current_parameters->end(); ++it) {
+		setParameterRepresentation(_robot_representation, it->first, it->second);
 	}
 
-	std::map<QString, std::map<unsigned int, RobotJointAngles> >::const_iterator it1 = it0->second.find(_variable_name);
-	if (it1 == it0->second.end()) {
-		return false;
+	if (this->memory_stats_representation_flag.load() == true) {
+		this->addMemoryStatsRepresentations(_robot_representation);
 	}
+}
 
-	std::map<unsigned int, RobotJointAngles>::const_iterator it2 = it1->second.find(_variable_index);
-	if (it2 == it1->second.end()) {
-		return false;
-	}
+RobotRepresentationSnapshot Robot::getRobotRepresentationSnapshot() {
+	QMutexLocker locker(&this->representation_mutex);
 
-	_joint_angles_variable = it2->second;
-	return true;
+	// the first call builds the snapshot, afterwards it follows the change notifications
+	if (this->representation_snapshot.isNull() == true) {
+		this->representation_snapshot.reset();
+		this->representation_snapshot.setVersion(this->data_version.load());
+		this->addRobotRepresentations(this->representation_snapshot);
+	}
 
+	return this->representation_snapshot;
 }
 
-bool Robot::removeJointAnglesVariable(QString _program_name, QString _variable_name, unsigned int _variable_index) {
-	QWriteLocker locker(&this->data_lock);
 
-	std::map<QString, std::map<QString, std::map<unsigned int, RobotJointAngles> > >::iterator it0 = this->joint_angles_variables.find(_program_name);
-	if (it0 == this->joint_angles_variables.end()) {
+bool Robot::getJointAnglesVariable(QString _program_name, QString _variable_name, unsigned int _variable_index, RobotJointAngles& _joint_angles_variable) const {
+	ReclamationDomain::ReadGuard guard(&this->domain);
+
+	VariableKey key;
+	if (this->findVariableKey(_program_name, _variable_name, _variable_index, key) == false) {
 		return false;
 	}
 
-	std::map<QString, std::map<unsigned int, RobotJointAngles> >::iterator it1 = it0->second.find(_variable_name);
-	if (it1 == it0->second.end()) {
+	return this->joint_angles_variables.load(key, _joint_angles_variable);
+}
+
+bool Robot::removeJointAnglesVariable(QString _program_name, QString _variable_name, unsigned int _variable_index) {
+	QMutexLocker locker(&this->write_mutex);
+
+	VariableKey key;
+	if (this->findVariableKey(_program_name, _variable_name, _variable_index, key) == false) {
 		return false;
 	}
 
-	std::map<unsigned int, RobotJointAngles>::iterator it2 = it1->second.find(_variable_index);
-	if (it2 == it1->second.end()) {
+	if (this->joint_angles_variables.remove(key) == false) {
 		return false;
 	}
 
-	it1->second.erase(it2);
+	this->recordVariableChange(RobotChangeSet::VARIABLE_JOINT_ANGLES, key, true);
+	this->domain.collect();
+
 	return true;
 }
 
 void Robot::setJointAnglesVariable(QString _program_name, QString _variable_name, unsigned int _variable_index, const RobotJointAngles& _joint_angles_variable) {
-	QWriteLocker locker(&this->data_lock);
+	QMutexLocker locker(&this->write_mutex);
 
-	this->joint_angles_variables[_program_name][_variable_name][_variable_index] = _joint_angles_variable;
+	VariableKey key = this->makeVariableKey(_program_name, _variable_name, _variable_index);
 
-	locker.unlock();
-	emit robotDataChanged();
+	if (this->writeVariable(this->joint_angles_variables, RobotChangeSet::VARIABLE_JOINT_ANGLES, key, _joint_angles_variable) == true) {
+		this->publishJointState(key, _joint_angles_variable);
+	}
+
+	this->domain.collect();
 }
 
 
 bool Robot::getNumericVariable(QString _program_name, QString _variable_name, unsigned int _variable_index, double& _numeric_variable) const {
-	QReadLocker locker(&this->data_lock);
-
-	std::map<QString, std::map<QString, std::map<unsigned int, double> > >::const_iterator it0 = this->numeric_variables.find(_program_name);
-	if (it0 == this->numeric_variables.end()) {
-		return false;
-	}
-
-	std::map<QString, std::map<unsigned int, double> >::const_iterator it1 = it0->second.find(_variable_name);
-	if (it1 == it0->second.end()) {
-		return false;
-	}
+	ReclamationDomain::ReadGuard guard(&this->domain);
 
-	std::map<unsigned int, double>::const_iterator it2 = it1->second.find(_variable_index);
-	if (it2 == it1->second.end()) {
+	VariableKey key;
+	if (this->findVariableKey(_program_name, _variable_name, _variable_index, key) == false) {
 		return false;
 	}
 
-	_numeric_variable = it2->second;
-	return true;
+	return this->numeric_variables.load(key, _numeric_variable);
 }
 
 bool Robot::removeNumericVariable(QString _program_name, QString _variable_name, unsigned int _variable_index) {
-	QWriteLocker locker(&this->data_lock);
+	QMutexLocker locker(&this->write_mutex);
 
-	std::map<QString, std::map<QString, std::map<unsigned int, double> > >::iterator it0 = this->numeric_variables.find(_program_name);
-	if (it0 == this->numeric_variables.end()) {
+	VariableKey key;
+	if (this->findVariableKey(_program_name, _variable_name, _variable_index, key) == false) {
 		return false;
 	}
 
-	std::map<QString, std::map<unsigned int, double> >::iterator it1 = it0->second.find(_variable_name);
-	if (it1 == it0->second.end()) {
+	if (this->numeric_variables.remove(key) == false) {
 		return false;
 	}
 
-	std::map<unsigned int, double>::iterator it2 = it1->second.find(_variable_index);
-	if (it2 == it1->second.end()) {
-		return false;
-	}
+	this->recordVariableChange(RobotChangeSet::VARIABLE_NUMERIC, key, true);
+	this->domain.collect();
 
-	it1->second.erase(it2);
 	return true;
 }
 
 void Robot::setNumericVariable(QString _program_name, QString _variable_name, unsigned int _variable_index, const double& _numeric_variable) {
-	bool variable_found_flag = false;
-	bool variable_changed_flag = false;
-
-	QWriteLocker locker(&this->data_lock);
-
-	std::map<QString, std::map<QString, std::map<unsigned int, double> > >::iterator it0 = this->numeric_variables.find(_program_name);
-	if (it0 != this->numeric_variables.end()) {
-		std::map<QString, std::map<unsigned int, double> >::iterator it1 = it0->second.find(_variable_name);
-		if (it1 != it0->second.end()) {
-			std::map<unsigned int, double>::iterator it2 = it1->second.find(_variable_index);
-			if (it2 != it1->second.end()) {
-				variable_found_flag = true;
-				if (it2->second != _numeric_variable) {
-					it2->second = _numeric_variable;
-					variable_changed_flag = true;
-				}
-
-			}
-		}
-	}
-
-	if (variable_found_flag == false) {
-		this->numeric_variables[_program_name][_variable_name][_variable_index] = _numeric_variable;
-		variable_changed_flag = true;
-	}
+	QMutexLocker locker(&this->write_mutex);
 
-	locker.unlock();
+	this->writeVariable(this->numeric_variables, RobotChangeSet::VARIABLE_NUMERIC, this->makeVariableKey(_program_name, _variable_name, _variable_index), _numeric_variable);
 
-	if (variable_changed_flag == true) {
-		emit robotDataChanged();	
-	}
+	this->domain.collect();
 }
 
 
 bool Robot::getPoseVariable(QString _program_name, QString _variable_name, unsigned int _variable_index, RobotPose& _pose_variable) const {
-	QReadLocker locker(&this->data_lock);
-
-	std::map<QString, std::map<QString, std::map<unsigned int, RobotPose> > >::const_iterator it0 = this->pose_variables.find(_program_name);
-	if (it0 == this->pose_variables.end()) {
-		return false;
-	}
-
-	std::map<QString, std::map<unsigned int, RobotPose> >::const_iterator it1 = it0->second.find(_variable_name);
-	if (it1 == it0->second.end()) {
-		return false;
-	}
+	ReclamationDomain::ReadGuard guard(&this->domain);
 
-	std::map<unsigned int, RobotPose>::const_iterator it2 = it1->second.find(_variable_index);
-	if (it2 == it1->second.end()) {
+	VariableKey key;
+	if (this->findVariableKey(_program_name, _variable_name, _variable_index, key) == false) {
 		return false;
 	}
 
-	_pose_variable = it2->second;
-	return true;
+	return this->pose_variables.load(key, _pose_variable);
 }
 
 bool Robot::removePoseVariable(QString _program_name, QString _variable_name, unsigned int _variable_index) {
-	QWriteLocker locker(&this->data_lock);
+	QMutexLocker locker(&this->write_mutex);
 
-	std::map<QString, std::map<QString, std::map<unsigned int, RobotPose> > >::iterator it0 = this->pose_variables.find(_program_name);
-	if (it0 == this->pose_variables.end()) {
+	VariableKey key;
+	if (this->findVariableKey(_program_name, _variable_name, _variable_index, key) == false) {
 		return false;
 	}
 
-	std::map<QString, std::map<unsigned int, RobotPose> >::iterator it1 = it0->second.find(_variable_name);
-	if (it1 == it0->second.end()) {
+	if (this->pose_variables.remove(key) == false) {
 		return false;
 	}
 
-	std::map<unsigned int, RobotPose>::iterator it2 = it1->second.find(_variable_index);
-	if (it2 == it1->second.end()) {
-		return false;
-	}
+	this->recordVariableChange(RobotChangeSet::VARIABLE_POSE, key, true);
+	this->domain.collect();
 
-	it1->second.erase(it2);
 	return true;
 }
 
 void Robot::setPoseVariable(QString _program_name, QString _variable_name, unsigned int _variable_index, const RobotPose& _pose_variable) {
-	QWriteLocker locker(&this->data_lock);
+	QMutexLocker locker(&this->write_mutex);
 
-	this->pose_variables[_program_name][_variable_name][_variable_index] = _pose_variable;
+	this->writeVariable(this->pose_variables, RobotChangeSet::VARIABLE_POSE, this->makeVariableKey(_program_name, _variable_name, _variable_index), _pose_variable);
 
-	locker.unlock();
-	emit robotDataChanged();
+	this->domain.collect();
 }
 
 
 bool Robot::getStringVariable(QString _program_name, QString _variable_name, unsigned int _variable_index, QString& _string_variable) const {
-	QReadLocker locker(&this->data_lock);
+	ReclamationDomain::ReadGuard guard(&this->domain);
 
-	std::map<QString, std::map<QString, std::map<unsigned int, QString> > >::const_iterator it0 = this->string_variables.find(_program_name);
-	if (it0 == this->string_variables.end()) {
+	VariableKey key;
+	if (this->findVariableKey(_program_name, _variable_name, _variable_index, key) == false) {
 		return false;
 	}
 
-	std::map<QString, std::map<unsigned int, QString> >::const_iterator it1 = it0->second.find(_variable_name);
-	if (it1 == it0->second.end()) {
-		return false;
-	}
-
-	std::map<unsigned int, QString>::const_iterator it2 = it1->second.find(_variable_index);
-	if (it2 == it1->second.end()) {
-		return false;
-	}
-
-	_string_variable = it2->second;
-	return true;
+	return this->string_variables.load(key, _string_variable);
 }
 
 bool Robot::removeStringVariable(QString _program_name, QString _variable_name, unsigned int _variable_index) {
-	QWriteLocker locker(&this->data_lock);
+	QMutexLocker locker(&this->write_mutex);
 
-	std::map<QString, std::map<QString, std::map<unsigned int, QString> > >::iterator it0 = this->string_variables.find(_program_name);
-	if (it0 == this->string_variables.end()) {
+	VariableKey key;
+	if (this->findVariableKey(_program_name, _variable_name, _variable_index, key) == false) {
 		return false;
 	}
 
-	std::map<QString, std::map<unsigned int, QString> >::iterator it1 = it0->second.find(_variable_name);
-	if (it1 == it0->second.end()) {
+	if (this->string_variables.remove(key) == false) {
 		return false;
 	}
 
-	std::map<unsigned int, QString>::const_iterator it2 = it1->second.find(_variable_index);
-	if (it2 == it1->second.end()) {
-		return false;
-	}
+	this->recordVariableChange(RobotChangeSet::VARIABLE_STRING, key, true);
+	this->domain.collect();
 
-	it1->second.erase(it2);
 	return true;
 }
 
 void Robot::setStringVariable(QString _program_name, QString _variable_name, unsigned int _variable_index, const QString& _string_variable) {
-	QWriteLocker locker(&this->data_lock);
+	QMutexLocker locker(&this->write_mutex);
 
-	this->string_variables[_program_name][_variable_name][_variable_index] = _string_variable;
+	this->writeVariable(this->string_variables, RobotChangeSet::VARIABLE_STRING, this->makeVariableKey(_program_name, _variable_name, _variable_index), _string_variable);
 
-	locker.unlock();
-	emit robotDataChanged();
+	this->domain.collect();
 }
 
-bool Robot::getParameter(QString _parameter_name, std::vector<double>& _values) const {
-	QReadLocker locker(&this->data_lock);
+Robot::JointAnglesVariableHandle Robot::resolveJointAnglesVariable(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, bool _create_flag) {
+	if (_create_flag == false) {
+		ReclamationDomain::ReadGuard guard(&this->domain);
 
-	std::map<QString, std::vector<double> >::const_iterator it = this->parameters.find(_parameter_name);
-	if (it == this->parameters.end()) {
-		return false;
+		VariableKey key;
+		if (this->findVariableKey(_program_name, _variable_name, _variable_index, key) == false) {
+			return Robot::JointAnglesVariableHandle();
+		}
+
+		return this->joint_angles_variables.getHandle(key);
 	}
 
-	_values = it->second;
-	return true;
-}
+	QMutexLocker locker(&this->write_mutex);
 
-bool Robot::removeParameter(QString _parameter_name) {
-	QWriteLocker locker(&this->data_lock);
+	VariableKey key = this->makeVariableKey(_program_name, _variable_name, _variable_index);
 
-	std::map<QString, std::vector<double> >::iterator it = this->parameters.find(_parameter_name);
-	if (it == this->parameters.end()) {
-		return false;
+	bool inserted_flag = false;
+	quint32 slot = this->joint_angles_variables.insert(key, RobotJointAngles(), inserted_flag);
+	if (inserted_flag == true) {
+		this->recordVariableChange(RobotChangeSet::VARIABLE_JOINT_ANGLES, key, false);
 	}
 
-	this->parameters.erase(it);
+	this->domain.collect();
 
-	return true;
+	return this->joint_angles_variables.getHandle(slot);
 }
 
-void Robot::setParameter(QString _parameter_name, const std::vector<double>& _values) {
-	QWriteLocker locker(&this->data_lock);
-
-	this->parameters[_parameter_name] = _values;
-
-	locker.unlock();
-	emit robotDataChanged();
+bool Robot::getJointAnglesVariable(const Robot::JointAnglesVariableHandle& _handle, RobotJointAngles& _joint_angles_variable) const {
+	// slots are never freed, a handle needs neither the index nor a ReadGuard
+	return this->joint_angles_variables.load(_handle, _joint_angles_variable);
 }
 
-double Robot::getBatteryPowerOnTime() const {
-	QReadLocker locker(&this->data_lock);
+bool Robot::setJointAnglesVariable(const Robot::JointAnglesVariableHandle& _handle, const RobotJointAngles& _joint_angles_variable) {
+	QMutexLocker locker(&this->write_mutex);
 
-	return this->battery_power_on_time;
-}
+	if (this->joint_angles_variables.isValid(_handle) == false) {
+		return false;
+	}
 
-void Robot::setBatteryPowerOnTime(double _battery_power_on_time) {
-	QWriteLocker locker(&this->data_lock);
+	if (this->writeVariable(this->joint_angles_variables, RobotChangeSet::VARIABLE_JOINT_ANGLES, _handle.getSlot(), _joint_angles_variable) == true) {
+		this->publishJointState(this->joint_angles_variables.getKey(_handle.getSlot()), _joint_angles_variable);
+	}
 
-	this->battery_power_on_time = _battery_power_on_time;
+	this->domain.collect();
 
-	locker.unlock();
-	emit robotDataChanged();
+	return true;
+}
+
+Robot::NumericVariableHandle Robot::resolveNumericVariable(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, bool _create_flag) {
+	if (_create_flag == false) {
+		ReclamationDomain::ReadGuard guard(&this->domain);
+
+		VariableKey key;
+		if (this->findVariableKey(_program_name, _variable_name, _variable_index, key) == false) {
+			return Robot::NumericVariableHandle();
+		}
+
+		return this->numeric_variables.getHandle(key);
+	}
+
+	QMutexLocker locker(&this->write_mutex);
+
+	VariableKey key = this->makeVariableKey(_program_name, _variable_name, _variable_index);
+
+	bool inserted_flag = false;
+	quint32 slot = this->numeric_variables.insert(key, 0.0, inserted_flag);
+	if (inserted_flag == true) {
+		this->recordVariableChange(RobotChangeSet::VARIABLE_NUMERIC, key, false);
+	}
+
+	this->domain.collect();
+
+	return this->numeric_variables.getHandle(slot);
+}
+
+bool Robot::getNumericVariable(const Robot::NumericVariableHandle& _handle, double& _numeric_variable) const {
+	// slots are never freed, a handle needs neither the index nor a ReadGuard
+	return this->numeric_variables.load(_handle, _numeric_variable);
+}
+
+bool Robot::setNumericVariable(const Robot::NumericVariableHandle& _handle, double _numeric_variable) {
+	QMutexLocker locker(&this->write_mutex);
+
+	if (this->numeric_variables.isValid(_handle) == false) {
+		return false;
+	}
+
+	this->writeVariable(this->numeric_variables, RobotChangeSet::VARIABLE_NUMERIC, _handle.getSlot(), _numeric_variable);
+
+	this->domain.collect();
+
+	return true;
+}
+
+Robot::PoseVariableHandle Robot::resolvePoseVariable(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, bool _create_flag) {
+	if (_create_flag == false) {
+		ReclamationDomain::ReadGuard guard(&this->domain);
+
+		VariableKey key;
+		if (this->findVariableKey(_program_name, _variable_name, _variable_index, key) == false) {
+			return Robot::PoseVariableHandle();
+		}
+
+		return this->pose_variables.getHandle(key);
+	}
+
+	QMutexLocker locker(&this->write_mutex);
+
+	VariableKey key = this->makeVariableKey(_program_name, _variable_name, _variable_index);
+
+	bool inserted_flag = false;
+	quint32 slot = this->pose_variables.insert(key, RobotPose(), inserted_flag);
+	if (inserted_flag == true) {
+		this->recordVariableChange(RobotChangeSet::VARIABLE_POSE, key, false);
+	}
+
+	this->domain.collect();
+
+	return this->pose_variables.getHandle(slot);
+}
+
+bool Robot::getPoseVariable(const Robot::PoseVariableHandle& _handle, RobotPose& _pose_variable) const {
+	// slots are never freed, a handle needs neither the index nor a ReadGuard
+	return this->pose_variables.load(_handle, _pose_variable);
+}
+
+bool Robot::setPoseVariable(const Robot::PoseVariableHandle& _handle, const RobotPose& _pose_variable) {
+	QMutexLocker locker(&this->write_mutex);
+
+	if (this->pose_variables.isValid(_handle) == false) {
+		return false;
+	}
+
+	this->writeVariable(this->pose_variables, RobotChangeSet::VARIABLE_POSE, _handle.getSlot(), _pose_variable);
+
+	this->domain.collect();
+
+	return true;
+}
+
+Robot::StringVariableHandle Robot::resolveStringVariable(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, bool _create_flag) {
+	if (_create_flag == false) {
+		ReclamationDomain::ReadGuard guard(&this->domain);
+
+		VariableKey key;
+		if (this->findVariableKey(_program_name, _variable_name, _variable_index, key) == false) {
+			return Robot::StringVariableHandle();
+		}
+
+		return this->string_variables.getHandle(key);
+	}
+
+	QMutexLocker locker(&this->write_mutex);
+
+	VariableKey key = this->makeVariableKey(_program_name, _variable_name, _variable_index);
+
+	bool inserted_flag = false;
+	quint32 slot = this->string_variables.insert(key, QString(), inserted_flag);
+	if (inserted_flag == true) {
+		this->recordVariableChange(RobotChangeSet::VARIABLE_STRING, key, false);
+	}
+
+	this->domain.collect();
+
+	return this->string_variables.getHandle(slot);
+}
+
+bool Robot::getStringVariable(const Robot::StringVariableHandle& _handle, QString& _string_variable) const {
+	// slots are never freed, a handle needs neither the index nor a ReadGuard
+	return this->string_variables.load(_handle, _string_variable);
+}
+
+bool Robot::setStringVariable(const Robot::StringVariableHandle& _handle, const QString& _string_variable) {
+	QMutexLocker locker(&this->write_mutex);
+
+	if (this->string_variables.isValid(_handle) == false) {
+		return false;
+	}
+
+	this->writeVariable(this->string_variables, RobotChangeSet::VARIABLE_STRING, _handle.getSlot(), _string_variable);
+
+	this->domain.collect();
+
+	return true;
+}
+
+std::size_t Robot::getVariables(RobotVariableBatch& _batch) const {
+	// excludes writers, the batch never contains half of a setVariables()
+	QMutexLocker locker(&this->write_mutex);
+
+	std::size_t number_found = 0;
+	QString program_name;
+	quint32 program_id = StringInterner::INVALID_ID;
+
+	for (std::size_t i = 0; i < _batch.entries.size(); ++i) {
+		RobotVariableBatch::Entry& entry = _batch.entries[i];
+		entry.found_flag = false;
+
+		if (i == 0 || entry.program_name != program_name) {
+			program_name = entry.program_name;
+			program_id = this->variable_names.find(program_name);
+		}
+
+		VariableKey key(program_id, this->variable_names.find(entry.variable_name), entry.variable_index);
+		if (key.program_id == StringInterner::INVALID_ID || key.name_id == StringInterner::INVALID_ID) {
+			continue;
+		}
+
+		switch (entry.type) {
+		case RobotChangeSet::VARIABLE_JOINT_ANGLES:
+			entry.found_flag = this->joint_angles_variables.load(key, _batch.joint_angles_variables[entry.value_index]);
+			break;
+		case RobotChangeSet::VARIABLE_NUMERIC:
+			entry.found_flag = this->numeric_variables.load(key, _batch.numeric_variables[entry.value_index]);
+			break;
+		case RobotChangeSet::VARIABLE_POSE:
+			entry.found_flag = this->pose_variables.load(key, _batch.pose_variables[entry.value_index]);
+			break;
+		case RobotChangeSet::VARIABLE_STRING:
+			entry.found_flag = this->string_variables.load(key, _batch.string_variables[entry.value_index]);
+			break;
+		}
+
+		if (entry.found_flag == true) {
+			++number_found;
+		}
+	}
+
+	return number_found;
+}
+
+std::size_t Robot::setVariables(const RobotVariableBatch& _batch) {
+	// flushChanges() waits for the write mutex, so the whole batch ends up in one change set
+	QMutexLocker locker(&this->write_mutex);
+
+	std::size_t number_changed = 0;
+	QString program_name;
+	quint32 program_id = StringInterner::INVALID_ID;
+
+	for (std::size_t i = 0; i < _batch.entries.size(); ++i) {
+		const RobotVariableBatch::Entry& entry = _batch.entries[i];
+		VariableKey key = this->makeVariableKey(entry, program_name, program_id);
+
+		bool changed_flag = false;
+		switch (entry.type) {
+		case RobotChangeSet::VARIABLE_JOINT_ANGLES:
+			changed_flag = this->writeVariable(this->joint_angles_variables, RobotChangeSet::VARIABLE_JOINT_ANGLES, key, _batch.joint_angles_variables[entry.value_index]);
+			if (changed_flag == true) {
+				this->publishJointState(key, _batch.joint_angles_variables[entry.value_index]);
+			}
+			break;
+		case RobotChangeSet::VARIABLE_NUMERIC:
+			changed_flag = this->writeVariable(this->numeric_variables, RobotChangeSet::VARIABLE_NUMERIC, key, _batch.numeric_variables[entry.value_index]);
+			break;
+		case RobotChangeSet::VARIABLE_POSE:
+			changed_flag = this->writeVariable(this->pose_variables, RobotChangeSet::VARIABLE_POSE, key, _batch.pose_variables[entry.value_index]);
+			break;
+		case RobotChangeSet::VARIABLE_STRING:
+			changed_flag = this->writeVariable(this->string_variables, RobotChangeSet::VARIABLE_STRING, key, _batch.string_variables[entry.value_index]);
+			break;
+		}
+
+		if (changed_flag == true) {
+			++number_changed;
+		}
+	}
+
+	this->domain.collect();
+
+	return number_changed;
+}
+
+bool Robot::getParameter(QString _parameter_name, std::vector<double>& _values) const {
+	std::shared_ptr<const Robot::ParameterMap> current_parameters = std::atomic_load(&this->parameters);
+
+	Robot::ParameterMap::const_iterator it = current_parameters->find(_parameter_name);
+	if (it == current_parameters->end()) {
+		return false;
+	}
+
+	_values = it->second;
+	return true;
+}
+
+bool Robot::removeParameter(QString _parameter_name) {
+	QMutexLocker locker(&this->write_mutex);
+
+	std::shared_ptr<const Robot::ParameterMap> current_parameters = std::atomic_load(&this->parameters);
+	if (current_parameters->find(_parameter_name) == current_parameters->end()) {
+		return false;
+	}
+
+	// parameters change rarely, readers keep the version they loaded
+	std::shared_ptr<Robot::ParameterMap> new_parameters = std::make_shared<Robot::ParameterMap>(*current_parameters);
+	++this->number_of_parameter_map_copies;
+	new_parameters->erase(_parameter_name);
+	std::atomic_store(&this->parameters, std::shared_ptr<const Robot::ParameterMap>(new_parameters));
+
+	this->recordParameterChange(_parameter_name, true);
+
+	return true;
+}
+
+void Robot::setParameter(QString _parameter_name, const std::vector<double>& _values) {
+	QMutexLocker locker(&this->write_mutex);
+
+	std::shared_ptr<const Robot::ParameterMap> current_parameters = std::atomic_load(&this->parameters);
+
+	Robot::ParameterMap::const_iterator it = current_parameters->find(_parameter_name);
+	if (it != current_parameters->end() && it->second == _values) {
+		return;
+	}
+
+	std::shared_ptr<Robot::ParameterMap> new_parameters = std::make_shared<Robot::ParameterMap>(*current_parameters);
+	++this->number_of_parameter_map_copies;
+	(*new_parameters)[_parameter_name] = _values;
+	std::atomic_store(&this->parameters, std::shared_ptr<const Robot::ParameterMap>(new_parameters));
+
+	this->recordParameterChange(_parameter_name, false);
+}
+
+double Robot::getBatteryPowerOnTime() const {
+	return this->battery_power_on_time.load();
+}
+
+void Robot::setBatteryPowerOnTime(double _battery_power_on_time) {
+	QMutexLocker locker(&this->write_mutex);
+
+	if (this->battery_power_on_time.load() == _battery_power_on_time) {
+		return;
+	}
+
+	this->battery_power_on_time.store(_battery_power_on_time);
+	this->recordBatteryChange();
 }
 
 double Robot::getBatteryRemainingTime() const {
-	QReadLocker locker(&this->data_lock);
+	return this->battery_remaining_time.load();
+}
+
+void Robot::setBatteryRemainingTime(double _battery_remaining_time) {
+	QMutexLocker locker(&this->write_mutex);
+
+	if (this->battery_remaining_time.load() == _battery_remaining_time) {
+		return;
+	}
+
+	this->battery_remaining_time.store(_battery_remaining_time);
+	this->recordBatteryChange();
+}
+
+int Robot::getChangeNotificationInterval() const {
+	return this->change_notification_interval.load();
+}
+
+void Robot::setChangeNotificationInterval(int _change_notification_interval) {
+	this->change_notification_interval.store(std::max(_change_notification_interval, 0));
+}
+
+quint64 Robot::getDataVersion() const {
+	return this->data_version.load();
+}
+
+bool Robot::enablePersistence(const QString& _base_name) {
+	QMutexLocker journal_locker(&this->journal_mutex);
+
+	if (this->journal.open(_base_name) == false) {
+		return false;
+	}
+
+	std::vector<VariableRecord> records;
+	quint64 persisted_data_version = 0;
+	if (this->journal.load(records, persisted_data_version) == false) {
+		// unreadable snapshot, the data is read from the controller and persisted from scratch
+		records.clear();
+	}
+
+	QMutexLocker locker(&this->write_mutex);
+
+	// the versions continue after the persisted ones, a lower snapshot version would let older journal entries win on the next load
+	this->data_version.store(persisted_data_version);
+	this->restoreRecords(records);
+
+	// the restored data is not journaled again, the next notification writes it as a new snapshot
+	this->journal_compaction_flag = true;
+	this->scheduleChangeNotification();
+
+	this->domain.collect();
+
+	return true;
+}
+
+void Robot::disablePersistence() {
+	QMutexLocker journal_locker(&this->journal_mutex);
+
+	this->journal.close();
+	this->journal_compaction_flag = false;
+}
+
+std::size_t Robot::validateReachability(const QString& _program_name, ReachabilityValidator& _validator,
+	std::vector<ReachabilityValidator::Point>& _points, std::vector<ReachabilityValidator::Result>& _results) const {
+	_points.clear();
+	_results.clear();
+
+	{
+		ReclamationDomain::ReadGuard guard(&this->domain);
+
+		quint32 program_id = StringInterner::INVALID_ID;
+		if (_program_name.isEmpty() == false) {
+			program_id = this->variable_names.find(_program_name);
+			if (program_id == StringInterner::INVALID_ID) {
+				return 0;
+			}
+		}
+
+		this->appendReachabilityPoints(this->joint_angles_variables, RobotChangeSet::VARIABLE_JOINT_ANGLES, program_id, _points);
+		this->appendReachabilityPoints(this->pose_variables, RobotChangeSet::VARIABLE_POSE, program_id, _points);
+	}
+
+	// the checks run without the guard, they take much longer than a write
+	return _validator.validate(_points, _results);
+}
+
+RobotVariableSubscription* Robot::subscribeVariables(const RobotVariableSubscription::Filter& _filter) {
+	RobotVariableSubscription* subscription = new RobotVariableSubscription(this, _filter);
+
+	QMutexLocker locker(&this->subscription_mutex);
+	this->subscriptions.push_back(subscription);
+
+	return subscription;
+}
+
+void Robot::unsubscribeVariables(RobotVariableSubscription* _subscription) {
+	QMutexLocker locker(&this->subscription_mutex);
+
+	std::vector<RobotVariableSubscription*>::iterator it = std::find(this->subscriptions.begin(), this->subscriptions.end(), _subscription);
+	if (it != this->subscriptions.end()) {
+		(*it)->robot = NULL;
+		this->subscriptions.erase(it);
+	}
+}
+
+bool Robot::enableVariableHistory(RobotChangeSet::VariableType _type, const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, std::size_t _capacity) {
+	QMutexLocker locker(&this->write_mutex);
+
+	VariableKey key = this->makeVariableKey(_program_name, _variable_name, _variable_index);
+
+	switch (_type) {
+	case RobotChangeSet::VARIABLE_JOINT_ANGLES:
+		this->startHistory(this->joint_angles_variables, _type, key, _capacity);
+		break;
+	case RobotChangeSet::VARIABLE_NUMERIC:
+		this->startHistory(this->numeric_variables, _type, key, _capacity);
+		break;
+	case RobotChangeSet::VARIABLE_POSE:
+		this->startHistory(this->pose_variables, _type, key, _capacity);
+		break;
+	case RobotChangeSet::VARIABLE_STRING:
+		return false;
+	}
+
+	this->history_flag = true;
+	this->domain.collect();
+
+	return true;
+}
+
+void Robot::disableVariableHistory(RobotChangeSet::VariableType _type, const QString& _program_name, const QString& _variable_name, unsigned int _variable_index) {
+	QMutexLocker locker(&this->write_mutex);
+
+	VariableKey key;
+	if (this->findVariableKey(_program_name, _variable_name, _variable_index, key) == false) {
+		return;
+	}
+
+	QMutexLocker history_locker(&this->history_mutex);
+
+	this->variable_histories[_type].erase(key);
+
+	this->history_flag = false;
+	for (int i = 0; i < 4; ++i) {
+		this->history_flag = this->history_flag || this->variable_histories[i].empty() == false;
+	}
+}
+
+bool Robot::getVariableHistory(RobotChangeSet::VariableType _type, const QString& _program_name, const QString& _variable_name, unsigned int _variable_index,
+	qint64 _start_time, qint64 _end_time, std::vector<qint64>& _times, std::vector<double>& _values) const {
+	ReclamationDomain::ReadGuard guard(&this->domain);
+
+	VariableKey key;
+	if (this->findVariableKey(_program_name, _variable_name, _variable_index, key) == false) {
+		return false;
+	}
+
+	QMutexLocker history_locker(&this->history_mutex);
+
+	std::unordered_map<VariableKey, std::shared_ptr<VariableHistory>, VariableKeyHash>::const_iterator it = this->variable_histories[_type].find(key);
+	if (it == this->variable_histories[_type].end()) {
+		return false;
+	}
+
+	it->second->query(_start_time, _end_time, _times, _values);
+
+	return true;
+}
+
+void Robot::getMemoryStats(RobotMemoryStats& _memory_stats) const {
+	_memory_stats.clear();
+
+	for (Robot::AttributeConstIter it = this->attributes.begin(); it != this->attributes.end(); ++it) {
+		_memory_stats.attributes.add(1, MAP_NODE_SIZE + sizeof(QString) + getHeapMemoryUsage(it->first) + it->second.getMemoryUsage());
+	}
+
+	_memory_stats.connection_attributes.add(0, this->connection_attributes.capacity() * sizeof(Robot::AttributeMap));
+	for (std::size_t i = 0; i < this->connection_attributes.size(); ++i) {
+		for (Robot::AttributeConstIter it = this->connection_attributes[i].begin(); it != this->connection_attributes[i].end(); ++it) {
+			_memory_stats.connection_attributes.add(1, MAP_NODE_SIZE + sizeof(QString) + getHeapMemoryUsage(it->first) + it->second.getMemoryUsage());
+		}
+	}
+
+	QMutexLocker locker(&this->write_mutex);
+
+	this->addVariableMemoryStats(this->joint_angles_variables, RobotChangeSet::VARIABLE_JOINT_ANGLES, _memory_stats);
+	this->addVariableMemoryStats(this->numeric_variables, RobotChangeSet::VARIABLE_NUMERIC, _memory_stats);
+	this->addVariableMemoryStats(this->pose_variables, RobotChangeSet::VARIABLE_POSE, _memory_stats);
+	this->addVariableMemoryStats(this->string_variables, RobotChangeSet::VARIABLE_STRING, _memory_stats);
+
+	_memory_stats.names.add(this->variable_names.size(), this->variable_names.getMemoryUsage());
+
+	std::shared_ptr<const Robot::ParameterMap> current_parameters = std::atomic_load(&this->parameters);
+	_memory_stats.parameters.add(0, sizeof(Robot::ParameterMap));
+	for (Robot::ParameterMap::const_iterator it = current_parameters->begin(); it != current_parameters->end(); ++it) {
+		_memory_stats.parameters.add(1, MAP_NODE_SIZE + sizeof(Robot::ParameterMap::value_type) + getHeapMemoryUsage(it->first) + it->second.capacity() * sizeof(double));
+	}
+	_memory_stats.number_of_parameter_map_copies = this->number_of_parameter_map_copies;
+
+	QMutexLocker history_locker(&this->history_mutex);
+
+	for (int i = 0; i < 4; ++i) {
+		std::unordered_map<VariableKey, std::shared_ptr<VariableHistory>, VariableKeyHash>::const_iterator it;
+		for (it = this->variable_histories[i].begin(); it != this->variable_histories[i].end(); ++it) {
+			_memory_stats.histories.add(1, sizeof(VariableHistory) + it->second->getCapacity());
+		}
+	}
+}
+
+bool Robot::isMemoryStatsRepresentationEnabled() const {
+	return this->memory_stats_representation_flag.load();
+}
+
+void Robot::setMemoryStatsRepresentationEnabled(bool _memory_stats_representation_flag) {
+	this->memory_stats_representation_flag.store(_memory_stats_representation_flag);
+}
+
+void Robot::setLiveJointAnglesVariable(QString _program_name, QString _variable_name, unsigned int _variable_index) {
+	QMutexLocker locker(&this->write_mutex);
+
+	this->live_variable_key = this->makeVariableKey(_program_name, _variable_name, _variable_index);
+	this->live_joint_angles_flag = true;
+
+	this->domain.collect();
+}
+
+TripleBuffer<JointState>& Robot::getJointStateBuffer() {
+	return this->joint_state_buffer;
+}
+
+// the caller holds a ReadGuard or the write mutex
+bool Robot::findVariableKey(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, VariableKey& _key) const {
+	_key.program_id = this->variable_names.find(_program_name);
+	_key.name_id = this->variable_names.find(_variable_name);
+	_key.index = _variable_index;
+
+	return _key.program_id != StringInterner::INVALID_ID && _key.name_id != StringInterner::INVALID_ID;
+}
+
+VariableKey Robot::makeVariableKey(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index) {
+	return VariableKey(this->variable_names.intern(_program_name), this->variable_names.intern(_variable_name), _variable_index);
+}
+
+VariableKey Robot::makeVariableKey(const RobotVariableBatch::Entry& _entry, QString& _program_name, quint32& _program_id) {
+	// uploads list the variables program by program
+	if (_program_id == StringInterner::INVALID_ID || _entry.program_name != _program_name) {
+		_program_name = _entry.program_name;
+		_program_id = this->variable_names.intern(_program_name);
+	}
+
+	return VariableKey(_program_id, this->variable_names.intern(_entry.variable_name), _entry.variable_index);
+}
+
+void Robot::publishJointState(const VariableKey& _key, const RobotJointAngles& _joint_angles_variable) {
+	if (this->live_joint_angles_flag == false || _key != this->live_variable_key) {
+		return;
+	}
+
+	JointState& joint_state = this->joint_state_buffer.getBackBuffer();
+	joint_state.sequence = ++this->joint_state_sequence;
+	joint_state.timestamp = QDateTime::currentMSecsSinceEpoch();
+	joint_state.angles[0] = _joint_angles_variable.getJ1();
+	joint_state.angles[1] = _joint_angles_variable.getJ2();
+	joint_state.angles[2] = _joint_angles_variable.getJ3();
+	joint_state.angles[3] = _joint_angles_variable.getJ4();
+	joint_state.angles[4] = _joint_angles_variable.getJ5();
+	joint_state.angles[5] = _joint_angles_variable.getJ6();
+	joint_state.angles[6] = _joint_angles_variable.getJ7();
+	joint_state.angles[7] = _joint_angles_variable.getJ8();
+	this->joint_state_buffer.publish();
+}
+
+static bool isSameValue(const RobotJointAngles& _a, const RobotJointAngles& _b) {
+	return _a.getJ1() == _b.getJ1() && _a.getJ2() == _b.getJ2() && _a.getJ3() == _b.getJ3() && _a.getJ4() == _b.getJ4() &&
+		_a.getJ5() == _b.getJ5() && _a.getJ6() == _b.getJ6() && _a.getJ7() == _b.getJ7() && _a.getJ8() == _b.getJ8();
+}
+
+static bool isSameValue(const RobotPose& _a, const RobotPose& _b) {
+	return _a.getX() == _b.getX() && _a.getY() == _b.getY() && _a.getZ() == _b.getZ() && _a.getA() == _b.getA() &&
+		_a.getB() == _b.getB() && _a.getC() == _b.getC() && _a.getF1() == _b.getF1() && _a.getF2() == _b.getF2();
+}
+
+static bool isSameValue(double _a, double _b) {
+	return _a == _b;
+}
+
+static bool isSameValue(const QString& _a, const QString& _b) {
+	return _a == _b;
+}
+
+// J1 .. J8, X .. C, F1, F2 or the numeric value, returns the number of values
+static std::size_t getValues(const RobotJointAngles& _joint_angles_variable, double* _values) {
+	_values[0] = _joint_angles_variable.getJ1();
+	_values[1] = _joint_angles_variable.getJ2();
+	_values[2] = _joint_angles_variable.getJ3();
+	_values[3] = _joint_angles_variable.getJ4();
+	_values[4] = _joint_angles_variable.getJ5();
+	_values[5] = _joint_angles_variable.getJ6();
+	_values[6] = _joint_angles_variable.getJ7();
+	_values[7] = _joint_angles_variable.getJ8();
+	return 8;
+}
+
+static std::size_t getValues(const RobotPose& _pose_variable, double* _values) {
+	_values[0] = _pose_variable.getX();
+	_values[1] = _pose_variable.getY();
+	_values[2] = _pose_variable.getZ();
+	_values[3] = _pose_variable.getA();
+	_values[4] = _pose_variable.getB();
+	_values[5] = _pose_variable.getC();
+	_values[6] = _pose_variable.getF1();
+	_values[7] = _pose_variable.getF2();
+	return 8;
+}
+
+static std::size_t getValues(double _numeric_variable, double* _values) {
+	_values[0] = _numeric_variable;
+	return 1;
+}
+
+static std::size_t getValues(const QString& /*_string_variable*/, double* /*_values*/) {
+	return 0;
+}
+
+static void setRecordValue(VariableRecord& _record, const RobotJointAngles& _joint_angles_variable) {
+	_record.values.resize(8);
+	getValues(_joint_angles_variable, &_record.values[0]);
+}
+
+static void setRecordValue(VariableRecord& _record, const RobotPose& _pose_variable) {
+	_record.values.resize(8);
+	getValues(_pose_variable, &_record.values[0]);
+}
+
+static void setRecordValue(VariableRecord& _record, double _numeric_variable) {
+	_record.values.resize(1);
+	getValues(_numeric_variable, &_record.values[0]);
+}
+
+static void setRecordValue(VariableRecord& _record, const QString& _string_variable) {
+	_record.string_value = _string_variable;
+}
+
+static bool getRecordValue(const VariableRecord& _record, RobotJointAngles& _joint_angles_variable) {
+	if (_record.values.size() != 8) {
+		return false;
+	}
+
+	_joint_angles_variable.setJ1(_record.values[0]);
+	_joint_angles_variable.setJ2(_record.values[1]);
+	_joint_angles_variable.setJ3(_record.values[2]);
+	_joint_angles_variable.setJ4(_record.values[3]);
+	_joint_angles_variable.setJ5(_record.values[4]);
+	_joint_angles_variable.setJ6(_record.values[5]);
+	_joint_angles_variable.setJ7(_record.values[6]);
+	_joint_angles_variable.setJ8(_record.values[7]);
+	return true;
+}
+
+static bool getRecordValue(const VariableRecord& _record, RobotPose& _pose_variable) {
+	if (_record.values.size() != 8) {
+		return false;
+	}
+
+	_pose_variable.setX(_record.values[0]);
+	_pose_variable.setY(_record.values[1]);
+	_pose_variable.setZ(_record.values[2]);
+	_pose_variable.setA(_record.values[3]);
+	_pose_variable.setB(_record.values[4]);
+	_pose_variable.setC(_record.values[5]);
+	_pose_variable.setF1(_record.values[6]);
+	_pose_variable.setF2(_record.values[7]);
+	return true;
+}
+
+static bool getRecordValue(const VariableRecord& _record, double& _numeric_variable) {
+	if (_record.values.size() != 1) {
+		return false;
+	}
+
+	_numeric_variable = _record.values[0];
+	return true;
+}
+
+static bool getRecordValue(const VariableRecord& _record, QString& _string_variable) {
+	_string_variable = _record.string_value;
+	return true;
+}
+
+template<typename T, typename R>
+void Robot::initVariableRepresentations(const VariableStore<T>& _store, R& _robot_representation) const {
+	VariableKey key;
+	T value;
 
-	return this->battery_remaining_time;
+	for (quint32 slot = 0; slot < _store.getNumberOfSlots(); ++slot) {
+		if (_store.loadSlot(slot, key, value) == true) {
+			setVariableRepresentation(_robot_representation, this->variable_names.getString(key.program_id), this->variable_names.getString(key.name_id), key.index, value);
+		}
+	}
 }
 
-void Robot::setBatteryRemainingTime(double _battery_remaining_time) {
-	QWriteLocker locker(&this->data_lock);
+template<typename T>
+void Robot::addVariableMemoryStats(const VariableStore<T>& _store, RobotChangeSet::VariableType _type, RobotMemoryStats& _memory_stats) const {
+	RobotMemoryStats::Usage& usage = _memory_stats.variables[_type];
+	usage.add(_store.size(), _store.getMemoryUsage());
+
+	// the slots of one program are mostly adjacent, the program entry is only looked up when the program changes
+	quint32 program_id = StringInterner::INVALID_ID;
+	RobotMemoryStats::Program* program = NULL;
+
+	for (quint32 slot = 0; slot < _store.getNumberOfSlots(); ++slot) {
+		if (_store.isUsed(slot) == false) {
+			continue;
+		}
+
+		const VariableKey& key = _store.getKey(slot);
+		if (program == NULL || key.program_id != program_id) {
+			program_id = key.program_id;
+			program = &_memory_stats.programs[this->variable_names.getString(program_id)];
+		}
+
+		std::size_t value_bytes = _store.getValueMemoryUsage(slot);
+		program->variables[_type].add(1, VariableStore<T>::getSlotSize() + value_bytes);
+		// the slot itself is part of the chunks
+		usage.add(0, value_bytes);
+	}
+
+	RobotMemoryStats::Counters& counters = _memory_stats.variable_counters[_type];
+	counters.number_of_inserts = _store.getNumberOfInserts();
+	counters.number_of_removals = _store.getNumberOfRemovals();
+	counters.number_of_chunk_allocations = _store.getNumberOfChunkAllocations();
+	counters.number_of_value_allocations = _store.getNumberOfValueAllocations();
+	counters.number_of_index_rehashes = _store.getNumberOfIndexRehashes();
+}
+
+template<typename T>
+void Robot::updateVariableRepresentation(const VariableStore<T>& _store, const RobotChangeSet::Variable& _variable, RobotRepresentationSnapshot& _snapshot) const {
+	ReclamationDomain::ReadGuard guard(&this->domain);
+
+	// the current value, it may already be newer than the change set, the next delta repeats it
+	VariableKey key;
+	T value;
+	if (_variable.removed_flag == false && this->findVariableKey(_variable.program_name, _variable.variable_name, _variable.variable_index, key) == true && _store.load(key, value) == true) {
+		setVariableRepresentation(_snapshot, _variable.program_name, _variable.variable_name, _variable.variable_index, value);
+	} else {
+		_snapshot.removeVariableRepresentation(_variable.type, _variable.program_name, _variable.variable_name, _variable.variable_index);
+	}
+}
+
+void Robot::updateRobotRepresentationSnapshot(const RobotChangeSet& _change_set) {
+	QMutexLocker locker(&this->representation_mutex);
+
+	if (this->representation_snapshot.isNull() == true) {
+		return;
+	}
+
+	RobotRepresentationDelta delta;
+	delta.base_version = this->representation_snapshot.getVersion();
+	delta.full_flag = _change_set.hasRemovals();
+	delta.change_set = _change_set;
+
+	// only the changed entries are replaced, a receiver holding the previous version keeps sharing all others
+	for (std::size_t i = 0; i < _change_set.variables.size(); ++i) {
+		const RobotChangeSet::Variable& variable = _change_set.variables[i];
+
+		switch (variable.type) {
+		case RobotChangeSet::VARIABLE_JOINT_ANGLES:
+			this->updateVariableRepresentation(this->joint_angles_variables, variable, this->representation_snapshot);
+			break;
+		case RobotChangeSet::VARIABLE_NUMERIC:
+			this->updateVariableRepresentation(this->numeric_variables, variable, this->representation_snapshot);
+			break;
+		case RobotChangeSet::VARIABLE_POSE:
+			this->updateVariableRepresentation(this->pose_variables, variable, this->representation_snapshot);
+			break;
+		case RobotChangeSet::VARIABLE_STRING:
+			this->updateVariableRepresentation(this->string_variables, variable, this->representation_snapshot);
+			break;
+		}
+	}
+
+	std::vector<double> values;
+	for (std::size_t i = 0; i < _change_set.parameters.size(); ++i) {
+		if (_change_set.parameters[i].removed_flag == false && this->getParameter(_change_set.parameters[i].name, values) == true) {
+			setParameterRepresentation(this->representation_snapshot, _change_set.parameters[i].name, values);
+		} else {
+			this->representation_snapshot.removeParameterRepresentation(_change_set.parameters[i].name);
+		}
+	}
+
+	if (this->memory_stats_representation_flag.load() == true) {
+		this->addMemoryStatsRepresentations(this->representation_snapshot);
+	}
+
+	this->representation_snapshot.setVersion(_change_set.getVersion());
+	delta.snapshot = this->representation_snapshot;
+
+	locker.unlock();
+
+	emit robotRepresentationUpdated(delta);
+}
+
+static QString getVariableTypeName(RobotChangeSet::VariableType _type) {
+	switch (_type) {
+	case RobotChangeSet::VARIABLE_JOINT_ANGLES:
+		return "joint_angles";
+	case RobotChangeSet::VARIABLE_NUMERIC:
+		return "numeric";
+	case RobotChangeSet::VARIABLE_POSE:
+		return "pose";
+	case RobotChangeSet::VARIABLE_STRING:
+		return "string";
+	}
+
+	return QString();
+}
+
+template<typename R>
+static void setMemoryUsageRepresentation(R& _robot_representation, const QString& _name, const RobotMemoryStats::Usage& _usage) {
+	std::vector<double> values;
+	values.push_back(static_cast<double>(_usage.number_of_entries));
+	values.push_back(static_cast<double>(_usage.number_of_bytes));
+
+	setParameterRepresentation(_robot_representation, _name, values);
+}
+
+// memory/total (bytes), memory/variables/<type> (entries, bytes, inserts, removals, chunk allocations, value allocations,
+// index rehashes), memory/programs/<program>/<type>, memory/names, memory/attributes, memory/connection_attributes,
+// memory/histories (entries, bytes) and memory/parameters (entries, bytes, map copies)
+template<typename R>
+void Robot::addMemoryStatsRepresentations(R& _robot_representation) const {
+	RobotMemoryStats memory_stats;
+	this->getMemoryStats(memory_stats);
+
+	setParameterRepresentation(_robot_representation, "memory/total", std::vector<double>(1, static_cast<double>(memory_stats.getNumberOfBytes())));
+
+	for (int i = 0; i < 4; ++i) {
+		const RobotMemoryStats::Counters& counters = memory_stats.variable_counters[i];
+
+		std::vector<double> values;
+		values.push_back(static_cast<double>(memory_stats.variables[i].number_of_entries));
+		values.push_back(static_cast<double>(memory_stats.variables[i].number_of_bytes));
+		values.push_back(static_cast<double>(counters.number_of_inserts));
+		values.push_back(static_cast<double>(counters.number_of_removals));
+		values.push_back(static_cast<double>(counters.number_of_chunk_allocations));
+		values.push_back(static_cast<double>(counters.number_of_value_allocations));
+		values.push_back(static_cast<double>(counters.number_of_index_rehashes));
+
+		setParameterRepresentation(_robot_representation, "memory/variables/" + getVariableTypeName(static_cast<RobotChangeSet::VariableType>(i)), values);
+	}
+
+	for (std::map<QString, RobotMemoryStats::Program>::const_iterator it = memory_stats.programs.begin(); it != memory_stats.programs.end(); ++it) {
+		for (int i = 0; i < 4; ++i) {
+			if (it->second.variables[i].number_of_entries > 0) {
+				setMemoryUsageRepresentation(_robot_representation, "memory/programs/" + it->first + "/" + getVariableTypeName(static_cast<RobotChangeSet::VariableType>(i)), it->second.variables[i]);
+			}
+		}
+	}
+
+	setMemoryUsageRepresentation(_robot_representation, "memory/names", memory_stats.names);
+	setMemoryUsageRepresentation(_robot_representation, "memory/attributes", memory_stats.attributes);
+	setMemoryUsageRepresentation(_robot_representation, "memory/connection_attributes", memory_stats.connection_attributes);
+	setMemoryUsageRepresentation(_robot_representation, "memory/histories", memory_stats.histories);
+
+	std::vector<double> values;
+	values.push_back(static_cast<double>(memory_stats.parameters.number_of_entries));
+	values.push_back(static_cast<double>(memory_stats.parameters.number_of_bytes));
+	values.push_back(static_cast<double>(memory_stats.number_of_parameter_map_copies));
+	setParameterRepresentation(_robot_representation, "memory/parameters", values);
+}
+
+// journal entries are at most this large before they are compacted into a snapshot
+static const std::uint64_t JOURNAL_COMPACTION_SIZE = 4 * 1024 * 1024;
+
+void Robot::persistChanges(const RobotChangeSet& _change_set) {
+	if (this->journal.isOpen() == false) {
+		return;
+	}
+
+	std::vector<VariableRecord> records;
+
+	if (this->journal_compaction_flag == false && _change_set.isEmpty() == false) {
+		// the current values, a newer value is journaled again with the next change set
+		for (std::size_t i = 0; i < _change_set.variables.size(); ++i) {
+			const RobotChangeSet::Variable& variable = _change_set.variables[i];
+
+			switch (variable.type) {
+			case RobotChangeSet::VARIABLE_JOINT_ANGLES:
+				this->appendVariableRecord(this->joint_angles_variables, variable, records);
+				break;
+			case RobotChangeSet::VARIABLE_NUMERIC:
+				this->appendVariableRecord(this->numeric_variables, variable, records);
+				break;
+			case RobotChangeSet::VARIABLE_POSE:
+				this->appendVariableRecord(this->pose_variables, variable, records);
+				break;
+			case RobotChangeSet::VARIABLE_STRING:
+				this->appendVariableRecord(this->string_variables, variable, records);
+				break;
+			}
+		}
+
+		for (std::size_t i = 0; i < _change_set.parameters.size(); ++i) {
+			VariableRecord record;
+			record.name = _change_set.parameters[i].name;
+			record.kind = (this->getParameter(record.name, record.values) == true) ? VariableRecord::RECORD_PARAMETER : VariableRecord::RECORD_PARAMETER_REMOVED;
+			records.push_back(record);
+		}
+
+		if (_change_set.battery_changed_flag == true) {
+			VariableRecord record;
+			record.kind = VariableRecord::RECORD_BATTERY;
+			record.values.push_back(this->battery_power_on_time.load());
+			record.values.push_back(this->battery_remaining_time.load());
+			records.push_back(record);
+		}
+
+		// entries after a failed one would be cut off on load, a snapshot makes the journal valid again
+		if (this->journal.append(records, _change_set.getVersion()) == false) {
+			this->journal_compaction_flag = true;
+		}
+	}
+
+	if (this->journal_compaction_flag == false && this->journal.getJournalSize() < JOURNAL_COMPACTION_SIZE) {
+		return;
+	}
+
+	records.clear();
+
+	QMutexLocker locker(&this->write_mutex);
+
+	// complete data of one version, later writes are journaled with a higher version
+	quint64 snapshot_data_version = this->data_version.load();
+
+	this->appendVariableRecords(this->joint_angles_variables, RobotChangeSet::VARIABLE_JOINT_ANGLES, records);
+	this->appendVariableRecords(this->numeric_variables, RobotChangeSet::VARIABLE_NUMERIC, records);
+	this->appendVariableRecords(this->pose_variables, RobotChangeSet::VARIABLE_POSE, records);
+	this->appendVariableRecords(this->string_variables, RobotChangeSet::VARIABLE_STRING, records);
+
+	std::shared_ptr<const Robot::ParameterMap> current_parameters = std::atomic_load(&this->parameters);
+	for (Robot::ParameterMap::const_iterator it = current_parameters->begin(); it != current_parameters->end(); ++it) {
+		VariableRecord record;
+		record.kind = VariableRecord::RECORD_PARAMETER;
+		record.name = it->first;
+		record.values = it->second;
+		records.push_back(record);
+	}
+
+	VariableRecord battery_record;
+	battery_record.kind = VariableRecord::RECORD_BATTERY;
+	battery_record.values.push_back(this->battery_power_on_time.load());
+	battery_record.values.push_back(this->battery_remaining_time.load());
+	records.push_back(battery_record);
+
+	locker.unlock();
+
+	this->journal_compaction_flag = (this->journal.writeSnapshot(records, snapshot_data_version) == false);
+}
+
+template<typename T>
+void Robot::appendVariableRecord(const VariableStore<T>& _store, const RobotChangeSet::Variable& _variable, std::vector<VariableRecord>& _records) const {
+	ReclamationDomain::ReadGuard guard(&this->domain);
+
+	VariableRecord record;
+	record.kind = VariableRecord::RECORD_VARIABLE_REMOVED;
+	record.type = _variable.type;
+	record.program_name = _variable.program_name;
+	record.name = _variable.variable_name;
+	record.index = _variable.variable_index;
+
+	VariableKey key;
+	T value;
+	if (_variable.removed_flag == false && this->findVariableKey(_variable.program_name, _variable.variable_name, _variable.variable_index, key) == true &&
+		_store.load(key, value) == true) {
+		record.kind = VariableRecord::RECORD_VARIABLE;
+		setRecordValue(record, value);
+	}
+
+	_records.push_back(record);
+}
+
+template<typename T>
+void Robot::appendVariableRecords(const VariableStore<T>& _store, RobotChangeSet::VariableType _type, std::vector<VariableRecord>& _records) const {
+	VariableKey key;
+	T value;
+
+	for (quint32 slot = 0; slot < _store.getNumberOfSlots(); ++slot) {
+		if (_store.loadSlot(slot, key, value) == false) {
+			continue;
+		}
+
+		VariableRecord record;
+		record.type = _type;
+		record.program_name = this->variable_names.getString(key.program_id);
+		record.name = this->variable_names.getString(key.name_id);
+		record.index = key.index;
+		setRecordValue(record, value);
+
+		_records.push_back(record);
+	}
+}
+
+void Robot::restoreRecords(const std::vector<VariableRecord>& _records) {
+	std::shared_ptr<Robot::ParameterMap> new_parameters;
+
+	for (std::size_t i = 0; i < _records.size(); ++i) {
+		const VariableRecord& record = _records[i];
+
+		switch (record.kind) {
+		case VariableRecord::RECORD_VARIABLE:
+		case VariableRecord::RECORD_VARIABLE_REMOVED: {
+			VariableKey key;
+			switch (record.type) {
+			case RobotChangeSet::VARIABLE_JOINT_ANGLES:
+				if (this->restoreVariable(this->joint_angles_variables, record, key) == true && record.kind == VariableRecord::RECORD_VARIABLE) {
+					this->publishJointState(key, this->joint_angles_variables.getValue(this->joint_angles_variables.find(key)));
+				}
+				break;
+			case RobotChangeSet::VARIABLE_NUMERIC:
+				this->restoreVariable(this->numeric_variables, record, key);
+				break;
+			case RobotChangeSet::VARIABLE_POSE:
+				this->restoreVariable(this->pose_variables, record, key);
+				break;
+			case RobotChangeSet::VARIABLE_STRING:
+				this->restoreVariable(this->string_variables, record, key);
+				break;
+			}
+			break;
+		}
+		case VariableRecord::RECORD_PARAMETER:
+		case VariableRecord::RECORD_PARAMETER_REMOVED:
+			if (new_parameters == NULL) {
+				new_parameters = std::make_shared<Robot::ParameterMap>(*std::atomic_load(&this->parameters));
+				++this->number_of_parameter_map_copies;
+			}
+
+			if (record.kind == VariableRecord::RECORD_PARAMETER) {
+				(*new_parameters)[record.name] = record.values;
+			} else {
+				new_parameters->erase(record.name);
+			}
+
+			this->recordParameterChange(record.name, record.kind == VariableRecord::RECORD_PARAMETER_REMOVED);
+			break;
+		case VariableRecord::RECORD_BATTERY:
+			if (record.values.size() == 2) {
+				this->battery_power_on_time.store(record.values[0]);
+				this->battery_remaining_time.store(record.values[1]);
+				this->recordBatteryChange();
+			}
+			break;
+		}
+	}
+
+	// one new parameter map for all restored parameters
+	if (new_parameters != NULL) {
+		std::atomic_store(&this->parameters, std::shared_ptr<const Robot::ParameterMap>(new_parameters));
+	}
+}
+
+template<typename T>
+bool Robot::restoreVariable(VariableStore<T>& _store, const VariableRecord& _record, VariableKey& _key) {
+	if (_record.kind == VariableRecord::RECORD_VARIABLE_REMOVED) {
+		if (this->findVariableKey(_record.program_name, _record.name, _record.index, _key) == false || _store.remove(_key) == false) {
+			return false;
+		}
+
+		this->recordVariableChange(_record.type, _key, true);
+		return true;
+	}
+
+	T value;
+	if (getRecordValue(_record, value) == false) {
+		return false;
+	}
+
+	_key = this->makeVariableKey(_record.program_name, _record.name, _record.index);
+	return this->writeVariable(_store, _record.type, _key, value);
+}
+
+template<typename T>
+void Robot::appendReachabilityPoints(const VariableStore<T>& _store, RobotChangeSet::VariableType _type, quint32 _program_id, std::vector<ReachabilityValidator::Point>& _points) const {
+	VariableKey key;
+	T value;
+
+	for (quint32 slot = 0; slot < _store.getNumberOfSlots(); ++slot) {
+		if (_store.loadSlot(slot, key, value) == false || (_program_id != StringInterner::INVALID_ID && key.program_id != _program_id)) {
+			continue;
+		}
+
+		ReachabilityValidator::Point point;
+		point.type = _type;
+		point.program_name = this->variable_names.getString(key.program_id);
+		point.variable_name = this->variable_names.getString(key.name_id);
+		point.variable_index = key.index;
+		getValues(value, point.values);
+
+		_points.push_back(point);
+	}
+}
+
+static std::size_t addBatchVariable(RobotVariableBatch& _batch, const RobotChangeSet::Variable& _variable, const RobotJointAngles& _joint_angles_variable) {
+	return _batch.addJointAnglesVariable(_variable.program_name, _variable.variable_name, _variable.variable_index, _joint_angles_variable);
+}
+
+static std::size_t addBatchVariable(RobotVariableBatch& _batch, const RobotChangeSet::Variable& _variable, double _numeric_variable) {
+	return _batch.addNumericVariable(_variable.program_name, _variable.variable_name, _variable.variable_index, _numeric_variable);
+}
+
+static std::size_t addBatchVariable(RobotVariableBatch& _batch, const RobotChangeSet::Variable& _variable, const RobotPose& _pose_variable) {
+	return _batch.addPoseVariable(_variable.program_name, _variable.variable_name, _variable.variable_index, _pose_variable);
+}
+
+static std::size_t addBatchVariable(RobotVariableBatch& _batch, const RobotChangeSet::Variable& _variable, const QString& _string_variable) {
+	return _batch.addStringVariable(_variable.program_name, _variable.variable_name, _variable.variable_index, _string_variable);
+}
+
+void Robot::deliverSubscriptions(const RobotChangeSet& _change_set) {
+	QMutexLocker locker(&this->subscription_mutex);
+
+	if (this->subscriptions.empty() == true) {
+		return;
+	}
+
+	ReclamationDomain::ReadGuard guard(&this->domain);
+
+	qint64 current_time = QDateTime::currentMSecsSinceEpoch();
+	qint64 next_delivery = -1;
+
+	for (std::size_t i = 0; i < this->subscriptions.size(); ++i) {
+		RobotVariableSubscription* subscription = this->subscriptions[i];
+
+		bool pending_flag = false;
+		VariableKey key;
+
+		for (std::size_t j = 0; j < _change_set.variables.size(); ++j) {
+			const RobotChangeSet::Variable& variable = _change_set.variables[j];
+
+			if (subscription->matches(variable) == true && this->findVariableKey(variable.program_name, variable.variable_name, variable.variable_index, key) == true) {
+				subscription->pending_variables[variable.type][key] = variable;
+			}
+		}
+
+		for (int type = 0; type < 4; ++type) {
+			pending_flag = pending_flag || subscription->pending_variables[type].empty() == false;
+		}
+
+		if (pending_flag == false) {
+			continue;
+		}
+
+		// the pending changes are delivered by a later notification
+		qint64 remaining_time = subscription->last_delivery_time + subscription->filter.min_interval - current_time;
+		if (remaining_time > 0) {
+			next_delivery = (next_delivery < 0) ? remaining_time : std::min(next_delivery, remaining_time);
+			continue;
+		}
+
+		RobotVariableBatch batch;
+
+		for (int type = 0; type < 4; ++type) {
+			std::unordered_map<VariableKey, RobotChangeSet::Variable, VariableKeyHash>& pending_variables = subscription->pending_variables[type];
+
+			for (std::unordered_map<VariableKey, RobotChangeSet::Variable, VariableKeyHash>::const_iterator it = pending_variables.begin(); it != pending_variables.end(); ++it) {
+				switch (it->second.type) {
+				case RobotChangeSet::VARIABLE_JOINT_ANGLES:
+					this->addSubscriptionValue(this->joint_angles_variables, subscription, it->first, it->second, batch);
+					break;
+				case RobotChangeSet::VARIABLE_NUMERIC:
+					this->addSubscriptionValue(this->numeric_variables, subscription, it->first, it->second, batch);
+					break;
+				case RobotChangeSet::VARIABLE_POSE:
+					this->addSubscriptionValue(this->pose_variables, subscription, it->first, it->second, batch);
+					break;
+				case RobotChangeSet::VARIABLE_STRING:
+					this->addSubscriptionValue(this->string_variables, subscription, it->first, it->second, batch);
+					break;
+				}
+			}
+
+			pending_variables.clear();
+		}
+
+		if (batch.isEmpty() == false) {
+			subscription->last_delivery_time = current_time;
+			subscription->deliver(batch);
+		}
+	}
+
+	// rate limited changes have their own timer, so new writes neither postpone nor advance them
+	if (next_delivery >= 0 && (this->subscription_timer->isActive() == false || this->subscription_timer->remainingTime() > next_delivery)) {
+		this->subscription_timer->start(static_cast<int>(next_delivery));
+	}
+}
+
+template<typename T>
+void Robot::addSubscriptionValue(const VariableStore<T>& _store, RobotVariableSubscription* _subscription, const VariableKey& _key, const RobotChangeSet::Variable& _variable, RobotVariableBatch& _batch) const {
+	std::unordered_map<VariableKey, std::vector<double>, VariableKeyHash>& delivered_values = _subscription->delivered_values[_variable.type];
+
+	T value = T();
+	if (_store.load(_key, value) == false) {
+		delivered_values.erase(_key);
+		addBatchVariable(_batch, _variable, value);
+		return;
+	}
+
+	double values[8];
+	std::size_t number_of_values = getValues(value, values);
+
+	if (_subscription->filter.deadband > 0.0 && number_of_values > 0) {
+		std::unordered_map<VariableKey, std::vector<double>, VariableKeyHash>::const_iterator it = delivered_values.find(_key);
+
+		if (it != delivered_values.end()) {
+			bool moved_flag = false;
+			for (std::size_t i = 0; i < number_of_values; ++i) {
+				moved_flag = moved_flag || std::fabs(values[i] - it->second[i]) >= _subscription->filter.deadband;
+			}
+
+			if (moved_flag == false) {
+				return;
+			}
+		}
+
+		delivered_values[_key].assign(values, values + number_of_values);
+	}
+
+	std::size_t entry_index = addBatchVariable(_batch, _variable, value);
+	_batch.entries[entry_index].found_flag = true;
+}
+
+template<typename T>
+void Robot::startHistory(const VariableStore<T>& _store, RobotChangeSet::VariableType _type, const VariableKey& _key, std::size_t _capacity) {
+	QMutexLocker history_locker(&this->history_mutex);
+
+	std::shared_ptr<VariableHistory>& history = this->variable_histories[_type][_key];
+	if (history != NULL) {
+		return;
+	}
+
+	double values[8];
+	history = std::make_shared<VariableHistory>(getValues(T(), values), _capacity);
+
+	// starts with the current value
+	quint32 slot = _store.find(_key);
+	if (slot != VariableIndex::INVALID_SLOT) {
+		getValues(_store.getValue(slot), values);
+		history->append(QDateTime::currentMSecsSinceEpoch(), values);
+	}
+}
+
+template<typename T>
+void Robot::recordHistory(RobotChangeSet::VariableType _type, const VariableKey& _key, const T& _value) {
+	QMutexLocker history_locker(&this->history_mutex);
+
+	std::unordered_map<VariableKey, std::shared_ptr<VariableHistory>, VariableKeyHash>::iterator it = this->variable_histories[_type].find(_key);
+	if (it == this->variable_histories[_type].end()) {
+		return;
+	}
+
+	double values[8];
+	if (getValues(_value, values) == it->second->getDof()) {
+		it->second->append(QDateTime::currentMSecsSinceEpoch(), values);
+	}
+}
+
+template<typename T>
+bool Robot::writeVariable(VariableStore<T>& _store, RobotChangeSet::VariableType _type, const VariableKey& _key, const T& _value) {
+	bool inserted_flag = false;
+	quint32 slot = _store.insert(_key, _value, inserted_flag);
+
+	if (inserted_flag == false) {
+		if (isSameValue(_store.getValue(slot), _value) == true) {
+			return false;
+		}
+
+		_store.store(slot, _value);
+	}
+
+	this->recordVariableChange(_type, _key, false);
+
+	if (this->history_flag == true) {
+		this->recordHistory(_type, _key, _value);
+	}
+
+	return true;
+}
+
+template<typename T>
+bool Robot::writeVariable(VariableStore<T>& _store, RobotChangeSet::VariableType _type, quint32 _slot, const T& _value) {
+	if (isSameValue(_store.getValue(_slot), _value) == true) {
+		return false;
+	}
+
+	_store.store(_slot, _value);
+	this->recordVariableChange(_type, _store.getKey(_slot), false);
+
+	if (this->history_flag == true) {
+		this->recordHistory(_type, _store.getKey(_slot), _value);
+	}
+
+	return true;
+}
+
+void Robot::recordVariableChange(RobotChangeSet::VariableType _type, const VariableKey& _key, bool _removed_flag) {
+	this->pending_variable_changes[_type][_key] = _removed_flag ? 1 : 0;
+	++this->pending_number_of_writes;
+	++this->data_version;
+
+	this->scheduleChangeNotification();
+}
+
+void Robot::recordParameterChange(const QString& _parameter_name, bool _removed_flag) {
+	this->pending_parameter_changes[_parameter_name] = _removed_flag ? 1 : 0;
+	++this->pending_number_of_writes;
+	++this->data_version;
+
+	this->scheduleChangeNotification();
+}
+
+void Robot::recordBatteryChange() {
+	this->pending_battery_changed_flag = true;
+	++this->pending_number_of_writes;
+	++this->data_version;
 
-	this->battery_remaining_time = _battery_remaining_time;
+	this->scheduleChangeNotification();
+}
+
+void Robot::scheduleChangeNotification() {
+	if (this->change_notification_scheduled_flag == true) {
+		return;
+	}
+
+	// writers run on any thread, the timer is started from the robot thread, which needs a running event loop
+	// for the queued call; the flag coalesces all writes until the next flushChanges() into one start
+	this->change_notification_scheduled_flag = true;
+	QMetaObject::invokeMethod(this, "startChangeNotificationTimer", Qt::QueuedConnection);
+}
+
+void Robot::startChangeNotificationTimer() {
+	if (this->change_timer->isActive() == true) {
+		return;
+	}
+
+	this->change_timer->start(this->change_notification_interval.load());
+}
+
+void Robot::deliverPendingSubscriptions() {
+	this->deliverSubscriptions(RobotChangeSet());
+}
+
+void Robot::flushChanges() {
+	RobotChangeSet change_set;
+
+	QMutexLocker locker(&this->write_mutex);
+
+	const RobotChangeSet::VariableType types[4] = {
+		RobotChangeSet::VARIABLE_JOINT_ANGLES,
+		RobotChangeSet::VARIABLE_NUMERIC,
+		RobotChangeSet::VARIABLE_POSE,
+		RobotChangeSet::VARIABLE_STRING
+	};
+
+	for (int i = 0; i < 4; ++i) {
+		std::unordered_map<VariableKey, char, VariableKeyHash>& pending_changes = this->pending_variable_changes[types[i]];
+
+		for (std::unordered_map<VariableKey, char, VariableKeyHash>::const_iterator it = pending_changes.begin(); it != pending_changes.end(); ++it) {
+			RobotChangeSet::Variable variable;
+			variable.type = types[i];
+			variable.program_name = this->variable_names.getString(it->first.program_id);
+			variable.variable_name = this->variable_names.getString(it->first.name_id);
+			variable.variable_index = it->first.index;
+			variable.removed_flag = (it->second != 0);
+
+			change_set.variables.push_back(variable);
+		}
+
+		pending_changes.clear();
+	}
+
+	for (std::map<QString, char>::const_iterator it = this->pending_parameter_changes.begin(); it != this->pending_parameter_changes.end(); ++it) {
+		RobotChangeSet::Parameter parameter;
+		parameter.name = it->first;
+		parameter.removed_flag = (it->second != 0);
+
+		change_set.parameters.push_back(parameter);
+	}
+	this->pending_parameter_changes.clear();
+
+	change_set.battery_changed_flag = this->pending_battery_changed_flag;
+	change_set.setVersion(this->data_version.load());
+	change_set.setNumberOfWrites(this->pending_number_of_writes);
+
+	this->pending_battery_changed_flag = false;
+	this->pending_number_of_writes = 0;
+	this->change_notification_scheduled_flag = false;
 
 	locker.unlock();
-	emit robotDataChanged();
+
+	QMutexLocker journal_locker(&this->journal_mutex);
+	this->persistChanges(change_set);
+	journal_locker.unlock();
+
+	this->deliverSubscriptions(change_set);
+
+	if (change_set.isEmpty() == false) {
+		this->updateRobotRepresentationSnapshot(change_set);
+
+		emit robotDataChangeSet(change_set);
+		emit robotDataChanged();
+	}
 }
 
 void Robot::moveObjectToMainThread() {
@@ -5,7 +5,8 @@
 #include <QVariant>
 #include <QString>
 #include <QCoreApplication>
-#include <QReadWriteLock>
+#include <QMutex>
+#include <QTimer>
 #include <rl/math/Transform.h>
 #include <rl/math/Unit.h>
 #include <rl/mdl/Kinematic.h>
@@ -14,11 +15,28 @@
 #include <rl/mdl/InverseKinematics.h>
 #include <rl/mdl/NloptInverseKinematics.h>
 
+#include <atomic>
 #include <map>
+#include <memory>
+#include <unordered_map>
 
 #include "representations/RobotRepresentation.h"
+#include "JointState.h"
+#include "ReachabilityValidator.h"
+#include "ReclamationDomain.h"
+#include "RobotChangeSet.h"
+#include "RobotMemoryStats.h"
+#include "RobotRepresentationSnapshot.h"
+#include "RobotVariableBatch.h"
+#include "RobotVariableSubscription.h"
 #include "RobotJointAngles.h"
 #include "RobotPose.h"
+#include "StringInterner.h"
+#include "TripleBuffer.h"
+#include "VariableHandle.h"
+#include "VariableHistory.h"
+#include "VariableJournal.h"
+#include "VariableStore.h"
 
 
 namespace vm {
@@ -26,6 +44,8 @@ namespace vm {
 class Robot : public QObject {
 	Q_OBJECT
 public:
+	// Attribute values are kept in their native type. Writes are checked against the type, clamped to the range and
+	// snapped to the step size once, typed reads return the stored value without conversion.
 	class Attribute {
 	public:
 		enum ValueType {
@@ -53,9 +73,29 @@ public:
 		Attribute::ValueType getValueType() const;
 		void setValueType(Attribute::ValueType _value_type);
 
+		// typed access, setters return false if the attribute has another type or the enum value is unknown
+		int getIntValue() const;
+		bool setIntValue(int _value);
+
+		double getRealValue() const;
+		bool setRealValue(double _value);
+
+		const QString& getStringValue() const;
+		bool setStringValue(const QString& _value);
+
+		// -1 if the enum list is empty
+		int getEnumIndex() const;
+		bool setEnumIndex(int _index);
+		// empty string if the enum list is empty
+		const QString& getEnumValue() const;
+		bool setEnumValue(const QString& _value);
+		const QStringList& getEnumValues() const;
+
 		QVariant getValue() const;
-		void setValue(const QVariant& _value);
+		// the variant must hold the attribute type (a string for enums)
+		bool setValue(const QVariant& _value);
 
+		// the value list for enums
 		QVariant getDefaultValue() const;
 		void setDefaultValue(const QVariant& _default_value);
 
@@ -68,16 +108,35 @@ public:
 		QVariant getStepSize() const;
 		void setStepSize(const QVariant& _step_size);
 
+		// estimated bytes of the attribute and its strings
+		std::size_t getMemoryUsage() const;
+
 	private:
 		QString name;
 		bool read_only_flag;
 
 		Attribute::ValueType value_type;
-		QVariant value;
-		QVariant default_value;
-		QVariant min_value;
-		QVariant max_value;
-		QVariant step_size;
+
+		// TYPE_INT, the enum index for TYPE_ENUM
+		int int_value;
+		int int_default_value;
+		int int_min_value;
+		int int_max_value;
+		int int_step_size;
+
+		// TYPE_REAL
+		double real_value;
+		double real_default_value;
+		double real_min_value;
+		double real_max_value;
+		double real_step_size;
+
+		// TYPE_STRING
+		QString string_value;
+		QString string_default_value;
+
+		// TYPE_ENUM
+		QStringList enum_values;
 	};
 
 	typedef std::map<QString, Robot::Attribute> AttributeMap;
@@ -85,6 +144,13 @@ public:
 	typedef AttributeMap::iterator AttributeIter;
 	typedef AttributeMap::const_iterator AttributeConstIter;
 
+	typedef std::map<QString, std::vector<double> > ParameterMap;
+
+	typedef VariableHandle<RobotJointAngles> JointAnglesVariableHandle;
+	typedef VariableHandle<double> NumericVariableHandle;
+	typedef VariableHandle<RobotPose> PoseVariableHandle;
+	typedef VariableHandle<QString> StringVariableHandle;
+
 
 	Robot(QObject* _parent = NULL);
 	virtual ~Robot();
@@ -104,6 +170,9 @@ public:
 	virtual void removeAttribute(const QString& _name);
 	virtual void removeAllAttributes();
 
+	// NULL if the attribute does not exist, the pointer is valid until the attribute is set or removed
+	virtual const Robot::Attribute* findAttribute(const QString& _name) const;
+
 	virtual bool getAttributeValue(const QString& _name, Robot::Attribute::ValueType& _value_type, QVariant& _value) const;
 	virtual bool setAttributeValue(const QString& _name, const QVariant& _value);
 
@@ -117,6 +186,8 @@ public:
 	virtual void removeConnectionAttribute(size_t _connection_index, const QString& _name);
 	virtual void removeAllConnectionAttributes(size_t _connection_index);
 
+	virtual const Robot::Attribute* findConnectionAttribute(size_t _connection_index, const QString& _name) const;
+
 	virtual bool getConnectionAttributeValue(size_t _connection_index, const QString& _name, Robot::Attribute::ValueType& _value_type, QVariant& _value) const;
 	virtual bool setConnectionAttributeValue(size_t _connection_index, const QString& _name, const QVariant& _value);
 
@@ -128,6 +199,10 @@ public:
 
 	virtual void initRobotRepresentation(RobotRepresentation& _robot_representation);
 
+	// Shared (copy-on-write) representation, built on the first call and then updated from the change sets.
+	// Every update is also sent as robotRepresentationUpdated(), receivers apply the delta instead of rebuilding.
+	virtual RobotRepresentationSnapshot getRobotRepresentationSnapshot();
+
 	virtual bool getJointAnglesVariable(QString _program_name, QString _variable_name, unsigned int _variable_index, RobotJointAngles& _joint_angles_variable) const;
 	virtual bool removeJointAnglesVariable(QString _program_name, QString _variable_name, unsigned int _variable_index);
 	
@@ -140,6 +215,32 @@ public:
 	virtual bool getStringVariable(QString _program_name, QString _variable_name, unsigned int _variable_index, QString& _string_variable) const;
 	virtual bool removeStringVariable(QString _program_name, QString _variable_name, unsigned int _variable_index);
 
+	// Handles resolve a variable once, get/set by handle do not hash or compare the names.
+	// A null handle is returned if the variable does not exist, unless _create_flag adds it with a default value.
+	// Get/set by handle return false after the variable was removed, the handle has to be resolved again.
+	virtual Robot::JointAnglesVariableHandle resolveJointAnglesVariable(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, bool _create_flag = false);
+	virtual bool getJointAnglesVariable(const Robot::JointAnglesVariableHandle& _handle, RobotJointAngles& _joint_angles_variable) const;
+	virtual bool setJointAnglesVariable(const Robot::JointAnglesVariableHandle& _handle, const RobotJointAngles& _joint_angles_variable);
+
+	virtual Robot::NumericVariableHandle resolveNumericVariable(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, bool _create_flag = false);
+	virtual bool getNumericVariable(const Robot::NumericVariableHandle& _handle, double& _numeric_variable) const;
+	virtual bool setNumericVariable(const Robot::NumericVariableHandle& _handle, double _numeric_variable);
+
+	virtual Robot::PoseVariableHandle resolvePoseVariable(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, bool _create_flag = false);
+	virtual bool getPoseVariable(const Robot::PoseVariableHandle& _handle, RobotPose& _pose_variable) const;
+	virtual bool setPoseVariable(const Robot::PoseVariableHandle& _handle, const RobotPose& _pose_variable);
+
+	virtual Robot::StringVariableHandle resolveStringVariable(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, bool _create_flag = false);
+	virtual bool getStringVariable(const Robot::StringVariableHandle& _handle, QString& _string_variable) const;
+	virtual bool setStringVariable(const Robot::StringVariableHandle& _handle, const QString& _string_variable);
+
+	// Whole lists under one acquisition of the write mutex, e.g. for a program upload from the controller.
+	// getVariables() sets the found flag and value of every entry and returns the number found, the values are
+	// consistent with each other. setVariables() creates missing variables and returns the number of changed values,
+	// all of them are reported in the same change notification.
+	virtual std::size_t getVariables(RobotVariableBatch& _batch) const;
+	virtual std::size_t setVariables(const RobotVariableBatch& _batch);
+
 	virtual bool getParameter(QString _parameter_name, std::vector<double>& _values) const;
 	virtual bool removeParameter(QString _parameter_name);
 	
@@ -149,6 +250,54 @@ public:
 	virtual double getBatteryRemainingTime() const;
 	virtual void setBatteryRemainingTime(double _battery_remaining_time);
 
+	// Writes are reported as one RobotChangeSet per window, started by the first write after the last notification.
+	// 0 notifies on the next event loop iteration of the robot thread.
+	virtual int getChangeNotificationInterval() const;
+	virtual void setChangeNotificationInterval(int _change_notification_interval);
+
+	// increases with every write that changed the robot data
+	virtual quint64 getDataVersion() const;
+
+	// Keeps the robot data in <_base_name>.snapshot and <_base_name>.journal and restores the persisted data at once,
+	// so a restarted robot starts with the last known values and the next read from the controller only changes what
+	// differs. Changes are journaled with each notification, the journal is compacted into a new snapshot when it grows.
+	virtual bool enablePersistence(const QString& _base_name);
+	virtual void disablePersistence();
+
+	// Checks the joint angles and pose variables of _program_name (of all programs if empty) with _validator, e.g. after
+	// a program upload. _points and _results list every checked variable, returns the number of problems found.
+	virtual std::size_t validateReachability(const QString& _program_name, ReachabilityValidator& _validator,
+		std::vector<ReachabilityValidator::Point>& _points, std::vector<ReachabilityValidator::Result>& _results) const;
+
+	// Only the changes of the matching variables, delivered to the calling thread, see RobotVariableSubscription.
+	// Filtering and rate limiting run in the robot thread when the change notification is sent.
+	virtual RobotVariableSubscription* subscribeVariables(const RobotVariableSubscription::Filter& _filter);
+	virtual void unsubscribeVariables(RobotVariableSubscription* _subscription);
+
+	// Optional history of a joint angles, numeric or pose variable, every changed value is recorded with its time
+	// (milliseconds since epoch) into a compressed ring of _capacity bytes, the oldest samples are dropped when it is full.
+	// Queries return 8 values per sample for joint angles (J1 .. J8) and poses (X .. C, F1, F2), 1 for numeric variables.
+	virtual bool enableVariableHistory(RobotChangeSet::VariableType _type, const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, std::size_t _capacity = 64 * 1024);
+	virtual void disableVariableHistory(RobotChangeSet::VariableType _type, const QString& _program_name, const QString& _variable_name, unsigned int _variable_index);
+	virtual bool getVariableHistory(RobotChangeSet::VariableType _type, const QString& _program_name, const QString& _variable_name, unsigned int _variable_index,
+		qint64 _start_time, qint64 _end_time, std::vector<qint64>& _times, std::vector<double>& _values) const;
+
+	// Entry counts and estimated bytes of the variable stores per program and type, of the names, attributes,
+	// parameters and histories, and the allocation counters. Called from the robot thread like the attribute accessors,
+	// writers are blocked while the variables are counted.
+	virtual void getMemoryStats(RobotMemoryStats& _memory_stats) const;
+
+	// Adds the memory stats to every representation as parameters named memory/<container>, values are
+	// (entries, bytes, ...), see addMemoryStatsRepresentations(). The snapshot refreshes them with every update,
+	// they are not listed in the change set of the delta.
+	virtual bool isMemoryStatsRepresentationEnabled() const;
+	virtual void setMemoryStatsRepresentationEnabled(bool _memory_stats_representation_flag);
+
+	// joint angles variable that is mirrored into the live joint state buffer, e.g. the current position of the driver
+	virtual void setLiveJointAnglesVariable(QString _program_name, QString _variable_name, unsigned int _variable_index);
+	// single consumer (e.g. a 3D view) reads the latest state without blocking the robot thread
+	virtual TripleBuffer<JointState>& getJointStateBuffer();
+
 
 public slots:
 	virtual void moveObjectToMainThread();
@@ -170,7 +319,11 @@ public slots:
 	//void receivedData(QByteArray _data);
 
 signals:
+	// both are emitted once per notification window, writes that did not change a value are not reported
 	void robotDataChanged();
+	void robotDataChangeSet(RobotChangeSet _change_set);
+	// only after getRobotRepresentationSnapshot() was called once
+	void robotRepresentationUpdated(RobotRepresentationDelta _delta);
 	
 	void restartRequested();
 
@@ -186,22 +339,135 @@ protected:
 	std::vector<char> connection_use_flags;
 	std::vector<Robot::AttributeMap> connection_attributes;
 
-	mutable QReadWriteLock data_lock;
+	// Readers never lock: variables are copied from their slot under a sequence lock, parameters are an immutable
+	// map replaced on change. Writers are serialized by write_mutex and publish their changes to the readers.
+	mutable QMutex write_mutex;
+	ReclamationDomain domain;
 
-		// program_name -> variable_name -> variable_index (0==no index) -> variable
-		std::map<QString, std::map<QString, std::map<unsigned int, RobotJointAngles> > > joint_angles_variables;
-		std::map<QString, std::map<QString, std::map<unsigned int, double> > > numeric_variables;
-		std::map<QString, std::map<QString, std::map<unsigned int, RobotPose> > > pose_variables;
-		std::map<QString, std::map<QString, std::map<unsigned int, QString> > > string_variables;
+		// program and variable names of all variables, keys are (program_id, name_id, variable_index (0==no index))
+		StringInterner variable_names;
 
-		// parameter_name -> parameter values
-		std::map<QString, std::vector<double> > parameters;
+		VariableStore<RobotJointAngles> joint_angles_variables;
+		VariableStore<double> numeric_variables;
+		VariableStore<RobotPose> pose_variables;
+		VariableStore<QString> string_variables;
 
-		double battery_power_on_time;
-		double battery_remaining_time;
-private:
+		// parameter_name -> parameter values, accessed with std::atomic_load/atomic_store
+		std::shared_ptr<const Robot::ParameterMap> parameters;
+		std::size_t number_of_parameter_map_copies;
 
-	
+		std::atomic<double> battery_power_on_time;
+		std::atomic<double> battery_remaining_time;
+
+		VariableKey live_variable_key;
+		bool live_joint_angles_flag;
+		std::uint64_t joint_state_sequence;
+
+		// written under the write mutex, so setters from several threads still form a single producer
+		TripleBuffer<JointState> joint_state_buffer;
+
+		// changes since the last notification, value is the removed flag of the last write
+		std::unordered_map<VariableKey, char, VariableKeyHash> pending_variable_changes[4];
+		std::map<QString, char> pending_parameter_changes;
+		bool pending_battery_changed_flag;
+		std::size_t pending_number_of_writes;
+		bool change_notification_scheduled_flag;
+
+	// histories are appended with the write mutex held, history_flag is only changed with it held
+	mutable QMutex history_mutex;
+	std::unordered_map<VariableKey, std::shared_ptr<VariableHistory>, VariableKeyHash> variable_histories[4];
+	bool history_flag;
+
+	// locked before the write mutex
+	QMutex journal_mutex;
+	VariableJournal journal;
+	// write a snapshot at the next notification instead of a journal entry
+	bool journal_compaction_flag;
+
+	QMutex subscription_mutex;
+	std::vector<RobotVariableSubscription*> subscriptions;
+
+	QMutex representation_mutex;
+	RobotRepresentationSnapshot representation_snapshot;
+
+	std::atomic<bool> memory_stats_representation_flag;
+
+	// single shot, started at most once per notification
+	QTimer* change_timer;
+	// delivers rate limited subscription changes
+	QTimer* subscription_timer;
+	std::atomic<int> change_notification_interval;
+	std::atomic<quint64> data_version;
+
+private slots:
+	void startChangeNotificationTimer();
+	void flushChanges();
+	void deliverPendingSubscriptions();
+
+private:
+	// false if one of the names was never used, then no variable with this key exists
+	bool findVariableKey(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, VariableKey& _key) const;
+	VariableKey makeVariableKey(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index);
+
+	// called with the write mutex held
+	void publishJointState(const VariableKey& _key, const RobotJointAngles& _joint_angles_variable);
+
+	// _robot_representation is a RobotRepresentation or a RobotRepresentationSnapshot
+	template<typename R>
+	void addRobotRepresentations(R& _robot_representation);
+	template<typename T, typename R>
+	void initVariableRepresentations(const VariableStore<T>& _store, R& _robot_representation) const;
+	template<typename T>
+	void updateVariableRepresentation(const VariableStore<T>& _store, const RobotChangeSet::Variable& _variable, RobotRepresentationSnapshot& _snapshot) const;
+	void updateRobotRepresentationSnapshot(const RobotChangeSet& _change_set);
+	template<typename R>
+	void addMemoryStatsRepresentations(R& _robot_representation) const;
+
+	// called with the write mutex held
+	template<typename T>
+	void addVariableMemoryStats(const VariableStore<T>& _store, RobotChangeSet::VariableType _type, RobotMemoryStats& _memory_stats) const;
+
+	// called with the write mutex held, interns the program name only when it differs from the previous entry
+	VariableKey makeVariableKey(const RobotVariableBatch::Entry& _entry, QString& _program_name, quint32& _program_id);
+
+	// called with the journal mutex held
+	void persistChanges(const RobotChangeSet& _change_set);
+	template<typename T>
+	void appendVariableRecord(const VariableStore<T>& _store, const RobotChangeSet::Variable& _variable, std::vector<VariableRecord>& _records) const;
+	template<typename T>
+	void appendVariableRecords(const VariableStore<T>& _store, RobotChangeSet::VariableType _type, std::vector<VariableRecord>& _records) const;
+
+	// called with the write mutex held
+	void restoreRecords(const std::vector<VariableRecord>& _records);
+	template<typename T>
+	bool restoreVariable(VariableStore<T>& _store, const VariableRecord& _record, VariableKey& _key);
+
+	template<typename T>
+	void appendReachabilityPoints(const VariableStore<T>& _store, RobotChangeSet::VariableType _type, quint32 _program_id, std::vector<ReachabilityValidator::Point>& _points) const;
+
+	// called from flushChanges()
+	void deliverSubscriptions(const RobotChangeSet& _change_set);
+	template<typename T>
+	void addSubscriptionValue(const VariableStore<T>& _store, RobotVariableSubscription* _subscription, const VariableKey& _key, const RobotChangeSet::Variable& _variable, RobotVariableBatch& _batch) const;
+
+	// called with the write mutex held
+	template<typename T>
+	void startHistory(const VariableStore<T>& _store, RobotChangeSet::VariableType _type, const VariableKey& _key, std::size_t _capacity);
+	template<typename T>
+	void recordHistory(RobotChangeSet::VariableType _type, const VariableKey& _key, const T& _value);
+
+	// called with the write mutex held, return false and record nothing if the value did not change
+	template<typename T>
+	bool writeVariable(VariableStore<T>& _store, RobotChangeSet::VariableType _type, const VariableKey& _key, const T& _value);
+	template<typename T>
+	bool writeVariable(VariableStore<T>& _store, RobotChangeSet::VariableType _type, quint32 _slot, const T& _value);
+
+	// called with the write mutex held
+	void recordVariableChange(RobotChangeSet::VariableType _type, const VariableKey& _key, bool _removed_flag);
+	void recordParameterChange(const QString& _parameter_name, bool _removed_flag);
+	void recordBatteryChange();
+	// posts the timer start to the robot thread, notifications are only sent while it runs an event loop
+	void scheduleChangeNotification();
 
 };
 
@@ -0,0 +1,58 @@
+#include "RobotChangeSet.h"
+
+namespace vm {
+
+RobotChangeSet::RobotChangeSet() {
+	this->battery_changed_flag = false;
+	this->version = 0;
+	this->number_of_writes = 0;
+}
+
+void RobotChangeSet::clear() {
+	this->variables.clear();
+	this->parameters.clear();
+	this->battery_changed_flag = false;
+	this->number_of_writes = 0;
+}
+
+bool RobotChangeSet::isEmpty() const {
+	return this->variables.empty() == true && this->parameters.empty() == true && this->battery_changed_flag == false;
+}
+
+quint64 RobotChangeSet::getVersion() const {
+	return this->version;
+}
+
+void RobotChangeSet::setVersion(quint64 _version) {
+	this->version = _version;
+}
+
+std::size_t RobotChangeSet::getNumberOfWrites() const {
+	return this->number_of_writes;
+}
+
+void RobotChangeSet::setNumberOfWrites(std::size_t _number_of_writes) {
+	this->number_of_writes = _number_of_writes;
+}
+
+bool RobotChangeSet::hasVariables() const {
+	return this->variables.empty() == false;
+}
+
+bool RobotChangeSet::hasRemovals() const {
+	for (std::size_t i = 0; i < this->variables.size(); ++i) {
+		if (this->variables[i].removed_flag == true) {
+			return true;
+		}
+	}
+
+	for (std::size_t i = 0; i < this->parameters.size(); ++i) {
+		if (this->parameters[i].removed_flag == true) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+}
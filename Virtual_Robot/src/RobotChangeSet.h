@@ -0,0 +1,64 @@
+#ifndef VM_ROBOT_CHANGE_SET_H
+#define VM_ROBOT_CHANGE_SET_H
+
+#include <QMetaType>
+#include <QString>
+
+#include <vector>
+
+namespace vm {
+
+// Keys of the robot data changed within one notification window, each key is listed once.
+class RobotChangeSet {
+public:
+	enum VariableType {
+		VARIABLE_JOINT_ANGLES,
+		VARIABLE_NUMERIC,
+		VARIABLE_POSE,
+		VARIABLE_STRING
+	};
+
+	struct Variable {
+		RobotChangeSet::VariableType type;
+		QString program_name;
+		QString variable_name;
+		unsigned int variable_index;
+		// the variable does not exist anymore, otherwise it was added or its value changed
+		bool removed_flag;
+	};
+
+	struct Parameter {
+		QString name;
+		bool removed_flag;
+	};
+
+	RobotChangeSet();
+
+	void clear();
+	bool isEmpty() const;
+
+	// version of the robot data after the last write in this set, increases with every write
+	quint64 getVersion() const;
+	void setVersion(quint64 _version);
+
+	// number of writes coalesced into this set, repeated writes of a key are counted each time
+	std::size_t getNumberOfWrites() const;
+	void setNumberOfWrites(std::size_t _number_of_writes);
+
+	bool hasVariables() const;
+	bool hasRemovals() const;
+
+	std::vector<RobotChangeSet::Variable> variables;
+	std::vector<RobotChangeSet::Parameter> parameters;
+	bool battery_changed_flag;
+
+private:
+	quint64 version;
+	std::size_t number_of_writes;
+};
+
+}
+
+Q_DECLARE_METATYPE(vm::RobotChangeSet)
+
+#endif /* VM_ROBOT_CHANGE_SET_H */
@@ -0,0 +1,34 @@
+#include "RobotMemoryStats.h"
+
+namespace vm {
+
+std::size_t RobotMemoryStats::Program::getNumberOfBytes() const {
+	std::size_t number_of_bytes = 0;
+	for (int i = 0; i < 4; ++i) {
+		number_of_bytes += this->variables[i].number_of_bytes;
+	}
+
+	return number_of_bytes;
+}
+
+RobotMemoryStats::RobotMemoryStats() {
+	this->number_of_parameter_map_copies = 0;
+}
+
+void RobotMemoryStats::clear() {
+	*this = RobotMemoryStats();
+}
+
+std::size_t RobotMemoryStats::getNumberOfBytes() const {
+	std::size_t number_of_bytes = this->names.number_of_bytes + this->attributes.number_of_bytes +
+		this->connection_attributes.number_of_bytes + this->parameters.number_of_bytes + this->histories.number_of_bytes;
+
+	// the programs are part of the variable stores
+	for (int i = 0; i < 4; ++i) {
+		number_of_bytes += this->variables[i].number_of_bytes;
+	}
+
+	return number_of_bytes;
+}
+
+}
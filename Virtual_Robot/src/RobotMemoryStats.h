@@ -0,0 +1,90 @@
+#ifndef VM_ROBOT_MEMORY_STATS_H
+#define VM_ROBOT_MEMORY_STATS_H
+
+#include <QMetaType>
+#include <QString>
+
+#include <map>
+
+#include "RobotChangeSet.h"
+
+namespace vm {
+
+// Memory of the robot data, filled by Robot::getMemoryStats().
+// Byte counts are estimates of the allocated memory including the container overhead, implicitly shared
+// string buffers are counted with every owner.
+class RobotMemoryStats {
+public:
+	struct Usage {
+		Usage() {
+			this->number_of_entries = 0;
+			this->number_of_bytes = 0;
+		}
+
+		void add(std::size_t _number_of_entries, std::size_t _number_of_bytes) {
+			this->number_of_entries += _number_of_entries;
+			this->number_of_bytes += _number_of_bytes;
+		}
+
+		std::size_t number_of_entries;
+		std::size_t number_of_bytes;
+	};
+
+	// allocations of one variable type since the robot was created
+	struct Counters {
+		Counters() {
+			this->number_of_inserts = 0;
+			this->number_of_removals = 0;
+			this->number_of_chunk_allocations = 0;
+			this->number_of_value_allocations = 0;
+			this->number_of_index_rehashes = 0;
+		}
+
+		std::size_t number_of_inserts;
+		std::size_t number_of_removals;
+		std::size_t number_of_chunk_allocations;
+		// every write of a string variable allocates the new value
+		std::size_t number_of_value_allocations;
+		std::size_t number_of_index_rehashes;
+	};
+
+	// variables of one program, indexed by RobotChangeSet::VariableType
+	struct Program {
+		std::size_t getNumberOfBytes() const;
+
+		RobotMemoryStats::Usage variables[4];
+	};
+
+	RobotMemoryStats();
+
+	void clear();
+
+	// sum of all containers below
+	std::size_t getNumberOfBytes() const;
+
+	// slots and values of the variables in use, the program and variable names are counted in names
+	std::map<QString, RobotMemoryStats::Program> programs;
+
+	// whole store of each variable type: every allocated slot (used or free), the index and the values,
+	// number_of_entries is the number of variables
+	RobotMemoryStats::Usage variables[4];
+	RobotMemoryStats::Counters variable_counters[4];
+
+	// program and variable names
+	RobotMemoryStats::Usage names;
+
+	RobotMemoryStats::Usage attributes;
+	RobotMemoryStats::Usage connection_attributes;
+
+	RobotMemoryStats::Usage parameters;
+	// every parameter write copies the parameter map
+	std::size_t number_of_parameter_map_copies;
+
+	RobotMemoryStats::Usage histories;
+};
+
+}
+
+Q_DECLARE_METATYPE(vm::RobotMemoryStats)
+
+#endif /* VM_ROBOT_MEMORY_STATS_H */
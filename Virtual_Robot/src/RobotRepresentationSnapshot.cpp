@@ -0,0 +1,225 @@
+#include "RobotRepresentationSnapshot.h"
+
+namespace vm {
+
+bool RobotRepresentationSnapshot::Program::isEmpty() const {
+	return this->string_variables.isEmpty() == true && this->joint_angles_variables.isEmpty() == true && this->numeric_variables.isEmpty() == true && this->pose_variables.isEmpty() == true;
+}
+
+RobotRepresentationSnapshot::RobotRepresentationSnapshot() {
+}
+
+bool RobotRepresentationSnapshot::isNull() const {
+	return this->data.constData() == NULL;
+}
+
+quint64 RobotRepresentationSnapshot::getVersion() const {
+	if (this->isNull() == true) {
+		return 0;
+	}
+
+	return this->data->version;
+}
+
+void RobotRepresentationSnapshot::setVersion(quint64 _version) {
+	if (this->isNull() == true) {
+		this->data = new RobotRepresentationSnapshot::Data();
+	}
+
+	this->data->version = _version;
+}
+
+void RobotRepresentationSnapshot::getRepresentation(RobotRepresentation& _robot_representation) const {
+	_robot_representation.reset();
+
+	if (this->isNull() == true) {
+		return;
+	}
+
+	for (QMap<QString, QSharedDataPointer<RobotRepresentationSnapshot::Program> >::const_iterator program = this->data->programs.constBegin(); program != this->data->programs.constEnd(); ++program) {
+		const RobotRepresentationSnapshot::Program* variables = program.value().constData();
+
+		for (RobotRepresentationSnapshot::VariableMap<StringVariableRepresentation>::Type::const_iterator it = variables->string_variables.constBegin(); it != variables->string_variables.constEnd(); ++it) {
+			_robot_representation.setStringVariableRepresentation(program.key(), it.key().first, it.key().second, it.value()->representation);
+		}
+
+		for (RobotRepresentationSnapshot::VariableMap<JointAnglesVariableRepresentation>::Type::const_iterator it = variables->joint_angles_variables.constBegin(); it != variables->joint_angles_variables.constEnd(); ++it) {
+			_robot_representation.setJointAnglesVariableRepresentation(program.key(), it.key().first, it.key().second, it.value()->representation);
+		}
+
+		for (RobotRepresentationSnapshot::VariableMap<NumericVariableRepresentation>::Type::const_iterator it = variables->numeric_variables.constBegin(); it != variables->numeric_variables.constEnd(); ++it) {
+			_robot_representation.setNumericVariableRepresentation(program.key(), it.key().first, it.key().second, it.value()->representation);
+		}
+
+		for (RobotRepresentationSnapshot::VariableMap<PoseVariableRepresentation>::Type::const_iterator it = variables->pose_variables.constBegin(); it != variables->pose_variables.constEnd(); ++it) {
+			_robot_representation.setPoseVariableRepresentation(program.key(), it.key().first, it.key().second, it.value()->representation);
+		}
+	}
+
+	for (QMap<QString, QSharedDataPointer<RobotRepresentationSnapshot::Node<ParameterRepresentation> > >::const_iterator it = this->data->parameters.constBegin(); it != this->data->parameters.constEnd(); ++it) {
+		_robot_representation.setParameterRepresentations(it.key(), it.value()->representation);
+	}
+}
+
+bool RobotRepresentationSnapshot::getStringVariableRepresentation(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, StringVariableRepresentation& _variable_representation) const {
+	return this->getVariableRepresentation(&RobotRepresentationSnapshot::Program::string_variables, _program_name, _variable_name, _variable_index, _variable_representation);
+}
+
+bool RobotRepresentationSnapshot::getJointAnglesVariableRepresentation(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, JointAnglesVariableRepresentation& _variable_representation) const {
+	return this->getVariableRepresentation(&RobotRepresentationSnapshot::Program::joint_angles_variables, _program_name, _variable_name, _variable_index, _variable_representation);
+}
+
+bool RobotRepresentationSnapshot::getNumericVariableRepresentation(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, NumericVariableRepresentation& _variable_representation) const {
+	return this->getVariableRepresentation(&RobotRepresentationSnapshot::Program::numeric_variables, _program_name, _variable_name, _variable_index, _variable_representation);
+}
+
+bool RobotRepresentationSnapshot::getPoseVariableRepresentation(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, PoseVariableRepresentation& _variable_representation) const {
+	return this->getVariableRepresentation(&RobotRepresentationSnapshot::Program::pose_variables, _program_name, _variable_name, _variable_index, _variable_representation);
+}
+
+bool RobotRepresentationSnapshot::getParameterRepresentation(const QString& _parameter_name, ParameterRepresentation& _parameter_representation) const {
+	if (this->isNull() == true) {
+		return false;
+	}
+
+	QMap<QString, QSharedDataPointer<RobotRepresentationSnapshot::Node<ParameterRepresentation> > >::const_iterator found = this->data->parameters.constFind(_parameter_name);
+	if (found == this->data->parameters.constEnd()) {
+		return false;
+	}
+
+	_parameter_representation = found.value()->representation;
+	return true;
+}
+
+std::size_t RobotRepresentationSnapshot::getNumberOfPrograms() const {
+	if (this->isNull() == true) {
+		return 0;
+	}
+
+	return this->data->programs.size();
+}
+
+std::size_t RobotRepresentationSnapshot::getNumberOfParameters() const {
+	if (this->isNull() == true) {
+		return 0;
+	}
+
+	return this->data->parameters.size();
+}
+
+void RobotRepresentationSnapshot::reset() {
+	quint64 version = this->getVersion();
+
+	this->data = new RobotRepresentationSnapshot::Data();
+	this->data->version = version;
+}
+
+void RobotRepresentationSnapshot::setStringVariableRepresentation(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, const StringVariableRepresentation& _variable_representation) {
+	this->setVariableRepresentation(&RobotRepresentationSnapshot::Program::string_variables, _program_name, _variable_name, _variable_index, _variable_representation);
+}
+
+void RobotRepresentationSnapshot::setJointAnglesVariableRepresentation(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, const JointAnglesVariableRepresentation& _variable_representation) {
+	this->setVariableRepresentation(&RobotRepresentationSnapshot::Program::joint_angles_variables, _program_name, _variable_name, _variable_index, _variable_representation);
+}
+
+void RobotRepresentationSnapshot::setNumericVariableRepresentation(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, const NumericVariableRepresentation& _variable_representation) {
+	this->setVariableRepresentation(&RobotRepresentationSnapshot::Program::numeric_variables, _program_name, _variable_name, _variable_index, _variable_representation);
+}
+
+void RobotRepresentationSnapshot::setPoseVariableRepresentation(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, const PoseVariableRepresentation& _variable_representation) {
+	this->setVariableRepresentation(&RobotRepresentationSnapshot::Program::pose_variables, _program_name, _variable_name, _variable_index, _variable_representation);
+}
+
+void RobotRepresentationSnapshot::setParameterRepresentations(const QString& _parameter_name, const ParameterRepresentation& _parameter_representation) {
+	if (this->isNull() == true) {
+		this->data = new RobotRepresentationSnapshot::Data();
+	}
+
+	this->data->parameters[_parameter_name] = new RobotRepresentationSnapshot::Node<ParameterRepresentation>(_parameter_representation);
+}
+
+void RobotRepresentationSnapshot::removeVariableRepresentation(RobotChangeSet::VariableType _type, const QString& _program_name, const QString& _variable_name, unsigned int _variable_index) {
+	switch (_type) {
+	case RobotChangeSet::VARIABLE_JOINT_ANGLES:
+		this->removeVariableRepresentation<JointAnglesVariableRepresentation>(&RobotRepresentationSnapshot::Program::joint_angles_variables, _program_name, _variable_name, _variable_index);
+		break;
+	case RobotChangeSet::VARIABLE_NUMERIC:
+		this->removeVariableRepresentation<NumericVariableRepresentation>(&RobotRepresentationSnapshot::Program::numeric_variables, _program_name, _variable_name, _variable_index);
+		break;
+	case RobotChangeSet::VARIABLE_POSE:
+		this->removeVariableRepresentation<PoseVariableRepresentation>(&RobotRepresentationSnapshot::Program::pose_variables, _program_name, _variable_name, _variable_index);
+		break;
+	case RobotChangeSet::VARIABLE_STRING:
+		this->removeVariableRepresentation<StringVariableRepresentation>(&RobotRepresentationSnapshot::Program::string_variables, _program_name, _variable_name, _variable_index);
+		break;
+	}
+}
+
+void RobotRepresentationSnapshot::removeParameterRepresentation(const QString& _parameter_name) {
+	// the lookup does not detach, a missing parameter leaves the nodes shared
+	if (this->isNull() == true || this->data.constData()->parameters.contains(_parameter_name) == false) {
+		return;
+	}
+
+	this->data->parameters.remove(_parameter_name);
+}
+
+template<typename T>
+bool RobotRepresentationSnapshot::getVariableRepresentation(typename RobotRepresentationSnapshot::VariableMap<T>::Type RobotRepresentationSnapshot::Program::* _variables, const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, T& _variable_representation) const {
+	if (this->isNull() == true) {
+		return false;
+	}
+
+	QMap<QString, QSharedDataPointer<RobotRepresentationSnapshot::Program> >::const_iterator program = this->data->programs.constFind(_program_name);
+	if (program == this->data->programs.constEnd()) {
+		return false;
+	}
+
+	const typename RobotRepresentationSnapshot::VariableMap<T>::Type& variables = program.value().constData()->*_variables;
+	typename RobotRepresentationSnapshot::VariableMap<T>::Type::const_iterator found = variables.constFind(RobotRepresentationSnapshot::VariableId(_variable_name, _variable_index));
+	if (found == variables.constEnd()) {
+		return false;
+	}
+
+	_variable_representation = found.value()->representation;
+	return true;
+}
+
+template<typename T>
+void RobotRepresentationSnapshot::setVariableRepresentation(typename RobotRepresentationSnapshot::VariableMap<T>::Type RobotRepresentationSnapshot::Program::* _variables, const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, const T& _variable_representation) {
+	if (this->isNull() == true) {
+		this->data = new RobotRepresentationSnapshot::Data();
+	}
+
+	// detaches the data and the program only if they are shared, the other programs and variables stay shared
+	QSharedDataPointer<RobotRepresentationSnapshot::Program>& program = this->data->programs[_program_name];
+	if (program.constData() == NULL) {
+		program = new RobotRepresentationSnapshot::Program();
+	}
+
+	(program.data()->*_variables)[RobotRepresentationSnapshot::VariableId(_variable_name, _variable_index)] = new RobotRepresentationSnapshot::Node<T>(_variable_representation);
+}
+
+template<typename T>
+void RobotRepresentationSnapshot::removeVariableRepresentation(typename RobotRepresentationSnapshot::VariableMap<T>::Type RobotRepresentationSnapshot::Program::* _variables, const QString& _program_name, const QString& _variable_name, unsigned int _variable_index) {
+	RobotRepresentationSnapshot::VariableId variable_id(_variable_name, _variable_index);
+
+	// the lookup does not detach, a missing variable leaves the nodes shared
+	if (this->isNull() == true) {
+		return;
+	}
+
+	QMap<QString, QSharedDataPointer<RobotRepresentationSnapshot::Program> >::const_iterator found = this->data.constData()->programs.constFind(_program_name);
+	if (found == this->data.constData()->programs.constEnd() || (found.value().constData()->*_variables).contains(variable_id) == false) {
+		return;
+	}
+
+	QSharedDataPointer<RobotRepresentationSnapshot::Program>& program = this->data->programs[_program_name];
+	(program.data()->*_variables).remove(variable_id);
+
+	if (program.constData()->isEmpty() == true) {
+		this->data->programs.remove(_program_name);
+	}
+}
+
+}
@@ -0,0 +1,121 @@
+#ifndef VM_ROBOT_REPRESENTATION_SNAPSHOT_H
+#define VM_ROBOT_REPRESENTATION_SNAPSHOT_H
+
+#include <QMap>
+#include <QMetaType>
+#include <QPair>
+#include <QSharedData>
+#include <QSharedDataPointer>
+
+#include "representations/RobotRepresentation.h"
+#include "RobotChangeSet.h"
+
+namespace vm {
+
+// Robot representation of one data version, it can be handed to other threads and queued signals without copying
+// the variables. Every program, variable and parameter is a shared node (copy-on-write): changing an entry copies
+// only the node of the entry and the maps on the way to it, all other nodes stay shared with the copies. The setters
+// mirror those of RobotRepresentation, changing a copy never affects the others.
+class RobotRepresentationSnapshot {
+public:
+	RobotRepresentationSnapshot();
+
+	bool isNull() const;
+
+	// RobotChangeSet::getVersion() of the last change contained
+	quint64 getVersion() const;
+	void setVersion(quint64 _version);
+
+	// copies every entry into _robot_representation
+	void getRepresentation(RobotRepresentation& _robot_representation) const;
+
+	// single entries, false if the entry does not exist
+	bool getStringVariableRepresentation(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, StringVariableRepresentation& _variable_representation) const;
+	bool getJointAnglesVariableRepresentation(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, JointAnglesVariableRepresentation& _variable_representation) const;
+	bool getNumericVariableRepresentation(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, NumericVariableRepresentation& _variable_representation) const;
+	bool getPoseVariableRepresentation(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, PoseVariableRepresentation& _variable_representation) const;
+	bool getParameterRepresentation(const QString& _parameter_name, ParameterRepresentation& _parameter_representation) const;
+
+	std::size_t getNumberOfPrograms() const;
+	std::size_t getNumberOfParameters() const;
+
+	// empties this snapshot, copies keep their entries
+	void reset();
+
+	void setStringVariableRepresentation(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, const StringVariableRepresentation& _variable_representation);
+	void setJointAnglesVariableRepresentation(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, const JointAnglesVariableRepresentation& _variable_representation);
+	void setNumericVariableRepresentation(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, const NumericVariableRepresentation& _variable_representation);
+	void setPoseVariableRepresentation(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, const PoseVariableRepresentation& _variable_representation);
+	void setParameterRepresentations(const QString& _parameter_name, const ParameterRepresentation& _parameter_representation);
+
+	// a program without variables is removed as well
+	void removeVariableRepresentation(RobotChangeSet::VariableType _type, const QString& _program_name, const QString& _variable_name, unsigned int _variable_index);
+	void removeParameterRepresentation(const QString& _parameter_name);
+
+private:
+	template<typename T>
+	struct Node : public QSharedData {
+		explicit Node(const T& _representation) : representation(_representation) {
+		}
+
+		T representation;
+	};
+
+	// variable name and index
+	typedef QPair<QString, unsigned int> VariableId;
+
+	template<typename T>
+	struct VariableMap {
+		typedef QMap<RobotRepresentationSnapshot::VariableId, QSharedDataPointer<RobotRepresentationSnapshot::Node<T> > > Type;
+	};
+
+	struct Program : public QSharedData {
+		bool isEmpty() const;
+
+		RobotRepresentationSnapshot::VariableMap<StringVariableRepresentation>::Type string_variables;
+		RobotRepresentationSnapshot::VariableMap<JointAnglesVariableRepresentation>::Type joint_angles_variables;
+		RobotRepresentationSnapshot::VariableMap<NumericVariableRepresentation>::Type numeric_variables;
+		RobotRepresentationSnapshot::VariableMap<PoseVariableRepresentation>::Type pose_variables;
+	};
+
+	struct Data : public QSharedData {
+		Data() {
+			this->version = 0;
+		}
+
+		QMap<QString, QSharedDataPointer<RobotRepresentationSnapshot::Program> > programs;
+		QMap<QString, QSharedDataPointer<RobotRepresentationSnapshot::Node<ParameterRepresentation> > > parameters;
+		quint64 version;
+	};
+
+	template<typename T>
+	bool getVariableRepresentation(typename RobotRepresentationSnapshot::VariableMap<T>::Type RobotRepresentationSnapshot::Program::* _variables, const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, T& _variable_representation) const;
+	template<typename T>
+	void setVariableRepresentation(typename RobotRepresentationSnapshot::VariableMap<T>::Type RobotRepresentationSnapshot::Program::* _variables, const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, const T& _variable_representation);
+	template<typename T>
+	void removeVariableRepresentation(typename RobotRepresentationSnapshot::VariableMap<T>::Type RobotRepresentationSnapshot::Program::* _variables, const QString& _program_name, const QString& _variable_name, unsigned int _variable_index);
+
+	QSharedDataPointer<RobotRepresentationSnapshot::Data> data;
+};
+
+// Update from one snapshot to the next: a receiver that holds the base version only applies the listed changes,
+// taking the changed entries from the snapshot, otherwise (or if full_flag is set) it takes the whole snapshot.
+struct RobotRepresentationDelta {
+	RobotRepresentationDelta() {
+		this->base_version = 0;
+		this->full_flag = false;
+	}
+
+	quint64 base_version;
+	// the change set has removals, they can not be applied to a RobotRepresentation
+	bool full_flag;
+	RobotChangeSet change_set;
+	RobotRepresentationSnapshot snapshot;
+};
+
+}
+
+Q_DECLARE_METATYPE(vm::RobotRepresentationSnapshot)
+Q_DECLARE_METATYPE(vm::RobotRepresentationDelta)
+
+#endif /* VM_ROBOT_REPRESENTATION_SNAPSHOT_H */
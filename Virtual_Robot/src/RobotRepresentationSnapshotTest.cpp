@@ -0,0 +1,69 @@
+#include <vector>
+
+#include "RobotRepresentationSnapshot.h"
+#include "TestCheck.h"
+
+using namespace vm;
+
+static NumericVariableRepresentation makeNumeric(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, double _value) {
+	NumericVariableRepresentation variable_representation;
+	variable_representation.setProgramName(_program_name);
+	variable_representation.setName(_variable_name);
+	variable_representation.setIndex(_variable_index);
+	variable_representation.setValue(_value);
+
+	return variable_representation;
+}
+
+int main() {
+	RobotRepresentationSnapshot snapshot;
+	if (check(snapshot.isNull() == true && snapshot.getNumberOfPrograms() == 0, "default snapshot is not null") == false) {
+		return 1;
+	}
+
+	snapshot.setVersion(1);
+	snapshot.setNumericVariableRepresentation("main", "counter", 0, makeNumeric("main", "counter", 0, 1));
+	snapshot.setNumericVariableRepresentation("main", "counter", 1, makeNumeric("main", "counter", 1, 2));
+	snapshot.setNumericVariableRepresentation("pick", "offset", 0, makeNumeric("pick", "offset", 0, 3));
+
+	ParameterRepresentation parameter_representation;
+	parameter_representation.setName("speed");
+	parameter_representation.setValues(std::vector<double>(1, 100));
+	snapshot.setParameterRepresentations("speed", parameter_representation);
+
+	// a receiver holds version 1 while the robot flushes version 2
+	RobotRepresentationSnapshot received = snapshot;
+
+	snapshot.setNumericVariableRepresentation("main", "counter", 0, makeNumeric("main", "counter", 0, 4));
+	snapshot.removeVariableRepresentation(RobotChangeSet::VARIABLE_NUMERIC, "pick", "offset", 0);
+	snapshot.removeParameterRepresentation("speed");
+	snapshot.setVersion(2);
+
+	NumericVariableRepresentation numeric_representation;
+	StringVariableRepresentation string_representation;
+
+	bool passed = true;
+	passed &= check(received.getVersion() == 1 && snapshot.getVersion() == 2, "versions are shared");
+	passed &= check(received.getNumericVariableRepresentation("pick", "offset", 0, numeric_representation) == true, "removal changed the received snapshot");
+	passed &= check(received.getParameterRepresentation("speed", parameter_representation) == true, "parameter removal changed the received snapshot");
+	passed &= check(received.getNumberOfPrograms() == 2, "received snapshot lost a program");
+	passed &= check(snapshot.getNumericVariableRepresentation("pick", "offset", 0, numeric_representation) == false, "variable was not removed");
+	passed &= check(snapshot.getNumberOfPrograms() == 1, "program without variables was not removed");
+	passed &= check(snapshot.getNumberOfParameters() == 0, "parameter was not removed");
+	passed &= check(snapshot.getNumericVariableRepresentation("main", "counter", 1, numeric_representation) == true, "unchanged variable is missing");
+	passed &= check(snapshot.getStringVariableRepresentation("main", "counter", 1, string_representation) == false, "variable types are mixed up");
+
+	// removing what does not exist changes nothing
+	snapshot.removeVariableRepresentation(RobotChangeSet::VARIABLE_POSE, "main", "counter", 0);
+	passed &= check(snapshot.getNumericVariableRepresentation("main", "counter", 0, numeric_representation) == true, "removal of another type removed the variable");
+
+	// resetting a copy leaves the original
+	RobotRepresentationSnapshot copy = snapshot;
+	copy.reset();
+	passed &= check(copy.getNumberOfPrograms() == 0 && snapshot.getNumberOfPrograms() == 1 && copy.getVersion() == 2, "reset changed the original");
+
+	RobotRepresentation robot_representation;
+	received.getRepresentation(robot_representation);
+
+	return passed == true ? 0 : 1;
+}
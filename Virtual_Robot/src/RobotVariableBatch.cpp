@@ -0,0 +1,110 @@
+#include "RobotVariableBatch.h"
+
+namespace vm {
+
+RobotVariableBatch::RobotVariableBatch() {
+}
+
+void RobotVariableBatch::clear() {
+	this->entries.clear();
+	this->joint_angles_variables.clear();
+	this->numeric_variables.clear();
+	this->pose_variables.clear();
+	this->string_variables.clear();
+}
+
+void RobotVariableBatch::reserve(std::size_t _number_of_entries) {
+	this->entries.reserve(_number_of_entries);
+}
+
+std::size_t RobotVariableBatch::size() const {
+	return this->entries.size();
+}
+
+bool RobotVariableBatch::isEmpty() const {
+	return this->entries.empty();
+}
+
+std::size_t RobotVariableBatch::addJointAnglesVariable(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, const RobotJointAngles& _joint_angles_variable) {
+	this->joint_angles_variables.push_back(_joint_angles_variable);
+	return this->addEntry(RobotChangeSet::VARIABLE_JOINT_ANGLES, _program_name, _variable_name, _variable_index, this->joint_angles_variables.size() - 1);
+}
+
+std::size_t RobotVariableBatch::addNumericVariable(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, double _numeric_variable) {
+	this->numeric_variables.push_back(_numeric_variable);
+	return this->addEntry(RobotChangeSet::VARIABLE_NUMERIC, _program_name, _variable_name, _variable_index, this->numeric_variables.size() - 1);
+}
+
+std::size_t RobotVariableBatch::addPoseVariable(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, const RobotPose& _pose_variable) {
+	this->pose_variables.push_back(_pose_variable);
+	return this->addEntry(RobotChangeSet::VARIABLE_POSE, _program_name, _variable_name, _variable_index, this->pose_variables.size() - 1);
+}
+
+std::size_t RobotVariableBatch::addStringVariable(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, const QString& _string_variable) {
+	this->string_variables.push_back(_string_variable);
+	return this->addEntry(RobotChangeSet::VARIABLE_STRING, _program_name, _variable_name, _variable_index, this->string_variables.size() - 1);
+}
+
+const RobotVariableBatch::Entry& RobotVariableBatch::getEntry(std::size_t _entry_index) const {
+	return this->entries[_entry_index];
+}
+
+bool RobotVariableBatch::isFound(std::size_t _entry_index) const {
+	return this->entries[_entry_index].found_flag;
+}
+
+bool RobotVariableBatch::getJointAnglesVariable(std::size_t _entry_index, RobotJointAngles& _joint_angles_variable) const {
+	const RobotVariableBatch::Entry& entry = this->entries[_entry_index];
+	if (entry.type != RobotChangeSet::VARIABLE_JOINT_ANGLES) {
+		return false;
+	}
+
+	_joint_angles_variable = this->joint_angles_variables[entry.value_index];
+	return true;
+}
+
+bool RobotVariableBatch::getNumericVariable(std::size_t _entry_index, double& _numeric_variable) const {
+	const RobotVariableBatch::Entry& entry = this->entries[_entry_index];
+	if (entry.type != RobotChangeSet::VARIABLE_NUMERIC) {
+		return false;
+	}
+
+	_numeric_variable = this->numeric_variables[entry.value_index];
+	return true;
+}
+
+bool RobotVariableBatch::getPoseVariable(std::size_t _entry_index, RobotPose& _pose_variable) const {
+	const RobotVariableBatch::Entry& entry = this->entries[_entry_index];
+	if (entry.type != RobotChangeSet::VARIABLE_POSE) {
+		return false;
+	}
+
+	_pose_variable = this->pose_variables[entry.value_index];
+	return true;
+}
+
+bool RobotVariableBatch::getStringVariable(std::size_t _entry_index, QString& _string_variable) const {
+	const RobotVariableBatch::Entry& entry = this->entries[_entry_index];
+	if (entry.type != RobotChangeSet::VARIABLE_STRING) {
+		return false;
+	}
+
+	_string_variable = this->string_variables[entry.value_index];
+	return true;
+}
+
+std::size_t RobotVariableBatch::addEntry(RobotChangeSet::VariableType _type, const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, std::size_t _value_index) {
+	RobotVariableBatch::Entry entry;
+	entry.type = _type;
+	entry.program_name = _program_name;
+	entry.variable_name = _variable_name;
+	entry.variable_index = _variable_index;
+	entry.value_index = _value_index;
+	entry.found_flag = false;
+
+	this->entries.push_back(entry);
+
+	return this->entries.size() - 1;
+}
+
+}
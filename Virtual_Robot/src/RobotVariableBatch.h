@@ -0,0 +1,70 @@
+#ifndef VM_ROBOT_VARIABLE_BATCH_H
+#define VM_ROBOT_VARIABLE_BATCH_H
+
+#include <QMetaType>
+#include <QString>
+
+#include <vector>
+
+#include "RobotChangeSet.h"
+#include "RobotJointAngles.h"
+#include "RobotPose.h"
+
+namespace vm {
+
+// List of variables of mixed types for Robot::getVariables() and Robot::setVariables(),
+// the whole list is read or written under one lock and written changes are reported in one notification.
+class RobotVariableBatch {
+public:
+	struct Entry {
+		RobotChangeSet::VariableType type;
+		QString program_name;
+		QString variable_name;
+		unsigned int variable_index;
+		// position in the value list of the type
+		std::size_t value_index;
+		// set by Robot::getVariables()
+		bool found_flag;
+	};
+
+	RobotVariableBatch();
+
+	void clear();
+	void reserve(std::size_t _number_of_entries);
+
+	std::size_t size() const;
+	bool isEmpty() const;
+
+	// returns the entry index, the value is only used by Robot::setVariables()
+	std::size_t addJointAnglesVariable(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, const RobotJointAngles& _joint_angles_variable = RobotJointAngles());
+	std::size_t addNumericVariable(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, double _numeric_variable = 0.0);
+	std::size_t addPoseVariable(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, const RobotPose& _pose_variable = RobotPose());
+	std::size_t addStringVariable(const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, const QString& _string_variable = QString());
+
+	const RobotVariableBatch::Entry& getEntry(std::size_t _entry_index) const;
+	bool isFound(std::size_t _entry_index) const;
+
+	// false if the entry has another type
+	bool getJointAnglesVariable(std::size_t _entry_index, RobotJointAngles& _joint_angles_variable) const;
+	bool getNumericVariable(std::size_t _entry_index, double& _numeric_variable) const;
+	bool getPoseVariable(std::size_t _entry_index, RobotPose& _pose_variable) const;
+	bool getStringVariable(std::size_t _entry_index, QString& _string_variable) const;
+
+private:
+	friend class Robot;
+
+	std::size_t addEntry(RobotChangeSet::VariableType _type, const QString& _program_name, const QString& _variable_name, unsigned int _variable_index, std::size_t _value_index);
+
+	std::vector<RobotVariableBatch::Entry> entries;
+
+	std::vector<RobotJointAngles> joint_angles_variables;
+	std::vector<double> numeric_variables;
+	std::vector<RobotPose> pose_variables;
+	std::vector<QString> string_variables;
+};
+
+}
+
+Q_DECLARE_METATYPE(vm::RobotVariableBatch)
+
+#endif /* VM_ROBOT_VARIABLE_BATCH_H */
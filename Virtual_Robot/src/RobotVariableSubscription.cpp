@@ -0,0 +1,48 @@
+#include "RobotVariableSubscription.h"
+#include "Robot.h"
+
+namespace vm {
+
+RobotVariableSubscription::RobotVariableSubscription(Robot* _robot, const RobotVariableSubscription::Filter& _filter) :
+	QObject(NULL)
+{
+	this->robot = _robot;
+	this->filter = _filter;
+	this->last_delivery_time = 0;
+}
+
+RobotVariableSubscription::~RobotVariableSubscription() {
+	if (this->robot != NULL) {
+		this->robot->unsubscribeVariables(this);
+	}
+}
+
+const RobotVariableSubscription::Filter& RobotVariableSubscription::getFilter() const {
+	return this->filter;
+}
+
+bool RobotVariableSubscription::matches(const RobotChangeSet::Variable& _variable) const {
+	if ((this->filter.type_mask & RobotVariableSubscription::typeBit(_variable.type)) == 0) {
+		return false;
+	}
+
+	if (this->filter.variable_index != RobotVariableSubscription::ANY_INDEX && this->filter.variable_index != _variable.variable_index) {
+		return false;
+	}
+
+	if (this->filter.program_name.isEmpty() == false && this->filter.program_name != _variable.program_name) {
+		return false;
+	}
+
+	if (this->filter.prefix_flag == true) {
+		return _variable.variable_name.startsWith(this->filter.variable_name);
+	}
+
+	return _variable.variable_name == this->filter.variable_name;
+}
+
+void RobotVariableSubscription::deliver(const RobotVariableBatch& _batch) {
+	emit variablesChanged(_batch);
+}
+
+}
@@ -0,0 +1,88 @@
+#ifndef VM_ROBOT_VARIABLE_SUBSCRIPTION_H
+#define VM_ROBOT_VARIABLE_SUBSCRIPTION_H
+
+#include <QObject>
+#include <QString>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "RobotChangeSet.h"
+#include "RobotVariableBatch.h"
+#include "VariableIndex.h"
+
+namespace vm {
+
+class Robot;
+
+// Changes of the variables matching a filter, created by Robot::subscribeVariables().
+// The subscription lives in the thread that created it, variablesChanged() is queued to that thread.
+// It is owned by the subscriber and unsubscribes when deleted, it must be deleted before the robot or in its thread.
+class RobotVariableSubscription : public QObject {
+	Q_OBJECT
+public:
+	static const unsigned int ANY_INDEX = 0xFFFFFFFF;
+
+	struct Filter {
+		Filter() {
+			this->type_mask = RobotVariableSubscription::typeBit(RobotChangeSet::VARIABLE_JOINT_ANGLES) |
+				RobotVariableSubscription::typeBit(RobotChangeSet::VARIABLE_NUMERIC) |
+				RobotVariableSubscription::typeBit(RobotChangeSet::VARIABLE_POSE) |
+				RobotVariableSubscription::typeBit(RobotChangeSet::VARIABLE_STRING);
+			this->prefix_flag = true;
+			this->variable_index = RobotVariableSubscription::ANY_INDEX;
+			this->deadband = 0.0;
+			this->min_interval = 0;
+		}
+
+		// typeBit() of the accepted variable types
+		int type_mask;
+		// empty matches every program
+		QString program_name;
+		// prefix of the variable names if prefix_flag is set (empty matches every variable), otherwise the whole name
+		QString variable_name;
+		bool prefix_flag;
+		unsigned int variable_index;
+
+		// a value is only delivered if one of its components moved at least this far from the value delivered last,
+		// string variables and removals are always delivered
+		double deadband;
+		// milliseconds between two deliveries, changes in between are collected and delivered together
+		int min_interval;
+	};
+
+	static int typeBit(RobotChangeSet::VariableType _type) {
+		return 1 << _type;
+	}
+
+	virtual ~RobotVariableSubscription();
+
+	const RobotVariableSubscription::Filter& getFilter() const;
+
+signals:
+	// current values of the changed variables, removed variables are not found (RobotVariableBatch::isFound())
+	void variablesChanged(RobotVariableBatch _batch);
+
+private:
+	friend class Robot;
+
+	RobotVariableSubscription(Robot* _robot, const RobotVariableSubscription::Filter& _filter);
+
+	bool matches(const RobotChangeSet::Variable& _variable) const;
+	void deliver(const RobotVariableBatch& _batch);
+
+	// robot side, accessed with the subscription mutex of the robot held
+	Robot* robot;
+	RobotVariableSubscription::Filter filter;
+
+	// changes that are waiting for the rate limit
+	std::unordered_map<VariableKey, RobotChangeSet::Variable, VariableKeyHash> pending_variables[4];
+	// values delivered last for the deadband
+	std::unordered_map<VariableKey, std::vector<double>, VariableKeyHash> delivered_values[4];
+	qint64 last_delivery_time;
+};
+
+}
+
+#endif /* VM_ROBOT_VARIABLE_SUBSCRIPTION_H */
@@ -0,0 +1,54 @@
+#ifndef VM_SEQ_LOCK_H
+#define VM_SEQ_LOCK_H
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <thread>
+
+namespace vm {
+
+// Sequence lock, readers never block the writer and retry if a write overlapped their copy.
+// Writers must be serialized by the owner. Only for data without owned pointers, a torn copy is discarded.
+class SeqLock {
+public:
+	SeqLock() {
+		this->sequence.store(0, std::memory_order_relaxed);
+	}
+
+	quint32 readBegin() const {
+		quint32 value = this->sequence.load(std::memory_order_acquire);
+		while ((value & 1) != 0) {
+			std::this_thread::yield();
+			value = this->sequence.load(std::memory_order_acquire);
+		}
+
+		return value;
+	}
+
+	// true if the data read since readBegin() may be torn
+	bool readRetry(quint32 _sequence) const {
+		std::atomic_thread_fence(std::memory_order_acquire);
+		return this->sequence.load(std::memory_order_relaxed) != _sequence;
+	}
+
+	void writeBegin() {
+		this->sequence.store(this->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+	}
+
+	void writeEnd() {
+		this->sequence.store(this->sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	}
+
+	quint32 getSequence() const {
+		return this->sequence.load(std::memory_order_acquire);
+	}
+
+private:
+	std::atomic<quint32> sequence;
+};
+
+}
+
+#endif /* VM_SEQ_LOCK_H */
@@ -0,0 +1,140 @@
+#include "StringInterner.h"
+
+#include <QHash>
+
+#include "MemoryUsage.h"
+
+namespace vm {
+
+StringInterner::Table::Table(std::size_t _capacity) {
+	this->capacity = _capacity;
+	this->buckets = new StringInterner::Bucket[_capacity];
+
+	for (std::size_t i = 0; i < _capacity; ++i) {
+		this->buckets[i].hash.store(0, std::memory_order_relaxed);
+		this->buckets[i].id.store(StringInterner::INVALID_ID, std::memory_order_relaxed);
+	}
+}
+
+StringInterner::Table::~Table() {
+	delete[] this->buckets;
+}
+
+StringInterner::StringInterner(ReclamationDomain* _domain) {
+	this->domain = _domain;
+	this->table.store(new StringInterner::Table(64));
+	this->number_of_strings.store(0);
+
+	for (std::size_t i = 0; i < StringInterner::MAX_CHUNKS; ++i) {
+		this->chunks[i].store(NULL, std::memory_order_relaxed);
+	}
+}
+
+StringInterner::~StringInterner() {
+	delete this->table.load();
+
+	for (std::size_t i = 0; i < StringInterner::MAX_CHUNKS; ++i) {
+		delete[] this->chunks[i].load();
+	}
+}
+
+quint32 StringInterner::intern(const QString& _string) {
+	quint32 id = this->find(_string);
+	if (id != StringInterner::INVALID_ID) {
+		return id;
+	}
+
+	id = this->number_of_strings.load(std::memory_order_relaxed);
+
+	std::size_t chunk_index = id / StringInterner::CHUNK_SIZE;
+	Q_ASSERT(chunk_index < StringInterner::MAX_CHUNKS);
+
+	QString* chunk = this->chunks[chunk_index].load(std::memory_order_relaxed);
+	if (chunk == NULL) {
+		chunk = new QString[StringInterner::CHUNK_SIZE];
+		this->chunks[chunk_index].store(chunk, std::memory_order_release);
+	}
+
+	// the string is complete before the id is released by the bucket or a variable slot
+	chunk[id % StringInterner::CHUNK_SIZE] = _string;
+	this->number_of_strings.store(id + 1, std::memory_order_release);
+
+	StringInterner::Table* current_table = this->table.load(std::memory_order_relaxed);
+	if ((id + 1) * 2 > current_table->capacity) {
+		StringInterner::Table* new_table = new StringInterner::Table(current_table->capacity * 2);
+
+		for (std::size_t i = 0; i < current_table->capacity; ++i) {
+			quint32 old_id = current_table->buckets[i].id.load(std::memory_order_relaxed);
+			if (old_id != StringInterner::INVALID_ID) {
+				this->insertBucket(new_table, current_table->buckets[i].hash.load(std::memory_order_relaxed), old_id);
+			}
+		}
+
+		// sequentially consistent, see ReclamationDomain::collect()
+		this->table.store(new_table);
+		this->domain->retire(current_table);
+		current_table = new_table;
+	}
+
+	this->insertBucket(current_table, qHash(_string), id);
+
+	return id;
+}
+
+quint32 StringInterner::find(const QString& _string) const {
+	const StringInterner::Table* current_table = this->table.load(std::memory_order_acquire);
+
+	quint32 hash = qHash(_string);
+	std::size_t mask = current_table->capacity - 1;
+
+	for (std::size_t i = hash & mask; ; i = (i + 1) & mask) {
+		const StringInterner::Bucket& bucket = current_table->buckets[i];
+
+		quint32 id = bucket.id.load(std::memory_order_acquire);
+		if (id == StringInterner::INVALID_ID) {
+			return StringInterner::INVALID_ID;
+		}
+
+		if (bucket.hash.load(std::memory_order_relaxed) == hash && this->getString(id) == _string) {
+			return id;
+		}
+	}
+}
+
+const QString& StringInterner::getString(quint32 _id) const {
+	return this->chunks[_id / StringInterner::CHUNK_SIZE].load(std::memory_order_acquire)[_id % StringInterner::CHUNK_SIZE];
+}
+
+std::size_t StringInterner::size() const {
+	return this->number_of_strings.load(std::memory_order_acquire);
+}
+
+std::size_t StringInterner::getMemoryUsage() const {
+	const StringInterner::Table* current_table = this->table.load(std::memory_order_relaxed);
+	std::size_t number_of_bytes = sizeof(StringInterner::Table) + current_table->capacity * sizeof(StringInterner::Bucket);
+
+	quint32 number_of_strings = this->number_of_strings.load(std::memory_order_relaxed);
+	for (std::size_t i = 0; i * StringInterner::CHUNK_SIZE < number_of_strings; ++i) {
+		number_of_bytes += StringInterner::CHUNK_SIZE * sizeof(QString);
+	}
+
+	for (quint32 id = 0; id < number_of_strings; ++id) {
+		number_of_bytes += getHeapMemoryUsage(this->getString(id));
+	}
+
+	return number_of_bytes;
+}
+
+void StringInterner::insertBucket(StringInterner::Table* _table, quint32 _hash, quint32 _id) {
+	std::size_t mask = _table->capacity - 1;
+
+	std::size_t i = _hash & mask;
+	while (_table->buckets[i].id.load(std::memory_order_relaxed) != StringInterner::INVALID_ID) {
+		i = (i + 1) & mask;
+	}
+
+	_table->buckets[i].hash.store(_hash, std::memory_order_relaxed);
+	_table->buckets[i].id.store(_id, std::memory_order_release);
+}
+
+}
@@ -0,0 +1,67 @@
+#ifndef VM_STRING_INTERNER_H
+#define VM_STRING_INTERNER_H
+
+#include <QString>
+
+#include <atomic>
+
+#include "ReclamationDomain.h"
+
+namespace vm {
+
+// Maps program and variable names to dense ids, so variable keys compare and hash as integers.
+// Ids are never released, the set of names of a controller is bounded.
+// find() and getString() run concurrently with a writer calling intern(), like VariableIndex.
+// Strings live in chunks that never move, the hash table is replaced when it grows.
+class StringInterner {
+public:
+	static const quint32 INVALID_ID = 0xFFFFFFFF;
+
+	explicit StringInterner(ReclamationDomain* _domain);
+	~StringInterner();
+
+	// writer side, returns the id of _string, a new id is assigned on first use
+	quint32 intern(const QString& _string);
+
+	// returns INVALID_ID if _string was never interned, readers hold a ReadGuard of the domain
+	quint32 find(const QString& _string) const;
+
+	// _id must have been returned by intern() or find()
+	const QString& getString(quint32 _id) const;
+
+	std::size_t size() const;
+
+	// writer side, bytes of the hash table, the chunks and the string buffers
+	std::size_t getMemoryUsage() const;
+
+private:
+	static const std::size_t CHUNK_SIZE = 1024;
+	static const std::size_t MAX_CHUNKS = 1024;
+
+	struct Bucket {
+		std::atomic<quint32> hash;
+		std::atomic<quint32> id;
+	};
+
+	struct Table {
+		explicit Table(std::size_t _capacity);
+		~Table();
+
+		std::size_t capacity;
+		StringInterner::Bucket* buckets;
+	};
+
+	StringInterner(const StringInterner&);
+	StringInterner& operator=(const StringInterner&);
+
+	void insertBucket(StringInterner::Table* _table, quint32 _hash, quint32 _id);
+
+	ReclamationDomain* domain;
+	std::atomic<StringInterner::Table*> table;
+	std::atomic<QString*> chunks[StringInterner::MAX_CHUNKS];
+	std::atomic<quint32> number_of_strings;
+};
+
+}
+
+#endif /* VM_STRING_INTERNER_H */
@@ -0,0 +1,462 @@
+#include "TrajectoryLog.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace vm {
+
+namespace {
+
+// all fixed size fields are written in host byte order
+struct FileHeader {
+	char magic[4];
+	std::uint32_t version;
+	std::uint32_t dof;
+	std::uint32_t reserved;
+	double resolution;
+};
+
+struct BlockHeader {
+	std::uint32_t number_of_samples;
+	std::uint32_t payload_size;
+	std::int64_t first_time;
+	std::int64_t last_time;
+};
+
+struct IndexEntry {
+	std::int64_t first_time;
+	std::int64_t last_time;
+	std::uint64_t offset;
+	std::uint32_t number_of_samples;
+	std::uint32_t reserved;
+};
+
+struct IndexFooter {
+	std::uint64_t index_offset;
+	std::uint32_t number_of_blocks;
+	char magic[4];
+};
+
+void writeVarint(QByteArray& _data, std::int64_t _value) {
+	// zigzag maps small negative and positive deltas to small unsigned numbers
+	std::uint64_t value = (static_cast<std::uint64_t>(_value) << 1) ^ static_cast<std::uint64_t>(_value >> 63);
+
+	while (value >= 0x80) {
+		_data.append(static_cast<char>((value & 0x7F) | 0x80));
+		value >>= 7;
+	}
+
+	_data.append(static_cast<char>(value));
+}
+
+bool readVarint(const char*& _position, const char* _end, std::int64_t& _value) {
+	std::uint64_t value = 0;
+
+	for (int shift = 0; shift < 64; shift += 7) {
+		if (_position == _end) {
+			return false;
+		}
+
+		std::uint8_t byte = static_cast<std::uint8_t>(*_position++);
+		value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+
+		if ((byte & 0x80) == 0) {
+			_value = static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+}
+
+const char TrajectoryLog::MAGIC[4] = { 'V', 'M', 'T', 'R' };
+const char TrajectoryLog::INDEX_MAGIC[4] = { 'V', 'M', 'T', 'I' };
+const std::uint32_t TrajectoryLog::VERSION = 1;
+
+
+TrajectoryLogWriter::TrajectoryLogWriter() {
+	this->dof = 0;
+	this->resolution = 1;
+	this->samples_per_block = 1024;
+	this->block_samples = 0;
+	this->block_first_time = 0;
+	this->previous_time = 0;
+	this->number_of_samples = 0;
+}
+
+TrajectoryLogWriter::~TrajectoryLogWriter() {
+	this->close();
+}
+
+bool TrajectoryLogWriter::open(const QString& _file_name, std::size_t _dof, double _resolution, std::size_t _samples_per_block) {
+	this->close();
+
+	this->file.setFileName(_file_name);
+	if (this->file.open(QIODevice::WriteOnly | QIODevice::Truncate) == false) {
+		return false;
+	}
+
+	this->dof = _dof;
+	this->resolution = _resolution;
+	this->samples_per_block = std::max<std::size_t>(_samples_per_block, 1);
+	this->payload.clear();
+	this->block_samples = 0;
+	this->previous_values.assign(_dof, 0);
+	this->blocks.clear();
+	this->number_of_samples = 0;
+
+	FileHeader header;
+	std::memcpy(header.magic, TrajectoryLog::MAGIC, sizeof(header.magic));
+	header.version = TrajectoryLog::VERSION;
+	header.dof = static_cast<std::uint32_t>(_dof);
+	header.reserved = 0;
+	header.resolution = _resolution;
+
+	return this->file.write(reinterpret_cast<const char*>(&header), sizeof(FileHeader)) == sizeof(FileHeader);
+}
+
+bool TrajectoryLogWriter::close() {
+	if (this->file.isOpen() == false) {
+		return false;
+	}
+
+	bool result = this->flushBlock();
+
+	IndexFooter footer;
+	footer.index_offset = static_cast<std::uint64_t>(this->file.pos());
+	footer.number_of_blocks = static_cast<std::uint32_t>(this->blocks.size());
+	std::memcpy(footer.magic, TrajectoryLog::INDEX_MAGIC, sizeof(footer.magic));
+
+	for (std::size_t i = 0; i < this->blocks.size(); ++i) {
+		IndexEntry entry;
+		entry.first_time = this->blocks[i].first_time;
+		entry.last_time = this->blocks[i].last_time;
+		entry.offset = this->blocks[i].offset;
+		entry.number_of_samples = this->blocks[i].number_of_samples;
+		entry.reserved = 0;
+		result = result && this->file.write(reinterpret_cast<const char*>(&entry), sizeof(IndexEntry)) == sizeof(IndexEntry);
+	}
+
+	result = result && this->file.write(reinterpret_cast<const char*>(&footer), sizeof(IndexFooter)) == sizeof(IndexFooter);
+
+	this->file.close();
+
+	return result;
+}
+
+bool TrajectoryLogWriter::isOpen() const {
+	return this->file.isOpen();
+}
+
+bool TrajectoryLogWriter::append(std::int64_t _time, const double* _values) {
+	if (this->file.isOpen() == false) {
+		return false;
+	}
+
+	bool first_flag = (this->block_samples == 0);
+
+	if (first_flag == true) {
+		this->block_first_time = _time;
+		writeVarint(this->payload, _time);
+	} else {
+		writeVarint(this->payload, _time - this->previous_time);
+	}
+
+	for (std::size_t i = 0; i < this->dof; ++i) {
+		std::int64_t value = static_cast<std::int64_t>(std::llround(_values[i] / this->resolution));
+		writeVarint(this->payload, first_flag == true ? value : value - this->previous_values[i]);
+		this->previous_values[i] = value;
+	}
+
+	this->previous_time = _time;
+	++this->block_samples;
+	++this->number_of_samples;
+
+	if (this->block_samples >= this->samples_per_block) {
+		return this->flushBlock();
+	}
+
+	return true;
+}
+
+std::uint64_t TrajectoryLogWriter::getNumberOfSamples() const {
+	return this->number_of_samples;
+}
+
+bool TrajectoryLogWriter::flushBlock() {
+	if (this->block_samples == 0) {
+		return true;
+	}
+
+	TrajectoryLog::BlockInfo info;
+	info.first_time = this->block_first_time;
+	info.last_time = this->previous_time;
+	info.offset = static_cast<std::uint64_t>(this->file.pos());
+	info.number_of_samples = this->block_samples;
+	this->blocks.push_back(info);
+
+	BlockHeader header;
+	header.number_of_samples = this->block_samples;
+	header.payload_size = static_cast<std::uint32_t>(this->payload.size());
+	header.first_time = info.first_time;
+	header.last_time = info.last_time;
+
+	bool result = this->file.write(reinterpret_cast<const char*>(&header), sizeof(BlockHeader)) == sizeof(BlockHeader);
+	result = result && this->file.write(this->payload) == this->payload.size();
+
+	this->payload.clear();
+	this->block_samples = 0;
+
+	return result;
+}
+
+
+TrajectoryLogReader::TrajectoryLogReader() {
+	this->data_offset = 0;
+	this->dof = 0;
+	this->resolution = 1;
+	this->number_of_samples = 0;
+	this->current_block = static_cast<std::size_t>(-1);
+}
+
+TrajectoryLogReader::~TrajectoryLogReader() {
+	this->close();
+}
+
+bool TrajectoryLogReader::open(const QString& _file_name) {
+	this->close();
+
+	this->file.setFileName(_file_name);
+	if (this->file.open(QIODevice::ReadOnly) == false) {
+		return false;
+	}
+
+	FileHeader header;
+	if (this->file.read(reinterpret_cast<char*>(&header), sizeof(FileHeader)) != sizeof(FileHeader) ||
+		std::memcmp(header.magic, TrajectoryLog::MAGIC, sizeof(header.magic)) != 0 ||
+		header.version != TrajectoryLog::VERSION) {
+		this->file.close();
+		return false;
+	}
+
+	this->dof = header.dof;
+	this->resolution = header.resolution;
+	this->data_offset = sizeof(FileHeader);
+
+	if (this->readIndex() == false && this->scanBlocks() == false) {
+		this->file.close();
+		return false;
+	}
+
+	this->number_of_samples = 0;
+	for (std::size_t i = 0; i < this->blocks.size(); ++i) {
+		this->number_of_samples += this->blocks[i].number_of_samples;
+	}
+
+	return this->blocks.empty() == false;
+}
+
+void TrajectoryLogReader::close() {
+	this->file.close();
+	this->blocks.clear();
+	this->times.clear();
+	this->values.clear();
+	this->number_of_samples = 0;
+	this->current_block = static_cast<std::size_t>(-1);
+}
+
+bool TrajectoryLogReader::isOpen() const {
+	return this->file.isOpen();
+}
+
+std::size_t TrajectoryLogReader::getDof() const {
+	return this->dof;
+}
+
+std::int64_t TrajectoryLogReader::getStartTime() const {
+	return this->blocks.empty() == true ? 0 : this->blocks.front().first_time;
+}
+
+std::int64_t TrajectoryLogReader::getEndTime() const {
+	return this->blocks.empty() == true ? 0 : this->blocks.back().last_time;
+}
+
+std::uint64_t TrajectoryLogReader::getNumberOfSamples() const {
+	return this->number_of_samples;
+}
+
+bool TrajectoryLogReader::interpolate(std::int64_t _time, double* _values) {
+	if (this->blocks.empty() == true) {
+		return false;
+	}
+
+	_time = std::max(this->getStartTime(), std::min(this->getEndTime(), _time));
+
+	// last block starting at or before _time
+	std::size_t block = 0;
+	std::size_t low = 0;
+	std::size_t high = this->blocks.size();
+	while (low < high) {
+		std::size_t middle = (low + high) / 2;
+		if (this->blocks[middle].first_time <= _time) {
+			block = middle;
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+
+	if (this->loadBlock(block) == false) {
+		return false;
+	}
+
+	// between the last sample of this block and the first of the next one
+	if (_time > this->times.back() && block + 1 < this->blocks.size()) {
+		std::int64_t time_a = this->times.back();
+		std::vector<double> values_a(this->values.end() - this->dof, this->values.end());
+
+		if (this->loadBlock(block + 1) == false) {
+			return false;
+		}
+
+		double s = static_cast<double>(_time - time_a) / static_cast<double>(std::max<std::int64_t>(this->times.front() - time_a, 1));
+		for (std::size_t i = 0; i < this->dof; ++i) {
+			_values[i] = values_a[i] + s * (this->values[i] - values_a[i]);
+		}
+
+		return true;
+	}
+
+	std::size_t b = std::upper_bound(this->times.begin(), this->times.end(), _time) - this->times.begin();
+	std::size_t a = (b == 0) ? 0 : b - 1;
+	b = std::min(b, this->times.size() - 1);
+
+	double s = (b == a) ? 0 : static_cast<double>(_time - this->times[a]) / static_cast<double>(std::max<std::int64_t>(this->times[b] - this->times[a], 1));
+	for (std::size_t i = 0; i < this->dof; ++i) {
+		_values[i] = this->values[a * this->dof + i] + s * (this->values[b * this->dof + i] - this->values[a * this->dof + i]);
+	}
+
+	return true;
+}
+
+bool TrajectoryLogReader::readIndex() {
+	qint64 size = this->file.size();
+	if (size < static_cast<qint64>(this->data_offset + sizeof(IndexFooter))) {
+		return false;
+	}
+
+	IndexFooter footer;
+	if (this->file.seek(size - sizeof(IndexFooter)) == false ||
+		this->file.read(reinterpret_cast<char*>(&footer), sizeof(IndexFooter)) != sizeof(IndexFooter) ||
+		std::memcmp(footer.magic, TrajectoryLog::INDEX_MAGIC, sizeof(footer.magic)) != 0 ||
+		footer.index_offset + footer.number_of_blocks * sizeof(IndexEntry) + sizeof(IndexFooter) != static_cast<std::uint64_t>(size)) {
+		return false;
+	}
+
+	std::vector<IndexEntry> entries(footer.number_of_blocks);
+	qint64 bytes = static_cast<qint64>(entries.size() * sizeof(IndexEntry));
+	if (this->file.seek(footer.index_offset) == false || this->file.read(reinterpret_cast<char*>(entries.data()), bytes) != bytes) {
+		return false;
+	}
+
+	// an entry without samples is corrupt, the blocks are scanned instead
+	for (std::size_t i = 0; i < entries.size(); ++i) {
+		if (entries[i].number_of_samples == 0) {
+			return false;
+		}
+	}
+
+	this->blocks.resize(entries.size());
+	for (std::size_t i = 0; i < entries.size(); ++i) {
+		this->blocks[i].first_time = entries[i].first_time;
+		this->blocks[i].last_time = entries[i].last_time;
+		this->blocks[i].offset = entries[i].offset;
+		this->blocks[i].number_of_samples = entries[i].number_of_samples;
+	}
+
+	return true;
+}
+
+bool TrajectoryLogReader::scanBlocks() {
+	this->blocks.clear();
+
+	std::uint64_t offset = this->data_offset;
+	std::uint64_t size = static_cast<std::uint64_t>(this->file.size());
+
+	// a truncated last block is dropped
+	while (offset + sizeof(BlockHeader) <= size) {
+		BlockHeader header;
+		if (this->file.seek(offset) == false || this->file.read(reinterpret_cast<char*>(&header), sizeof(BlockHeader)) != sizeof(BlockHeader)) {
+			break;
+		}
+
+		if (header.number_of_samples == 0 || offset + sizeof(BlockHeader) + header.payload_size > size) {
+			break;
+		}
+
+		TrajectoryLog::BlockInfo info;
+		info.first_time = header.first_time;
+		info.last_time = header.last_time;
+		info.offset = offset;
+		info.number_of_samples = header.number_of_samples;
+		this->blocks.push_back(info);
+
+		offset += sizeof(BlockHeader) + header.payload_size;
+	}
+
+	return this->blocks.empty() == false;
+}
+
+bool TrajectoryLogReader::loadBlock(std::size_t _block) {
+	if (_block == this->current_block) {
+		return true;
+	}
+
+	BlockHeader header;
+	if (this->file.seek(this->blocks[_block].offset) == false || this->file.read(reinterpret_cast<char*>(&header), sizeof(BlockHeader)) != sizeof(BlockHeader) ||
+		header.number_of_samples != this->blocks[_block].number_of_samples) {
+		return false;
+	}
+
+	QByteArray payload = this->file.read(header.payload_size);
+	if (payload.size() != static_cast<int>(header.payload_size)) {
+		return false;
+	}
+
+	this->times.resize(header.number_of_samples);
+	this->values.resize(header.number_of_samples * this->dof);
+
+	const char* position = payload.constData();
+	const char* end = position + payload.size();
+
+	std::int64_t time = 0;
+	std::vector<std::int64_t> quantized(this->dof, 0);
+
+	for (std::uint32_t i = 0; i < header.number_of_samples; ++i) {
+		std::int64_t delta;
+		if (readVarint(position, end, delta) == false) {
+			this->current_block = static_cast<std::size_t>(-1);
+			return false;
+		}
+		time += delta;
+		this->times[i] = time;
+
+		for (std::size_t j = 0; j < this->dof; ++j) {
+			if (readVarint(position, end, delta) == false) {
+				this->current_block = static_cast<std::size_t>(-1);
+				return false;
+			}
+			quantized[j] += delta;
+			this->values[i * this->dof + j] = quantized[j] * this->resolution;
+		}
+	}
+
+	this->current_block = _block;
+
+	return true;
+}
+
+}
@@ -0,0 +1,106 @@
+#ifndef VM_TRAJECTORY_LOG_H
+#define VM_TRAJECTORY_LOG_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+#include <cstdint>
+#include <vector>
+
+namespace vm {
+
+// Compact binary joint trajectory log.
+// Samples (time in microseconds, joint values) are quantized to a fixed resolution and stored in blocks, the first
+// sample of a block absolute and the following ones as zigzag varint deltas to their predecessor. Every block starts
+// with a small header (sample count, payload size, first and last time), an index of all blocks is appended on close.
+// Logs without index (e.g. after a crash) are indexed by skipping from block header to block header.
+class TrajectoryLog {
+public:
+	struct BlockInfo {
+		std::int64_t first_time;
+		std::int64_t last_time;
+		std::uint64_t offset;
+		std::uint32_t number_of_samples;
+	};
+
+	static const char MAGIC[4];
+	static const char INDEX_MAGIC[4];
+	static const std::uint32_t VERSION;
+};
+
+class TrajectoryLogWriter {
+public:
+	TrajectoryLogWriter();
+	virtual ~TrajectoryLogWriter();
+
+	// _resolution is the quantization step of the joint values in their own unit
+	bool open(const QString& _file_name, std::size_t _dof, double _resolution, std::size_t _samples_per_block);
+	bool close();
+	bool isOpen() const;
+
+	// times must not decrease, _values holds dof entries
+	bool append(std::int64_t _time, const double* _values);
+
+	std::uint64_t getNumberOfSamples() const;
+
+private:
+	bool flushBlock();
+
+	QFile file;
+
+	std::size_t dof;
+	double resolution;
+	std::size_t samples_per_block;
+
+	QByteArray payload;
+	std::uint32_t block_samples;
+	std::int64_t block_first_time;
+	std::int64_t previous_time;
+	std::vector<std::int64_t> previous_values;
+
+	std::vector<TrajectoryLog::BlockInfo> blocks;
+	std::uint64_t number_of_samples;
+};
+
+// Streams a trajectory log from disk, only the block around the requested time is decoded.
+class TrajectoryLogReader {
+public:
+	TrajectoryLogReader();
+	virtual ~TrajectoryLogReader();
+
+	bool open(const QString& _file_name);
+	void close();
+	bool isOpen() const;
+
+	std::size_t getDof() const;
+	std::int64_t getStartTime() const;
+	std::int64_t getEndTime() const;
+	std::uint64_t getNumberOfSamples() const;
+
+	// linear interpolation between the samples around _time, clamped to the recorded range
+	bool interpolate(std::int64_t _time, double* _values);
+
+private:
+	bool readIndex();
+	bool scanBlocks();
+	bool loadBlock(std::size_t _block);
+
+	QFile file;
+	std::uint64_t data_offset;
+
+	std::size_t dof;
+	double resolution;
+
+	std::vector<TrajectoryLog::BlockInfo> blocks;
+	std::uint64_t number_of_samples;
+
+	// decoded samples of the current block
+	std::size_t current_block;
+	std::vector<std::int64_t> times;
+	std::vector<double> values;
+};
+
+}
+
+#endif /* VM_TRAJECTORY_LOG_H */
@@ -0,0 +1,116 @@
+#include <QDir>
+#include <QFile>
+
+#include <cmath>
+
+#include "TestCheck.h"
+#include "TrajectoryLog.h"
+
+using namespace vm;
+
+static const double RESOLUTION = 1e-4;
+
+// sample i is recorded at 1000 * i microseconds
+static void getSample(std::size_t _sample, double* _values) {
+	_values[0] = 0.01 * static_cast<double>(_sample);
+	_values[1] = std::sin(0.1 * static_cast<double>(_sample));
+}
+
+static bool isNear(const double* _values, double _first, double _second, double _tolerance) {
+	return std::abs(_values[0] - _first) <= _tolerance && std::abs(_values[1] - _second) <= _tolerance;
+}
+
+int main() {
+	QString file_name = QDir::tempPath() + "/TrajectoryLogTest.log";
+
+	bool passed = true;
+	double values[2];
+	double expected[2];
+	double next[2];
+
+	// 100 samples in blocks of 16, the last block is partial
+	{
+		TrajectoryLogWriter writer;
+		if (check(writer.open(file_name, 2, RESOLUTION, 16) == true, "the log could not be created") == false) {
+			return 1;
+		}
+
+		for (std::size_t i = 0; i < 100; ++i) {
+			getSample(i, values);
+			passed &= check(writer.append(static_cast<std::int64_t>(i) * 1000, values) == true, "a sample was not appended");
+		}
+
+		passed &= check(writer.getNumberOfSamples() == 100 && writer.close() == true, "the log was not closed");
+	}
+
+	{
+		TrajectoryLogReader reader;
+		if (check(reader.open(file_name) == true, "the log could not be opened") == false) {
+			return 1;
+		}
+
+		passed &= check(reader.getDof() == 2 && reader.getNumberOfSamples() == 100, "the index does not match the samples");
+		passed &= check(reader.getStartTime() == 0 && reader.getEndTime() == 99000, "the time range is wrong");
+
+		// recorded samples within the quantization
+		bool exact_flag = true;
+		for (std::size_t i = 0; i < 100; ++i) {
+			getSample(i, expected);
+			exact_flag = exact_flag && reader.interpolate(static_cast<std::int64_t>(i) * 1000, values) == true && isNear(values, expected[0], expected[1], RESOLUTION / 2);
+		}
+		passed &= check(exact_flag == true, "a recorded sample was not restored");
+
+		// halfway within a block and between the last sample of one block and the first of the next
+		getSample(20, expected);
+		getSample(21, next);
+		passed &= check(reader.interpolate(20500, values) == true && isNear(values, (expected[0] + next[0]) / 2, (expected[1] + next[1]) / 2, RESOLUTION), "the interpolation within a block is wrong");
+
+		getSample(15, expected);
+		getSample(16, next);
+		passed &= check(reader.interpolate(15250, values) == true && isNear(values, expected[0] + (next[0] - expected[0]) / 4, expected[1] + (next[1] - expected[1]) / 4, RESOLUTION), "the interpolation across blocks is wrong");
+
+		// clamped to the recorded range, also after jumping backwards
+		getSample(99, expected);
+		passed &= check(reader.interpolate(1000000, values) == true && isNear(values, expected[0], expected[1], RESOLUTION / 2), "a time after the end was not clamped");
+
+		getSample(0, expected);
+		passed &= check(reader.interpolate(-1000, values) == true && isNear(values, expected[0], expected[1], RESOLUTION / 2), "a time before the start was not clamped");
+	}
+
+	// an index entry without samples is not trusted, the blocks are scanned instead
+	{
+		QFile file(file_name);
+		file.open(QIODevice::ReadWrite);
+		// number_of_samples of the third of 7 index entries of 32 bytes before the 16 byte footer
+		file.seek(file.size() - 16 - 5 * 32 + 24);
+		std::uint32_t number_of_samples = 0;
+		file.write(reinterpret_cast<const char*>(&number_of_samples), sizeof(number_of_samples));
+		file.close();
+
+		TrajectoryLogReader reader;
+		passed &= check(reader.open(file_name) == true && reader.getNumberOfSamples() == 100, "the log with a corrupt index could not be opened");
+
+		getSample(40, expected);
+		passed &= check(reader.interpolate(40000, values) == true && isNear(values, expected[0], expected[1], RESOLUTION / 2), "a sample of a block with a corrupt index entry was not restored");
+	}
+
+	// a crashed writer leaves no index and a torn last block, the complete blocks are still found
+	{
+		QFile file(file_name);
+		file.open(QIODevice::ReadWrite);
+		// 7 index entries of 32 bytes and the 16 byte footer, then 3 bytes of the last block
+		file.resize(file.size() - 7 * 32 - 16 - 3);
+		file.close();
+
+		TrajectoryLogReader reader;
+		passed &= check(reader.open(file_name) == true, "the log without index could not be opened");
+		passed &= check(reader.getNumberOfSamples() == 96 && reader.getEndTime() == 95000, "the torn block was not dropped");
+
+		getSample(50, expected);
+		passed &= check(reader.interpolate(50000, values) == true && isNear(values, expected[0], expected[1], RESOLUTION / 2), "a sample of the scanned log was not restored");
+	}
+
+	QFile::remove(file_name);
+
+	return passed == true ? 0 : 1;
+}
@@ -0,0 +1,78 @@
+#ifndef VM_TRIPLE_BUFFER_H
+#define VM_TRIPLE_BUFFER_H
+
+#include <atomic>
+
+namespace vm {
+
+// Lock free single producer, single consumer triple buffer.
+// The producer always has a buffer to write to and never waits, the consumer always reads the latest complete value.
+// Intermediate values are dropped when the producer is faster than the consumer.
+template<typename T>
+class TripleBuffer {
+public:
+	TripleBuffer() {
+		this->back_index = 0;
+		this->middle_index = 1;
+		this->front_index = 2;
+	}
+
+	// producer side: fill the back buffer, then publish it
+	T& getBackBuffer() {
+		return this->buffers[this->back_index];
+	}
+
+	void publish() {
+		unsigned int previous = this->middle_index.exchange(this->back_index | TripleBuffer::FRESH_FLAG, std::memory_order_acq_rel);
+		this->back_index = previous & TripleBuffer::INDEX_MASK;
+	}
+
+	void write(const T& _value) {
+		this->getBackBuffer() = _value;
+		this->publish();
+	}
+
+	// consumer side: returns true and switches the front buffer if a new value was published since the last call
+	bool update() {
+		if ((this->middle_index.load(std::memory_order_relaxed) & TripleBuffer::FRESH_FLAG) == 0) {
+			return false;
+		}
+
+		unsigned int previous = this->middle_index.exchange(this->front_index, std::memory_order_acq_rel);
+		this->front_index = previous & TripleBuffer::INDEX_MASK;
+
+		return true;
+	}
+
+	const T& getFrontBuffer() const {
+		return this->buffers[this->front_index];
+	}
+
+	bool read(T& _value) {
+		bool fresh_flag = this->update();
+		_value = this->getFrontBuffer();
+		return fresh_flag;
+	}
+
+	bool hasNewValue() const {
+		return (this->middle_index.load(std::memory_order_relaxed) & TripleBuffer::FRESH_FLAG) != 0;
+	}
+
+private:
+	static const unsigned int INDEX_MASK = 3;
+	static const unsigned int FRESH_FLAG = 4;
+
+	TripleBuffer(const TripleBuffer&);
+	TripleBuffer& operator=(const TripleBuffer&);
+
+	T buffers[3];
+
+	// producer and consumer indices on separate cache lines, the middle index is the only shared state
+	alignas(64) unsigned int back_index;
+	alignas(64) std::atomic<unsigned int> middle_index;
+	alignas(64) unsigned int front_index;
+};
+
+}
+
+#endif /* VM_TRIPLE_BUFFER_H */
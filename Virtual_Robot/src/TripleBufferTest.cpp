@@ -0,0 +1,93 @@
+#include <thread>
+
+#include "TestCheck.h"
+#include "TripleBuffer.h"
+
+using namespace vm;
+
+// every field holds the same counter, a mix of two writes shows up as differing fields
+struct Sample {
+	Sample() {
+		for (int i = 0; i < 16; ++i) {
+			this->values[i] = 0;
+		}
+	}
+
+	explicit Sample(unsigned long long _counter) {
+		for (int i = 0; i < 16; ++i) {
+			this->values[i] = _counter;
+		}
+	}
+
+	bool isConsistent() const {
+		for (int i = 1; i < 16; ++i) {
+			if (this->values[i] != this->values[0]) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	unsigned long long values[16];
+};
+
+int main() {
+	bool passed = true;
+
+	// the consumer sees the latest published value once, intermediate values are dropped
+	{
+		TripleBuffer<Sample> buffer;
+		Sample sample;
+
+		passed &= check(buffer.hasNewValue() == false && buffer.read(sample) == false && sample.values[0] == 0, "a new buffer has a value");
+
+		buffer.write(Sample(1));
+		buffer.write(Sample(2));
+		passed &= check(buffer.hasNewValue() == true, "the published value is not new");
+		passed &= check(buffer.read(sample) == true && sample.values[0] == 2, "the latest value was not read");
+		passed &= check(buffer.read(sample) == false && sample.values[0] == 2, "the value was not kept after reading");
+
+		// a value filled in place is only visible after publishing
+		buffer.getBackBuffer() = Sample(3);
+		passed &= check(buffer.update() == false && buffer.getFrontBuffer().values[0] == 2, "an unpublished value is visible");
+		buffer.publish();
+		passed &= check(buffer.update() == true && buffer.getFrontBuffer().values[0] == 3, "the published value is not visible");
+	}
+
+	// a producer and a consumer thread, the consumer never sees a torn or an older value
+	{
+		const unsigned long long number_of_samples = 200000;
+
+		TripleBuffer<Sample> buffer;
+		bool consistent_flag = true;
+		bool ordered_flag = true;
+
+		std::thread consumer([&buffer, &consistent_flag, &ordered_flag, number_of_samples]() {
+			unsigned long long last = 0;
+			Sample sample;
+
+			while (last < number_of_samples) {
+				if (buffer.read(sample) == false) {
+					std::this_thread::yield();
+					continue;
+				}
+
+				consistent_flag = consistent_flag && sample.isConsistent();
+				ordered_flag = ordered_flag && sample.values[0] > last;
+				last = sample.values[0];
+			}
+		});
+
+		for (unsigned long long i = 1; i <= number_of_samples; ++i) {
+			buffer.write(Sample(i));
+		}
+
+		consumer.join();
+
+		passed &= check(consistent_flag == true, "the consumer read a torn value");
+		passed &= check(ordered_flag == true, "the consumer read an older or repeated value");
+	}
+
+	return passed == true ? 0 : 1;
+}
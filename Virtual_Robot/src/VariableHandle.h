@@ -0,0 +1,54 @@
+#ifndef VM_VARIABLE_HANDLE_H
+#define VM_VARIABLE_HANDLE_H
+
+#include <QtGlobal>
+
+namespace vm {
+
+// Resolved variable of a VariableStore<T>, the slot is accessed directly without hashing the names.
+// The generation of a slot changes when its variable is removed, a handle to a removed variable stays invalid
+// even if the slot is reused.
+template<typename T>
+class VariableHandle {
+public:
+	static const quint32 INVALID_SLOT = 0xFFFFFFFF;
+
+	VariableHandle() {
+		this->slot = VariableHandle::INVALID_SLOT;
+		this->generation = 0;
+	}
+
+	VariableHandle(quint32 _slot, quint32 _generation) {
+		this->slot = _slot;
+		this->generation = _generation;
+	}
+
+	// only tells whether the handle was resolved, the store checks the generation
+	bool isNull() const {
+		return this->slot == VariableHandle::INVALID_SLOT;
+	}
+
+	quint32 getSlot() const {
+		return this->slot;
+	}
+
+	quint32 getGeneration() const {
+		return this->generation;
+	}
+
+	bool operator==(const VariableHandle& _other) const {
+		return this->slot == _other.slot && this->generation == _other.generation;
+	}
+
+	bool operator!=(const VariableHandle& _other) const {
+		return !(*this == _other);
+	}
+
+private:
+	quint32 slot;
+	quint32 generation;
+};
+
+}
+
+#endif /* VM_VARIABLE_HANDLE_H */
@@ -0,0 +1,397 @@
+#include "VariableHistory.h"
+
+#include <QtAlgorithms>
+
+#include <algorithm>
+#include <cstring>
+
+namespace vm {
+
+namespace {
+
+// bits of the largest sample, a new block is started if they do not fit anymore
+const std::size_t MAX_TIME_BITS = 4 + 64;
+const std::size_t MAX_VALUE_BITS = 2 + 6 + 6 + 64;
+
+std::uint64_t toBits(double _value) {
+	std::uint64_t bits;
+	std::memcpy(&bits, &_value, sizeof(bits));
+	return bits;
+}
+
+double fromBits(std::uint64_t _bits) {
+	double value;
+	std::memcpy(&value, &_bits, sizeof(value));
+	return value;
+}
+
+class BitReader {
+public:
+	BitReader(const std::vector<std::uint64_t>& _words, std::size_t _number_of_bits) :
+		words(_words)
+	{
+		this->position = 0;
+		this->number_of_bits = _number_of_bits;
+	}
+
+	bool read(int _number_of_bits, std::uint64_t& _bits) {
+		if (this->position + _number_of_bits > this->number_of_bits) {
+			return false;
+		}
+
+		_bits = 0;
+		while (_number_of_bits > 0) {
+			int offset = static_cast<int>(this->position % 64);
+			int chunk = std::min(_number_of_bits, 64 - offset);
+			std::uint64_t word = this->words[this->position / 64];
+			std::uint64_t part = (word << offset) >> (64 - chunk);
+
+			_bits = (chunk == 64) ? part : ((_bits << chunk) | part);
+			this->position += chunk;
+			_number_of_bits -= chunk;
+		}
+
+		return true;
+	}
+
+	// number of 1 bits before the first 0, at most _max_ones
+	bool readPrefix(int _max_ones, int& _ones) {
+		std::uint64_t bit = 0;
+
+		for (_ones = 0; _ones < _max_ones; ++_ones) {
+			if (this->read(1, bit) == false) {
+				return false;
+			}
+			if (bit == 0) {
+				break;
+			}
+		}
+
+		return true;
+	}
+
+private:
+	const std::vector<std::uint64_t>& words;
+	std::size_t position;
+	std::size_t number_of_bits;
+};
+
+}
+
+
+VariableHistory::VariableHistory(std::size_t _dof, std::size_t _capacity) {
+	this->dof = std::max<std::size_t>(_dof, 1);
+
+	std::size_t block_size = VariableHistory::BLOCK_WORDS * sizeof(std::uint64_t);
+	this->blocks.resize(std::max<std::size_t>(_capacity / block_size, 2));
+
+	this->previous_values.resize(this->dof);
+	this->previous_leading_zeros.resize(this->dof);
+	this->previous_trailing_zeros.resize(this->dof);
+
+	this->clear();
+}
+
+std::size_t VariableHistory::getDof() const {
+	return this->dof;
+}
+
+void VariableHistory::append(qint64 _time, const double* _values) {
+	std::size_t needed_bits = MAX_TIME_BITS + this->dof * MAX_VALUE_BITS;
+
+	if (this->number_of_used_blocks == 0 ||
+		this->blocks[this->current_block].number_of_bits + needed_bits > VariableHistory::BLOCK_WORDS * 64) {
+		this->startBlock();
+	}
+
+	VariableHistory::Block& block = this->blocks[this->current_block];
+
+	// also across blocks, queries stop at the first sample after the range
+	qint64 time = _time;
+	if (this->number_of_used_blocks > 1 || block.number_of_samples > 0) {
+		time = std::max(time, this->previous_time);
+	}
+
+	if (block.number_of_samples == 0) {
+		this->writeBits(static_cast<std::uint64_t>(time), 64);
+
+		for (std::size_t i = 0; i < this->dof; ++i) {
+			this->previous_values[i] = toBits(_values[i]);
+			this->previous_leading_zeros[i] = -1;
+			this->previous_trailing_zeros[i] = -1;
+			this->writeBits(this->previous_values[i], 64);
+		}
+
+		this->previous_time = time;
+		this->previous_delta = 0;
+		block.first_time = time;
+	} else {
+		qint64 delta = time - this->previous_time;
+		qint64 delta_of_delta = delta - this->previous_delta;
+
+		// regular sampling makes most deltas of deltas 0
+		if (delta_of_delta == 0) {
+			this->writeBits(0, 1);
+		} else if (delta_of_delta >= -63 && delta_of_delta <= 64) {
+			this->writeBits(2, 2);
+			this->writeBits(static_cast<std::uint64_t>(delta_of_delta + 63), 7);
+		} else if (delta_of_delta >= -255 && delta_of_delta <= 256) {
+			this->writeBits(6, 3);
+			this->writeBits(static_cast<std::uint64_t>(delta_of_delta + 255), 9);
+		} else if (delta_of_delta >= -2047 && delta_of_delta <= 2048) {
+			this->writeBits(14, 4);
+			this->writeBits(static_cast<std::uint64_t>(delta_of_delta + 2047), 12);
+		} else {
+			this->writeBits(15, 4);
+			this->writeBits(static_cast<std::uint64_t>(delta_of_delta), 64);
+		}
+
+		for (std::size_t i = 0; i < this->dof; ++i) {
+			std::uint64_t bits = toBits(_values[i]);
+			std::uint64_t xor_bits = bits ^ this->previous_values[i];
+			this->previous_values[i] = bits;
+
+			// unchanged values cost one bit
+			if (xor_bits == 0) {
+				this->writeBits(0, 1);
+				continue;
+			}
+
+			int leading_zeros = static_cast<int>(qCountLeadingZeroBits(xor_bits));
+			int trailing_zeros = static_cast<int>(qCountTrailingZeroBits(xor_bits));
+
+			if (this->previous_leading_zeros[i] >= 0 && leading_zeros >= this->previous_leading_zeros[i] && trailing_zeros >= this->previous_trailing_zeros[i]) {
+				// fits into the window of the previous value
+				int length = 64 - this->previous_leading_zeros[i] - this->previous_trailing_zeros[i];
+				this->writeBits(2, 2);
+				this->writeBits(xor_bits >> this->previous_trailing_zeros[i], length);
+			} else {
+				int length = 64 - leading_zeros - trailing_zeros;
+				this->writeBits(3, 2);
+				this->writeBits(static_cast<std::uint64_t>(leading_zeros), 6);
+				this->writeBits(static_cast<std::uint64_t>(length - 1), 6);
+				this->writeBits(xor_bits >> trailing_zeros, length);
+
+				this->previous_leading_zeros[i] = leading_zeros;
+				this->previous_trailing_zeros[i] = trailing_zeros;
+			}
+		}
+
+		this->previous_time = time;
+		this->previous_delta = delta;
+	}
+
+	block.last_time = this->previous_time;
+	++block.number_of_samples;
+}
+
+void VariableHistory::clear() {
+	for (std::size_t i = 0; i < this->blocks.size(); ++i) {
+		this->blocks[i].words.clear();
+		this->blocks[i].words.shrink_to_fit();
+		this->blocks[i].number_of_bits = 0;
+		this->blocks[i].number_of_samples = 0;
+		this->blocks[i].first_time = 0;
+		this->blocks[i].last_time = 0;
+	}
+
+	this->current_block = 0;
+	this->number_of_used_blocks = 0;
+	this->previous_time = 0;
+	this->previous_delta = 0;
+}
+
+std::size_t VariableHistory::query(qint64 _start_time, qint64 _end_time, std::vector<qint64>& _times, std::vector<double>& _values) const {
+	std::size_t number_of_samples = _times.size();
+
+	// oldest block first, blocks outside of the range are not decoded
+	std::size_t first_block = (this->number_of_used_blocks < this->blocks.size()) ? 0 : (this->current_block + 1) % this->blocks.size();
+
+	for (std::size_t i = 0; i < this->number_of_used_blocks; ++i) {
+		const VariableHistory::Block& block = this->blocks[(first_block + i) % this->blocks.size()];
+
+		if (block.number_of_samples == 0 || block.last_time < _start_time) {
+			continue;
+		}
+		if (block.first_time > _end_time) {
+			break;
+		}
+
+		this->decodeBlock(block, _start_time, _end_time, _times, _values);
+	}
+
+	return _times.size() - number_of_samples;
+}
+
+std::size_t VariableHistory::getNumberOfSamples() const {
+	std::size_t number_of_samples = 0;
+
+	for (std::size_t i = 0; i < this->blocks.size(); ++i) {
+		number_of_samples += this->blocks[i].number_of_samples;
+	}
+
+	return number_of_samples;
+}
+
+qint64 VariableHistory::getStartTime() const {
+	if (this->number_of_used_blocks == 0) {
+		return 0;
+	}
+
+	std::size_t first_block = (this->number_of_used_blocks < this->blocks.size()) ? 0 : (this->current_block + 1) % this->blocks.size();
+	return this->blocks[first_block].first_time;
+}
+
+qint64 VariableHistory::getEndTime() const {
+	if (this->number_of_used_blocks == 0) {
+		return 0;
+	}
+
+	return this->blocks[this->current_block].last_time;
+}
+
+std::size_t VariableHistory::getCapacity() const {
+	return this->blocks.size() * VariableHistory::BLOCK_WORDS * sizeof(std::uint64_t);
+}
+
+void VariableHistory::startBlock() {
+	if (this->number_of_used_blocks == 0) {
+		this->current_block = 0;
+	} else {
+		this->current_block = (this->current_block + 1) % this->blocks.size();
+	}
+
+	// the oldest block is overwritten once the ring is full
+	this->number_of_used_blocks = std::min(this->number_of_used_blocks + 1, this->blocks.size());
+
+	VariableHistory::Block& block = this->blocks[this->current_block];
+	block.words.assign(VariableHistory::BLOCK_WORDS, 0);
+	block.number_of_bits = 0;
+	block.number_of_samples = 0;
+	block.first_time = 0;
+	block.last_time = 0;
+}
+
+void VariableHistory::writeBits(std::uint64_t _bits, int _number_of_bits) {
+	VariableHistory::Block& block = this->blocks[this->current_block];
+
+	while (_number_of_bits > 0) {
+		int offset = static_cast<int>(block.number_of_bits % 64);
+		int chunk = std::min(_number_of_bits, 64 - offset);
+
+		std::uint64_t part = _bits >> (_number_of_bits - chunk);
+		if (chunk < 64) {
+			part &= (static_cast<std::uint64_t>(1) << chunk) - 1;
+		}
+
+		block.words[block.number_of_bits / 64] |= part << (64 - offset - chunk);
+		block.number_of_bits += chunk;
+		_number_of_bits -= chunk;
+	}
+}
+
+void VariableHistory::decodeBlock(const VariableHistory::Block& _block, qint64 _start_time, qint64 _end_time, std::vector<qint64>& _times, std::vector<double>& _values) const {
+	BitReader reader(_block.words, _block.number_of_bits);
+
+	qint64 time = 0;
+	qint64 delta = 0;
+	std::vector<std::uint64_t> values(this->dof, 0);
+	std::vector<int> leading_zeros(this->dof, 0);
+	std::vector<int> trailing_zeros(this->dof, 0);
+
+	std::uint64_t bits = 0;
+
+	for (std::size_t sample = 0; sample < _block.number_of_samples; ++sample) {
+		if (sample == 0) {
+			if (reader.read(64, bits) == false) {
+				return;
+			}
+			time = static_cast<qint64>(bits);
+
+			for (std::size_t i = 0; i < this->dof; ++i) {
+				if (reader.read(64, values[i]) == false) {
+					return;
+				}
+			}
+		} else {
+			int ones = 0;
+			if (reader.readPrefix(4, ones) == false) {
+				return;
+			}
+
+			qint64 delta_of_delta = 0;
+			switch (ones) {
+			case 0:
+				break;
+			case 1:
+				if (reader.read(7, bits) == false) {
+					return;
+				}
+				delta_of_delta = static_cast<qint64>(bits) - 63;
+				break;
+			case 2:
+				if (reader.read(9, bits) == false) {
+					return;
+				}
+				delta_of_delta = static_cast<qint64>(bits) - 255;
+				break;
+			case 3:
+				if (reader.read(12, bits) == false) {
+					return;
+				}
+				delta_of_delta = static_cast<qint64>(bits) - 2047;
+				break;
+			default:
+				if (reader.read(64, bits) == false) {
+					return;
+				}
+				delta_of_delta = static_cast<qint64>(bits);
+				break;
+			}
+
+			delta += delta_of_delta;
+			time += delta;
+
+			for (std::size_t i = 0; i < this->dof; ++i) {
+				if (reader.readPrefix(2, ones) == false) {
+					return;
+				}
+
+				if (ones == 0) {
+					continue;
+				}
+
+				if (ones == 2) {
+					std::uint64_t leading = 0;
+					std::uint64_t length = 0;
+					if (reader.read(6, leading) == false || reader.read(6, length) == false) {
+						return;
+					}
+
+					leading_zeros[i] = static_cast<int>(leading);
+					trailing_zeros[i] = 64 - leading_zeros[i] - static_cast<int>(length + 1);
+				}
+
+				if (reader.read(64 - leading_zeros[i] - trailing_zeros[i], bits) == false) {
+					return;
+				}
+
+				values[i] ^= bits << trailing_zeros[i];
+			}
+		}
+
+		// times do not decrease
+		if (time > _end_time) {
+			return;
+		}
+
+		if (time >= _start_time) {
+			_times.push_back(time);
+			for (std::size_t i = 0; i < this->dof; ++i) {
+				_values.push_back(fromBits(values[i]));
+			}
+		}
+	}
+}
+
+}
@@ -0,0 +1,69 @@
+#ifndef VM_VARIABLE_HISTORY_H
+#define VM_VARIABLE_HISTORY_H
+
+#include <QtGlobal>
+
+#include <cstdint>
+#include <vector>
+
+namespace vm {
+
+// Time series of one variable with dof values per sample in a fixed amount of memory.
+// Samples are compressed into blocks: times as delta of delta, values XOR'ed with the previous value of the same
+// channel and stored without leading and trailing zero bits. Every block starts with an uncompressed sample, so the
+// oldest block can be dropped when the ring is full and the remaining blocks still decode.
+class VariableHistory {
+public:
+	// _capacity is the memory for the compressed samples in bytes
+	VariableHistory(std::size_t _dof, std::size_t _capacity);
+
+	std::size_t getDof() const;
+
+	// times must not decrease, _values holds dof entries
+	void append(qint64 _time, const double* _values);
+	void clear();
+
+	// appends the samples with _start_time <= time <= _end_time, dof values per sample, returns their number
+	std::size_t query(qint64 _start_time, qint64 _end_time, std::vector<qint64>& _times, std::vector<double>& _values) const;
+
+	std::size_t getNumberOfSamples() const;
+	// 0 if empty
+	qint64 getStartTime() const;
+	qint64 getEndTime() const;
+
+	std::size_t getCapacity() const;
+
+private:
+	struct Block {
+		std::vector<std::uint64_t> words;
+		std::size_t number_of_bits;
+		std::size_t number_of_samples;
+		qint64 first_time;
+		qint64 last_time;
+	};
+
+	// 8 KiB blocks, a worst case joint angles sample takes about 80 bytes
+	static const std::size_t BLOCK_WORDS = 1024;
+
+	void startBlock();
+	void writeBits(std::uint64_t _bits, int _number_of_bits);
+	void decodeBlock(const VariableHistory::Block& _block, qint64 _start_time, qint64 _end_time, std::vector<qint64>& _times, std::vector<double>& _values) const;
+
+	std::size_t dof;
+
+	// ring of blocks, current_block is the one written to
+	std::vector<VariableHistory::Block> blocks;
+	std::size_t current_block;
+	std::size_t number_of_used_blocks;
+
+	// encoder state of the current block
+	qint64 previous_time;
+	qint64 previous_delta;
+	std::vector<std::uint64_t> previous_values;
+	std::vector<int> previous_leading_zeros;
+	std::vector<int> previous_trailing_zeros;
+};
+
+}
+
+#endif /* VM_VARIABLE_HISTORY_H */
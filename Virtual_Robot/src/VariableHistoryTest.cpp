@@ -0,0 +1,146 @@
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "TestCheck.h"
+#include "VariableHistory.h"
+
+using namespace vm;
+
+// bit exact, the compression must not round
+static bool isSameValue(double _a, double _b) {
+	return std::memcmp(&_a, &_b, sizeof(double)) == 0;
+}
+
+static bool isSameSamples(const std::vector<qint64>& _times, const std::vector<double>& _values, const std::vector<qint64>& _expected_times, const std::vector<double>& _expected_values, std::size_t _first_sample, std::size_t _dof) {
+	if (_times.size() + _first_sample != _expected_times.size() || _values.size() != _times.size() * _dof) {
+		return false;
+	}
+
+	for (std::size_t i = 0; i < _times.size(); ++i) {
+		if (_times[i] != _expected_times[_first_sample + i]) {
+			return false;
+		}
+
+		for (std::size_t j = 0; j < _dof; ++j) {
+			if (isSameValue(_values[i * _dof + j], _expected_values[(_first_sample + i) * _dof + j]) == false) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+int main() {
+	bool passed = true;
+
+	const std::size_t dof = 6;
+
+	// samples are decoded exactly: regular and irregular times, smooth, constant and special values
+	{
+		VariableHistory history(dof, 1024 * 1024);
+
+		std::vector<qint64> times;
+		std::vector<double> values;
+		qint64 time = 1000000;
+
+		for (std::size_t i = 0; i < 5000; ++i) {
+			// mostly 4 ms, with jitter and gaps that need every delta of delta size
+			if (i % 97 == 0) {
+				time += 100000 + static_cast<qint64>(i);
+			} else if (i % 13 == 0) {
+				time += 4 + static_cast<qint64>(i % 300);
+			} else {
+				time += 4;
+			}
+			times.push_back(time);
+
+			double sample[dof];
+			sample[0] = std::sin(0.01 * static_cast<double>(i));
+			sample[1] = 42.5;
+			sample[2] = static_cast<double>(i % 10);
+			sample[3] = (i % 2 == 0) ? -0.0 : 0.0;
+			sample[4] = (i % 500 == 0) ? std::numeric_limits<double>::infinity() : -1e300 * static_cast<double>(i);
+			sample[5] = std::numeric_limits<double>::denorm_min() * static_cast<double>(i);
+
+			history.append(time, sample);
+			values.insert(values.end(), sample, sample + dof);
+		}
+
+		std::vector<qint64> queried_times;
+		std::vector<double> queried_values;
+
+		passed &= check(history.getNumberOfSamples() == 5000 && history.getStartTime() == times.front() && history.getEndTime() == times.back(), "samples are missing");
+		passed &= check(history.query(times.front(), times.back(), queried_times, queried_values) == 5000, "the query did not return all samples");
+		passed &= check(isSameSamples(queried_times, queried_values, times, values, 0, dof) == true, "the decoded samples differ");
+
+		// a range in the middle, the results are appended
+		std::vector<qint64> range_times(1, 0);
+		std::vector<double> range_values(dof, 0);
+		passed &= check(history.query(times[1000], times[1999], range_times, range_values) == 1000 && range_times.size() == 1001 && range_times[1] == times[1000] && range_times.back() == times[1999], "the range query returned the wrong samples");
+	}
+
+	// the oldest blocks are dropped when the ring is full, the remaining ones still decode
+	{
+		VariableHistory history(dof, 2 * 8192);
+
+		std::vector<qint64> times;
+		std::vector<double> values;
+
+		for (std::size_t i = 0; i < 20000; ++i) {
+			qint64 time = static_cast<qint64>(i) * 4;
+			times.push_back(time);
+
+			double sample[dof];
+			for (std::size_t j = 0; j < dof; ++j) {
+				sample[j] = std::cos(0.001 * static_cast<double>(i * (j + 1)));
+			}
+
+			history.append(time, sample);
+			values.insert(values.end(), sample, sample + dof);
+		}
+
+		std::vector<qint64> queried_times;
+		std::vector<double> queried_values;
+		std::size_t number_of_samples = history.query(0, times.back(), queried_times, queried_values);
+
+		passed &= check(number_of_samples > 0 && number_of_samples < 20000 && number_of_samples == history.getNumberOfSamples(), "the ring did not drop old samples");
+		passed &= check(history.getStartTime() > 0 && history.getEndTime() == times.back(), "the time range does not follow the ring");
+		passed &= check(isSameSamples(queried_times, queried_values, times, values, times.size() - number_of_samples, dof) == true, "the samples after a dropped block differ");
+
+		history.clear();
+		passed &= check(history.getNumberOfSamples() == 0 && history.getStartTime() == 0 && history.query(0, times.back(), queried_times, queried_values) == 0, "the history was not cleared");
+	}
+
+	// regular samples of a constant value take one bit per value, uncompressed they would not fit into the two blocks
+	{
+		VariableHistory history(dof, 2 * 8192);
+
+		double sample[dof] = { 1, 2, 3, 4, 5, 6 };
+		for (qint64 i = 0; i < 10000; ++i) {
+			history.append(i * 4, sample);
+		}
+
+		passed &= check(history.getNumberOfSamples() == 10000 && history.getStartTime() == 0, "constant samples were not compressed");
+	}
+
+	// decreasing times are clamped, queries stop at the first sample after the range
+	{
+		VariableHistory history(1, 8192);
+
+		double value = 1;
+		history.append(100, &value);
+		value = 2;
+		history.append(90, &value);
+		value = 3;
+		history.append(110, &value);
+
+		std::vector<qint64> queried_times;
+		std::vector<double> queried_values;
+		passed &= check(history.query(100, 100, queried_times, queried_values) == 2 && queried_values[1] == 2, "a decreasing time was not clamped");
+	}
+
+	return passed == true ? 0 : 1;
+}
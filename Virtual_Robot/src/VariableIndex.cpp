@@ -0,0 +1,192 @@
+#include "VariableIndex.h"
+
+namespace vm {
+
+VariableIndex::Table::Table(std::size_t _capacity) {
+	this->capacity = _capacity;
+	this->buckets = new VariableIndex::Bucket[_capacity];
+
+	for (std::size_t i = 0; i < _capacity; ++i) {
+		this->buckets[i].program_id.store(0, std::memory_order_relaxed);
+		this->buckets[i].name_id.store(0, std::memory_order_relaxed);
+		this->buckets[i].index.store(0, std::memory_order_relaxed);
+		this->buckets[i].slot.store(VariableIndex::INVALID_SLOT, std::memory_order_relaxed);
+	}
+}
+
+VariableIndex::Table::~Table() {
+	delete[] this->buckets;
+}
+
+VariableIndex::VariableIndex(ReclamationDomain* _domain) {
+	this->domain = _domain;
+	this->table.store(NULL);
+	this->number_of_keys = 0;
+	this->number_of_tombstones = 0;
+	this->number_of_rehashes = 0;
+}
+
+VariableIndex::~VariableIndex() {
+	delete this->table.load();
+}
+
+quint32 VariableIndex::find(const VariableKey& _key) const {
+	const VariableIndex::Table* current_table = this->table.load(std::memory_order_acquire);
+	if (current_table == NULL) {
+		return VariableIndex::INVALID_SLOT;
+	}
+
+	std::size_t mask = current_table->capacity - 1;
+
+	for (std::size_t i = VariableIndex::hash(_key) & mask; ; i = (i + 1) & mask) {
+		const VariableIndex::Bucket& bucket = current_table->buckets[i];
+
+		// the key of a bucket is written before its slot is released
+		quint32 slot = bucket.slot.load(std::memory_order_acquire);
+		if (slot == VariableIndex::INVALID_SLOT) {
+			return VariableIndex::INVALID_SLOT;
+		}
+
+		if (slot != VariableIndex::TOMBSTONE_SLOT &&
+			bucket.program_id.load(std::memory_order_relaxed) == _key.program_id &&
+			bucket.name_id.load(std::memory_order_relaxed) == _key.name_id &&
+			bucket.index.load(std::memory_order_relaxed) == _key.index) {
+			return slot;
+		}
+	}
+}
+
+void VariableIndex::insert(const VariableKey& _key, quint32 _slot) {
+	VariableIndex::Table* current_table = this->table.load(std::memory_order_relaxed);
+
+	// tombstones are not refilled while readers may probe them, so they count against the load
+	// keep the load below one half, probe sequences stay short
+	if (current_table == NULL || (this->number_of_keys + this->number_of_tombstones + 1) * 2 > current_table->capacity) {
+		std::size_t capacity = 16;
+		while (capacity < (this->number_of_keys + 1) * 4) {
+			capacity *= 2;
+		}
+		this->rehash(capacity);
+		current_table = this->table.load(std::memory_order_relaxed);
+	}
+
+	std::size_t mask = current_table->capacity - 1;
+
+	for (std::size_t i = VariableIndex::hash(_key) & mask; ; i = (i + 1) & mask) {
+		VariableIndex::Bucket& bucket = current_table->buckets[i];
+
+		if (bucket.slot.load(std::memory_order_relaxed) == VariableIndex::INVALID_SLOT) {
+			bucket.program_id.store(_key.program_id, std::memory_order_relaxed);
+			bucket.name_id.store(_key.name_id, std::memory_order_relaxed);
+			bucket.index.store(_key.index, std::memory_order_relaxed);
+			bucket.slot.store(_slot, std::memory_order_release);
+			++this->number_of_keys;
+			return;
+		}
+	}
+}
+
+bool VariableIndex::remove(const VariableKey& _key) {
+	VariableIndex::Table* current_table = this->table.load(std::memory_order_relaxed);
+	if (current_table == NULL) {
+		return false;
+	}
+
+	std::size_t mask = current_table->capacity - 1;
+
+	for (std::size_t i = VariableIndex::hash(_key) & mask; ; i = (i + 1) & mask) {
+		VariableIndex::Bucket& bucket = current_table->buckets[i];
+
+		quint32 slot = bucket.slot.load(std::memory_order_relaxed);
+		if (slot == VariableIndex::INVALID_SLOT) {
+			return false;
+		}
+
+		if (slot != VariableIndex::TOMBSTONE_SLOT &&
+			bucket.program_id.load(std::memory_order_relaxed) == _key.program_id &&
+			bucket.name_id.load(std::memory_order_relaxed) == _key.name_id &&
+			bucket.index.load(std::memory_order_relaxed) == _key.index) {
+			bucket.slot.store(VariableIndex::TOMBSTONE_SLOT, std::memory_order_release);
+			--this->number_of_keys;
+			++this->number_of_tombstones;
+			return true;
+		}
+	}
+}
+
+std::size_t VariableIndex::size() const {
+	return this->number_of_keys;
+}
+
+void VariableIndex::clear() {
+	VariableIndex::Table* old_table = this->table.exchange(NULL);
+	if (old_table != NULL) {
+		this->domain->retire(old_table);
+	}
+
+	this->number_of_keys = 0;
+	this->number_of_tombstones = 0;
+}
+
+std::size_t VariableIndex::getMemoryUsage() const {
+	const VariableIndex::Table* current_table = this->table.load(std::memory_order_relaxed);
+	if (current_table == NULL) {
+		return 0;
+	}
+
+	return sizeof(VariableIndex::Table) + current_table->capacity * sizeof(VariableIndex::Bucket);
+}
+
+std::size_t VariableIndex::getNumberOfRehashes() const {
+	return this->number_of_rehashes;
+}
+
+quint32 VariableIndex::hash(const VariableKey& _key) {
+	// 64 bit multiplicative mixing of the three ids, the high bits are folded down
+	quint64 value = (static_cast<quint64>(_key.program_id) << 32) ^ _key.name_id;
+	value = (value ^ (static_cast<quint64>(_key.index) * Q_UINT64_C(0x9E3779B97F4A7C15))) * Q_UINT64_C(0xFF51AFD7ED558CCD);
+	value ^= value >> 32;
+
+	return static_cast<quint32>(value);
+}
+
+void VariableIndex::rehash(std::size_t _capacity) {
+	VariableIndex::Table* old_table = this->table.load(std::memory_order_relaxed);
+	VariableIndex::Table* new_table = new VariableIndex::Table(_capacity);
+
+	std::size_t mask = _capacity - 1;
+
+	if (old_table != NULL) {
+		for (std::size_t i = 0; i < old_table->capacity; ++i) {
+			const VariableIndex::Bucket& bucket = old_table->buckets[i];
+
+			quint32 slot = bucket.slot.load(std::memory_order_relaxed);
+			if (slot == VariableIndex::INVALID_SLOT || slot == VariableIndex::TOMBSTONE_SLOT) {
+				continue;
+			}
+
+			VariableKey key(bucket.program_id.load(std::memory_order_relaxed), bucket.name_id.load(std::memory_order_relaxed), bucket.index.load(std::memory_order_relaxed));
+
+			std::size_t j = VariableIndex::hash(key) & mask;
+			while (new_table->buckets[j].slot.load(std::memory_order_relaxed) != VariableIndex::INVALID_SLOT) {
+				j = (j + 1) & mask;
+			}
+
+			new_table->buckets[j].program_id.store(key.program_id, std::memory_order_relaxed);
+			new_table->buckets[j].name_id.store(key.name_id, std::memory_order_relaxed);
+			new_table->buckets[j].index.store(key.index, std::memory_order_relaxed);
+			new_table->buckets[j].slot.store(slot, std::memory_order_relaxed);
+		}
+	}
+
+	// sequentially consistent, see ReclamationDomain::collect()
+	this->table.store(new_table);
+	this->number_of_tombstones = 0;
+	++this->number_of_rehashes;
+
+	if (old_table != NULL) {
+		this->domain->retire(old_table);
+	}
+}
+
+}
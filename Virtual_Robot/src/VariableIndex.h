@@ -0,0 +1,106 @@
+#ifndef VM_VARIABLE_INDEX_H
+#define VM_VARIABLE_INDEX_H
+
+#include <QtGlobal>
+
+#include <atomic>
+
+#include "ReclamationDomain.h"
+
+namespace vm {
+
+// (program, name, index) key of a variable, program and name are ids of a StringInterner
+struct VariableKey {
+	VariableKey() {
+		this->program_id = 0;
+		this->name_id = 0;
+		this->index = 0;
+	}
+
+	VariableKey(quint32 _program_id, quint32 _name_id, quint32 _index) {
+		this->program_id = _program_id;
+		this->name_id = _name_id;
+		this->index = _index;
+	}
+
+	bool operator==(const VariableKey& _other) const {
+		return this->program_id == _other.program_id && this->name_id == _other.name_id && this->index == _other.index;
+	}
+
+	bool operator!=(const VariableKey& _other) const {
+		return !(*this == _other);
+	}
+
+	quint32 program_id;
+	quint32 name_id;
+	quint32 index;
+};
+
+// Open addressing hash table (linear probing, power of two capacity) from variable keys to storage slots.
+// Buckets are one flat array, a lookup touches a single cache line in the common case.
+// find() runs concurrently with a writer: a published bucket is only ever filled once and then tombstoned,
+// growing or compacting publishes a new table and retires the old one to the ReclamationDomain.
+class VariableIndex {
+public:
+	static const quint32 INVALID_SLOT = 0xFFFFFFFF;
+
+	explicit VariableIndex(ReclamationDomain* _domain);
+	~VariableIndex();
+
+	// returns INVALID_SLOT if the key is not in the index, readers hold a ReadGuard of the domain
+	// the slot may be removed concurrently, the caller checks the key stored with the slot
+	quint32 find(const VariableKey& _key) const;
+
+	// writer side, the key must not be in the index yet
+	void insert(const VariableKey& _key, quint32 _slot);
+	bool remove(const VariableKey& _key);
+
+	std::size_t size() const;
+	void clear();
+
+	// writer side, bytes of the current table and the number of tables built so far
+	std::size_t getMemoryUsage() const;
+	std::size_t getNumberOfRehashes() const;
+
+	static quint32 hash(const VariableKey& _key);
+
+private:
+	static const quint32 TOMBSTONE_SLOT = 0xFFFFFFFE;
+
+	struct Bucket {
+		std::atomic<quint32> program_id;
+		std::atomic<quint32> name_id;
+		std::atomic<quint32> index;
+		std::atomic<quint32> slot;
+	};
+
+	struct Table {
+		explicit Table(std::size_t _capacity);
+		~Table();
+
+		std::size_t capacity;
+		VariableIndex::Bucket* buckets;
+	};
+
+	VariableIndex(const VariableIndex&);
+	VariableIndex& operator=(const VariableIndex&);
+
+	void rehash(std::size_t _capacity);
+
+	ReclamationDomain* domain;
+	std::atomic<VariableIndex::Table*> table;
+	std::size_t number_of_keys;
+	std::size_t number_of_tombstones;
+	std::size_t number_of_rehashes;
+};
+
+// for std::unordered_map and std::unordered_set of variable keys
+struct VariableKeyHash {
+	std::size_t operator()(const VariableKey& _key) const {
+		return VariableIndex::hash(_key);
+	}
+};
+
+}
+
+#endif /* VM_VARIABLE_INDEX_H */
@@ -0,0 +1,88 @@
+#include "StringInterner.h"
+#include "TestCheck.h"
+#include "VariableIndex.h"
+
+using namespace vm;
+
+int main() {
+	bool passed = true;
+
+	// keys survive growing, tombstones and the rehashes that drop them
+	{
+		ReclamationDomain domain;
+		VariableIndex index(&domain);
+
+		passed &= check(index.find(VariableKey(0, 0, 0)) == VariableIndex::INVALID_SLOT && index.getMemoryUsage() == 0, "a new index is not empty");
+
+		const quint32 number_of_keys = 5000;
+		for (quint32 i = 0; i < number_of_keys; ++i) {
+			index.insert(VariableKey(i % 7, i % 11, i), i);
+		}
+
+		bool found_flag = true;
+		for (quint32 i = 0; i < number_of_keys; ++i) {
+			found_flag = found_flag && index.find(VariableKey(i % 7, i % 11, i)) == i;
+		}
+		passed &= check(found_flag == true && index.size() == number_of_keys, "a key was lost while the index grew");
+		passed &= check(index.find(VariableKey(0, 0, number_of_keys)) == VariableIndex::INVALID_SLOT, "a missing key was found");
+
+		// keys that only differ in one id
+		index.insert(VariableKey(100, 1, 2), 10000);
+		index.insert(VariableKey(100, 2, 1), 10001);
+		passed &= check(index.find(VariableKey(100, 1, 2)) == 10000 && index.find(VariableKey(100, 2, 1)) == 10001 && index.find(VariableKey(100, 1, 1)) == VariableIndex::INVALID_SLOT, "similar keys are mixed up");
+
+		for (quint32 i = 0; i < number_of_keys; i += 2) {
+			index.remove(VariableKey(i % 7, i % 11, i));
+		}
+		passed &= check(index.remove(VariableKey(0, 0, 0)) == false, "a removed key was removed again");
+
+		// removing and inserting fills the table with tombstones until it is rehashed
+		std::size_t number_of_rehashes = index.getNumberOfRehashes();
+		for (quint32 i = 0; i < 4 * number_of_keys; ++i) {
+			index.insert(VariableKey(200, 0, i), i);
+			index.remove(VariableKey(200, 0, i));
+		}
+		passed &= check(index.getNumberOfRehashes() > number_of_rehashes, "tombstones did not trigger a rehash");
+
+		found_flag = true;
+		for (quint32 i = 0; i < number_of_keys; ++i) {
+			quint32 slot = index.find(VariableKey(i % 7, i % 11, i));
+			found_flag = found_flag && slot == ((i % 2 == 0) ? VariableIndex::INVALID_SLOT : i);
+		}
+		passed &= check(found_flag == true && index.size() == number_of_keys / 2 + 2, "removals changed other keys");
+
+		index.clear();
+		passed &= check(index.size() == 0 && index.find(VariableKey(1, 1, 1)) == VariableIndex::INVALID_SLOT, "the index was not cleared");
+
+		domain.collect();
+		domain.collect();
+		passed &= check(domain.getNumberOfRetired() == 0, "replaced tables were not reclaimed");
+	}
+
+	// names get dense ids that stay valid while the table grows
+	{
+		ReclamationDomain domain;
+		StringInterner interner(&domain);
+
+		passed &= check(interner.find("main") == StringInterner::INVALID_ID, "a name was found before it was interned");
+
+		quint32 main_id = interner.intern("main");
+		passed &= check(interner.intern("main") == main_id && interner.find("main") == main_id && interner.getString(main_id) == QString("main"), "the same name got another id");
+
+		const quint32 number_of_names = 3000;
+		for (quint32 i = 0; i < number_of_names; ++i) {
+			interner.intern(QString("variable_") + QString::number(i));
+		}
+
+		bool found_flag = true;
+		for (quint32 i = 0; i < number_of_names; ++i) {
+			QString name = QString("variable_") + QString::number(i);
+			quint32 id = interner.find(name);
+			found_flag = found_flag && id == main_id + 1 + i && interner.getString(id) == name;
+		}
+		passed &= check(found_flag == true && interner.size() == number_of_names + 1, "a name was lost while the table grew");
+		passed &= check(interner.getString(main_id) == QString("main"), "the first name moved");
+	}
+
+	return passed == true ? 0 : 1;
+}
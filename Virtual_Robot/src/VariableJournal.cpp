@@ -0,0 +1,378 @@
+#include "VariableJournal.h"
+
+#include <QSaveFile>
+
+#include <cstring>
+
+namespace vm {
+
+namespace {
+
+struct SnapshotHeader {
+	char magic[4];
+	std::uint32_t version;
+	std::uint64_t data_version;
+	std::uint64_t payload_size;
+	std::uint32_t number_of_records;
+	// over data_version and the payload
+	std::uint32_t crc;
+};
+
+struct JournalHeader {
+	char magic[4];
+	std::uint32_t version;
+};
+
+struct EntryHeader {
+	std::uint64_t data_version;
+	std::uint32_t payload_size;
+	std::uint32_t number_of_records;
+	// over data_version and the payload
+	std::uint32_t crc;
+	std::uint32_t reserved;
+};
+
+// CRC-32 (IEEE 802.3), _crc is 0 for the first block
+std::uint32_t crc32(std::uint32_t _crc, const char* _data, std::size_t _size) {
+	static std::uint32_t table[256];
+	static bool table_flag = false;
+
+	if (table_flag == false) {
+		for (std::uint32_t i = 0; i < 256; ++i) {
+			std::uint32_t value = i;
+			for (int bit = 0; bit < 8; ++bit) {
+				value = (value & 1) ? (0xEDB88320 ^ (value >> 1)) : (value >> 1);
+			}
+			table[i] = value;
+		}
+		table_flag = true;
+	}
+
+	std::uint32_t crc = ~_crc;
+	for (std::size_t i = 0; i < _size; ++i) {
+		crc = table[(crc ^ static_cast<std::uint8_t>(_data[i])) & 0xFF] ^ (crc >> 8);
+	}
+
+	return ~crc;
+}
+
+std::uint32_t checksum(std::uint64_t _data_version, const char* _payload, std::size_t _size) {
+	std::uint32_t crc = crc32(0, reinterpret_cast<const char*>(&_data_version), sizeof(_data_version));
+	return crc32(crc, _payload, _size);
+}
+
+template<typename T>
+void writeValue(QByteArray& _data, T _value) {
+	_data.append(reinterpret_cast<const char*>(&_value), sizeof(T));
+}
+
+template<typename T>
+bool readValue(const char*& _position, const char* _end, T& _value) {
+	if (static_cast<std::size_t>(_end - _position) < sizeof(T)) {
+		return false;
+	}
+
+	std::memcpy(&_value, _position, sizeof(T));
+	_position += sizeof(T);
+
+	return true;
+}
+
+void writeString(QByteArray& _data, const QString& _string) {
+	QByteArray utf8 = _string.toUtf8();
+	writeValue<std::uint32_t>(_data, static_cast<std::uint32_t>(utf8.size()));
+	_data.append(utf8);
+}
+
+bool readString(const char*& _position, const char* _end, QString& _string) {
+	std::uint32_t size = 0;
+	if (readValue(_position, _end, size) == false || static_cast<std::size_t>(_end - _position) < size) {
+		return false;
+	}
+
+	_string = QString::fromUtf8(_position, static_cast<int>(size));
+	_position += size;
+
+	return true;
+}
+
+void writeRecord(QByteArray& _data, const VariableRecord& _record) {
+	writeValue<std::uint8_t>(_data, static_cast<std::uint8_t>(_record.kind));
+	writeValue<std::uint8_t>(_data, static_cast<std::uint8_t>(_record.type));
+	writeValue<std::uint32_t>(_data, _record.index);
+	writeString(_data, _record.program_name);
+	writeString(_data, _record.name);
+
+	writeValue<std::uint32_t>(_data, static_cast<std::uint32_t>(_record.values.size()));
+	for (std::size_t i = 0; i < _record.values.size(); ++i) {
+		writeValue<double>(_data, _record.values[i]);
+	}
+
+	writeString(_data, _record.string_value);
+}
+
+bool readRecord(const char*& _position, const char* _end, VariableRecord& _record) {
+	std::uint8_t kind = 0;
+	std::uint8_t type = 0;
+	std::uint32_t index = 0;
+	std::uint32_t number_of_values = 0;
+
+	if (readValue(_position, _end, kind) == false || kind > VariableRecord::RECORD_BATTERY ||
+		readValue(_position, _end, type) == false || type > RobotChangeSet::VARIABLE_STRING ||
+		readValue(_position, _end, index) == false ||
+		readString(_position, _end, _record.program_name) == false ||
+		readString(_position, _end, _record.name) == false ||
+		readValue(_position, _end, number_of_values) == false ||
+		static_cast<std::size_t>(_end - _position) / sizeof(double) < number_of_values) {
+		return false;
+	}
+
+	_record.kind = static_cast<VariableRecord::Kind>(kind);
+	_record.type = static_cast<RobotChangeSet::VariableType>(type);
+	_record.index = index;
+
+	_record.values.resize(number_of_values);
+	for (std::uint32_t i = 0; i < number_of_values; ++i) {
+		readValue(_position, _end, _record.values[i]);
+	}
+
+	return readString(_position, _end, _record.string_value);
+}
+
+bool readRecords(const char* _position, const char* _end, std::uint32_t _number_of_records, std::vector<VariableRecord>& _records) {
+	std::size_t first_record = _records.size();
+	_records.resize(first_record + _number_of_records);
+
+	for (std::uint32_t i = 0; i < _number_of_records; ++i) {
+		if (readRecord(_position, _end, _records[first_record + i]) == false) {
+			_records.resize(first_record);
+			return false;
+		}
+	}
+
+	return _position == _end;
+}
+
+}
+
+const char VariableJournal::SNAPSHOT_MAGIC[4] = { 'V', 'M', 'V', 'S' };
+const char VariableJournal::JOURNAL_MAGIC[4] = { 'V', 'M', 'V', 'J' };
+const std::uint32_t VariableJournal::VERSION = 1;
+
+
+VariableJournal::VariableJournal() {
+	this->journal_size = 0;
+}
+
+VariableJournal::~VariableJournal() {
+	this->close();
+}
+
+bool VariableJournal::open(const QString& _base_name) {
+	this->close();
+
+	this->snapshot_file_name = _base_name + ".snapshot";
+
+	this->journal_file.setFileName(_base_name + ".journal");
+	if (this->journal_file.open(QIODevice::ReadWrite) == false) {
+		return false;
+	}
+
+	JournalHeader header;
+	bool valid_flag = this->journal_file.read(reinterpret_cast<char*>(&header), sizeof(JournalHeader)) == sizeof(JournalHeader) &&
+		std::memcmp(header.magic, VariableJournal::JOURNAL_MAGIC, sizeof(header.magic)) == 0 && header.version == VariableJournal::VERSION;
+
+	if (valid_flag == false) {
+		// new file or unknown format, start over
+		std::memcpy(header.magic, VariableJournal::JOURNAL_MAGIC, sizeof(header.magic));
+		header.version = VariableJournal::VERSION;
+
+		if (this->journal_file.resize(0) == false || this->journal_file.seek(0) == false ||
+			this->journal_file.write(reinterpret_cast<const char*>(&header), sizeof(JournalHeader)) != sizeof(JournalHeader)) {
+			this->journal_file.close();
+			return false;
+		}
+	}
+
+	this->journal_size = static_cast<std::uint64_t>(this->journal_file.size());
+	this->journal_file.seek(this->journal_file.size());
+
+	return true;
+}
+
+void VariableJournal::close() {
+	this->journal_file.close();
+	this->journal_size = 0;
+}
+
+bool VariableJournal::isOpen() const {
+	return this->journal_file.isOpen();
+}
+
+bool VariableJournal::load(std::vector<VariableRecord>& _records, quint64& _data_version) {
+	_records.clear();
+	_data_version = 0;
+
+	if (this->isOpen() == false) {
+		return false;
+	}
+
+	if (this->loadSnapshot(_records, _data_version) == false) {
+		// the entries only make sense on top of their snapshot, their versions must not outlive it
+		_records.clear();
+		_data_version = 0;
+		this->journal_file.resize(sizeof(JournalHeader));
+		this->journal_file.seek(sizeof(JournalHeader));
+		this->journal_size = sizeof(JournalHeader);
+		return false;
+	}
+
+	return this->loadJournal(_records, _data_version);
+}
+
+bool VariableJournal::append(const std::vector<VariableRecord>& _records, quint64 _data_version) {
+	if (this->isOpen() == false) {
+		return false;
+	}
+
+	this->payload.clear();
+	for (std::size_t i = 0; i < _records.size(); ++i) {
+		writeRecord(this->payload, _records[i]);
+	}
+
+	EntryHeader header;
+	header.data_version = _data_version;
+	header.payload_size = static_cast<std::uint32_t>(this->payload.size());
+	header.number_of_records = static_cast<std::uint32_t>(_records.size());
+	header.crc = checksum(_data_version, this->payload.constData(), this->payload.size());
+	header.reserved = 0;
+
+	// a torn entry fails its CRC on the next load and is cut off there, no fsync to keep notifications cheap
+	bool result = this->journal_file.write(reinterpret_cast<const char*>(&header), sizeof(EntryHeader)) == sizeof(EntryHeader) &&
+		this->journal_file.write(this->payload) == this->payload.size() && this->journal_file.flush() == true;
+
+	this->journal_size = static_cast<std::uint64_t>(this->journal_file.pos());
+
+	return result;
+}
+
+bool VariableJournal::writeSnapshot(const std::vector<VariableRecord>& _records, quint64 _data_version) {
+	if (this->isOpen() == false) {
+		return false;
+	}
+
+	this->payload.clear();
+	for (std::size_t i = 0; i < _records.size(); ++i) {
+		writeRecord(this->payload, _records[i]);
+	}
+
+	SnapshotHeader header;
+	std::memcpy(header.magic, VariableJournal::SNAPSHOT_MAGIC, sizeof(header.magic));
+	header.version = VariableJournal::VERSION;
+	header.data_version = _data_version;
+	header.payload_size = static_cast<std::uint64_t>(this->payload.size());
+	header.number_of_records = static_cast<std::uint32_t>(_records.size());
+	header.crc = checksum(_data_version, this->payload.constData(), this->payload.size());
+
+	// the previous snapshot stays in place until the new one is complete
+	QSaveFile file(this->snapshot_file_name);
+	if (file.open(QIODevice::WriteOnly) == false ||
+		file.write(reinterpret_cast<const char*>(&header), sizeof(SnapshotHeader)) != sizeof(SnapshotHeader) ||
+		file.write(this->payload) != this->payload.size() || file.commit() == false) {
+		return false;
+	}
+
+	if (this->journal_file.resize(sizeof(JournalHeader)) == false || this->journal_file.seek(sizeof(JournalHeader)) == false) {
+		return false;
+	}
+
+	this->journal_size = sizeof(JournalHeader);
+
+	return true;
+}
+
+std::uint64_t VariableJournal::getJournalSize() const {
+	return this->journal_size;
+}
+
+bool VariableJournal::loadSnapshot(std::vector<VariableRecord>& _records, quint64& _data_version) {
+	QFile file(this->snapshot_file_name);
+	if (file.exists() == false) {
+		return true;
+	}
+
+	if (file.open(QIODevice::ReadOnly) == false || file.size() < static_cast<qint64>(sizeof(SnapshotHeader))) {
+		return false;
+	}
+
+	// records are decoded straight from the mapping, the file is not copied
+	const char* data = reinterpret_cast<const char*>(file.map(0, file.size()));
+	if (data == NULL) {
+		return false;
+	}
+
+	SnapshotHeader header;
+	std::memcpy(&header, data, sizeof(SnapshotHeader));
+
+	const char* payload_begin = data + sizeof(SnapshotHeader);
+	bool result = std::memcmp(header.magic, VariableJournal::SNAPSHOT_MAGIC, sizeof(header.magic)) == 0 && header.version == VariableJournal::VERSION &&
+		header.payload_size == static_cast<std::uint64_t>(file.size()) - sizeof(SnapshotHeader) &&
+		checksum(header.data_version, payload_begin, header.payload_size) == header.crc &&
+		readRecords(payload_begin, payload_begin + header.payload_size, header.number_of_records, _records) == true;
+
+	if (result == true) {
+		_data_version = header.data_version;
+	}
+
+	file.unmap(reinterpret_cast<uchar*>(const_cast<char*>(data)));
+
+	return result;
+}
+
+bool VariableJournal::loadJournal(std::vector<VariableRecord>& _records, quint64& _data_version) {
+	if (this->journal_file.seek(sizeof(JournalHeader)) == false) {
+		return false;
+	}
+
+	QByteArray data = this->journal_file.readAll();
+	const char* position = data.constData();
+	const char* end = position + data.size();
+
+	while (position != end) {
+		EntryHeader header;
+		const char* entry_begin = position;
+
+		if (readValue(position, end, header) == false || static_cast<std::size_t>(end - position) < header.payload_size ||
+			checksum(header.data_version, position, header.payload_size) != header.crc) {
+			// torn or corrupt tail of a crashed process, everything before it is valid
+			position = entry_begin;
+			break;
+		}
+
+		const char* payload_end = position + header.payload_size;
+
+		// already contained in the snapshot
+		if (header.data_version > _data_version) {
+			if (readRecords(position, payload_end, header.number_of_records, _records) == false) {
+				position = entry_begin;
+				break;
+			}
+
+			_data_version = header.data_version;
+		}
+
+		position = payload_end;
+	}
+
+	qint64 valid_size = sizeof(JournalHeader) + (position - data.constData());
+	if (valid_size != this->journal_file.size()) {
+		this->journal_file.resize(valid_size);
+	}
+
+	this->journal_file.seek(valid_size);
+	this->journal_size = static_cast<std::uint64_t>(valid_size);
+
+	return true;
+}
+
+}
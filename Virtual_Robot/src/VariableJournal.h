@@ -0,0 +1,89 @@
+#ifndef VM_VARIABLE_JOURNAL_H
+#define VM_VARIABLE_JOURNAL_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+#include <cstdint>
+#include <vector>
+
+#include "RobotChangeSet.h"
+
+namespace vm {
+
+// One persisted change of the robot data, values are absolute, so replaying a record twice does no harm.
+struct VariableRecord {
+	enum Kind {
+		RECORD_VARIABLE,
+		RECORD_VARIABLE_REMOVED,
+		RECORD_PARAMETER,
+		RECORD_PARAMETER_REMOVED,
+		// values are power on time and remaining time
+		RECORD_BATTERY
+	};
+
+	VariableRecord() {
+		this->kind = VariableRecord::RECORD_VARIABLE;
+		this->type = RobotChangeSet::VARIABLE_NUMERIC;
+		this->index = 0;
+	}
+
+	VariableRecord::Kind kind;
+	RobotChangeSet::VariableType type;
+	// parameters only use the name
+	QString program_name;
+	QString name;
+	unsigned int index;
+	// joint angles and poses have 8 values, numeric variables 1, parameters any number
+	std::vector<double> values;
+	QString string_value;
+};
+
+// Crash-safe persistence of the robot data as a snapshot file plus an append-only journal.
+// <base>.snapshot holds the complete data of one data version, it is replaced atomically (QSaveFile) and memory
+// mapped when loaded. <base>.journal holds one entry per change notification, every entry carries its data version
+// and a CRC-32, loading stops at the first torn or corrupt entry and cuts the journal there.
+// Entries not newer than the snapshot are skipped, so a crash between writing a snapshot and cutting the journal
+// loses nothing. All fixed size fields are written in host byte order.
+// Journal entries are flushed to the operating system but not synced to disk, they survive a crash of the process
+// but the last entries may be lost on a power failure. Snapshots are synced when QSaveFile commits them.
+class VariableJournal {
+public:
+	static const char SNAPSHOT_MAGIC[4];
+	static const char JOURNAL_MAGIC[4];
+	static const std::uint32_t VERSION;
+
+	VariableJournal();
+	virtual ~VariableJournal();
+
+	bool open(const QString& _base_name);
+	void close();
+	bool isOpen() const;
+
+	// records of the snapshot followed by the newer journal entries, in the order they have to be applied.
+	// _data_version is the version of the last record, new entries must be appended with higher versions.
+	// An unreadable snapshot returns false and empties the journal.
+	bool load(std::vector<VariableRecord>& _records, quint64& _data_version);
+
+	bool append(const std::vector<VariableRecord>& _records, quint64 _data_version);
+
+	// _records is the complete robot data, the journal is emptied afterwards
+	bool writeSnapshot(const std::vector<VariableRecord>& _records, quint64 _data_version);
+
+	std::uint64_t getJournalSize() const;
+
+private:
+	bool loadSnapshot(std::vector<VariableRecord>& _records, quint64& _data_version);
+	bool loadJournal(std::vector<VariableRecord>& _records, quint64& _data_version);
+
+	QString snapshot_file_name;
+	QFile journal_file;
+	std::uint64_t journal_size;
+
+	QByteArray payload;
+};
+
+}
+
+#endif /* VM_VARIABLE_JOURNAL_H */
@@ -0,0 +1,202 @@
+#include <QDir>
+#include <QFile>
+
+#include <vector>
+
+#include "TestCheck.h"
+#include "VariableJournal.h"
+
+using namespace vm;
+
+static VariableRecord makeNumeric(const QString& _name, double _value) {
+	VariableRecord record;
+	record.kind = VariableRecord::RECORD_VARIABLE;
+	record.type = RobotChangeSet::VARIABLE_NUMERIC;
+	record.program_name = "main";
+	record.name = _name;
+	record.values.push_back(_value);
+
+	return record;
+}
+
+static VariableRecord makeString(const QString& _name, const QString& _value) {
+	VariableRecord record;
+	record.kind = VariableRecord::RECORD_VARIABLE;
+	record.type = RobotChangeSet::VARIABLE_STRING;
+	record.program_name = "main";
+	record.name = _name;
+	record.string_value = _value;
+
+	return record;
+}
+
+static bool isNumeric(const VariableRecord& _record, const QString& _name, double _value) {
+	return _record.kind == VariableRecord::RECORD_VARIABLE && _record.type == RobotChangeSet::VARIABLE_NUMERIC && _record.program_name == "main" &&
+		_record.name == _name && _record.values.size() == 1 && _record.values[0] == _value;
+}
+
+int main() {
+	QString base_name = QDir::tempPath() + "/VariableJournalTest";
+	QFile::remove(base_name + ".snapshot");
+	QFile::remove(base_name + ".journal");
+
+	bool passed = true;
+	std::vector<VariableRecord> records;
+	quint64 data_version = 0;
+	std::uint64_t empty_size = 0;
+
+	// entries are replayed in append order after a restart
+	{
+		VariableJournal journal;
+		if (check(journal.open(base_name) == true, "the journal could not be opened") == false) {
+			return 1;
+		}
+
+		passed &= check(journal.load(records, data_version) == true && records.empty() == true && data_version == 0, "a new journal is not empty");
+		empty_size = journal.getJournalSize();
+
+		std::vector<VariableRecord> entry;
+		entry.push_back(makeNumeric("counter", 1));
+		entry.push_back(makeString("state", "running"));
+		passed &= check(journal.append(entry, 1) == true, "the first entry was not appended");
+
+		entry.clear();
+		entry.push_back(makeNumeric("counter", 2));
+		passed &= check(journal.append(entry, 2) == true, "the second entry was not appended");
+	}
+
+	{
+		VariableJournal journal;
+		journal.open(base_name);
+
+		passed &= check(journal.load(records, data_version) == true && data_version == 2, "the journal was not replayed");
+		passed &= check(records.size() == 3 && isNumeric(records[0], "counter", 1) == true && isNumeric(records[2], "counter", 2) == true, "the entries were not replayed in order");
+		passed &= check(records.size() == 3 && records[1].type == RobotChangeSet::VARIABLE_STRING && records[1].string_value == "running", "the string value was not replayed");
+	}
+
+	// a snapshot empties the journal, the entries after it are replayed on top
+	{
+		VariableJournal journal;
+		journal.open(base_name);
+
+		std::vector<VariableRecord> snapshot;
+		snapshot.push_back(makeNumeric("counter", 3));
+		passed &= check(journal.writeSnapshot(snapshot, 3) == true, "the snapshot was not written");
+		passed &= check(journal.load(records, data_version) == true && records.size() == 1 && data_version == 3, "the snapshot did not replace the journal");
+
+		std::vector<VariableRecord> entry(1, makeNumeric("counter", 4));
+		journal.append(entry, 4);
+
+		// left behind by a crash between writing a snapshot and emptying the journal
+		entry[0] = makeNumeric("counter", 0);
+		journal.append(entry, 2);
+	}
+
+	{
+		VariableJournal journal;
+		journal.open(base_name);
+
+		passed &= check(journal.load(records, data_version) == true && data_version == 4, "the snapshot and the journal were not replayed");
+		passed &= check(records.size() == 2 && isNumeric(records[0], "counter", 3) == true && isNumeric(records[1], "counter", 4) == true, "an entry older than the snapshot was replayed");
+	}
+
+	// a torn entry at the end is cut off, the entries before it are kept
+	std::uint64_t valid_size = 0;
+	{
+		VariableJournal journal;
+		journal.open(base_name);
+		journal.load(records, data_version);
+
+		std::vector<VariableRecord> entry(1, makeNumeric("counter", 5));
+		journal.append(entry, 5);
+		valid_size = journal.getJournalSize();
+
+		entry[0] = makeNumeric("counter", 6);
+		journal.append(entry, 6);
+		std::uint64_t torn_size = journal.getJournalSize() - 3;
+		journal.close();
+
+		QFile file(base_name + ".journal");
+		file.open(QIODevice::ReadWrite);
+		file.resize(static_cast<qint64>(torn_size));
+	}
+
+	{
+		VariableJournal journal;
+		journal.open(base_name);
+
+		passed &= check(journal.load(records, data_version) == true && data_version == 5, "the torn entry was replayed");
+		passed &= check(records.size() == 3 && isNumeric(records[2], "counter", 5) == true, "an entry before the torn one was lost");
+		passed &= check(journal.getJournalSize() == valid_size, "the torn entry was not cut off");
+
+		// appending continues after the last valid entry
+		std::vector<VariableRecord> entry(1, makeNumeric("counter", 7));
+		journal.append(entry, 7);
+	}
+
+	{
+		VariableJournal journal;
+		journal.open(base_name);
+
+		passed &= check(journal.load(records, data_version) == true && data_version == 7 && records.size() == 4 && isNumeric(records[3], "counter", 7) == true, "an entry after the cut was lost");
+	}
+
+	// a restart continues after the loaded version, stale entries left by a crash while compacting lose against the snapshot
+	{
+		VariableJournal journal;
+		journal.open(base_name);
+		journal.load(records, data_version);
+
+		QByteArray stale_journal;
+		{
+			QFile file(base_name + ".journal");
+			file.open(QIODevice::ReadWrite);
+			stale_journal = file.readAll();
+		}
+
+		std::vector<VariableRecord> snapshot(1, makeNumeric("counter", 8));
+		passed &= check(journal.writeSnapshot(snapshot, data_version + 1) == true, "the compacted snapshot was not written");
+		journal.close();
+
+		QFile file(base_name + ".journal");
+		file.open(QIODevice::ReadWrite);
+		file.resize(0);
+		file.write(stale_journal);
+	}
+
+	{
+		VariableJournal journal;
+		journal.open(base_name);
+
+		passed &= check(journal.load(records, data_version) == true && data_version == 8, "the compacted snapshot has a lower version");
+		passed &= check(records.size() == 1 && isNumeric(records[0], "counter", 8) == true, "a stale entry was replayed over the compacted snapshot");
+	}
+
+	// a corrupt snapshot is reported instead of replaying the journal alone, its entries are dropped with it
+	{
+		VariableJournal journal;
+		journal.open(base_name);
+
+		std::vector<VariableRecord> entry(1, makeNumeric("counter", 9));
+		journal.append(entry, 9);
+	}
+
+	{
+		QFile file(base_name + ".snapshot");
+		file.open(QIODevice::ReadWrite);
+		file.seek(file.size() - 1);
+		file.write("x", 1);
+		file.close();
+
+		VariableJournal journal;
+		journal.open(base_name);
+
+		passed &= check(journal.load(records, data_version) == false && records.empty() == true && data_version == 0, "a corrupt snapshot was loaded");
+		passed &= check(journal.getJournalSize() == empty_size, "the entries of a corrupt snapshot were kept");
+	}
+
+	QFile::remove(base_name + ".snapshot");
+	QFile::remove(base_name + ".journal");
+
+	return passed == true ? 0 : 1;
+}
@@ -0,0 +1,399 @@
+#ifndef VM_VARIABLE_STORE_H
+#define VM_VARIABLE_STORE_H
+
+#include <QString>
+
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "MemoryUsage.h"
+#include "ReclamationDomain.h"
+#include "SeqLock.h"
+#include "VariableHandle.h"
+#include "VariableIndex.h"
+
+namespace vm {
+
+// How a value is kept in a slot. Plain values are copied under the slot sequence lock,
+// a torn copy is discarded by the reader.
+template<typename T>
+struct VariableValue {
+	static_assert(std::is_trivially_copyable<T>::value, "a torn copy must be harmless, other types need a specialization like QString");
+
+	typedef T Storage;
+
+	static void load(const Storage& _storage, T& _value) {
+		_value = _storage;
+	}
+
+	static void store(Storage& _storage, const T& _value) {
+		_storage = _value;
+	}
+
+	static T get(const Storage& _storage) {
+		return _storage;
+	}
+
+	// stores that allocate, and the bytes allocated for a stored value
+	static const bool ALLOCATING_FLAG = false;
+
+	static std::size_t getHeapMemoryUsage(const Storage&) {
+		return 0;
+	}
+};
+
+// a QString owns a reference counted buffer, a torn copy would release foreign memory,
+// so readers take a reference to an immutable string instead
+template<>
+struct VariableValue<QString> {
+	typedef std::shared_ptr<const QString> Storage;
+
+	static void load(const Storage& _storage, QString& _value) {
+		Storage string = std::atomic_load(&_storage);
+		_value = (string == NULL) ? QString() : *string;
+	}
+
+	static void store(Storage& _storage, const QString& _value) {
+		std::atomic_store(&_storage, std::make_shared<const QString>(_value));
+	}
+
+	static QString get(const Storage& _storage) {
+		return (_storage == NULL) ? QString() : *_storage;
+	}
+
+	static const bool ALLOCATING_FLAG = true;
+
+	// the string and its control block in one allocation (std::make_shared)
+	static std::size_t getHeapMemoryUsage(const Storage& _storage) {
+		return (_storage == NULL) ? 0 : 2 * sizeof(void*) + sizeof(QString) + vm::getHeapMemoryUsage(*_storage);
+	}
+};
+
+// Variables of one type in stable slots, found through a VariableIndex.
+// Slots of removed variables are reused by the next insert, so the arrays stay dense.
+// Readers (load*, getHandle(key), getNumberOfSlots) never block, they hold a ReadGuard of the domain and
+// copy a slot under its sequence lock. Writers are serialized by the owner (vm::Robot).
+// Slots live in chunks that are never moved or freed while the store exists.
+template<typename T>
+class VariableStore {
+public:
+	explicit VariableStore(ReclamationDomain* _domain) :
+		index(_domain)
+	{
+		this->number_of_slots.store(0, std::memory_order_relaxed);
+		this->number_of_inserts = 0;
+		this->number_of_removals = 0;
+		this->number_of_chunk_allocations = 0;
+		this->number_of_value_allocations = 0;
+
+		for (std::size_t i = 0; i < VariableStore::MAX_CHUNKS; ++i) {
+			this->chunks[i].store(NULL, std::memory_order_relaxed);
+		}
+	}
+
+	~VariableStore() {
+		for (std::size_t i = 0; i < VariableStore::MAX_CHUNKS; ++i) {
+			delete[] this->chunks[i].load();
+		}
+	}
+
+	// reader side
+
+	bool load(const VariableKey& _key, T& _value) const {
+		quint32 slot = this->index.find(_key);
+		if (slot == VariableIndex::INVALID_SLOT) {
+			return false;
+		}
+
+		// the slot may have been removed and reused after the lookup
+		const VariableStore::Slot& current_slot = this->getSlot(slot);
+
+		bool found_flag = false;
+		quint32 sequence = 0;
+		do {
+			sequence = current_slot.lock.readBegin();
+			found_flag = (current_slot.used_flag == true && current_slot.key == _key);
+			if (found_flag == true) {
+				VariableValue<T>::load(current_slot.value, _value);
+			}
+		} while (current_slot.lock.readRetry(sequence) == true);
+
+		return found_flag;
+	}
+
+	bool load(const VariableHandle<T>& _handle, T& _value) const {
+		if (_handle.isNull() == true || _handle.getSlot() >= this->getNumberOfSlots()) {
+			return false;
+		}
+
+		const VariableStore::Slot& current_slot = this->getSlot(_handle.getSlot());
+
+		bool found_flag = false;
+		quint32 sequence = 0;
+		do {
+			sequence = current_slot.lock.readBegin();
+			found_flag = (current_slot.used_flag == true && current_slot.generation == _handle.getGeneration());
+			if (found_flag == true) {
+				VariableValue<T>::load(current_slot.value, _value);
+			}
+		} while (current_slot.lock.readRetry(sequence) == true);
+
+		return found_flag;
+	}
+
+	// consistent key and value of a slot, false if the slot is unused
+	bool loadSlot(quint32 _slot, VariableKey& _key, T& _value) const {
+		const VariableStore::Slot& current_slot = this->getSlot(_slot);
+
+		bool used_flag = false;
+		quint32 sequence = 0;
+		do {
+			sequence = current_slot.lock.readBegin();
+			used_flag = current_slot.used_flag;
+			if (used_flag == true) {
+				_key = current_slot.key;
+				VariableValue<T>::load(current_slot.value, _value);
+			}
+		} while (current_slot.lock.readRetry(sequence) == true);
+
+		return used_flag;
+	}
+
+	// returns a null handle if the variable does not exist
+	VariableHandle<T> getHandle(const VariableKey& _key) const {
+		quint32 slot = this->index.find(_key);
+		if (slot == VariableIndex::INVALID_SLOT) {
+			return VariableHandle<T>();
+		}
+
+		const VariableStore::Slot& current_slot = this->getSlot(slot);
+
+		VariableHandle<T> handle;
+		quint32 sequence = 0;
+		do {
+			sequence = current_slot.lock.readBegin();
+			if (current_slot.used_flag == true && current_slot.key == _key) {
+				handle = VariableHandle<T>(slot, current_slot.generation);
+			} else {
+				handle = VariableHandle<T>();
+			}
+		} while (current_slot.lock.readRetry(sequence) == true);
+
+		return handle;
+	}
+
+	// slots are iterated from 0 to getNumberOfSlots() with loadSlot()
+	std::size_t getNumberOfSlots() const {
+		return this->number_of_slots.load(std::memory_order_acquire);
+	}
+
+	// writer side
+
+	quint32 find(const VariableKey& _key) const {
+		return this->index.find(_key);
+	}
+
+	// returns the slot of _key, _value is only stored if the key is new, readers never see a new variable without its value
+	quint32 insert(const VariableKey& _key, const T& _value, bool& _inserted_flag) {
+		quint32 slot = this->index.find(_key);
+		if (slot != VariableIndex::INVALID_SLOT) {
+			_inserted_flag = false;
+			return slot;
+		}
+
+		if (this->free_slots.empty() == false) {
+			slot = this->free_slots.back();
+			this->free_slots.pop_back();
+		} else {
+			slot = this->number_of_slots.load(std::memory_order_relaxed);
+
+			std::size_t chunk_index = slot / VariableStore::CHUNK_SIZE;
+			Q_ASSERT(chunk_index < VariableStore::MAX_CHUNKS);
+
+			if (this->chunks[chunk_index].load(std::memory_order_relaxed) == NULL) {
+				this->chunks[chunk_index].store(new VariableStore::Slot[VariableStore::CHUNK_SIZE], std::memory_order_release);
+				++this->number_of_chunk_allocations;
+			}
+		}
+
+		VariableStore::Slot& current_slot = this->getSlot(slot);
+		current_slot.lock.writeBegin();
+		current_slot.key = _key;
+		current_slot.used_flag = true;
+		VariableValue<T>::store(current_slot.value, _value);
+		current_slot.lock.writeEnd();
+
+		if (slot == this->number_of_slots.load(std::memory_order_relaxed)) {
+			this->number_of_slots.store(slot + 1, std::memory_order_release);
+		}
+
+		this->index.insert(_key, slot);
+		_inserted_flag = true;
+		++this->number_of_inserts;
+		this->countValueAllocation();
+
+		return slot;
+	}
+
+	bool remove(const VariableKey& _key) {
+		quint32 slot = this->index.find(_key);
+		if (slot == VariableIndex::INVALID_SLOT) {
+			return false;
+		}
+
+		this->index.remove(_key);
+
+		VariableStore::Slot& current_slot = this->getSlot(slot);
+		current_slot.lock.writeBegin();
+		current_slot.used_flag = false;
+		++current_slot.generation;
+		VariableValue<T>::store(current_slot.value, T());
+		current_slot.lock.writeEnd();
+
+		this->free_slots.push_back(slot);
+		++this->number_of_removals;
+		this->countValueAllocation();
+
+		return true;
+	}
+
+	void store(quint32 _slot, const T& _value) {
+		VariableStore::Slot& current_slot = this->getSlot(_slot);
+		current_slot.lock.writeBegin();
+		VariableValue<T>::store(current_slot.value, _value);
+		current_slot.lock.writeEnd();
+
+		this->countValueAllocation();
+	}
+
+	// writer side reads need no sequence lock, only the writer modifies slots
+	T getValue(quint32 _slot) const {
+		return VariableValue<T>::get(this->getSlot(_slot).value);
+	}
+
+	const VariableKey& getKey(quint32 _slot) const {
+		return this->getSlot(_slot).key;
+	}
+
+	VariableHandle<T> getHandle(quint32 _slot) const {
+		if (_slot == VariableIndex::INVALID_SLOT) {
+			return VariableHandle<T>();
+		}
+
+		return VariableHandle<T>(_slot, this->getSlot(_slot).generation);
+	}
+
+	// false for null handles and handles of removed variables
+	bool isValid(const VariableHandle<T>& _handle) const {
+		if (_handle.isNull() == true || _handle.getSlot() >= this->number_of_slots.load(std::memory_order_relaxed)) {
+			return false;
+		}
+
+		const VariableStore::Slot& current_slot = this->getSlot(_handle.getSlot());
+		return current_slot.used_flag == true && current_slot.generation == _handle.getGeneration();
+	}
+
+	std::size_t size() const {
+		return this->index.size();
+	}
+
+	bool isUsed(quint32 _slot) const {
+		return this->getSlot(_slot).used_flag;
+	}
+
+	// bytes of one slot, used or not
+	static std::size_t getSlotSize() {
+		return sizeof(VariableStore::Slot);
+	}
+
+	// heap bytes of the value in a slot, 0 for plain values
+	std::size_t getValueMemoryUsage(quint32 _slot) const {
+		return VariableValue<T>::getHeapMemoryUsage(this->getSlot(_slot).value);
+	}
+
+	// bytes of the allocated chunks, the free list and the index, without the heap memory of the values
+	std::size_t getMemoryUsage() const {
+		std::size_t number_of_bytes = sizeof(VariableStore) + this->free_slots.capacity() * sizeof(quint32) + this->index.getMemoryUsage();
+
+		for (std::size_t i = 0; i < VariableStore::MAX_CHUNKS; ++i) {
+			if (this->chunks[i].load(std::memory_order_relaxed) != NULL) {
+				number_of_bytes += VariableStore::CHUNK_SIZE * sizeof(VariableStore::Slot);
+			}
+		}
+
+		return number_of_bytes;
+	}
+
+	// allocation counters since the store was created
+	std::size_t getNumberOfInserts() const {
+		return this->number_of_inserts;
+	}
+
+	std::size_t getNumberOfRemovals() const {
+		return this->number_of_removals;
+	}
+
+	std::size_t getNumberOfChunkAllocations() const {
+		return this->number_of_chunk_allocations;
+	}
+
+	// every store of an allocating value type allocates, 0 for plain values
+	std::size_t getNumberOfValueAllocations() const {
+		return this->number_of_value_allocations;
+	}
+
+	std::size_t getNumberOfIndexRehashes() const {
+		return this->index.getNumberOfRehashes();
+	}
+
+private:
+	static const std::size_t CHUNK_SIZE = 1024;
+	static const std::size_t MAX_CHUNKS = 1024;
+
+	struct Slot {
+		Slot() {
+			this->generation = 0;
+			this->used_flag = false;
+		}
+
+		SeqLock lock;
+		VariableKey key;
+		quint32 generation;
+		bool used_flag;
+		typename VariableValue<T>::Storage value;
+	};
+
+	VariableStore(const VariableStore&);
+	VariableStore& operator=(const VariableStore&);
+
+	const VariableStore::Slot& getSlot(quint32 _slot) const {
+		return this->chunks[_slot / VariableStore::CHUNK_SIZE].load(std::memory_order_acquire)[_slot % VariableStore::CHUNK_SIZE];
+	}
+
+	VariableStore::Slot& getSlot(quint32 _slot) {
+		return this->chunks[_slot / VariableStore::CHUNK_SIZE].load(std::memory_order_acquire)[_slot % VariableStore::CHUNK_SIZE];
+	}
+
+	void countValueAllocation() {
+		if (VariableValue<T>::ALLOCATING_FLAG == true) {
+			++this->number_of_value_allocations;
+		}
+	}
+
+	VariableIndex index;
+
+	std::atomic<VariableStore::Slot*> chunks[VariableStore::MAX_CHUNKS];
+	std::atomic<quint32> number_of_slots;
+	std::vector<quint32> free_slots;
+
+	std::size_t number_of_inserts;
+	std::size_t number_of_removals;
+	std::size_t number_of_chunk_allocations;
+	std::size_t number_of_value_allocations;
+};
+
+}
+
+#endif /* VM_VARIABLE_STORE_H */
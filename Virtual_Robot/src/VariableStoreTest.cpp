@@ -0,0 +1,145 @@
+#include <atomic>
+#include <thread>
+
+#include "TestCheck.h"
+#include "VariableStore.h"
+
+using namespace vm;
+
+// every field holds the same counter, a mix of two writes shows up as differing fields
+struct Sample {
+	Sample() {
+		for (int i = 0; i < 8; ++i) {
+			this->values[i] = 0;
+		}
+	}
+
+	explicit Sample(double _counter) {
+		for (int i = 0; i < 8; ++i) {
+			this->values[i] = _counter;
+		}
+	}
+
+	bool isConsistent() const {
+		for (int i = 1; i < 8; ++i) {
+			if (this->values[i] != this->values[0]) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	double values[8];
+};
+
+int main() {
+	bool passed = true;
+
+	// handles of removed variables stay invalid when their slot is reused
+	{
+		ReclamationDomain domain;
+		VariableStore<double> store(&domain);
+
+		bool inserted_flag = false;
+		quint32 slot = store.insert(VariableKey(1, 2, 0), 1.5, inserted_flag);
+		VariableHandle<double> handle = store.getHandle(VariableKey(1, 2, 0));
+
+		double value = 0;
+		passed &= check(inserted_flag == true && handle.isNull() == false && store.load(handle, value) == true && value == 1.5, "the inserted value was not loaded");
+
+		store.insert(VariableKey(1, 2, 0), 2.5, inserted_flag);
+		passed &= check(inserted_flag == false && store.load(VariableKey(1, 2, 0), value) == true && value == 1.5, "an existing value was replaced by insert");
+
+		store.store(slot, 3.5);
+		passed &= check(store.load(handle, value) == true && value == 3.5, "the stored value was not loaded");
+
+		store.remove(VariableKey(1, 2, 0));
+		passed &= check(store.isValid(handle) == false && store.load(handle, value) == false && store.getHandle(VariableKey(1, 2, 0)).isNull() == true, "the removed variable is still loaded");
+
+		quint32 reused_slot = store.insert(VariableKey(1, 3, 0), 4.5, inserted_flag);
+		passed &= check(reused_slot == slot && store.load(handle, value) == false, "the handle loads the variable of the reused slot");
+		passed &= check(store.load(store.getHandle(VariableKey(1, 3, 0)), value) == true && value == 4.5, "the variable in the reused slot was not loaded");
+	}
+
+	// readers never see a torn value while the writer stores, inserts and removes
+	{
+		ReclamationDomain domain;
+		VariableStore<Sample> store(&domain);
+
+		bool inserted_flag = false;
+		store.insert(VariableKey(1, 1, 0), Sample(0), inserted_flag);
+		VariableHandle<Sample> handle = store.getHandle(VariableKey(1, 1, 0));
+
+		std::atomic<bool> started_flag(false);
+		std::atomic<bool> running_flag(true);
+		std::atomic<bool> consistent_flag(true);
+		std::atomic<bool> found_flag(true);
+
+		std::thread reader([&store, &domain, &handle, &started_flag, &running_flag, &consistent_flag, &found_flag]() {
+			Sample sample;
+			started_flag.store(true);
+
+			while (running_flag.load() == true) {
+				if (store.load(handle, sample) == false) {
+					found_flag.store(false);
+				}
+				consistent_flag.store(consistent_flag.load() && sample.isConsistent());
+
+				// a lookup by key may run into a table that is replaced concurrently
+				ReclamationDomain::ReadGuard guard(&domain);
+				if (store.load(VariableKey(1, 1, 0), sample) == false) {
+					found_flag.store(false);
+				}
+				consistent_flag.store(consistent_flag.load() && sample.isConsistent());
+			}
+		});
+
+		while (started_flag.load() == false) {
+			std::this_thread::yield();
+		}
+
+		quint32 slot = handle.getSlot();
+
+		for (int i = 1; i <= 200000; ++i) {
+			store.store(slot, Sample(i));
+
+			// grows the index and reuses slots of other variables
+			if (i % 10 == 0) {
+				store.insert(VariableKey(2, 1, (i / 10) % 3000), Sample(-i), inserted_flag);
+			}
+			if (i % 70 == 0) {
+				store.remove(VariableKey(2, 1, (i / 70) % 3000));
+			}
+
+			domain.collect();
+		}
+
+		running_flag.store(false);
+		reader.join();
+
+		// the first collect advances past the epoch of the last retirement, the second deletes it
+		domain.collect();
+		domain.collect();
+
+		passed &= check(consistent_flag.load() == true, "a reader saw a torn value");
+		passed &= check(found_flag.load() == true, "a reader lost the variable while others were changed");
+		passed &= check(domain.getNumberOfRetired() == 0, "replaced index tables were not reclaimed");
+	}
+
+	// strings are replaced as a whole
+	{
+		ReclamationDomain domain;
+		VariableStore<QString> store(&domain);
+
+		bool inserted_flag = false;
+		quint32 slot = store.insert(VariableKey(1, 1, 0), QString("first"), inserted_flag);
+		store.store(slot, QString("second"));
+
+		QString value;
+		passed &= check(store.load(store.getHandle(VariableKey(1, 1, 0)), value) == true && value == QString("second"), "the string was not replaced");
+		passed &= check(store.getNumberOfValueAllocations() == 2, "string stores were not counted");
+	}
+
+	return passed == true ? 0 : 1;
+}